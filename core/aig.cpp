@@ -0,0 +1,144 @@
+/*********************                                                        */
+/*! \file aig.cpp
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief And-inverter graph of a sequential circuit.
+**
+**/
+
+#include "core/aig.h"
+
+#include <cassert>
+#include <utility>
+
+#include "utils/exceptions.h"
+
+using namespace std;
+
+namespace pono {
+
+Aig::Aig() : num_ands_(0) { new_var(CONST); }
+
+AigLit Aig::make_input()
+{
+  uint32_t v = new_var(INPUT);
+  AigLit l = make_lit(v, false);
+  idx_[v] = inputs_.size();
+  inputs_.push_back(l);
+  return l;
+}
+
+AigLit Aig::make_latch()
+{
+  uint32_t v = new_var(LATCH);
+  AigLit l = make_lit(v, false);
+  idx_[v] = latches_.size();
+  latches_.push_back({ l, aig_false, l });
+  return l;
+}
+
+void Aig::set_next(AigLit latch, AigLit next)
+{
+  latches_[latch_index(latch)].next = next;
+}
+
+void Aig::set_init(AigLit latch, AigLit init)
+{
+  if (init != aig_false && init != aig_true && init != latch) {
+    throw PonoException("AIG latches are initialized to constants");
+  }
+  latches_[latch_index(latch)].init = init;
+}
+
+size_t Aig::latch_index(AigLit latch) const
+{
+  assert(!is_negated(latch));
+  assert(kinds_[var(latch)] == LATCH);
+  return idx_[var(latch)];
+}
+
+size_t Aig::input_index(AigLit input) const
+{
+  assert(!is_negated(input));
+  assert(kinds_[var(input)] == INPUT);
+  return idx_[var(input)];
+}
+
+vector<bool> Aig::eval(const vector<bool> & latch_vals,
+                       const vector<bool> & input_vals) const
+{
+  // variables are in topological order
+  vector<bool> vals(kinds_.size(), false);
+  for (uint32_t v = 1; v < kinds_.size(); ++v) {
+    switch (kinds_[v]) {
+      case INPUT: vals[v] = input_vals.at(idx_[v]); break;
+      case LATCH: vals[v] = latch_vals.at(idx_[v]); break;
+      case AND:
+        vals[v] = lit_value(vals, fanins_[v].first)
+                  && lit_value(vals, fanins_[v].second);
+        break;
+      default: break;
+    }
+  }
+  return vals;
+}
+
+AigLit Aig::make_and(AigLit a, AigLit b)
+{
+  if (a > b) {
+    swap(a, b);
+  }
+  if (a == aig_false || a == negate(b)) {
+    return aig_false;
+  } else if (a == aig_true || a == b) {
+    return b;
+  }
+
+  uint64_t key = (uint64_t(a) << 32) | b;
+  auto it = strash_.find(key);
+  if (it != strash_.end()) {
+    return it->second;
+  }
+  uint32_t v = new_var(AND);
+  fanins_[v] = { a, b };
+  ++num_ands_;
+  AigLit l = make_lit(v, false);
+  strash_[key] = l;
+  return l;
+}
+
+AigLit Aig::make_or(AigLit a, AigLit b)
+{
+  return negate(make_and(negate(a), negate(b)));
+}
+
+AigLit Aig::make_xor(AigLit a, AigLit b)
+{
+  return make_or(make_and(a, negate(b)), make_and(negate(a), b));
+}
+
+AigLit Aig::make_ite(AigLit c, AigLit t, AigLit e)
+{
+  if (t == e) {
+    return t;
+  }
+  return make_or(make_and(c, t), make_and(negate(c), e));
+}
+
+uint32_t Aig::new_var(NodeKind k)
+{
+  uint32_t v = kinds_.size();
+  kinds_.push_back(k);
+  fanins_.push_back({ aig_false, aig_false });
+  idx_.push_back(0);
+  return v;
+}
+
+}  // namespace pono
@@ -0,0 +1,137 @@
+/*********************                                                        */
+/*! \file aig.h
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief And-inverter graph of a sequential circuit.
+**        Literals follow the AIGER convention: variable * 2 + sign, with
+**        variable 0 being the constant false. And gates are structurally
+**        hashed, so building the same gate twice returns the same literal.
+**
+**/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace pono {
+
+typedef uint32_t AigLit;
+
+class Aig
+{
+ public:
+  enum NodeKind : uint8_t
+  {
+    CONST,
+    INPUT,
+    LATCH,
+    AND
+  };
+
+  struct Latch
+  {
+    AigLit lit;
+    AigLit next;
+    AigLit init;  ///< aig_false, aig_true or lit itself if uninitialized
+  };
+
+  static constexpr AigLit aig_false = 0;
+  static constexpr AigLit aig_true = 1;
+
+  static AigLit negate(AigLit l) { return l ^ 1; }
+  static AigLit negate_if(AigLit l, bool c) { return l ^ (c ? 1 : 0); }
+  static uint32_t var(AigLit l) { return l >> 1; }
+  static bool is_negated(AigLit l) { return l & 1; }
+  static AigLit make_lit(uint32_t v, bool neg) { return (v << 1) | neg; }
+
+  Aig();
+
+  AigLit make_input();
+
+  /** Creates an uninitialized latch, its next state is set later */
+  AigLit make_latch();
+
+  void set_next(AigLit latch, AigLit next);
+
+  void set_init(AigLit latch, AigLit init);
+
+  /** @return a literal for a AND b, existing gates are reused and trivial
+   *          gates (constant or repeated inputs) are simplified away
+   */
+  AigLit make_and(AigLit a, AigLit b);
+
+  AigLit make_or(AigLit a, AigLit b);
+  AigLit make_xor(AigLit a, AigLit b);
+  AigLit make_iff(AigLit a, AigLit b) { return negate(make_xor(a, b)); }
+  AigLit make_ite(AigLit c, AigLit t, AigLit e);
+
+  /** Adds a bad state literal (a property is violated when it is true) */
+  void add_bad(AigLit l) { bad_.push_back(l); }
+
+  /** Adds an invariant constraint, which must hold in every state of a
+   *  trace
+   */
+  void add_constraint(AigLit l) { constraints_.push_back(l); }
+
+  size_t num_vars() const { return kinds_.size(); }
+  NodeKind kind(uint32_t v) const { return kinds_[v]; }
+  bool is_and(uint32_t v) const { return kinds_[v] == AND; }
+
+  /** @return the fanins of an and gate */
+  AigLit fanin0(uint32_t v) const { return fanins_[v].first; }
+  AigLit fanin1(uint32_t v) const { return fanins_[v].second; }
+
+  const std::vector<AigLit> & inputs() const { return inputs_; }
+  const std::vector<Latch> & latches() const { return latches_; }
+  const std::vector<AigLit> & bad() const { return bad_; }
+  const std::vector<AigLit> & constraints() const { return constraints_; }
+
+  /** @return the index of a latch in latches(), latch must be a latch */
+  size_t latch_index(AigLit latch) const;
+
+  /** @return the index of an input in inputs(), input must be an input */
+  size_t input_index(AigLit input) const;
+
+  /** Evaluates the graph for one state
+   *  @param latch_vals the values of latches()
+   *  @param input_vals the values of inputs()
+   *  @return the values of all variables
+   */
+  std::vector<bool> eval(const std::vector<bool> & latch_vals,
+                         const std::vector<bool> & input_vals) const;
+
+  /** @return the value of l given the values of all variables */
+  static bool lit_value(const std::vector<bool> & vals, AigLit l)
+  {
+    return vals[var(l)] != is_negated(l);
+  }
+
+  size_t num_ands() const { return num_ands_; }
+
+ protected:
+  uint32_t new_var(NodeKind k);
+
+  std::vector<NodeKind> kinds_;
+  std::vector<std::pair<AigLit, AigLit>> fanins_;
+  std::vector<uint32_t> idx_;  ///< index into inputs_ or latches_, per variable
+
+  std::vector<AigLit> inputs_;
+  std::vector<Latch> latches_;
+  std::vector<AigLit> bad_;
+  std::vector<AigLit> constraints_;
+
+  std::unordered_map<uint64_t, AigLit> strash_;  ///< (fanin0, fanin1) to gate
+  size_t num_ands_;
+};
+
+}  // namespace pono
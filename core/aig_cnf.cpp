@@ -0,0 +1,74 @@
+/*********************                                                        */
+/*! \file aig_cnf.cpp
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Tseitin encoding of and-inverter graphs into a SatSolver.
+**
+**/
+
+#include "core/aig_cnf.h"
+
+using namespace std;
+
+namespace pono {
+
+vector<int> aig_new_copy(const Aig & aig, SatSolver & sat)
+{
+  vector<int> map(aig.num_vars(), 0);
+  map[0] = sat.new_var();
+  sat.add_clause({ -map[0] });
+  return map;
+}
+
+int aig_encode(const Aig & aig, SatSolver & sat, vector<int> & map, AigLit l)
+{
+  if (map.size() < aig.num_vars()) {
+    map.resize(aig.num_vars(), 0);
+  }
+
+  uint32_t v = Aig::var(l);
+  // iterative post-order traversal, the graph can be very deep
+  vector<uint32_t> to_visit({ v });
+  while (!to_visit.empty()) {
+    uint32_t u = to_visit.back();
+    if (map[u]) {
+      to_visit.pop_back();
+      continue;
+    }
+    if (!aig.is_and(u)) {
+      map[u] = sat.new_var();
+      to_visit.pop_back();
+      continue;
+    }
+
+    AigLit f0 = aig.fanin0(u);
+    AigLit f1 = aig.fanin1(u);
+    bool ready = true;
+    for (auto f : { f0, f1 }) {
+      if (!map[Aig::var(f)]) {
+        to_visit.push_back(Aig::var(f));
+        ready = false;
+      }
+    }
+    if (ready) {
+      to_visit.pop_back();
+      int a = Aig::is_negated(f0) ? -map[Aig::var(f0)] : map[Aig::var(f0)];
+      int b = Aig::is_negated(f1) ? -map[Aig::var(f1)] : map[Aig::var(f1)];
+      int x = sat.new_var();
+      sat.add_clause({ -x, a });
+      sat.add_clause({ -x, b });
+      sat.add_clause({ x, -a, -b });
+      map[u] = x;
+    }
+  }
+  return Aig::is_negated(l) ? -map[v] : map[v];
+}
+
+}  // namespace pono
@@ -0,0 +1,41 @@
+/*********************                                                        */
+/*! \file aig_cnf.h
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Tseitin encoding of and-inverter graphs into a SatSolver.
+**
+**/
+
+#pragma once
+
+#include <vector>
+
+#include "core/aig.h"
+#include "smt/sat_solver.h"
+
+namespace pono {
+
+/** @return a map for a new copy of aig in sat, only the constant is mapped
+ */
+std::vector<int> aig_new_copy(const Aig & aig, SatSolver & sat);
+
+/** Encodes the cone of l in one copy of aig
+ *  @param sat the solver to add the gates to
+ *  @param map SAT variables of the graph variables in this copy (0 if not
+ *         encoded yet), inputs and latches that are not mapped get fresh
+ *         variables. It is extended if the graph grew since it was created.
+ *  @return the SAT literal of l
+ */
+int aig_encode(const Aig & aig,
+               SatSolver & sat,
+               std::vector<int> & map,
+               AigLit l);
+
+}  // namespace pono
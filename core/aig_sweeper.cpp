@@ -0,0 +1,530 @@
+/*********************                                                        */
+/*! \file aig_sweeper.cpp
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Reduces and-inverter graphs while preserving the reachability of
+**        their bad states.
+**
+**/
+
+#include "core/aig_sweeper.h"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <map>
+#include <memory>
+
+#include "core/aig_cnf.h"
+
+using namespace std;
+
+namespace pono {
+
+namespace {
+
+uint64_t hash_words(const uint64_t * w, size_t n, bool complement)
+{
+  uint64_t h = 14695981039346656037ULL;
+  for (size_t i = 0; i < n; ++i) {
+    h ^= complement ? ~w[i] : w[i];
+    h *= 1099511628211ULL;
+    h ^= h >> 29;
+  }
+  return h;
+}
+
+}  // namespace
+
+AigSweeper::AigSweeper(const Aig & aig, uint64_t seed)
+    : cur_(aig),
+      gen_(seed),
+      sat_(nullptr),
+      merged_ands_(0),
+      merged_latches_(0)
+{
+  map_.reserve(aig.num_vars());
+  for (uint32_t v = 0; v < aig.num_vars(); ++v) {
+    map_.push_back(Aig::make_lit(v, false));
+  }
+}
+
+void AigSweeper::reduce()
+{
+  rewrite(true);
+  if (merge_latches()) {
+    rewrite(true);
+  }
+  // drop the gates that were merged away
+  rewrite(false);
+}
+
+void AigSweeper::rewrite(bool sweep)
+{
+  copy(vector<AigLit>(cur_.num_vars(), lit_undef), sweep);
+}
+
+size_t AigSweeper::merge_latches()
+{
+  vector<AigLit> subst = latch_correspondence();
+  size_t merged = 0;
+  for (auto l : subst) {
+    merged += (l != lit_undef);
+  }
+  if (merged) {
+    copy(subst, true);
+    merged_latches_ += merged;
+  }
+  return merged;
+}
+
+void AigSweeper::copy(const vector<AigLit> & subst, bool sweep)
+{
+  const Aig & src = cur_;
+  size_t n = src.num_vars();
+
+  // cone of the bad states and constraints
+  vector<bool> mark(n, false);
+  vector<uint32_t> to_visit;
+  auto visit = [&](AigLit l) {
+    uint32_t v = Aig::var(l);
+    if (!mark[v]) {
+      mark[v] = true;
+      to_visit.push_back(v);
+    }
+  };
+  for (auto b : src.bad()) {
+    visit(b);
+  }
+  for (auto c : src.constraints()) {
+    visit(c);
+  }
+  while (!to_visit.empty()) {
+    uint32_t v = to_visit.back();
+    to_visit.pop_back();
+    if (src.is_and(v)) {
+      visit(src.fanin0(v));
+      visit(src.fanin1(v));
+    } else if (src.kind(v) == Aig::LATCH) {
+      if (subst[v] != lit_undef) {
+        visit(subst[v]);
+      } else {
+        visit(src.latches()[src.latch_index(Aig::make_lit(v, false))].next);
+      }
+    }
+  }
+
+  Aig dst;
+  vector<AigLit> m(n, lit_undef);
+  m[0] = Aig::aig_false;
+  auto mlit = [&m](AigLit l) {
+    assert(m[Aig::var(l)] != lit_undef);
+    return Aig::negate_if(m[Aig::var(l)], Aig::is_negated(l));
+  };
+
+  for (auto in : src.inputs()) {
+    if (mark[Aig::var(in)]) {
+      m[Aig::var(in)] = dst.make_input();
+    }
+  }
+  vector<const Aig::Latch *> kept;
+  for (const auto & l : src.latches()) {
+    uint32_t v = Aig::var(l.lit);
+    if (mark[v] && subst[v] == lit_undef) {
+      m[v] = dst.make_latch();
+      kept.push_back(&l);
+    }
+  }
+  for (const auto & l : src.latches()) {
+    uint32_t v = Aig::var(l.lit);
+    if (mark[v] && subst[v] != lit_undef) {
+      m[v] = mlit(subst[v]);
+    }
+  }
+
+  unique_ptr<SatSolver> sat;
+  if (sweep) {
+    sat.reset(new SatSolver());
+    sat_ = sat.get();
+    cnf_ = aig_new_copy(dst, *sat_);
+    sim_.clear();
+    repr_.clear();
+    classes_.clear();
+    simulate_new(dst);
+    // the constant is the first candidate of its class
+    classes_[hash_words(sim_.data(), sim_words_, false)].push_back(
+        Aig::aig_false);
+  }
+
+  for (uint32_t v = 1; v < n; ++v) {
+    if (!mark[v] || !src.is_and(v)) {
+      continue;
+    }
+    AigLit l = rewrite_and(dst, mlit(src.fanin0(v)), mlit(src.fanin1(v)));
+    m[v] = sweep ? this->sweep(dst, l) : l;
+  }
+
+  for (const auto * l : kept) {
+    AigLit dl = m[Aig::var(l->lit)];
+    dst.set_next(dl, mlit(l->next));
+    if (l->init != l->lit) {
+      dst.set_init(dl, l->init);
+    }
+  }
+  for (auto c : src.constraints()) {
+    dst.add_constraint(mlit(c));
+  }
+  for (auto b : src.bad()) {
+    dst.add_bad(mlit(b));
+  }
+
+  for (auto & l : map_) {
+    if (l != lit_undef) {
+      AigLit ml = m[Aig::var(l)];
+      l = (ml == lit_undef) ? lit_undef
+                            : Aig::negate_if(ml, Aig::is_negated(l));
+    }
+  }
+
+  sat_ = nullptr;
+  sim_.clear();
+  repr_.clear();
+  classes_.clear();
+  cur_ = dst;
+}
+
+AigLit AigSweeper::rewrite_and(Aig & dst, AigLit a, AigLit b)
+{
+  auto is_gate = [&dst](AigLit l) { return dst.is_and(Aig::var(l)); };
+  for (int i = 0; i < 2; ++i) {
+    AigLit x = i ? b : a;
+    AigLit y = i ? a : b;
+    if (!is_gate(x)) {
+      continue;
+    }
+    AigLit x0 = dst.fanin0(Aig::var(x));
+    AigLit x1 = dst.fanin1(Aig::var(x));
+    if (!Aig::is_negated(x)) {
+      if (y == Aig::negate(x0) || y == Aig::negate(x1)) {
+        // contradiction
+        return Aig::aig_false;
+      } else if (y == x0 || y == x1) {
+        // idempotence
+        return x;
+      }
+    } else {
+      if (y == Aig::negate(x0) || y == Aig::negate(x1)) {
+        // subsumption
+        return y;
+      } else if (y == x0) {
+        // substitution
+        return rewrite_and(dst, y, Aig::negate(x1));
+      } else if (y == x1) {
+        return rewrite_and(dst, y, Aig::negate(x0));
+      }
+    }
+  }
+
+  if (is_gate(a) && is_gate(b) && !Aig::is_negated(a) && !Aig::is_negated(b))
+  {
+    AigLit a0 = dst.fanin0(Aig::var(a));
+    AigLit a1 = dst.fanin1(Aig::var(a));
+    AigLit b0 = dst.fanin0(Aig::var(b));
+    AigLit b1 = dst.fanin1(Aig::var(b));
+    for (auto x : { a0, a1 }) {
+      if (x == Aig::negate(b0) || x == Aig::negate(b1)) {
+        return Aig::aig_false;
+      }
+    }
+  }
+
+  return dst.make_and(a, b);
+}
+
+AigLit AigSweeper::sweep(Aig & dst, AigLit l)
+{
+  simulate_new(dst);
+  uint32_t v = Aig::var(l);
+  if (!dst.is_and(v)) {
+    return l;
+  } else if (repr_[v] != lit_undef) {
+    // a gate that was already swept, found again by structural hashing
+    return Aig::negate_if(repr_[v], Aig::is_negated(l));
+  }
+
+  const uint64_t * w = &sim_[v * sim_words_];
+  // normalize the phase so that complemented gates share a class
+  bool phase = w[0] & 1;
+  AigLit norm = Aig::make_lit(v, phase);
+  vector<AigLit> & cands = classes_[hash_words(w, sim_words_, phase)];
+  for (auto c : cands) {
+    const uint64_t * cw = &sim_[Aig::var(c) * sim_words_];
+    bool same = true;
+    for (size_t i = 0; i < sim_words_ && same; ++i) {
+      uint64_t cv = Aig::is_negated(c) ? ~cw[i] : cw[i];
+      uint64_t nv = phase ? ~w[i] : w[i];
+      same = (cv == nv);
+    }
+    if (same && equivalent(dst, norm, c)) {
+      ++merged_ands_;
+      repr_[v] = Aig::negate_if(c, phase);
+      return Aig::negate_if(repr_[v], Aig::is_negated(l));
+    }
+  }
+
+  if (cands.size() < max_candidates_) {
+    cands.push_back(norm);
+  }
+  repr_[v] = Aig::make_lit(v, false);
+  return l;
+}
+
+void AigSweeper::simulate_new(const Aig & dst)
+{
+  size_t first = repr_.size();
+  size_t n = dst.num_vars();
+  sim_.resize(n * sim_words_);
+  repr_.resize(n, lit_undef);
+  for (size_t v = first; v < n; ++v) {
+    uint64_t * w = &sim_[v * sim_words_];
+    if (dst.is_and(v)) {
+      AigLit f0 = dst.fanin0(v);
+      AigLit f1 = dst.fanin1(v);
+      const uint64_t * w0 = &sim_[Aig::var(f0) * sim_words_];
+      const uint64_t * w1 = &sim_[Aig::var(f1) * sim_words_];
+      uint64_t m0 = Aig::is_negated(f0) ? ~0ULL : 0;
+      uint64_t m1 = Aig::is_negated(f1) ? ~0ULL : 0;
+      for (size_t i = 0; i < sim_words_; ++i) {
+        w[i] = (w0[i] ^ m0) & (w1[i] ^ m1);
+      }
+    } else {
+      for (size_t i = 0; i < sim_words_; ++i) {
+        w[i] = v ? gen_() : 0;
+      }
+    }
+  }
+}
+
+bool AigSweeper::equivalent(const Aig & dst, AigLit a, AigLit b)
+{
+  int x = aig_encode(dst, *sat_, cnf_, a);
+  int y = aig_encode(dst, *sat_, cnf_, b);
+  set_budget(*sat_, conflict_budget_);
+  if (sat_->solve({ x, -y }) != SatResult::UNSAT) {
+    return false;
+  }
+  set_budget(*sat_, conflict_budget_);
+  return sat_->solve({ -x, y }) == SatResult::UNSAT;
+}
+
+vector<AigLit> AigSweeper::latch_correspondence()
+{
+  const vector<Aig::Latch> & latches = cur_.latches();
+  const vector<AigLit> & inputs = cur_.inputs();
+  size_t n = cur_.num_vars();
+  vector<AigLit> subst(n, lit_undef);
+  if (latches.size() < 1) {
+    return subst;
+  }
+
+  // candidates from simulating random traces from the initial states,
+  // 64 traces per word
+  const size_t W = sim_words_;
+  vector<vector<uint64_t>> sigs(latches.size());
+  vector<uint64_t> lvals(latches.size() * W);
+  for (size_t i = 0; i < latches.size(); ++i) {
+    for (size_t j = 0; j < W; ++j) {
+      const Aig::Latch & l = latches[i];
+      lvals[i * W + j] = (l.init == Aig::aig_false) ? 0
+                         : (l.init == Aig::aig_true) ? ~0ULL
+                                                     : gen_();
+    }
+  }
+  vector<uint64_t> vals(n * W, 0);
+  auto lit_word = [&vals, W](AigLit l, size_t j) {
+    uint64_t w = vals[Aig::var(l) * W + j];
+    return Aig::is_negated(l) ? ~w : w;
+  };
+  for (size_t step = 0; step < sim_steps_; ++step) {
+    for (size_t i = 0; i < latches.size(); ++i) {
+      for (size_t j = 0; j < W; ++j) {
+        vals[Aig::var(latches[i].lit) * W + j] = lvals[i * W + j];
+        sigs[i].push_back(lvals[i * W + j]);
+      }
+    }
+    for (auto in : inputs) {
+      for (size_t j = 0; j < W; ++j) {
+        vals[Aig::var(in) * W + j] = gen_();
+      }
+    }
+    for (uint32_t v = 1; v < n; ++v) {
+      if (cur_.is_and(v)) {
+        for (size_t j = 0; j < W; ++j) {
+          vals[v * W + j] =
+              lit_word(cur_.fanin0(v), j) & lit_word(cur_.fanin1(v), j);
+        }
+      }
+    }
+    for (size_t i = 0; i < latches.size(); ++i) {
+      for (size_t j = 0; j < W; ++j) {
+        lvals[i * W + j] = lit_word(latches[i].next, j);
+      }
+    }
+  }
+
+  // classes of latch literals with equal signatures, the first is the
+  // representative and the constant comes first in its class
+  std::map<vector<uint64_t>, vector<AigLit>> by_sig;
+  by_sig[vector<uint64_t>(sim_steps_ * W, 0)].push_back(Aig::aig_false);
+  for (size_t i = 0; i < latches.size(); ++i) {
+    vector<uint64_t> & s = sigs[i];
+    bool phase = s[0] & 1;
+    if (phase) {
+      for (auto & w : s) {
+        w = ~w;
+      }
+    }
+    by_sig[s].push_back(Aig::negate_if(latches[i].lit, phase));
+  }
+  sigs.clear();
+  vector<vector<AigLit>> classes;
+  for (auto & e : by_sig) {
+    if (e.second.size() > 1) {
+      classes.push_back(move(e.second));
+    }
+  }
+  if (classes.empty()) {
+    return subst;
+  }
+
+  // splits the classes by the values of their literals in a model
+  auto refine = [&classes](const function<bool(AigLit)> & value) {
+    vector<vector<AigLit>> res;
+    for (const auto & cls : classes) {
+      vector<AigLit> same, diff;
+      bool rv = value(cls[0]);
+      for (auto l : cls) {
+        (value(l) == rv ? same : diff).push_back(l);
+      }
+      if (same.size() > 1) {
+        res.push_back(move(same));
+      }
+      if (diff.size() > 1) {
+        res.push_back(move(diff));
+      }
+    }
+    classes = move(res);
+  };
+
+  // adds a clause, activated by act, that some pair of a class differs
+  // in the literals given by lit
+  auto add_differ = [&classes](SatSolver & sat,
+                               int act,
+                               const function<int(AigLit)> & lit) {
+    vector<int> clause({ -act });
+    for (const auto & cls : classes) {
+      int x = lit(cls[0]);
+      for (size_t i = 1; i < cls.size(); ++i) {
+        int y = lit(cls[i]);
+        int d = sat.new_var();
+        sat.add_clause({ -d, x, y });
+        sat.add_clause({ -d, -x, -y });
+        clause.push_back(d);
+      }
+    }
+    sat.add_clause(clause);
+  };
+
+  // base case: the classes hold in all initial states
+  {
+    SatSolver sat;
+    vector<int> cnf = aig_new_copy(cur_, sat);
+    for (const auto & l : latches) {
+      int x = aig_encode(cur_, sat, cnf, l.lit);
+      if (l.init != l.lit) {
+        sat.add_clause({ (l.init == Aig::aig_true) ? x : -x });
+      }
+    }
+    for (auto c : cur_.constraints()) {
+      sat.add_clause({ aig_encode(cur_, sat, cnf, c) });
+    }
+    auto cur_lit = [&](AigLit l) { return aig_encode(cur_, sat, cnf, l); };
+    while (!classes.empty()) {
+      int act = sat.new_var();
+      add_differ(sat, act, cur_lit);
+      set_budget(sat, conflict_budget_ * 10);
+      SatResult r = sat.solve({ act });
+      if (r == SatResult::UNSAT) {
+        break;
+      } else if (r == SatResult::UNKNOWN) {
+        return subst;
+      }
+      refine([&](AigLit l) { return sat.value(cur_lit(l)); });
+      sat.add_clause({ -act });
+    }
+  }
+
+  // inductive step: if the classes hold in a state that satisfies the
+  // constraints, they hold in the next state
+  {
+    SatSolver sat;
+    vector<int> cnf = aig_new_copy(cur_, sat);
+    for (auto c : cur_.constraints()) {
+      sat.add_clause({ aig_encode(cur_, sat, cnf, c) });
+    }
+    auto cur_lit = [&](AigLit l) { return aig_encode(cur_, sat, cnf, l); };
+    auto next_lit = [&](AigLit l) {
+      if (l == Aig::aig_false) {
+        return cur_lit(l);
+      }
+      const Aig::Latch & latch = latches[cur_.latch_index(
+          Aig::make_lit(Aig::var(l), false))];
+      return aig_encode(
+          cur_, sat, cnf, Aig::negate_if(latch.next, Aig::is_negated(l)));
+    };
+    while (!classes.empty()) {
+      int act = sat.new_var();
+      for (const auto & cls : classes) {
+        int x = cur_lit(cls[0]);
+        for (size_t i = 1; i < cls.size(); ++i) {
+          int y = cur_lit(cls[i]);
+          sat.add_clause({ -act, -x, y });
+          sat.add_clause({ -act, x, -y });
+        }
+      }
+      add_differ(sat, act, next_lit);
+      set_budget(sat, conflict_budget_ * 10);
+      SatResult r = sat.solve({ act });
+      if (r == SatResult::UNSAT) {
+        break;
+      } else if (r == SatResult::UNKNOWN) {
+        return subst;
+      }
+      refine([&](AigLit l) { return sat.value(next_lit(l)); });
+      sat.add_clause({ -act });
+    }
+  }
+
+  for (const auto & cls : classes) {
+    for (size_t i = 1; i < cls.size(); ++i) {
+      // the latch of cls[i] is cls[0], complemented if cls[i] is
+      subst[Aig::var(cls[i])] = Aig::negate_if(cls[0], Aig::is_negated(cls[i]));
+    }
+  }
+  return subst;
+}
+
+void AigSweeper::set_budget(SatSolver & sat, uint64_t conflicts)
+{
+  uint64_t limit = sat.num_conflicts() + conflicts;
+  sat.set_terminate([&sat, limit]() { return sat.num_conflicts() > limit; });
+}
+
+}  // namespace pono
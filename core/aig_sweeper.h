@@ -0,0 +1,119 @@
+/*********************                                                        */
+/*! \file aig_sweeper.h
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Reduces and-inverter graphs while preserving the reachability of
+**        their bad states.
+**        The graph is copied with structural hashing and local two-level
+**        rewriting, keeping only the cones of the bad states and
+**        constraints. SAT sweeping merges and gates that are equivalent
+**        for all values of the inputs and latches (candidates come from
+**        random simulation), and latch correspondence merges latches that
+**        are equivalent (or opposite, or constant) in all reachable
+**        states, proven by induction.
+**
+**/
+
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "core/aig.h"
+#include "smt/sat_solver.h"
+
+namespace pono {
+
+class AigSweeper
+{
+ public:
+  /** @param aig the graph to reduce */
+  AigSweeper(const Aig & aig, uint64_t seed = 0);
+
+  /** Runs all the passes, the result replaces the current graph */
+  void reduce();
+
+  /** Copies the graph with rewriting, and with SAT sweeping if sweep is set
+   */
+  void rewrite(bool sweep);
+
+  /** Finds and merges equivalent latches
+   *  @return the number of merged latches
+   */
+  size_t merge_latches();
+
+  /** @return the current graph, its inputs and latches are in the same order
+   *          as in the original graph
+   */
+  const Aig & result() const { return cur_; }
+
+  /** @return the literal of the current graph for a variable of the original
+   *          graph, or lit_undef if it was removed. Merged latches map to
+   *          the latch or constant they are equivalent to.
+   */
+  AigLit map(uint32_t v) const { return map_.at(v); }
+
+  static constexpr AigLit lit_undef = UINT32_MAX;
+
+  size_t num_merged_ands() const { return merged_ands_; }
+  size_t num_merged_latches() const { return merged_latches_; }
+
+ protected:
+  /** Copies the cones of the bad states and constraints into a new graph
+   *  @param subst a literal of the current graph that replaces each
+   *         latch variable, or lit_undef to keep the latch
+   */
+  void copy(const std::vector<AigLit> & subst, bool sweep);
+
+  /** @return a AND b in dst, after two-level rewriting */
+  AigLit rewrite_and(Aig & dst, AigLit a, AigLit b);
+
+  /** @return a literal equivalent to l in dst, merging the gate of l with
+   *          an equivalent gate that was created before
+   */
+  AigLit sweep(Aig & dst, AigLit l);
+
+  /** Computes the simulation words of the new variables of dst */
+  void simulate_new(const Aig & dst);
+
+  /** @return true if a and b are proven equivalent in dst */
+  bool equivalent(const Aig & dst, AigLit a, AigLit b);
+
+  /** @return a substitution for the latches of the current graph that are
+   *          equivalent to another latch or to a constant
+   */
+  std::vector<AigLit> latch_correspondence();
+
+  /** Limits the conflicts of the next solve call on sat */
+  void set_budget(SatSolver & sat, uint64_t conflicts);
+
+  Aig cur_;
+  std::vector<AigLit> map_;  ///< original variables to literals of cur_
+  std::mt19937_64 gen_;
+
+  // SAT sweeping state, valid during a copy
+  std::vector<uint64_t> sim_;  ///< sim_words_ words per variable
+  std::vector<AigLit> repr_;  ///< per variable of the copy, after sweeping
+  std::unordered_map<uint64_t, std::vector<AigLit>> classes_;
+  SatSolver * sat_;
+  std::vector<int> cnf_;
+
+  size_t merged_ands_;
+  size_t merged_latches_;
+
+  static constexpr size_t sim_words_ = 4;
+  static constexpr size_t sim_steps_ = 16;
+  static constexpr size_t max_candidates_ = 4;
+  static constexpr uint64_t conflict_budget_ = 1000;
+};
+
+}  // namespace pono
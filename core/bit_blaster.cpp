@@ -0,0 +1,555 @@
+/*********************                                                        */
+/*! \file bit_blaster.cpp
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Bit-blasts a functional transition system into an and-inverter
+**        graph.
+**
+**/
+
+#include "core/bit_blaster.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "core/witness_trace.h"
+#include "utils/exceptions.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+namespace {
+
+size_t sort_width(const Sort & sort)
+{
+  SortKind sk = sort->get_sort_kind();
+  if (sk == BOOL) {
+    return 1;
+  } else if (sk == BV) {
+    return sort->get_width();
+  }
+  throw PonoException("BitBlaster does not support sort " + sort->to_string());
+}
+
+bool name_less(const Term & t1, const Term & t2)
+{
+  return t1->to_string() < t2->to_string();
+}
+
+}  // namespace
+
+BitBlaster::BitBlaster(const TransitionSystem & ts, Aig & aig)
+    : ts_(ts), aig_(aig), init_flag_(Aig::aig_false)
+{
+  if (!ts_.is_functional()) {
+    throw PonoException("BitBlaster requires a functional transition system");
+  }
+
+  // sorted by name so that the graph is reproducible
+  inputs_.assign(ts_.inputvars().begin(), ts_.inputvars().end());
+  sort(inputs_.begin(), inputs_.end(), name_less);
+  states_.assign(ts_.statevars().begin(), ts_.statevars().end());
+  sort(states_.begin(), states_.end(), name_less);
+
+  for (const auto & iv : inputs_) {
+    vector<AigLit> & bits = cache_[iv];
+    for (size_t i = 0; i < sort_width(iv->get_sort()); ++i) {
+      bits.push_back(aig_.make_input());
+    }
+  }
+  for (const auto & sv : states_) {
+    vector<AigLit> & bits = cache_[sv];
+    for (size_t i = 0; i < sort_width(sv->get_sort()); ++i) {
+      bits.push_back(aig_.make_latch());
+    }
+  }
+
+  // constraints that are also init conjuncts are blasted once, below
+  UnorderedTermSet constraints;
+  for (const auto & e : ts_.constraints()) {
+    constraints.insert(e.first);
+  }
+
+  // constant initial values become latch initial values,
+  // the other initial state constraints only hold in the first state
+  AigLit other_init = Aig::aig_true;
+  UnorderedTermSet initialized;
+  for (const auto & c : ts_.init_conjuncts()) {
+    if (constraints.find(c) != constraints.end()) {
+      continue;
+    }
+
+    Term st;
+    Term val;
+    if (ts_.is_curr_var(c)) {
+      st = c;
+      val = ts_.solver()->make_term(true);
+    } else if (c->get_op().prim_op == Not && ts_.is_curr_var(*(c->begin()))) {
+      st = *(c->begin());
+      val = ts_.solver()->make_term(false);
+    } else if (c->get_op().prim_op == Equal) {
+      TermVec children;
+      for (const auto & cc : c) {
+        children.push_back(cc);
+      }
+      if (children.size() == 2 && children[1]->is_value()
+          && ts_.is_curr_var(children[0])) {
+        st = children[0];
+        val = children[1];
+      } else if (children.size() == 2 && children[0]->is_value()
+                 && ts_.is_curr_var(children[1])) {
+        st = children[1];
+        val = children[0];
+      }
+    }
+
+    if (st && initialized.find(st) == initialized.end()) {
+      initialized.insert(st);
+      const vector<AigLit> & latches = cache_.at(st);
+      const vector<AigLit> & vals = blast(val);
+      for (size_t i = 0; i < latches.size(); ++i) {
+        aig_.set_init(latches[i], vals[i]);
+      }
+    } else {
+      other_init = aig_.make_and(other_init, blast(c)[0]);
+    }
+  }
+
+  if (other_init != Aig::aig_true) {
+    init_flag_ = aig_.make_latch();
+    aig_.set_init(init_flag_, Aig::aig_true);
+    aig_.set_next(init_flag_, Aig::aig_false);
+    aig_.add_constraint(aig_.make_or(Aig::negate(init_flag_), other_init));
+  }
+
+  const UnorderedTermMap & updates = ts_.state_updates();
+  for (const auto & sv : states_) {
+    const vector<AigLit> & latches = cache_.at(sv);
+    auto it = updates.find(sv);
+    if (it != updates.end()) {
+      vector<AigLit> next = blast(it->second);
+      for (size_t i = 0; i < latches.size(); ++i) {
+        aig_.set_next(latches[i], next[i]);
+      }
+    } else {
+      // no update, the next state is arbitrary
+      for (size_t i = 0; i < latches.size(); ++i) {
+        aig_.set_next(latches[i], aig_.make_input());
+      }
+    }
+  }
+
+  for (const auto & e : ts_.constraints()) {
+    aig_.add_constraint(blast(e.first)[0]);
+  }
+}
+
+const vector<AigLit> & BitBlaster::blast(const Term & term)
+{
+  // iterative post-order traversal, terms can be very deep
+  TermVec to_visit({ term });
+  Term t;
+  while (!to_visit.empty()) {
+    t = to_visit.back();
+    if (cache_.find(t) != cache_.end()) {
+      to_visit.pop_back();
+      continue;
+    }
+
+    if (t->is_symbol()) {
+      throw PonoException("BitBlaster cannot blast symbol " + t->to_string());
+    } else if (t->is_value()) {
+      to_visit.pop_back();
+      vector<AigLit> & bits = cache_[t];
+      if (t->get_sort()->get_sort_kind() == BOOL) {
+        bool val = t == ts_.solver()->make_term(true);
+        bits.push_back(val ? Aig::aig_true : Aig::aig_false);
+      } else {
+        string val = WitnessTrace::value_bits(t);
+        for (auto it = val.rbegin(); it != val.rend(); ++it) {
+          bits.push_back(*it == '1' ? Aig::aig_true : Aig::aig_false);
+        }
+      }
+      continue;
+    }
+
+    bool children_done = true;
+    for (const auto & c : t) {
+      if (cache_.find(c) == cache_.end()) {
+        to_visit.push_back(c);
+        children_done = false;
+      }
+    }
+
+    if (children_done) {
+      to_visit.pop_back();
+      vector<vector<AigLit>> args;
+      for (const auto & c : t) {
+        args.push_back(cache_.at(c));
+      }
+      cache_[t] = blast_op(t, args);
+    }
+  }
+  return cache_.at(term);
+}
+
+const vector<AigLit> & BitBlaster::var_bits(const Term & v) const
+{
+  if (!ts_.is_curr_var(v) && ts_.inputvars().find(v) == ts_.inputvars().end())
+  {
+    throw PonoException("BitBlaster: not a state or input " + v->to_string());
+  }
+  return cache_.at(v);
+}
+
+Term BitBlaster::value(const Term & v, const vector<bool> & bits) const
+{
+  Sort sort = v->get_sort();
+  if (sort->get_sort_kind() == BOOL) {
+    return ts_.solver()->make_term(bool(bits.at(0)));
+  }
+  string val(bits.size(), '0');
+  for (size_t i = 0; i < bits.size(); ++i) {
+    if (bits[i]) {
+      val[bits.size() - 1 - i] = '1';
+    }
+  }
+  return ts_.solver()->make_term(val, sort, 2);
+}
+
+Term BitBlaster::eval(const Term & t, const vector<bool> & vals) const
+{
+  auto it = cache_.find(t);
+  if (it == cache_.end()) {
+    throw PonoException("BitBlaster: term was not blasted " + t->to_string());
+  }
+  vector<bool> bits;
+  bits.reserve(it->second.size());
+  for (auto l : it->second) {
+    bits.push_back(Aig::lit_value(vals, l));
+  }
+  return value(t, bits);
+}
+
+vector<AigLit> BitBlaster::blast_op(const Term & t,
+                                    const vector<vector<AigLit>> & args)
+{
+  Op op = t->get_op();
+  size_t width = sort_width(t->get_sort());
+
+  auto bitwise = [&](AigLit (Aig::*f)(AigLit, AigLit), bool negate) {
+    vector<AigLit> res = args.at(0);
+    for (size_t i = 1; i < args.size(); ++i) {
+      for (size_t j = 0; j < width; ++j) {
+        res[j] = (aig_.*f)(res[j], args[i][j]);
+      }
+    }
+    if (negate) {
+      for (auto & r : res) {
+        r = Aig::negate(r);
+      }
+    }
+    return res;
+  };
+
+  auto binary = [&]() {
+    if (args.size() != 2) {
+      throw PonoException("BitBlaster expected two arguments in "
+                          + t->to_string());
+    }
+  };
+
+  vector<AigLit> res;
+  switch (op.prim_op) {
+    case And:
+    case BVAnd: return bitwise(&Aig::make_and, false);
+    case Or:
+    case BVOr: return bitwise(&Aig::make_or, false);
+    case Xor:
+    case BVXor: return bitwise(&Aig::make_xor, false);
+    case BVNand: binary(); return bitwise(&Aig::make_and, true);
+    case BVNor: binary(); return bitwise(&Aig::make_or, true);
+    case BVXnor: binary(); return bitwise(&Aig::make_xor, true);
+    case Not:
+    case BVNot:
+      for (auto a : args.at(0)) {
+        res.push_back(Aig::negate(a));
+      }
+      return res;
+    case Implies:
+      binary();
+      return { aig_.make_or(Aig::negate(args[0][0]), args[1][0]) };
+    case Equal: {
+      AigLit eq = Aig::aig_true;
+      for (size_t i = 1; i < args.size(); ++i) {
+        eq = aig_.make_and(eq, equal(args[i - 1], args[i]));
+      }
+      return { eq };
+    }
+    case Distinct: binary(); return { Aig::negate(equal(args[0], args[1])) };
+    case BVComp: binary(); return { equal(args[0], args[1]) };
+    case Ite: return ite(args.at(0).at(0), args.at(1), args.at(2));
+    case BVNeg: return neg(args.at(0));
+    case BVAdd:
+      res = args.at(0);
+      for (size_t i = 1; i < args.size(); ++i) {
+        res = add(res, args[i], Aig::aig_false);
+      }
+      return res;
+    case BVSub: {
+      binary();
+      vector<AigLit> nb;
+      for (auto b : args[1]) {
+        nb.push_back(Aig::negate(b));
+      }
+      return add(args[0], nb, Aig::aig_true);
+    }
+    case BVMul:
+      res = args.at(0);
+      for (size_t i = 1; i < args.size(); ++i) {
+        res = mul(res, args[i]);
+      }
+      return res;
+    case BVUdiv:
+    case BVUrem: {
+      binary();
+      vector<AigLit> quot, rem;
+      udivrem(args[0], args[1], quot, rem);
+      return (op.prim_op == BVUdiv) ? quot : rem;
+    }
+    case BVSdiv:
+    case BVSrem:
+    case BVSmod: {
+      binary();
+      AigLit sa = args[0].back();
+      AigLit sb = args[1].back();
+      vector<AigLit> abs_a = ite(sa, neg(args[0]), args[0]);
+      vector<AigLit> abs_b = ite(sb, neg(args[1]), args[1]);
+      vector<AigLit> quot, rem;
+      udivrem(abs_a, abs_b, quot, rem);
+      if (op.prim_op == BVSdiv) {
+        return ite(aig_.make_xor(sa, sb), neg(quot), quot);
+      }
+      // the remainder has the sign of the dividend
+      vector<AigLit> srem = ite(sa, neg(rem), rem);
+      if (op.prim_op == BVSrem) {
+        return srem;
+      }
+      // the modulus has the sign of the divisor
+      AigLit rem_zero = equal(rem, vector<AigLit>(width, Aig::aig_false));
+      AigLit same_sign = Aig::negate(aig_.make_xor(sa, sb));
+      return ite(aig_.make_or(rem_zero, same_sign),
+                 srem,
+                 add(srem, args[1], Aig::aig_false));
+    }
+    case BVShl: binary(); return shift(args[0], args[1], true, Aig::aig_false);
+    case BVLshr:
+      binary();
+      return shift(args[0], args[1], false, Aig::aig_false);
+    case BVAshr:
+      binary();
+      return shift(args[0], args[1], false, args[0].back());
+    case BVUlt: binary(); return { ult(args[0], args[1]) };
+    case BVUle: binary(); return { Aig::negate(ult(args[1], args[0])) };
+    case BVUgt: binary(); return { ult(args[1], args[0]) };
+    case BVUge: binary(); return { Aig::negate(ult(args[0], args[1])) };
+    case BVSlt: binary(); return { slt(args[0], args[1]) };
+    case BVSle: binary(); return { Aig::negate(slt(args[1], args[0])) };
+    case BVSgt: binary(); return { slt(args[1], args[0]) };
+    case BVSge: binary(); return { Aig::negate(slt(args[0], args[1])) };
+    case Concat:
+      // the first argument is the most significant
+      for (auto it = args.rbegin(); it != args.rend(); ++it) {
+        res.insert(res.end(), it->begin(), it->end());
+      }
+      return res;
+    case Extract:
+      return vector<AigLit>(args.at(0).begin() + op.idx1,
+                            args.at(0).begin() + op.idx0 + 1);
+    case Zero_Extend:
+      res = args.at(0);
+      res.resize(width, Aig::aig_false);
+      return res;
+    case Sign_Extend:
+      res = args.at(0);
+      res.resize(width, args[0].back());
+      return res;
+    case Repeat:
+      for (size_t i = 0; i < op.idx0; ++i) {
+        res.insert(res.end(), args.at(0).begin(), args.at(0).end());
+      }
+      return res;
+    case Rotate_Left:
+    case Rotate_Right: {
+      const vector<AigLit> & a = args.at(0);
+      size_t n = op.idx0 % width;
+      if (op.prim_op == Rotate_Right) {
+        n = (width - n) % width;
+      }
+      // bit i of the result is bit i - n of a
+      for (size_t i = 0; i < width; ++i) {
+        res.push_back(a[(i + width - n) % width]);
+      }
+      return res;
+    }
+    default:
+      throw PonoException("BitBlaster does not support operator "
+                          + op.to_string());
+  }
+}
+
+vector<AigLit> BitBlaster::add(const vector<AigLit> & a,
+                               const vector<AigLit> & b,
+                               AigLit carry)
+{
+  assert(a.size() == b.size());
+  vector<AigLit> res;
+  for (size_t i = 0; i < a.size(); ++i) {
+    AigLit x = aig_.make_xor(a[i], b[i]);
+    res.push_back(aig_.make_xor(x, carry));
+    carry =
+        aig_.make_or(aig_.make_and(a[i], b[i]), aig_.make_and(x, carry));
+  }
+  return res;
+}
+
+vector<AigLit> BitBlaster::neg(const vector<AigLit> & a)
+{
+  vector<AigLit> na;
+  for (auto l : a) {
+    na.push_back(Aig::negate(l));
+  }
+  return add(na, vector<AigLit>(a.size(), Aig::aig_false), Aig::aig_true);
+}
+
+vector<AigLit> BitBlaster::mul(const vector<AigLit> & a,
+                               const vector<AigLit> & b)
+{
+  assert(a.size() == b.size());
+  size_t width = a.size();
+  vector<AigLit> res(width, Aig::aig_false);
+  for (size_t i = 0; i < width; ++i) {
+    // add a << i if bit i of b is set
+    vector<AigLit> partial(width, Aig::aig_false);
+    for (size_t j = i; j < width; ++j) {
+      partial[j] = aig_.make_and(a[j - i], b[i]);
+    }
+    res = add(res, partial, Aig::aig_false);
+  }
+  return res;
+}
+
+void BitBlaster::udivrem(const vector<AigLit> & a,
+                         const vector<AigLit> & b,
+                         vector<AigLit> & quot,
+                         vector<AigLit> & rem)
+{
+  assert(a.size() == b.size());
+  size_t width = a.size();
+  quot.assign(width, Aig::aig_false);
+  rem.assign(width, Aig::aig_false);
+
+  // one extra bit so that the shifted remainder does not overflow
+  vector<AigLit> nb;
+  for (auto l : b) {
+    nb.push_back(Aig::negate(l));
+  }
+  nb.push_back(Aig::aig_true);
+
+  for (size_t i = width; i-- > 0;) {
+    // rem = (rem << 1) | a[i]
+    vector<AigLit> r;
+    r.push_back(a[i]);
+    r.insert(r.end(), rem.begin(), rem.end());
+    // r >= b iff r - b does not borrow
+    vector<AigLit> diff = add(r, nb, Aig::aig_true);
+    AigLit ge = Aig::negate(diff.back());
+    quot[i] = ge;
+    for (size_t j = 0; j < width; ++j) {
+      rem[j] = aig_.make_ite(ge, diff[j], r[j]);
+    }
+  }
+  // a / 0 is all ones and a % 0 is a, which restoring division produces
+}
+
+vector<AigLit> BitBlaster::shift(const vector<AigLit> & a,
+                                 const vector<AigLit> & b,
+                                 bool left,
+                                 AigLit fill)
+{
+  size_t width = a.size();
+  vector<AigLit> res = a;
+  AigLit overflow = Aig::aig_false;
+  for (size_t s = 0; s < b.size(); ++s) {
+    if (s >= 64 || (uint64_t(1) << s) >= width) {
+      overflow = aig_.make_or(overflow, b[s]);
+      continue;
+    }
+    size_t amount = size_t(1) << s;
+    vector<AigLit> shifted(width, fill);
+    for (size_t i = 0; i < width; ++i) {
+      if (left && i >= amount) {
+        shifted[i] = res[i - amount];
+      } else if (!left && i + amount < width) {
+        shifted[i] = res[i + amount];
+      }
+    }
+    res = ite(b[s], shifted, res);
+  }
+  return ite(overflow, vector<AigLit>(width, fill), res);
+}
+
+vector<AigLit> BitBlaster::ite(AigLit c,
+                               const vector<AigLit> & t,
+                               const vector<AigLit> & e)
+{
+  assert(t.size() == e.size());
+  vector<AigLit> res;
+  for (size_t i = 0; i < t.size(); ++i) {
+    res.push_back(aig_.make_ite(c, t[i], e[i]));
+  }
+  return res;
+}
+
+AigLit BitBlaster::equal(const vector<AigLit> & a, const vector<AigLit> & b)
+{
+  assert(a.size() == b.size());
+  AigLit res = Aig::aig_true;
+  for (size_t i = 0; i < a.size(); ++i) {
+    res = aig_.make_and(res, aig_.make_iff(a[i], b[i]));
+  }
+  return res;
+}
+
+AigLit BitBlaster::ult(const vector<AigLit> & a, const vector<AigLit> & b)
+{
+  assert(a.size() == b.size());
+  // from the least significant bit, a more significant difference decides
+  AigLit lt = Aig::aig_false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    AigLit bit_lt = aig_.make_and(Aig::negate(a[i]), b[i]);
+    lt = aig_.make_or(bit_lt, aig_.make_and(aig_.make_iff(a[i], b[i]), lt));
+  }
+  return lt;
+}
+
+AigLit BitBlaster::slt(const vector<AigLit> & a, const vector<AigLit> & b)
+{
+  // flipping the sign bits maps signed order to unsigned order
+  vector<AigLit> fa = a;
+  vector<AigLit> fb = b;
+  fa.back() = Aig::negate(fa.back());
+  fb.back() = Aig::negate(fb.back());
+  return ult(fa, fb);
+}
+
+}  // namespace pono
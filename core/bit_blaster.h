@@ -0,0 +1,109 @@
+/*********************                                                        */
+/*! \file bit_blaster.h
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Bit-blasts a functional transition system into an and-inverter
+**        graph.
+**        Every bit of a state becomes a latch and every bit of an input
+**        an AIG input. Initial values that are constants become latch
+**        initial values, other initial state constraints are only
+**        enforced in the first state with a latch that is true only
+**        initially.
+**
+**/
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "core/aig.h"
+#include "core/ts.h"
+#include "smt-switch/smt.h"
+
+namespace pono {
+
+class BitBlaster
+{
+ public:
+  /** Blasts the initial states, state updates and constraints of ts
+   *  @param ts a functional transition system over booleans and
+   *         bit-vectors
+   *  @param aig the graph to build into
+   *  throws a PonoException if ts is not functional or uses an
+   *  unsupported sort or operator
+   */
+  BitBlaster(const TransitionSystem & ts, Aig & aig);
+
+  /** Blasts an (untimed) term over states and inputs
+   *  @return the literals of its bits, least significant first
+   *          (a single literal for booleans)
+   */
+  const std::vector<AigLit> & blast(const smt::Term & t);
+
+  /** State and input variables of ts, sorted by name */
+  const smt::TermVec & states() const { return states_; }
+  const smt::TermVec & inputs() const { return inputs_; }
+
+  /** @return the latches or inputs of a state or input variable */
+  const std::vector<AigLit> & var_bits(const smt::Term & v) const;
+
+  /** @return the latch that is only true in the initial state, or
+   *          aig_false if all initial states are latch initial values
+   */
+  AigLit init_flag() const { return init_flag_; }
+
+  /** @return a value of the sort of v from the values of its bits,
+   *          least significant first
+   */
+  smt::Term value(const smt::Term & v, const std::vector<bool> & bits) const;
+
+  /** @return the value of a term that was blasted, given the values of all
+   *          variables of the graph (see Aig::eval)
+   */
+  smt::Term eval(const smt::Term & t, const std::vector<bool> & vals) const;
+
+ protected:
+  std::vector<AigLit> blast_op(const smt::Term & t,
+                               const std::vector<std::vector<AigLit>> & args);
+
+  std::vector<AigLit> add(const std::vector<AigLit> & a,
+                          const std::vector<AigLit> & b,
+                          AigLit carry);
+  std::vector<AigLit> neg(const std::vector<AigLit> & a);
+  std::vector<AigLit> mul(const std::vector<AigLit> & a,
+                          const std::vector<AigLit> & b);
+  /** Restoring division with the SMT-LIB results for division by zero */
+  void udivrem(const std::vector<AigLit> & a,
+               const std::vector<AigLit> & b,
+               std::vector<AigLit> & quot,
+               std::vector<AigLit> & rem);
+  std::vector<AigLit> shift(const std::vector<AigLit> & a,
+                            const std::vector<AigLit> & b,
+                            bool left,
+                            AigLit fill);
+  std::vector<AigLit> ite(AigLit c,
+                          const std::vector<AigLit> & t,
+                          const std::vector<AigLit> & e);
+  AigLit equal(const std::vector<AigLit> & a, const std::vector<AigLit> & b);
+  AigLit ult(const std::vector<AigLit> & a, const std::vector<AigLit> & b);
+  AigLit slt(const std::vector<AigLit> & a, const std::vector<AigLit> & b);
+
+  const TransitionSystem & ts_;
+  Aig & aig_;
+
+  smt::TermVec states_;
+  smt::TermVec inputs_;
+  AigLit init_flag_;
+
+  std::unordered_map<smt::Term, std::vector<AigLit>> cache_;
+};
+
+}  // namespace pono
@@ -45,6 +45,14 @@ Term FunctionalUnroller::at_time(const Term & t, unsigned int k)
   return super::at_time(t, k);
 }
 
+Term FunctionalUnroller::time_shift(const Term & timed_t,
+                                   unsigned int j,
+                                   unsigned int k)
+{
+  throw PonoException(
+      "Functional unroller does not support shifting terms in time");
+}
+
 UnorderedTermMap & FunctionalUnroller::var_cache_at_time(unsigned int k)
 {
   const UnorderedTermMap & state_updates = ts_.state_updates();
@@ -78,8 +86,8 @@ UnorderedTermMap & FunctionalUnroller::var_cache_at_time(unsigned int k)
       }
 
       assert(!no_update);
-      Term fun_subst =
-          solver_->substitute(state_updates.at(v), time_cache_.at(t - 1));
+      // shares the memoized unrolled subterms of the previous step
+      Term fun_subst = super::at_time(state_updates.at(v), t - 1);
 
       if (create_new) {
         // add equality to extra constraints
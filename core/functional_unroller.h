@@ -61,6 +61,13 @@ class FunctionalUnroller : public Unroller
    */
   smt::Term at_time(const smt::Term & t, unsigned int k) override;
 
+  /** Not supported, state variables are not unrolled at every time step
+   *  throws a PonoException
+   */
+  smt::Term time_shift(const smt::Term & timed_t,
+                       unsigned int j,
+                       unsigned int k) override;
+
   /** Provides extra constraints for a functional unrolling
    *  with intermittent fresh symbols
    *  this is an attempt to deal with ITE explosion in deeply
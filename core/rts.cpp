@@ -28,8 +28,8 @@ void RelationalTransitionSystem::set_behavior(const Term & init,
   if (!known_symbols(init) || !known_symbols(trans)) {
     throw PonoException("Unknown symbols");
   }
-  init_ = init;
-  trans_ = trans;
+  reset_init(init);
+  reset_trans(trans);
 }
 
 void RelationalTransitionSystem::set_trans(const Term & trans)
@@ -38,7 +38,7 @@ void RelationalTransitionSystem::set_trans(const Term & trans)
   if (!known_symbols(trans)) {
     throw PonoException("Unknown symbols");
   }
-  trans_ = trans;
+  reset_trans(trans);
 }
 
 void RelationalTransitionSystem::constrain_trans(const Term & constraint)
@@ -47,7 +47,7 @@ void RelationalTransitionSystem::constrain_trans(const Term & constraint)
   if (!known_symbols(constraint)) {
     throw PonoException("Unknown symbols");
   }
-  trans_ = solver_->make_term(And, trans_, constraint);
+  add_trans_conjunct(constraint);
 }
 
 }  // namespace pono
@@ -0,0 +1,1002 @@
+/*********************                                                        */
+/*! \file simulator.cpp
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Concrete simulator for functional transition systems.
+**
+**/
+
+#include "core/simulator.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "core/witness_trace.h"
+#include "gmpxx.h"
+#include "smt-switch/utils.h"
+#include "utils/exceptions.h"
+#include "utils/logger.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+namespace {
+
+size_t num_words(uint32_t width) { return (width + 63) / 64; }
+
+uint64_t width_mask(uint32_t width)
+{
+  return (width >= 64) ? ~uint64_t(0) : ((uint64_t(1) << width) - 1);
+}
+
+/** Sign-extends a value of the given width to 64 bits */
+int64_t sext64(uint64_t v, uint32_t width)
+{
+  return static_cast<int64_t>(v << (64 - width)) >> (64 - width);
+}
+
+uint32_t sort_width(const Sort & s)
+{
+  SortKind sk = s->get_sort_kind();
+  if (sk == BOOL) {
+    return 1;
+  } else if (sk == BV) {
+    return s->get_width();
+  }
+  throw PonoException("Simulator does not support sort " + s->to_string());
+}
+
+mpz_class load_mpz(const uint64_t * r, uint32_t off, uint32_t width)
+{
+  mpz_class z;
+  mpz_import(
+      z.get_mpz_t(), num_words(width), -1, sizeof(uint64_t), 0, 0, r + off);
+  return z;
+}
+
+/** Stores z modulo 2^width */
+void store_mpz(uint64_t * r, uint32_t off, uint32_t width, mpz_class z)
+{
+  mpz_fdiv_r_2exp(z.get_mpz_t(), z.get_mpz_t(), width);
+  memset(r + off, 0, num_words(width) * sizeof(uint64_t));
+  size_t count = 0;
+  mpz_export(r + off, &count, -1, sizeof(uint64_t), 0, 0, z.get_mpz_t());
+}
+
+mpz_class to_signed(mpz_class z, uint32_t width)
+{
+  if (mpz_tstbit(z.get_mpz_t(), width - 1)) {
+    z -= mpz_class(1) << width;
+  }
+  return z;
+}
+
+bool name_less(const Term & t1, const Term & t2)
+{
+  return t1->to_string() < t2->to_string();
+}
+
+}  // namespace
+
+Simulator::Simulator(const TransitionSystem & ts) : ts_(ts)
+{
+  if (!ts_.is_functional()) {
+    throw PonoException("Simulator requires a functional transition system");
+  }
+
+  // fixed order, so that seeded runs are reproducible
+  states_.assign(ts_.statevars().begin(), ts_.statevars().end());
+  inputs_.assign(ts_.inputvars().begin(), ts_.inputvars().end());
+  sort(states_.begin(), states_.end(), name_less);
+  sort(inputs_.begin(), inputs_.end(), name_less);
+
+  for (const auto & v : states_) {
+    var_slots_[v] = new_slot(v->get_sort());
+  }
+  for (const auto & v : inputs_) {
+    var_slots_[v] = new_slot(v->get_sort());
+    input_slots_.push_back(var_slots_.at(v));
+  }
+
+  compile_init();
+
+  const UnorderedTermMap & state_updates = ts_.state_updates();
+  size_t num_next_words = 0;
+  size_t num_next_arrays = 0;
+  for (const auto & sv : states_) {
+    const Slot & st = var_slots_.at(sv);
+    auto it = state_updates.find(sv);
+    if (it == state_updates.end()) {
+      nondet_states_.push_back(st);
+      continue;
+    }
+    Slot up = compile(it->second, step_tape_, step_slots_);
+    // signals and constraints can read next states
+    step_slots_[ts_.next(sv)] = up;
+    if (up.off == st.off && up.is_array == st.is_array) {
+      // the state keeps its value
+      continue;
+    }
+    updates_.push_back({ st, up });
+    if (st.is_array) {
+      num_next_arrays++;
+    } else {
+      num_next_words += num_words(st.width);
+    }
+  }
+  next_words_.resize(num_next_words);
+  next_arrays_.resize(num_next_arrays);
+
+  for (const auto & c : ts_.constraints()) {
+    constraint_checks_.push_back(compile(c.first, step_tape_, step_slots_));
+  }
+
+  logger.log(1,
+             "Simulator compiled {} init and {} step instructions over {} "
+             "words and {} arrays",
+             init_tape_.size(),
+             step_tape_.size(),
+             regs_.size(),
+             arrays_.size());
+}
+
+void Simulator::add_signal(const Term & t)
+{
+  compile(t, step_tape_, step_slots_);
+}
+
+bool Simulator::reset(bool random)
+{
+  for (const auto & s : free_states_) {
+    if (random) {
+      randomize(s);
+    } else if (s.is_array) {
+      arrays_[s.off] = ArrayValue{ 0, {} };
+    } else {
+      memset(&regs_[s.off], 0, num_words(s.width) * sizeof(uint64_t));
+    }
+  }
+
+  run(init_tape_);
+
+  for (const auto & s : init_checks_) {
+    if (!regs_[s.off]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Simulator::eval() { run(step_tape_); }
+
+bool Simulator::constraints_hold() const
+{
+  for (const auto & s : constraint_checks_) {
+    if (!regs_[s.off]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Simulator::advance()
+{
+  // two phases, updates can read other states
+  size_t w = 0;
+  size_t k = 0;
+  for (const auto & u : updates_) {
+    const Slot & up = u.second;
+    if (up.is_array) {
+      next_arrays_[k++] = arrays_[up.off];
+    } else {
+      size_t n = num_words(up.width);
+      memcpy(&next_words_[w], &regs_[up.off], n * sizeof(uint64_t));
+      w += n;
+    }
+  }
+
+  w = 0;
+  k = 0;
+  for (const auto & u : updates_) {
+    const Slot & st = u.first;
+    if (st.is_array) {
+      swap(arrays_[st.off], next_arrays_[k++]);
+    } else {
+      size_t n = num_words(st.width);
+      memcpy(&regs_[st.off], &next_words_[w], n * sizeof(uint64_t));
+      w += n;
+    }
+  }
+
+  for (const auto & s : nondet_states_) {
+    randomize(s);
+  }
+}
+
+bool Simulator::step()
+{
+  eval();
+  bool res = constraints_hold();
+  advance();
+  return res;
+}
+
+void Simulator::randomize_inputs()
+{
+  for (const auto & s : input_slots_) {
+    randomize(s);
+  }
+}
+
+void Simulator::set(const Term & var, uint64_t val)
+{
+  auto it = var_slots_.find(var);
+  if (it == var_slots_.end() || it->second.is_array) {
+    throw PonoException("Simulator can only set bit-vector variables, got "
+                        + var->to_string());
+  }
+  vector<uint64_t> w(num_words(it->second.width), 0);
+  w[0] = val;
+  write_words(it->second, w.data());
+}
+
+void Simulator::set_bits(const Term & var, const string & bits)
+{
+  auto it = var_slots_.find(var);
+  if (it == var_slots_.end() || it->second.is_array) {
+    throw PonoException("Simulator can only set bit-vector variables, got "
+                        + var->to_string());
+  }
+  const Slot & s = it->second;
+  if (bits.size() != s.width) {
+    throw PonoException("Expected " + std::to_string(s.width)
+                        + " bits for " + var->to_string());
+  }
+  vector<uint64_t> w(num_words(s.width), 0);
+  for (size_t i = 0; i < s.width; ++i) {
+    if (bits[s.width - 1 - i] == '1') {
+      w[i / 64] |= uint64_t(1) << (i % 64);
+    }
+  }
+  write_words(s, w.data());
+}
+
+void Simulator::set_value(const Term & var, const Term & val)
+{
+  auto it = var_slots_.find(var);
+  if (it == var_slots_.end()) {
+    throw PonoException("Simulator can only set variables, got "
+                        + var->to_string());
+  }
+  const Slot & s = it->second;
+  if (s.is_array) {
+    load_array(val, arrays_[s.off]);
+    return;
+  }
+  vector<uint64_t> w(num_words(s.width), 0);
+  WitnessTrace::pack(val, s.width, w.data());
+  write_words(s, w.data());
+}
+
+void Simulator::set_frame(const UnorderedTermMap & m)
+{
+  for (const auto & elem : m) {
+    if (var_slots_.find(elem.first) != var_slots_.end()) {
+      set_value(elem.first, elem.second);
+    }
+  }
+}
+
+uint64_t Simulator::get(const Term & t) const
+{
+  const Slot & s = lookup(t);
+  if (s.is_array || s.width > 64) {
+    throw PonoException("Simulator::get expects at most 64 bits, got "
+                        + t->to_string());
+  }
+  return regs_[s.off];
+}
+
+string Simulator::get_bits(const Term & t) const
+{
+  const Slot & s = lookup(t);
+  if (s.is_array) {
+    throw PonoException("Simulator::get_bits expects a bit-vector, got "
+                        + t->to_string());
+  }
+  return WitnessTrace::words_to_bits(&regs_[s.off], s.width);
+}
+
+Term Simulator::get_value(const Term & t) const
+{
+  const Slot & s = lookup(t);
+  Sort sort = t->get_sort();
+  const SmtSolver & solver = ts_.solver();
+  if (!s.is_array) {
+    if (sort->get_sort_kind() == BOOL) {
+      return solver->make_term(regs_[s.off] != 0);
+    }
+    return solver->make_term(
+        WitnessTrace::words_to_bits(&regs_[s.off], s.width), sort, 2);
+  }
+
+  const ArrayValue & av = arrays_[s.off];
+  Sort idxsort = sort->get_indexsort();
+  Sort elemsort = sort->get_elemsort();
+  Term res = solver->make_term(value_term(av.dflt, elemsort), sort);
+  vector<pair<uint64_t, uint64_t>> vals(av.vals.begin(), av.vals.end());
+  std::sort(vals.begin(), vals.end());
+  for (const auto & elem : vals) {
+    res = solver->make_term(Store,
+                            res,
+                            value_term(elem.first, idxsort),
+                            value_term(elem.second, elemsort));
+  }
+  return res;
+}
+
+void Simulator::get_frame(UnorderedTermMap & m) const
+{
+  for (const auto & v : states_) {
+    m[v] = get_value(v);
+  }
+  for (const auto & v : inputs_) {
+    m[v] = get_value(v);
+  }
+}
+
+Simulator::Slot Simulator::new_slot(const Sort & s)
+{
+  if (s->get_sort_kind() != ARRAY) {
+    return word_slot(sort_width(s));
+  }
+
+  uint32_t idx_width = sort_width(s->get_indexsort());
+  uint32_t elem_width = sort_width(s->get_elemsort());
+  if (idx_width > 64 || elem_width > 64) {
+    throw PonoException(
+        "Simulator only supports array indices and elements of at most 64 "
+        "bits, got "
+        + s->to_string());
+  }
+  Slot res{ true, static_cast<uint32_t>(arrays_.size()), elem_width };
+  arrays_.push_back(ArrayValue{ 0, {} });
+  return res;
+}
+
+Simulator::Slot Simulator::word_slot(uint32_t width)
+{
+  Slot res{ false, static_cast<uint32_t>(regs_.size()), width };
+  regs_.resize(regs_.size() + num_words(width), 0);
+  return res;
+}
+
+Simulator::Slot Simulator::compile(const Term & term,
+                                   Tape & tape,
+                                   SlotMap & slots)
+{
+  auto find_slot = [&](const Term & t) -> const Slot * {
+    auto it = var_slots_.find(t);
+    if (it != var_slots_.end()) {
+      return &it->second;
+    }
+    it = slots.find(t);
+    return (it == slots.end()) ? nullptr : &it->second;
+  };
+
+  // iterative post-order traversal, terms can be very deep
+  TermVec to_visit({ term });
+  Term t;
+  while (!to_visit.empty()) {
+    t = to_visit.back();
+    if (find_slot(t)) {
+      to_visit.pop_back();
+      continue;
+    }
+
+    if (t->is_symbol()) {
+      throw PonoException("Simulator cannot evaluate symbol " + t->to_string());
+    } else if (t->get_op().is_null()) {
+      to_visit.pop_back();
+      slots[t] = constant(t);
+      continue;
+    }
+
+    bool children_done = true;
+    for (const auto & c : t) {
+      if (!find_slot(c)) {
+        to_visit.push_back(c);
+        children_done = false;
+      }
+    }
+
+    if (children_done) {
+      to_visit.pop_back();
+      vector<Slot> args;
+      for (const auto & c : t) {
+        args.push_back(*find_slot(c));
+      }
+      slots[t] = compile_op(t, args, tape);
+    }
+  }
+  return *find_slot(term);
+}
+
+Simulator::Slot Simulator::compile_op(const Term & t,
+                                      const vector<Slot> & args,
+                                      Tape & tape)
+{
+  Op op = t->get_op();
+  Sort sort = t->get_sort();
+
+  auto binary = [&](Code code) {
+    if (args.size() != 2) {
+      throw PonoException("Simulator expected two arguments in "
+                          + t->to_string());
+    }
+    return emit(tape, code, new_slot(sort), args);
+  };
+
+  // left-associative fold of n-ary operators
+  auto fold = [&](Code code) {
+    Slot res = args.at(0);
+    for (size_t i = 1; i < args.size(); ++i) {
+      uint32_t width =
+          (code == CONCAT) ? res.width + args[i].width : sort_width(sort);
+      res = emit(tape, code, word_slot(width), { res, args[i] });
+    }
+    return res;
+  };
+
+  auto equal = [&](const Slot & a, const Slot & b) {
+    return emit(tape, a.is_array ? ARRAY_EQ : EQ, word_slot(1), { a, b });
+  };
+
+  switch (op.prim_op) {
+    case And:
+    case BVAnd: return fold(AND);
+    case Or:
+    case BVOr: return fold(OR);
+    case Xor:
+    case BVXor: return fold(XOR);
+    case BVAdd: return fold(ADD);
+    case BVMul: return fold(MUL);
+    case Concat: return fold(CONCAT);
+    case Not:
+    case BVNot: return emit(tape, NOT, new_slot(sort), args);
+    case BVNeg: return emit(tape, NEG, new_slot(sort), args);
+    case Implies: return binary(IMPLIES);
+    case BVNand: return binary(NAND);
+    case BVNor: return binary(NOR);
+    case BVXnor: return binary(XNOR);
+    case BVSub: return binary(SUB);
+    case BVUdiv: return binary(UDIV);
+    case BVUrem: return binary(UREM);
+    case BVSdiv: return binary(SDIV);
+    case BVSrem: return binary(SREM);
+    case BVSmod: return binary(SMOD);
+    case BVShl: return binary(SHL);
+    case BVLshr: return binary(LSHR);
+    case BVAshr: return binary(ASHR);
+    case BVUlt: return binary(ULT);
+    case BVUle: return binary(ULE);
+    case BVSlt: return binary(SLT);
+    case BVSle: return binary(SLE);
+    case BVUgt: return emit(tape, ULT, new_slot(sort), { args[1], args[0] });
+    case BVUge: return emit(tape, ULE, new_slot(sort), { args[1], args[0] });
+    case BVSgt: return emit(tape, SLT, new_slot(sort), { args[1], args[0] });
+    case BVSge: return emit(tape, SLE, new_slot(sort), { args[1], args[0] });
+    case BVComp: return equal(args.at(0), args.at(1));
+    case Equal: {
+      Slot res = equal(args.at(0), args.at(1));
+      for (size_t i = 2; i < args.size(); ++i) {
+        res = emit(tape, AND, word_slot(1), { res, equal(args[i - 1], args[i]) });
+      }
+      return res;
+    }
+    case Distinct: {
+      if (args.size() != 2) {
+        throw PonoException("Simulator only supports binary distinct, got "
+                            + t->to_string());
+      }
+      return emit(tape, NOT, word_slot(1), { equal(args[0], args[1]) });
+    }
+    case Ite:
+      return emit(tape,
+                  args.at(1).is_array ? ARRAY_ITE : ITE,
+                  new_slot(sort),
+                  args);
+    case Extract:
+      return emit(tape, EXTRACT, new_slot(sort), args, op.idx0, op.idx1);
+    case Zero_Extend: return emit(tape, ZEXT, new_slot(sort), args);
+    case Sign_Extend: return emit(tape, SEXT, new_slot(sort), args);
+    case Repeat: return emit(tape, REPEAT, new_slot(sort), args, op.idx0);
+    case Rotate_Left: return emit(tape, ROTL, new_slot(sort), args, op.idx0);
+    case Rotate_Right: return emit(tape, ROTR, new_slot(sort), args, op.idx0);
+    case Select: return emit(tape, SELECT, new_slot(sort), args);
+    case Store: return emit(tape, STORE, new_slot(sort), args);
+    default:
+      throw PonoException("Simulator does not support operator "
+                          + op.to_string());
+  }
+}
+
+Simulator::Slot Simulator::emit(Tape & tape,
+                                Code code,
+                                const Slot & dst,
+                                const vector<Slot> & args,
+                                uint64_t idx0,
+                                uint64_t idx1)
+{
+  Instr in;
+  in.code = code;
+  in.wide_op = code;
+  in.dst = dst.off;
+  in.a = (args.size() > 0) ? args[0].off : 0;
+  in.b = (args.size() > 1) ? args[1].off : 0;
+  in.c = (args.size() > 2) ? args[2].off : 0;
+  in.width = dst.width;
+  in.aw = (args.size() > 0) ? args[0].width : 0;
+  in.bw = (args.size() > 1) ? args[1].width : 0;
+  in.mask = width_mask(dst.width);
+  in.idx0 = idx0;
+  in.idx1 = idx1;
+
+  if (code < WIDE && !dst.is_array) {
+    bool wide = dst.width > 64;
+    for (const auto & a : args) {
+      wide |= (!a.is_array && a.width > 64);
+    }
+    if (wide) {
+      in.code = WIDE;
+    }
+  }
+
+  tape.push_back(in);
+  return dst;
+}
+
+Simulator::Slot Simulator::constant(const Term & val)
+{
+  Sort sort = val->get_sort();
+  Slot res = new_slot(sort);
+  if (res.is_array) {
+    // constant array
+    Term elem = *(val->begin());
+    if (!elem->is_value()) {
+      throw PonoException("Simulator cannot evaluate " + val->to_string());
+    }
+    WitnessTrace::pack(elem, res.width, &arrays_[res.off].dflt);
+  } else if (val->is_value()) {
+    WitnessTrace::pack(val, res.width, &regs_[res.off]);
+  } else {
+    throw PonoException("Simulator cannot evaluate " + val->to_string());
+  }
+  return res;
+}
+
+void Simulator::run(const Tape & tape)
+{
+  uint64_t * r = regs_.data();
+  for (const Instr & in : tape) {
+    const uint64_t m = in.mask;
+    switch (in.code) {
+      case COPY: r[in.dst] = r[in.a]; break;
+      case NOT: r[in.dst] = ~r[in.a] & m; break;
+      case AND: r[in.dst] = r[in.a] & r[in.b]; break;
+      case OR: r[in.dst] = r[in.a] | r[in.b]; break;
+      case XOR: r[in.dst] = r[in.a] ^ r[in.b]; break;
+      case NAND: r[in.dst] = ~(r[in.a] & r[in.b]) & m; break;
+      case NOR: r[in.dst] = ~(r[in.a] | r[in.b]) & m; break;
+      case XNOR: r[in.dst] = ~(r[in.a] ^ r[in.b]) & m; break;
+      case IMPLIES: r[in.dst] = (~r[in.a] | r[in.b]) & 1; break;
+      case NEG: r[in.dst] = (0 - r[in.a]) & m; break;
+      case ADD: r[in.dst] = (r[in.a] + r[in.b]) & m; break;
+      case SUB: r[in.dst] = (r[in.a] - r[in.b]) & m; break;
+      case MUL: r[in.dst] = (r[in.a] * r[in.b]) & m; break;
+      case UDIV: {
+        uint64_t b = r[in.b];
+        r[in.dst] = b ? r[in.a] / b : m;
+        break;
+      }
+      case UREM: {
+        uint64_t b = r[in.b];
+        r[in.dst] = b ? r[in.a] % b : r[in.a];
+        break;
+      }
+      case SDIV:
+      case SREM:
+      case SMOD: {
+        // SMT-LIB definitions in terms of the absolute values
+        uint64_t a = r[in.a];
+        uint64_t b = r[in.b];
+        bool neg_a = (a >> (in.aw - 1)) & 1;
+        bool neg_b = (b >> (in.aw - 1)) & 1;
+        uint64_t abs_a = neg_a ? (0 - a) & m : a;
+        uint64_t abs_b = neg_b ? (0 - b) & m : b;
+        if (in.code == SDIV) {
+          uint64_t q = abs_b ? abs_a / abs_b : m;
+          r[in.dst] = (neg_a != neg_b) ? (0 - q) & m : q;
+        } else {
+          uint64_t u = abs_b ? abs_a % abs_b : abs_a;
+          if (in.code == SREM) {
+            r[in.dst] = neg_a ? (0 - u) & m : u;
+          } else if (u == 0 || (!neg_a && !neg_b)) {
+            r[in.dst] = u;
+          } else if (neg_a && !neg_b) {
+            r[in.dst] = (b - u) & m;
+          } else if (!neg_a && neg_b) {
+            r[in.dst] = (u + b) & m;
+          } else {
+            r[in.dst] = (0 - u) & m;
+          }
+        }
+        break;
+      }
+      case SHL: {
+        uint64_t b = r[in.b];
+        r[in.dst] = (b >= in.aw) ? 0 : (r[in.a] << b) & m;
+        break;
+      }
+      case LSHR: {
+        uint64_t b = r[in.b];
+        r[in.dst] = (b >= in.aw) ? 0 : r[in.a] >> b;
+        break;
+      }
+      case ASHR: {
+        uint64_t b = r[in.b];
+        int64_t a = sext64(r[in.a], in.aw);
+        r[in.dst] = static_cast<uint64_t>(a >> min<uint64_t>(b, 63)) & m;
+        break;
+      }
+      case EQ: r[in.dst] = r[in.a] == r[in.b]; break;
+      case NE: r[in.dst] = r[in.a] != r[in.b]; break;
+      case ULT: r[in.dst] = r[in.a] < r[in.b]; break;
+      case ULE: r[in.dst] = r[in.a] <= r[in.b]; break;
+      case SLT:
+        r[in.dst] = sext64(r[in.a], in.aw) < sext64(r[in.b], in.aw);
+        break;
+      case SLE:
+        r[in.dst] = sext64(r[in.a], in.aw) <= sext64(r[in.b], in.aw);
+        break;
+      case ITE: r[in.dst] = r[in.a] ? r[in.b] : r[in.c]; break;
+      case CONCAT: r[in.dst] = (r[in.a] << in.bw) | r[in.b]; break;
+      case EXTRACT: r[in.dst] = (r[in.a] >> in.idx1) & m; break;
+      case ZEXT: r[in.dst] = r[in.a]; break;
+      case SEXT:
+        r[in.dst] = static_cast<uint64_t>(sext64(r[in.a], in.aw)) & m;
+        break;
+      case REPEAT: {
+        uint64_t res = 0;
+        for (uint64_t i = 0; i < in.idx0; ++i) {
+          res = (in.aw == 64) ? r[in.a] : (res << in.aw) | r[in.a];
+        }
+        r[in.dst] = res;
+        break;
+      }
+      case ROTL:
+      case ROTR: {
+        uint64_t a = r[in.a];
+        uint64_t k = in.idx0 % in.aw;
+        if (k && in.code == ROTR) {
+          k = in.aw - k;
+        }
+        r[in.dst] = k ? ((a << k) | (a >> (in.aw - k))) & m : a;
+        break;
+      }
+      case WIDE: run_wide(in); break;
+      case SELECT: r[in.dst] = arrays_[in.a].read(r[in.b]); break;
+      case STORE: {
+        ArrayValue & dst = arrays_[in.dst];
+        dst = arrays_[in.a];
+        dst.vals[r[in.b]] = r[in.c];
+        break;
+      }
+      case ARRAY_ITE:
+        arrays_[in.dst] = r[in.a] ? arrays_[in.b] : arrays_[in.c];
+        break;
+      case ARRAY_EQ: {
+        const ArrayValue & a = arrays_[in.a];
+        const ArrayValue & b = arrays_[in.b];
+        bool eq = a.dflt == b.dflt;
+        for (auto it = a.vals.begin(); eq && it != a.vals.end(); ++it) {
+          eq = b.read(it->first) == it->second;
+        }
+        for (auto it = b.vals.begin(); eq && it != b.vals.end(); ++it) {
+          eq = a.read(it->first) == it->second;
+        }
+        r[in.dst] = eq;
+        break;
+      }
+      case ARRAY_COPY: arrays_[in.dst] = arrays_[in.a]; break;
+      default: assert(false);
+    }
+  }
+}
+
+void Simulator::run_wide(const Instr & in)
+{
+  uint64_t * r = regs_.data();
+  mpz_class a = load_mpz(r, in.a, in.aw);
+  mpz_class b;
+  if (in.bw) {
+    b = load_mpz(r, in.b, in.bw);
+  }
+  mpz_class res;
+
+  switch (in.wide_op) {
+    case COPY:
+    case ZEXT: res = a; break;
+    case NOT: res = ~a; break;
+    case AND: res = a & b; break;
+    case OR: res = a | b; break;
+    case XOR: res = a ^ b; break;
+    case NAND: res = ~(a & b); break;
+    case NOR: res = ~(a | b); break;
+    case XNOR: res = ~(a ^ b); break;
+    case NEG: res = -a; break;
+    case ADD: res = a + b; break;
+    case SUB: res = a - b; break;
+    case MUL: res = a * b; break;
+    case UDIV: res = (b == 0) ? mpz_class(-1) : mpz_class(a / b); break;
+    case UREM: res = (b == 0) ? a : mpz_class(a % b); break;
+    case SDIV:
+    case SREM:
+    case SMOD: {
+      mpz_class sa = to_signed(a, in.aw);
+      mpz_class sb = to_signed(b, in.aw);
+      if (sb == 0) {
+        res = (in.wide_op != SDIV) ? sa : mpz_class((sa < 0) ? 1 : -1);
+      } else if (in.wide_op == SDIV) {
+        // truncating division, as in SMT-LIB
+        res = sa / sb;
+      } else if (in.wide_op == SREM) {
+        res = sa % sb;
+      } else {
+        // the sign follows the divisor
+        mpz_fdiv_r(res.get_mpz_t(), sa.get_mpz_t(), sb.get_mpz_t());
+      }
+      break;
+    }
+    case SHL:
+      res = (b >= in.aw) ? mpz_class(0) : mpz_class(a << b.get_ui());
+      break;
+    case LSHR:
+      res = (b >= in.aw) ? mpz_class(0) : mpz_class(a >> b.get_ui());
+      break;
+    case ASHR: {
+      mpz_class sa = to_signed(a, in.aw);
+      res = sa >> ((b >= in.aw) ? in.aw : b.get_ui());
+      break;
+    }
+    case EQ: res = (a == b) ? 1 : 0; break;
+    case NE: res = (a != b) ? 1 : 0; break;
+    case ULT: res = (a < b) ? 1 : 0; break;
+    case ULE: res = (a <= b) ? 1 : 0; break;
+    case SLT: res = (to_signed(a, in.aw) < to_signed(b, in.bw)) ? 1 : 0; break;
+    case SLE: res = (to_signed(a, in.aw) <= to_signed(b, in.bw)) ? 1 : 0; break;
+    case ITE:
+      res = (a != 0) ? b : load_mpz(r, in.c, in.width);
+      break;
+    case CONCAT: res = (a << in.bw) | b; break;
+    case EXTRACT: res = a >> in.idx1; break;
+    case SEXT: res = to_signed(a, in.aw); break;
+    case REPEAT:
+      res = 0;
+      for (uint64_t i = 0; i < in.idx0; ++i) {
+        res = (res << in.aw) | a;
+      }
+      break;
+    case ROTL:
+    case ROTR: {
+      uint64_t k = in.idx0 % in.aw;
+      if (k && in.wide_op == ROTR) {
+        k = in.aw - k;
+      }
+      res = k ? mpz_class((a << k) | (a >> (in.aw - k))) : a;
+      break;
+    }
+    default:
+      throw PonoException("Simulator: unexpected wide instruction");
+  }
+
+  store_mpz(r, in.dst, in.width, res);
+}
+
+void Simulator::compile_init()
+{
+  const SmtSolver & solver = ts_.solver();
+
+  // initial values are equalities with a state on one side
+  // and a term that does not read the state on the other side
+  TermVec assigned_states;
+  TermVec values;
+  TermVec conjuncts;
+  TermVec checks;
+  UnorderedTermSet targets;
+  for (const auto & c : ts_.init_conjuncts()) {
+    Term st;
+    Term val;
+    Op op = c->get_op();
+    if (ts_.is_curr_var(c)) {
+      st = c;
+      val = solver->make_term(true);
+    } else if (op.prim_op == Not && ts_.is_curr_var(*(c->begin()))) {
+      st = *(c->begin());
+      val = solver->make_term(false);
+    } else if (op.prim_op == Equal) {
+      TermVec children;
+      for (const auto & cc : c) {
+        children.push_back(cc);
+      }
+      if (children.size() == 2) {
+        if (ts_.is_curr_var(children[0])
+            && targets.find(children[0]) == targets.end()) {
+          st = children[0];
+          val = children[1];
+        } else if (ts_.is_curr_var(children[1])) {
+          st = children[1];
+          val = children[0];
+        }
+      }
+    }
+
+    if (st && targets.find(st) == targets.end()) {
+      UnorderedTermSet free_vars;
+      get_free_symbolic_consts(val, free_vars);
+      if (free_vars.find(st) == free_vars.end()) {
+        targets.insert(st);
+        assigned_states.push_back(st);
+        values.push_back(val);
+        conjuncts.push_back(c);
+        continue;
+      }
+    }
+    checks.push_back(c);
+  }
+
+  // compute every initial value after the initial values it reads
+  UnorderedTermSet assigned;
+  vector<bool> done(values.size(), false);
+  bool progress = true;
+  while (progress) {
+    progress = false;
+    for (size_t i = 0; i < values.size(); ++i) {
+      if (done[i]) {
+        continue;
+      }
+      UnorderedTermSet free_vars;
+      get_free_symbolic_consts(values[i], free_vars);
+      bool ready = true;
+      for (const auto & v : free_vars) {
+        if (targets.find(v) != targets.end()
+            && assigned.find(v) == assigned.end()) {
+          ready = false;
+          break;
+        }
+      }
+      if (!ready) {
+        continue;
+      }
+
+      const Slot & st = var_slots_.at(assigned_states[i]);
+      Slot val = compile(values[i], init_tape_, init_slots_);
+      emit(init_tape_, st.is_array ? ARRAY_COPY : COPY, st, { val });
+      assigned.insert(assigned_states[i]);
+      done[i] = true;
+      progress = true;
+    }
+  }
+
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (!done[i]) {
+      // cyclic initial values
+      checks.push_back(conjuncts[i]);
+    }
+  }
+
+  for (const auto & c : checks) {
+    init_checks_.push_back(compile(c, init_tape_, init_slots_));
+  }
+
+  for (const auto & sv : states_) {
+    if (assigned.find(sv) == assigned.end()) {
+      free_states_.push_back(var_slots_.at(sv));
+    }
+  }
+}
+
+const Simulator::Slot & Simulator::lookup(const Term & t) const
+{
+  auto it = var_slots_.find(t);
+  if (it != var_slots_.end()) {
+    return it->second;
+  }
+  it = step_slots_.find(t);
+  if (it != step_slots_.end()) {
+    return it->second;
+  }
+  throw PonoException("Simulator has no value for " + t->to_string()
+                      + ", add it with add_signal");
+}
+
+void Simulator::write_words(const Slot & s, const uint64_t * w)
+{
+  size_t n = num_words(s.width);
+  memcpy(&regs_[s.off], w, n * sizeof(uint64_t));
+  regs_[s.off + n - 1] &= width_mask(s.width - 64 * (n - 1));
+}
+
+void Simulator::randomize(const Slot & s)
+{
+  if (s.is_array) {
+    // random contents are not needed to find bugs in most designs
+    // and would make every step as expensive as the array is large
+    arrays_[s.off] = ArrayValue{ gen_() & width_mask(s.width), {} };
+    return;
+  }
+  size_t n = num_words(s.width);
+  for (size_t i = 0; i < n; ++i) {
+    regs_[s.off + i] = gen_();
+  }
+  regs_[s.off + n - 1] &= width_mask(s.width - 64 * (n - 1));
+}
+
+Term Simulator::value_term(uint64_t v, const Sort & sort) const
+{
+  if (sort->get_sort_kind() == BOOL) {
+    return ts_.solver()->make_term(v != 0);
+  }
+  return ts_.solver()->make_term(
+      WitnessTrace::words_to_bits(&v, sort->get_width()), sort, 2);
+}
+
+void Simulator::load_array(const Term & val, ArrayValue & av) const
+{
+  Sort sort = val->get_sort();
+  uint32_t idx_width = sort_width(sort->get_indexsort());
+  uint32_t elem_width = sort_width(sort->get_elemsort());
+
+  vector<pair<uint64_t, uint64_t>> writes;
+  Term t = val;
+  while (true) {
+    Op op = t->get_op();
+    if (op.prim_op == Store) {
+      TermVec children;
+      for (const auto & c : t) {
+        children.push_back(c);
+      }
+      uint64_t idx = 0;
+      uint64_t elem = 0;
+      WitnessTrace::pack(children[1], idx_width, &idx);
+      WitnessTrace::pack(children[2], elem_width, &elem);
+      writes.push_back({ idx, elem });
+      t = children[0];
+    } else if (op.is_null() && !t->is_symbol()) {
+      // constant array
+      WitnessTrace::pack(*(t->begin()), elem_width, &av.dflt);
+      break;
+    } else {
+      throw PonoException("Simulator cannot interpret array value "
+                          + val->to_string());
+    }
+  }
+
+  av.vals.clear();
+  // outer stores overwrite inner ones
+  for (auto it = writes.rbegin(); it != writes.rend(); ++it) {
+    av.vals[it->first] = it->second;
+  }
+}
+
+}  // namespace pono
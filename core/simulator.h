@@ -0,0 +1,283 @@
+/*********************                                                        */
+/*! \file simulator.h
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Concrete simulator for functional transition systems.
+**        The state updates, initial state and constraints are lowered
+**        once to a flat instruction tape over packed 64-bit words,
+**        so stepping the system never touches a solver.
+**
+**/
+
+#pragma once
+
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/ts.h"
+#include "smt-switch/smt.h"
+
+namespace pono {
+
+class Simulator
+{
+ public:
+  /** Compiles the system for simulation
+   *  @param ts a functional transition system over bit-vectors, booleans and
+   *         arrays of bit-vectors (array indices and elements are limited
+   *         to 64 bits)
+   *  throws a PonoException if ts is not functional or uses an
+   *  unsupported operator or sort
+   */
+  Simulator(const TransitionSystem & ts);
+
+  const TransitionSystem & ts() const { return ts_; }
+
+  /** Compiles an (untimed) term over states and inputs so that its value
+   *  can be read with get after each call to eval
+   *  Terms that were already compiled are not recompiled.
+   */
+  void add_signal(const smt::Term & t);
+
+  /** Puts the system in an initial state
+   *  States assigned by an equality in init() get their initial value,
+   *  the other states are set to zero or, if random is set, random values.
+   *  Inputs are not changed, they are read by initial values that use them.
+   *  @return true iff the remaining initial state constraints hold
+   */
+  bool reset(bool random = false);
+
+  /** Evaluates all compiled terms for the current states and inputs */
+  void eval();
+
+  /** @return true iff all constraints hold, valid after eval */
+  bool constraints_hold() const;
+
+  /** Moves to the next state computed by the last call to eval
+   *  States without an update get random values.
+   */
+  void advance();
+
+  /** Evaluates the current state and moves to the next one
+   *  @return true iff the constraints held in the state that was left
+   */
+  bool step();
+
+  /** Seeds the generator used by randomize_inputs and reset */
+  void seed(uint64_t s) { gen_.seed(s); }
+
+  /** Gives all inputs random values */
+  void randomize_inputs();
+
+  /** Sets a state or input variable
+   *  @param var the variable (bit-vector or boolean, up to 64 bits)
+   *  @param val the new value, truncated to the width of var
+   */
+  void set(const smt::Term & var, uint64_t val);
+
+  /** Sets a state or input variable from binary digits, most significant
+   *  first
+   */
+  void set_bits(const smt::Term & var, const std::string & bits);
+
+  /** Sets a state or input variable from a solver value, e.g. from a witness
+   *  (arrays can be given as stores over a constant array)
+   */
+  void set_value(const smt::Term & var, const smt::Term & val);
+
+  /** Sets all variables that have a value in m (other keys are ignored) */
+  void set_frame(const smt::UnorderedTermMap & m);
+
+  /** @return the value of a variable or compiled term of at most 64 bits */
+  uint64_t get(const smt::Term & t) const;
+
+  /** @return the binary digits of a bit-vector or boolean variable or
+   *          compiled term, most significant first
+   */
+  std::string get_bits(const smt::Term & t) const;
+
+  /** @return the value of a variable or compiled term as a solver value */
+  smt::Term get_value(const smt::Term & t) const;
+
+  /** Adds the values of all states and inputs to m, e.g. to build a witness
+   */
+  void get_frame(smt::UnorderedTermMap & m) const;
+
+ protected:
+  enum Code : uint8_t
+  {
+    COPY,
+    NOT,
+    AND,
+    OR,
+    XOR,
+    NAND,
+    NOR,
+    XNOR,
+    IMPLIES,
+    NEG,
+    ADD,
+    SUB,
+    MUL,
+    UDIV,
+    UREM,
+    SDIV,
+    SREM,
+    SMOD,
+    SHL,
+    LSHR,
+    ASHR,
+    EQ,
+    NE,
+    ULT,
+    ULE,
+    SLT,
+    SLE,
+    ITE,
+    CONCAT,
+    EXTRACT,
+    ZEXT,
+    SEXT,
+    REPEAT,
+    ROTL,
+    ROTR,
+    // operands are wider than 64 bits, the operator is in wide_op
+    WIDE,
+    // array operators, array operands are indices into arrays_
+    SELECT,
+    STORE,
+    ARRAY_ITE,
+    ARRAY_EQ,
+    ARRAY_COPY
+  };
+
+  /** One instruction of a tape
+   *  Word operands are offsets into regs_, array operands are indices into
+   *  arrays_.
+   */
+  struct Instr
+  {
+    Code code;
+    Code wide_op;
+    uint32_t dst;
+    uint32_t a, b, c;
+    uint32_t width;  ///< result width
+    uint32_t aw, bw;  ///< widths of a and b
+    uint64_t mask;  ///< mask of the result, for results of at most 64 bits
+    uint64_t idx0, idx1;
+  };
+
+  struct ArrayValue
+  {
+    uint64_t dflt;
+    std::unordered_map<uint64_t, uint64_t> vals;
+
+    uint64_t read(uint64_t idx) const
+    {
+      auto it = vals.find(idx);
+      return (it == vals.end()) ? dflt : it->second;
+    }
+  };
+
+  /** Location of the value of a term */
+  struct Slot
+  {
+    bool is_array;
+    uint32_t off;  ///< offset into regs_ or index into arrays_
+    uint32_t width;  ///< bit-width, for arrays the element width
+  };
+
+  typedef std::vector<Instr> Tape;
+  typedef std::unordered_map<smt::Term, Slot> SlotMap;
+
+  /** @return a new slot for values of sort s */
+  Slot new_slot(const smt::Sort & s);
+
+  /** @return a new slot for a bit-vector of the given width */
+  Slot word_slot(uint32_t width);
+
+  /** Compiles t and its subterms that are not in slots onto tape */
+  Slot compile(const smt::Term & t, Tape & tape, SlotMap & slots);
+
+  /** Compiles a single operator application whose children are compiled */
+  Slot compile_op(const smt::Term & t,
+                  const std::vector<Slot> & args,
+                  Tape & tape);
+
+  /** Appends an instruction and returns its destination slot
+   *  Word instructions with operands wider than 64 bits become WIDE.
+   */
+  Slot emit(Tape & tape,
+            Code code,
+            const Slot & dst,
+            const std::vector<Slot> & args,
+            uint64_t idx0 = 0,
+            uint64_t idx1 = 0);
+
+  /** Puts a constant value in a new slot */
+  Slot constant(const smt::Term & val);
+
+  void run(const Tape & tape);
+
+  /** Evaluates a WIDE instruction */
+  void run_wide(const Instr & in);
+
+  /** Splits init() into initial value assignments and constraints */
+  void compile_init();
+
+  /** @return the slot of a variable or compiled term, throws if none */
+  const Slot & lookup(const smt::Term & t) const;
+
+  void write_words(const Slot & s, const uint64_t * w);
+
+  void randomize(const Slot & s);
+
+  smt::Term value_term(uint64_t v, const smt::Sort & sort) const;
+
+  void load_array(const smt::Term & val, ArrayValue & av) const;
+
+  const TransitionSystem & ts_;
+
+  smt::TermVec states_;
+  smt::TermVec inputs_;
+
+  std::vector<uint64_t> regs_;
+  std::vector<ArrayValue> arrays_;
+
+  // slots of variables, shared by all tapes
+  SlotMap var_slots_;
+
+  // initial values, evaluated by reset, the tape copies them to the states
+  Tape init_tape_;
+  SlotMap init_slots_;
+  // states that are not assigned by init_tape_
+  std::vector<Slot> free_states_;
+  std::vector<Slot> init_checks_;
+
+  // constraints, state updates and signals, evaluated by eval
+  Tape step_tape_;
+  SlotMap step_slots_;
+  // (state slot, update slot)
+  std::vector<std::pair<Slot, Slot>> updates_;
+  std::vector<Slot> constraint_checks_;
+  std::vector<Slot> input_slots_;
+  // states without an update, they are randomized by advance
+  std::vector<Slot> nondet_states_;
+
+  // next state buffers used by advance
+  std::vector<uint64_t> next_words_;
+  std::vector<ArrayValue> next_arrays_;
+
+  std::mt19937_64 gen_;
+};
+
+}  // namespace pono
@@ -0,0 +1,504 @@
+/*********************                                                        */
+/*! \file ternary_simulator.cpp
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Ternary (0/1/X) simulation of the next state functions of a
+**        deterministic transition system.
+**
+**/
+
+#include "core/ternary_simulator.h"
+
+#include "assert.h"
+#include "core/witness_trace.h"
+#include "utils/exceptions.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+namespace {
+
+uint64_t mask(uint32_t width)
+{
+  return width >= 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+}
+
+int64_t sext64(uint64_t v, uint32_t width)
+{
+  if (width >= 64) {
+    return static_cast<int64_t>(v);
+  }
+  uint64_t sign = uint64_t(1) << (width - 1);
+  return static_cast<int64_t>((v ^ sign) - sign);
+}
+
+}  // namespace
+
+TernarySimulator::TernarySimulator(const TransitionSystem & ts) : ts_(ts)
+{
+  if (!ts_.is_deterministic()) {
+    throw PonoException("Ternary simulation requires a deterministic system");
+  }
+}
+
+TermVec TernarySimulator::generalize(const TermVec & cube,
+                                     const UnorderedTermMap & inputs,
+                                     const Term & c)
+{
+  clear();
+  for (const auto & elem : inputs) {
+    set(elem.first, elem.second);
+  }
+
+  // state variable of each literal, null for literals that are kept as is
+  TermVec vars(cube.size());
+  for (size_t i = 0; i < cube.size(); ++i) {
+    const Term & l = cube[i];
+    Term var, val;
+    if (ts_.is_curr_var(l)) {
+      var = l;
+    } else if (l->get_op() == Not) {
+      Term child = *(l->begin());
+      if (ts_.is_curr_var(child)) {
+        var = child;
+      }
+    } else if (l->get_op() == Equal) {
+      TermVec children(l->begin(), l->end());
+      assert(children.size() == 2);
+      for (size_t j = 0; j < 2 && !var; ++j) {
+        if (ts_.is_curr_var(children[j]) && children[1 - j]->is_value()) {
+          var = children[j];
+          val = children[1 - j];
+        }
+      }
+    }
+    if (!var || !sort_width(var->get_sort())
+        || assignment_.find(var) != assignment_.end()) {
+      continue;
+    }
+
+    if (val) {
+      set(var, val);
+    } else {
+      // boolean literal
+      bool pos = (l == var);
+      assignment_[var] = { 1, pos ? uint64_t(1) : uint64_t(0), 1 };
+    }
+    if (assignment_.find(var) != assignment_.end()) {
+      vars[i] = var;
+    }
+  }
+
+  if (!successor_holds(c)) {
+    return cube;
+  }
+
+  TermVec kept;
+  for (size_t i = 0; i < cube.size(); ++i) {
+    const Term & var = vars[i];
+    if (!var) {
+      kept.push_back(cube[i]);
+      continue;
+    }
+    TValue saved = assignment_.at(var);
+    assignment_.erase(var);
+    cache_[0].clear();
+    cache_[1].clear();
+    if (!successor_holds(c)) {
+      assignment_[var] = saved;
+      cache_[0].clear();
+      cache_[1].clear();
+      kept.push_back(cube[i]);
+    }
+  }
+  return kept;
+}
+
+bool TernarySimulator::successor_holds(const Term & t)
+{
+  TValue r = eval(t, true);
+  return r.width == 1 && (r.known & 1) && (r.val & 1);
+}
+
+void TernarySimulator::set(const Term & var, const Term & val)
+{
+  cache_[0].clear();
+  cache_[1].clear();
+  uint32_t width = sort_width(var->get_sort());
+  if (!val || !width || !val->is_value()) {
+    assignment_.erase(var);
+    return;
+  }
+  uint64_t v = 0;
+  WitnessTrace::pack(val, width, &v);
+  assignment_[var] = { width, v & mask(width), mask(width) };
+}
+
+void TernarySimulator::clear()
+{
+  assignment_.clear();
+  cache_[0].clear();
+  cache_[1].clear();
+}
+
+TernarySimulator::TValue TernarySimulator::eval(const Term & t, bool succ)
+{
+  unordered_map<Term, TValue> & cache = cache_[succ];
+  auto it = cache.find(t);
+  if (it != cache.end()) {
+    return it->second;
+  }
+
+  // post-order traversal, the children of a term on the stack are
+  // evaluated once it is visited again
+  vector<pair<Term, bool>> to_visit({ { t, false } });
+  vector<TValue> args;
+  while (to_visit.size()) {
+    Term n = to_visit.back().first;
+    bool children_done = to_visit.back().second;
+    if (cache.find(n) != cache.end()) {
+      to_visit.pop_back();
+      continue;
+    }
+
+    const uint32_t width = sort_width(n->get_sort());
+    if (n->is_symbolic_const()) {
+      to_visit.pop_back();
+      if (succ) {
+        // state variables of the successor are given by their next state
+        // function, inputs of the successor are unknown
+        auto upd = ts_.state_updates().find(n);
+        cache[n] = (upd == ts_.state_updates().end())
+                       ? unknown(width)
+                       : eval(upd->second, false);
+      } else {
+        auto a = assignment_.find(n);
+        cache[n] = (a == assignment_.end()) ? unknown(width) : a->second;
+      }
+    } else if (n->is_value()) {
+      to_visit.pop_back();
+      TValue v = unknown(width);
+      if (width) {
+        WitnessTrace::pack(n, width, &v.val);
+        v.val &= mask(width);
+        v.known = mask(width);
+      }
+      cache[n] = v;
+    } else if (!children_done) {
+      to_visit.back().second = true;
+      for (auto c : n) {
+        if (cache.find(c) == cache.end()) {
+          to_visit.push_back({ c, false });
+        }
+      }
+    } else {
+      to_visit.pop_back();
+      args.clear();
+      for (auto c : n) {
+        args.push_back(cache.at(c));
+      }
+      cache[n] = apply(n->get_op(), args, width);
+    }
+  }
+  return cache.at(t);
+}
+
+TernarySimulator::TValue TernarySimulator::apply(const Op & op,
+                                                 const vector<TValue> & args,
+                                                 uint32_t width) const
+{
+  if (!width || args.empty()) {
+    return unknown(width);
+  }
+  for (const auto & a : args) {
+    if (!a.width) {
+      return unknown(width);
+    }
+  }
+  const uint64_t m = mask(width);
+
+  auto full = [](const TValue & a) { return a.known == mask(a.width); };
+  auto t_not = [](const TValue & a) {
+    return TValue{ a.width, ~a.val & a.known, a.known };
+  };
+  auto t_and = [](const TValue & a, const TValue & b) {
+    // a bit is known if both are known or one is a known zero
+    uint64_t known =
+        (a.known & b.known) | (a.known & ~a.val) | (b.known & ~b.val);
+    return TValue{ a.width, a.val & b.val, known };
+  };
+  auto t_or = [](const TValue & a, const TValue & b) {
+    uint64_t known = (a.known & b.known) | a.val | b.val;
+    return TValue{ a.width, a.val | b.val, known };
+  };
+  auto t_xor = [](const TValue & a, const TValue & b) {
+    uint64_t known = a.known & b.known;
+    return TValue{ a.width, (a.val ^ b.val) & known, known };
+  };
+  auto t_eq = [&full](const TValue & a, const TValue & b) {
+    if (a.known & b.known & (a.val ^ b.val)) {
+      return TValue{ 1, 0, 1 };
+    }
+    return (full(a) && full(b)) ? TValue{ 1, 1, 1 } : unknown(1);
+  };
+  // ripple carry addition, a carry is known if two of its inputs agree
+  auto t_add = [&full](const TValue & a, const TValue & b, bool carry_in) {
+    const uint64_t m = mask(a.width);
+    if (full(a) && full(b)) {
+      return TValue{ a.width, (a.val + b.val + carry_in) & m, m };
+    }
+    TValue r{ a.width, 0, 0 };
+    bool c_known = true, c_val = carry_in;
+    for (uint32_t i = 0; i < a.width; ++i) {
+      const uint64_t bit = uint64_t(1) << i;
+      bool ak = a.known & bit, bk = b.known & bit;
+      bool av = a.val & bit, bv = b.val & bit;
+      if (ak && bk && c_known) {
+        r.known |= bit;
+        r.val |= (av ^ bv ^ c_val) ? bit : 0;
+      }
+      int ones = (ak && av) + (bk && bv) + (c_known && c_val);
+      int zeros = (ak && !av) + (bk && !bv) + (c_known && !c_val);
+      c_known = ones >= 2 || zeros >= 2;
+      c_val = ones >= 2;
+    }
+    return r;
+  };
+  auto zero = [](uint32_t w) { return TValue{ w, 0, mask(w) }; };
+  // unsigned comparison from the most significant bit
+  auto t_ult = [](const TValue & a, const TValue & b, bool or_equal) {
+    for (uint32_t i = a.width; i-- > 0;) {
+      const uint64_t bit = uint64_t(1) << i;
+      if (!(a.known & b.known & bit)) {
+        return unknown(1);
+      }
+      if ((a.val ^ b.val) & bit) {
+        return TValue{ 1, (b.val & bit) ? uint64_t(1) : uint64_t(0), 1 };
+      }
+    }
+    return TValue{ 1, or_equal ? uint64_t(1) : uint64_t(0), 1 };
+  };
+  // signed comparisons are unsigned ones with the sign bits flipped
+  auto flip_sign = [](const TValue & a) {
+    const uint64_t sign = uint64_t(1) << (a.width - 1);
+    return TValue{ a.width, a.val ^ (a.known & sign), a.known };
+  };
+  auto fold = [&args](auto f) {
+    TValue r = args[0];
+    for (size_t i = 1; i < args.size(); ++i) {
+      r = f(r, args[i]);
+    }
+    return r;
+  };
+
+  switch (op.prim_op) {
+    case And:
+    case BVAnd: return fold(t_and);
+    case Or:
+    case BVOr: return fold(t_or);
+    case Xor:
+    case BVXor: return fold(t_xor);
+    case Not:
+    case BVNot: return t_not(args[0]);
+    case Implies: return t_or(t_not(args[0]), args[1]);
+    case BVNand: return t_not(t_and(args[0], args[1]));
+    case BVNor: return t_not(t_or(args[0], args[1]));
+    case BVXnor: return t_not(t_xor(args[0], args[1]));
+    case Equal:
+    case BVComp: {
+      TValue r = t_eq(args[0], args[1]);
+      for (size_t i = 2; i < args.size(); ++i) {
+        r = t_and(r, t_eq(args[i - 1], args[i]));
+      }
+      return r;
+    }
+    case Distinct:
+      if (args.size() != 2) {
+        return unknown(width);
+      }
+      return t_not(t_eq(args[0], args[1]));
+    case Ite: {
+      const TValue & cond = args[0];
+      if (cond.known & 1) {
+        return (cond.val & 1) ? args[1] : args[2];
+      }
+      const TValue & a = args[1];
+      const TValue & b = args[2];
+      uint64_t known = a.known & b.known & ~(a.val ^ b.val);
+      return TValue{ width, a.val & known, known };
+    }
+    case BVAdd:
+      return fold([&t_add](const TValue & a, const TValue & b) {
+        return t_add(a, b, false);
+      });
+    case BVSub: return t_add(args[0], t_not(args[1]), true);
+    case BVNeg: return t_add(t_not(args[0]), zero(width), true);
+    case BVUlt: return t_ult(args[0], args[1], false);
+    case BVUle: return t_ult(args[0], args[1], true);
+    case BVUgt: return t_ult(args[1], args[0], false);
+    case BVUge: return t_ult(args[1], args[0], true);
+    case BVSlt: return t_ult(flip_sign(args[0]), flip_sign(args[1]), false);
+    case BVSle: return t_ult(flip_sign(args[0]), flip_sign(args[1]), true);
+    case BVSgt: return t_ult(flip_sign(args[1]), flip_sign(args[0]), false);
+    case BVSge: return t_ult(flip_sign(args[1]), flip_sign(args[0]), true);
+    case Concat:
+      return fold([](const TValue & a, const TValue & b) {
+        return TValue{ a.width + b.width,
+                       (a.val << b.width) | b.val,
+                       (a.known << b.width) | b.known };
+      });
+    case Extract: {
+      const uint64_t lo = op.idx1;
+      const TValue & a = args[0];
+      return TValue{ width, (a.val >> lo) & m, (a.known >> lo) & m };
+    }
+    case Zero_Extend: {
+      const TValue & a = args[0];
+      return TValue{ width, a.val, a.known | (m & ~mask(a.width)) };
+    }
+    case Sign_Extend: {
+      const TValue & a = args[0];
+      const uint64_t ext = m & ~mask(a.width);
+      const uint64_t sign = uint64_t(1) << (a.width - 1);
+      if (!(a.known & sign)) {
+        return TValue{ width, a.val, a.known };
+      }
+      uint64_t val = (a.val & sign) ? a.val | ext : a.val;
+      return TValue{ width, val, a.known | ext };
+    }
+    case Repeat: {
+      const TValue & a = args[0];
+      TValue r{ width, 0, 0 };
+      for (uint64_t i = 0; i < op.idx0; ++i) {
+        r.val = (a.width == 64) ? a.val : (r.val << a.width) | a.val;
+        r.known = (a.width == 64) ? a.known : (r.known << a.width) | a.known;
+      }
+      return r;
+    }
+    case Rotate_Left:
+    case Rotate_Right: {
+      const TValue & a = args[0];
+      uint64_t k = op.idx0 % a.width;
+      if (k && op.prim_op == Rotate_Right) {
+        k = a.width - k;
+      }
+      if (!k) {
+        return a;
+      }
+      auto rot = [&](uint64_t v) {
+        return ((v << k) | (v >> (a.width - k))) & m;
+      };
+      return TValue{ width, rot(a.val), rot(a.known) };
+    }
+    case BVShl:
+    case BVLshr:
+    case BVAshr: {
+      const TValue & a = args[0];
+      const TValue & b = args[1];
+      if (!full(b)) {
+        return unknown(width);
+      }
+      const uint64_t k = b.val;
+      if (op.prim_op == BVShl) {
+        if (k >= width) {
+          return zero(width);
+        }
+        return TValue{
+          width, (a.val << k) & m, ((a.known << k) | mask(k)) & m
+        };
+      } else if (op.prim_op == BVLshr) {
+        if (k >= width) {
+          return zero(width);
+        }
+        return TValue{
+          width, a.val >> k, (a.known >> k) | (m & ~(m >> k))
+        };
+      }
+      // arithmetic shift: the vacated bits are copies of the sign bit
+      const uint64_t sign = uint64_t(1) << (width - 1);
+      const uint64_t s = (k >= width) ? width : k;
+      const uint64_t vacated = (s >= width) ? m : m & ~(m >> s);
+      uint64_t val = (s >= width) ? 0 : a.val >> s;
+      uint64_t known = (s >= width) ? 0 : a.known >> s;
+      if (a.known & sign) {
+        known |= vacated;
+        val |= (a.val & sign) ? vacated : 0;
+      } else {
+        known &= ~vacated;
+      }
+      return TValue{ width, val, known };
+    }
+    case BVMul:
+    case BVUdiv:
+    case BVUrem:
+    case BVSdiv:
+    case BVSrem:
+    case BVSmod: {
+      for (const auto & a : args) {
+        if (!full(a)) {
+          return unknown(width);
+        }
+      }
+      uint64_t a = args[0].val;
+      uint64_t b = args[1].val;
+      uint64_t r;
+      if (op.prim_op == BVMul) {
+        r = a;
+        for (size_t i = 1; i < args.size(); ++i) {
+          r = (r * args[i].val) & m;
+        }
+      } else if (op.prim_op == BVUdiv) {
+        r = b ? a / b : m;
+      } else if (op.prim_op == BVUrem) {
+        r = b ? a % b : a;
+      } else {
+        // SMT-LIB definitions in terms of the absolute values
+        bool neg_a = sext64(a, width) < 0;
+        bool neg_b = sext64(b, width) < 0;
+        uint64_t abs_a = neg_a ? (0 - a) & m : a;
+        uint64_t abs_b = neg_b ? (0 - b) & m : b;
+        if (op.prim_op == BVSdiv) {
+          uint64_t q = abs_b ? abs_a / abs_b : m;
+          r = (neg_a != neg_b) ? (0 - q) & m : q;
+        } else {
+          uint64_t u = abs_b ? abs_a % abs_b : abs_a;
+          if (op.prim_op == BVSrem) {
+            r = neg_a ? (0 - u) & m : u;
+          } else if (u == 0 || (!neg_a && !neg_b)) {
+            r = u;
+          } else if (neg_a && !neg_b) {
+            r = (b - u) & m;
+          } else if (!neg_a && neg_b) {
+            r = (u + b) & m;
+          } else {
+            r = (0 - u) & m;
+          }
+        }
+      }
+      return TValue{ width, r & m, m };
+    }
+    default: return unknown(width);
+  }
+}
+
+uint32_t TernarySimulator::sort_width(const Sort & sort)
+{
+  SortKind sk = sort->get_sort_kind();
+  if (sk == BOOL) {
+    return 1;
+  } else if (sk == BV && sort->get_width() <= 64) {
+    return sort->get_width();
+  }
+  return 0;
+}
+
+}  // namespace pono
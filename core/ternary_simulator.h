@@ -0,0 +1,103 @@
+/*********************                                                        */
+/*! \file ternary_simulator.h
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Ternary (0/1/X) simulation of the next state functions of a
+**        deterministic transition system, used to generalize predecessors
+**        in IC3 without solver calls.
+**
+**        Every bit of a value is 0, 1 or unknown (X). Bitwise operators,
+**        comparisons, additions and shifts by a known amount keep the
+**        known bits they can; the other operators give X unless all their
+**        operands are known. Bit-vectors wider than 64 bits, arrays and
+**        other sorts are always X.
+**
+**/
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "core/ts.h"
+#include "smt-switch/smt.h"
+
+namespace pono {
+
+class TernarySimulator
+{
+ public:
+  /** @param ts a deterministic transition system (every state variable has
+   *         a next state function and there are no constraints)
+   *  throws a PonoException if ts is not deterministic
+   */
+  TernarySimulator(const TransitionSystem & ts);
+
+  /** Drops the literals of a predecessor cube that are not needed for its
+   *  successor to satisfy c: a literal is dropped if c still evaluates to
+   *  true in the successor with its state variable set to X.
+   *  Literals are x and !x for boolean state variables and x = v for a
+   *  state variable x and a value v. Literals of another shape are always
+   *  kept and do not constrain the simulation.
+   *  @param cube the literals of the predecessor, tried in order
+   *  @param inputs values of the inputs in the transition, missing inputs
+   *         are X
+   *  @param c the target, over current state variables
+   *  @return the kept literals (a subsequence of cube), the whole cube if c
+   *          does not evaluate to true for it
+   */
+  smt::TermVec generalize(const smt::TermVec & cube,
+                          const smt::UnorderedTermMap & inputs,
+                          const smt::Term & c);
+
+  /** @return true iff t evaluates to true in the successor of the states
+   *          described by the current assignment
+   */
+  bool successor_holds(const smt::Term & t);
+
+  /** Sets a state or input variable to a value, or to X if val is null */
+  void set(const smt::Term & var, const smt::Term & val);
+
+  /** Sets all variables to X */
+  void clear();
+
+ protected:
+  struct TValue
+  {
+    uint32_t width;  ///< 0 for a value that is not simulated
+    uint64_t val;    ///< bits that are known to be one
+    uint64_t known;  ///< bits that are known
+  };
+
+  /** @return the value of t, with state variables read in the successor
+   *          if succ is set (i.e. as the value of their next state function)
+   */
+  TValue eval(const smt::Term & t, bool succ);
+
+  /** @return the value of an operator application */
+  TValue apply(const smt::Op & op,
+               const std::vector<TValue> & args,
+               uint32_t width) const;
+
+  /** @return the bit-width of a simulated sort, 0 otherwise */
+  static uint32_t sort_width(const smt::Sort & sort);
+
+  static TValue unknown(uint32_t width) { return { width, 0, 0 }; }
+
+  const TransitionSystem & ts_;
+
+  /** state and input variables with a value (not X) */
+  std::unordered_map<smt::Term, TValue> assignment_;
+
+  /** values of terms in the current state and in the successor */
+  std::unordered_map<smt::Term, TValue> cache_[2];
+};
+
+}  // namespace pono
@@ -30,6 +30,8 @@ namespace pono {
 void swap(TransitionSystem & ts1, TransitionSystem & ts2)
 {
   std::swap(ts1.solver_, ts2.solver_);
+  std::swap(ts1.init_conjuncts_, ts2.init_conjuncts_);
+  std::swap(ts1.trans_conjuncts_, ts2.trans_conjuncts_);
   std::swap(ts1.init_, ts2.init_);
   std::swap(ts1.trans_, ts2.trans_);
   std::swap(ts1.statevars_, ts2.statevars_);
@@ -71,8 +73,13 @@ TransitionSystem::TransitionSystem(const TransitionSystem & other_ts,
   solver_ = tt.get_solver();
   // transfer init and trans -- expect them to be boolean
   // will cast if underlying solver aliases Bool/BV1
-  init_ = transfer_as(other_ts.init_, BOOL);
-  trans_ = transfer_as(other_ts.trans_, BOOL);
+  for (const auto & c : other_ts.init_conjuncts_) {
+    init_conjuncts_.push_back(transfer_as(c, BOOL));
+  }
+  for (const auto & c : other_ts.trans_conjuncts_) {
+    trans_conjuncts_.push_back(transfer_as(c, BOOL));
+  }
+  // conjunctions are rebuilt on demand
 
   // populate data structures with translated terms
 
@@ -117,8 +124,8 @@ TransitionSystem::TransitionSystem(const TransitionSystem & other_ts,
     curr_map_[transfer(elem.first)] = transfer(elem.second);
   }
 
-  /* Constraints collected in vector 'constraints_' were part of init_
-     and/or trans_ and were transferred already above. Hence these
+  /* Constraints collected in vector 'constraints_' were conjuncts of init
+     and/or trans and were transferred already above. Hence these
      terms should be in the term translator cache. */
   for (const auto & e : other_ts.constraints_) {
     constraints_.push_back({ transfer_as(e.first, BOOL), e.second });
@@ -130,8 +137,8 @@ TransitionSystem::TransitionSystem(const TransitionSystem & other_ts,
 bool TransitionSystem::operator==(const TransitionSystem & other) const
 {
   return (solver_ == other.solver_ &&
-          init_ == other.init_ &&
-          trans_ == other.trans_ &&
+          init() == other.init() &&
+          trans() == other.trans() &&
           statevars_ == other.statevars_ &&
           next_statevars_ == other.next_statevars_ &&
           inputvars_ == other.inputvars_ &&
@@ -150,6 +157,22 @@ bool TransitionSystem::operator!=(const TransitionSystem & other) const
   return !(*this == other);
 }
 
+Term TransitionSystem::init() const
+{
+  if (!init_) {
+    init_ = make_conjunction(init_conjuncts_);
+  }
+  return init_;
+}
+
+Term TransitionSystem::trans() const
+{
+  if (!trans_) {
+    trans_ = make_conjunction(trans_conjuncts_);
+  }
+  return trans_;
+}
+
 void TransitionSystem::set_init(const Term & init)
 {
   // TODO: only do this check in debug mode
@@ -158,7 +181,7 @@ void TransitionSystem::set_init(const Term & init)
         "Initial state constraints should only use current state variables");
   }
 
-  init_ = init;
+  reset_init(init);
 }
 
 void TransitionSystem::constrain_init(const Term & constraint)
@@ -168,7 +191,7 @@ void TransitionSystem::constrain_init(const Term & constraint)
     throw PonoException(
         "Initial state constraints should only use current state variables");
   }
-  init_ = solver_->make_term(And, init_, constraint);
+  add_init_conjunct(constraint);
 }
 
 void TransitionSystem::assign_next(const Term & state, const Term & val)
@@ -190,8 +213,7 @@ void TransitionSystem::assign_next(const Term & state, const Term & val)
   }
 
   state_updates_[state] = val;
-  trans_ = solver_->make_term(
-      And, trans_, solver_->make_term(Equal, next_map_.at(state), val));
+  add_trans_conjunct(solver_->make_term(Equal, next_map_.at(state), val));
 
   // if not functional, then we cannot guarantee deterministm
   // if it is functional, depends on if all state variables
@@ -211,11 +233,11 @@ void TransitionSystem::add_invar(const Term & constraint)
 
   // TODO: only check this in debug mode
   if (only_curr(constraint)) {
-    init_ = solver_->make_term(And, init_, constraint);
-    trans_ = solver_->make_term(And, trans_, constraint);
+    add_init_conjunct(constraint);
+    add_trans_conjunct(constraint);
     Term next_constraint = solver_->substitute(constraint, next_map_);
     // add the next-state version
-    trans_ = solver_->make_term(And, trans_, next_constraint);
+    add_trans_conjunct(next_constraint);
     constraints_.push_back({ constraint, true });
   } else {
     throw PonoException("Invariants should be over current states only.");
@@ -229,7 +251,7 @@ void TransitionSystem::constrain_inputs(const Term & constraint)
   deterministic_ = false;
 
   if (no_next(constraint)) {
-    trans_ = solver_->make_term(And, trans_, constraint);
+    add_trans_conjunct(constraint);
     constraints_.push_back({ constraint, true });
   } else {
     throw PonoException("Cannot have next-states in an input constraint.");
@@ -244,16 +266,16 @@ void TransitionSystem::add_constraint(const Term & constraint,
   deterministic_ = false;
 
   if (only_curr(constraint)) {
-    trans_ = solver_->make_term(And, trans_, constraint);
+    add_trans_conjunct(constraint);
 
     if (to_init_and_next) {
-      init_ = solver_->make_term(And, init_, constraint);
+      add_init_conjunct(constraint);
       Term next_constraint = solver_->substitute(constraint, next_map_);
-      trans_ = solver_->make_term(And, trans_, next_constraint);
+      add_trans_conjunct(next_constraint);
     }
     constraints_.push_back({ constraint, to_init_and_next });
   } else if (no_next(constraint)) {
-    trans_ = solver_->make_term(And, trans_, constraint);
+    add_trans_conjunct(constraint);
     constraints_.push_back({ constraint, to_init_and_next });
   } else {
     throw PonoException("Constraint cannot have next states");
@@ -479,8 +501,8 @@ void TransitionSystem::rebuild_trans_based_on_coi(
     const UnorderedTermSet & state_vars_in_coi,
     const UnorderedTermSet & input_vars_in_coi)
 {
-  /* Clear current transition relation 'trans_'. */
-  trans_ = solver_->make_term(true);
+  /* Clear current transition relation. */
+  reset_trans(solver_->make_term(true));
 
   /* Add next-state functions for state variables in COI. */
   for (const auto & state_var : state_vars_in_coi) {
@@ -491,11 +513,11 @@ void TransitionSystem::rebuild_trans_based_on_coi(
     /* May find state variables without next-function. */
     if (next_func != NULL) {
         Term eq = solver_->make_term(Equal, next_map_.at(state_var), next_func);
-        trans_ = solver_->make_term(And, trans_, eq);
+        add_trans_conjunct(eq);
       }
   }
 
-  /* Add global constraints added to previous 'trans_'. */
+  /* Add global constraints added to previous transition relation. */
   // TODO: check potential optimizations in removing global constraints
   std::vector<std::pair<smt::Term, bool>> prev_constraints = constraints_;
   constraints_.clear();
@@ -511,7 +533,9 @@ void TransitionSystem::rebuild_trans_based_on_coi(
   // this shouldn't affect performance much, because
   // variables in init that are not in the COI *only*
   // appear in init
-  get_free_symbolic_consts(init_, statevars_);
+  for (const auto & c : init_conjuncts_) {
+    get_free_symbolic_consts(c, statevars_);
+  }
   for (const auto & var : state_vars_in_coi) {
     statevars_.insert(var);
   }
@@ -574,6 +598,60 @@ void TransitionSystem::rebuild_trans_based_on_coi(
 
 // protected methods
 
+void TransitionSystem::add_init_conjunct(const Term & constraint)
+{
+  init_conjuncts_.push_back(constraint);
+  init_ = nullptr;
+}
+
+void TransitionSystem::add_trans_conjunct(const Term & constraint)
+{
+  trans_conjuncts_.push_back(constraint);
+  trans_ = nullptr;
+}
+
+void TransitionSystem::reset_init(const Term & init)
+{
+  init_conjuncts_.clear();
+  if (init != solver_->make_term(true)) {
+    init_conjuncts_.push_back(init);
+  }
+  init_ = init;
+}
+
+void TransitionSystem::reset_trans(const Term & trans)
+{
+  trans_conjuncts_.clear();
+  if (trans != solver_->make_term(true)) {
+    trans_conjuncts_.push_back(trans);
+  }
+  trans_ = trans;
+}
+
+Term TransitionSystem::make_conjunction(const TermVec & conjuncts) const
+{
+  if (conjuncts.empty()) {
+    return solver_->make_term(true);
+  }
+
+  // combine neighbors pairwise until one term is left
+  // the depth is logarithmic in the number of conjuncts
+  TermVec level = conjuncts;
+  TermVec next_level;
+  while (level.size() > 1) {
+    next_level.clear();
+    next_level.reserve((level.size() + 1) / 2);
+    for (size_t i = 0; i + 1 < level.size(); i += 2) {
+      next_level.push_back(solver_->make_term(And, level[i], level[i + 1]));
+    }
+    if (level.size() % 2) {
+      next_level.push_back(level.back());
+    }
+    level.swap(next_level);
+  }
+  return level[0];
+}
+
 bool TransitionSystem::contains(const Term & term,
                                 UnorderedTermSetPtrVec term_sets) const
 {
@@ -632,17 +710,17 @@ void TransitionSystem::drop_state_updates(const TermVec & svs)
   }
 
   // now rebuild trans
-  /* Clear current transition relation 'trans_'. */
-  trans_ = solver_->make_term(true);
+  /* Clear current transition relation. */
+  reset_trans(solver_->make_term(true));
 
   /* Add next-state functions for state variables in COI. */
   for (const auto & elem : state_updates_) {
     assert(elem.second);  // should be non-null if in map
     Term eq = solver_->make_term(Equal, next_map_.at(elem.first), elem.second);
-    trans_ = solver_->make_term(And, trans_, eq);
+    add_trans_conjunct(eq);
   }
 
-  /* Add global constraints added to previous 'trans_'. */
+  /* Add global constraints added to previous transition relation. */
   for (const auto & e : constraints_) {
     add_constraint(e.first, e.second);
   }
@@ -685,13 +763,19 @@ void TransitionSystem::replace_terms(const UnorderedTermMap & to_replace)
   SubstitutionWalker sw(solver_, to_replace);
 
   // now rebuild terms in every data structure with replacements
-  init_ = sw.visit(init_);
-  if (!only_curr(init_)) {
-    throw PonoException(
-        "Replaced a state variable appearing in init with an input in "
-        "replace_terms");
+  for (auto & c : init_conjuncts_) {
+    c = sw.visit(c);
+    if (!only_curr(c)) {
+      throw PonoException(
+          "Replaced a state variable appearing in init with an input in "
+          "replace_terms");
+    }
+  }
+  init_ = nullptr;
+  for (auto & c : trans_conjuncts_) {
+    c = sw.visit(c);
   }
-  trans_ = sw.visit(trans_);
+  trans_ = nullptr;
 
   unordered_map<string, Term> new_named_terms;
   unordered_map<Term, string> new_term_to_name;
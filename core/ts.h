@@ -53,6 +53,13 @@ class TransitionSystem
 
   friend void swap(TransitionSystem & ts1, TransitionSystem & ts2);
 
+  /** Access the data structures directly, see core/ts_snapshot.h */
+  friend void write_ts_snapshot(const std::string & filename,
+                                const TransitionSystem & ts,
+                                const smt::TermVec & props);
+  friend smt::TermVec read_ts_snapshot(const std::string & filename,
+                                       TransitionSystem & ts);
+
   /** Copy assignment using
    *  copy-and-swap idiom
    */
@@ -234,12 +241,26 @@ class TransitionSystem
   /* Returns the initial state constraints
    * @return a boolean term constraining the initial state
    */
-  smt::Term init() const { return init_; };
+  smt::Term init() const;
 
   /* Returns the transition relation
    * @return a boolean term representing the transition relation
    */
-  smt::Term trans() const { return trans_; };
+  smt::Term trans() const;
+
+  /* Returns the conjuncts of the initial state constraints
+   * in the order they were added
+   * init() is a balanced conjunction of these terms
+   * @return a vector of boolean terms (empty if init is true)
+   */
+  const smt::TermVec & init_conjuncts() const { return init_conjuncts_; };
+
+  /* Returns the conjuncts of the transition relation
+   * in the order they were added
+   * trans() is a balanced conjunction of these terms
+   * @return a vector of boolean terms (empty if trans is true)
+   */
+  const smt::TermVec & trans_conjuncts() const { return trans_conjuncts_; };
 
   /* Returns the next state updates
    * @return a map of functional next state updates
@@ -478,11 +499,17 @@ class TransitionSystem
   // solver
   smt::SmtSolver solver_;
 
-  // initial state constraint
-  smt::Term init_;
+  // conjuncts of the initial state constraint
+  smt::TermVec init_conjuncts_;
+
+  // conjuncts of the transition relation (functional in this class)
+  smt::TermVec trans_conjuncts_;
+
+  // conjunction of init_conjuncts_, built on demand (null if stale)
+  mutable smt::Term init_;
 
-  // transition relation (functional in this class)
-  smt::Term trans_;
+  // conjunction of trans_conjuncts_, built on demand (null if stale)
+  mutable smt::Term trans_;
 
   // system state variables
   smt::UnorderedTermSet statevars_;
@@ -552,6 +579,26 @@ class TransitionSystem
 
   /* Returns true iff all the symbols in the formula are known */
   virtual bool known_symbols(const smt::Term & term) const;
+
+  /** Adds a conjunct to the initial state constraint */
+  void add_init_conjunct(const smt::Term & constraint);
+
+  /** Adds a conjunct to the transition relation */
+  void add_trans_conjunct(const smt::Term & constraint);
+
+  /** Replaces all conjuncts of the initial state constraint with init */
+  void reset_init(const smt::Term & init);
+
+  /** Replaces all conjuncts of the transition relation with trans */
+  void reset_trans(const smt::Term & trans);
+
+  /** Builds a balanced binary tree of And over the conjuncts
+   *  avoids the deep left-leaning chains created by adding one conjunct
+   *  at a time, which are slow to traverse and substitute
+   *  @param conjuncts the terms to conjoin
+   *  @return the conjunction (true if conjuncts is empty)
+   */
+  smt::Term make_conjunction(const smt::TermVec & conjuncts) const;
 };
 
 }  // namespace pono
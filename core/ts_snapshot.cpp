@@ -0,0 +1,793 @@
+/*********************                                                        */
+/*! \file ts_snapshot.cpp
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Compact binary snapshots of a TransitionSystem and its properties
+**        that can be reloaded into any solver without re-parsing the
+**        original model.
+**
+**/
+
+#include "core/ts_snapshot.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <unordered_map>
+
+#include "smt/available_solvers.h"
+#include "utils/exceptions.h"
+#include "utils/logger.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+namespace {
+
+const char snapshot_magic[8] = { 'P', 'O', 'N', 'O', 'T', 'S', '\0', '\0' };
+const char term_lists_magic[8] = { 'P', 'O', 'N', 'O', 'T', 'L', '\0', '\0' };
+const uint32_t snapshot_version = 1;
+// numbers are stored in native byte order, used to detect a mismatch
+const uint32_t snapshot_byte_order = 0x01020304;
+
+// kinds of entries in the sort and term table
+enum EntryKind : uint8_t
+{
+  SORT_ENTRY = 0,
+  SYMBOL_ENTRY,
+  VALUE_ENTRY,
+  CONST_ARRAY_ENTRY,
+  OP_ENTRY,
+  END_ENTRY
+};
+
+EntryKind term_entry_kind(const Term & t)
+{
+  if (t->is_symbol()) {
+    return SYMBOL_ENTRY;
+  } else if (t->is_param()) {
+    throw PonoException("Cannot snapshot terms with bound variables: "
+                        + t->to_string());
+  } else if (!t->get_op().is_null()) {
+    return OP_ENTRY;
+  } else if (t->get_sort()->get_sort_kind() == ARRAY) {
+    return CONST_ARRAY_ENTRY;
+  } else if (t->is_value()) {
+    return VALUE_ENTRY;
+  }
+  throw PonoException("Cannot snapshot term: " + t->to_string());
+}
+
+/** Converts an SMT-LIB integer or real value to the format
+ *  expected by make_term, e.g. (- (/ 1 2)) to -1/2
+ */
+string arith_value(const string & val)
+{
+  if (val.size() < 2 || val.front() != '(' || val.back() != ')') {
+    return val;
+  }
+
+  string inner = val.substr(1, val.size() - 2);
+  if (inner.substr(0, 2) == "- ") {
+    return "-" + arith_value(inner.substr(2));
+  } else if (inner.substr(0, 2) == "/ ") {
+    // split the operands at the first top-level space
+    size_t depth = 0;
+    for (size_t i = 2; i < inner.size(); ++i) {
+      if (inner[i] == '(') {
+        depth++;
+      } else if (inner[i] == ')') {
+        depth--;
+      } else if (inner[i] == ' ' && !depth) {
+        return arith_value(inner.substr(2, i - 2)) + "/"
+               + arith_value(inner.substr(i + 1));
+      }
+    }
+  }
+  throw PonoException("Cannot snapshot value: " + val);
+}
+
+/** Buffers the sort and term table and the transition system members */
+class SnapshotWriter
+{
+ public:
+  /** Adds the sort (and its subsorts) to the table if needed
+   *  @return the index of the sort
+   */
+  uint64_t sort_id(const Sort & sort)
+  {
+    auto it = sort_ids_.find(sort);
+    if (it != sort_ids_.end()) {
+      return it->second;
+    }
+
+    SortKind sk = sort->get_sort_kind();
+    vector<uint64_t> subsorts;
+    if (sk == ARRAY) {
+      subsorts.push_back(sort_id(sort->get_indexsort()));
+      subsorts.push_back(sort_id(sort->get_elemsort()));
+    } else if (sk == FUNCTION) {
+      for (const auto & d : sort->get_domain_sorts()) {
+        subsorts.push_back(sort_id(d));
+      }
+      subsorts.push_back(sort_id(sort->get_codomain_sort()));
+    }
+
+    put<uint8_t>(table_, SORT_ENTRY);
+    put<uint8_t>(table_, sk);
+    switch (sk) {
+      case BOOL:
+      case INT:
+      case REAL: break;
+      case BV: put<uint64_t>(table_, sort->get_width()); break;
+      case ARRAY:
+      case FUNCTION: put_ids(table_, subsorts); break;
+      case UNINTERPRETED:
+        put_string(table_, sort->get_uninterpreted_name());
+        put<uint64_t>(table_, sort->get_arity());
+        break;
+      default:
+        throw PonoException("Cannot snapshot sort: " + sort->to_string());
+    }
+
+    uint64_t id = sort_ids_.size();
+    sort_ids_[sort] = id;
+    return id;
+  }
+
+  /** Adds the term and all its subterms to the table if needed
+   *  @return the index of the term
+   */
+  uint64_t term_id(const Term & term)
+  {
+    // iterative post-order traversal, terms can be very deep
+    TermVec to_visit({ term });
+    Term t;
+    while (!to_visit.empty()) {
+      t = to_visit.back();
+      if (term_ids_.find(t) != term_ids_.end()) {
+        to_visit.pop_back();
+        continue;
+      }
+
+      EntryKind kind = term_entry_kind(t);
+      bool children_done = true;
+      if (kind == OP_ENTRY || kind == CONST_ARRAY_ENTRY) {
+        for (const auto & c : t) {
+          if (term_ids_.find(c) == term_ids_.end()) {
+            to_visit.push_back(c);
+            children_done = false;
+          }
+        }
+      }
+
+      if (children_done) {
+        to_visit.pop_back();
+        add_term(t, kind);
+      }
+    }
+    return term_ids_.at(term);
+  }
+
+  void put_term(const Term & t) { put<uint64_t>(members_, term_id(t)); }
+
+  template <class Container>
+  void put_terms(const Container & terms)
+  {
+    put<uint64_t>(members_, terms.size());
+    for (const auto & t : terms) {
+      put_term(t);
+    }
+  }
+
+  void put_term_map(const UnorderedTermMap & m)
+  {
+    put<uint64_t>(members_, m.size());
+    for (const auto & elem : m) {
+      put_term(elem.first);
+      put_term(elem.second);
+    }
+  }
+
+  string & members() { return members_; }
+
+  /** Writes the header, the table and the members to filename
+   *  The file is written next to filename first and then renamed,
+   *  so an interrupted write never leaves a truncated file behind.
+   */
+  void dump(const string & filename, const string & header)
+  {
+    string tmp_name = filename + ".tmp";
+    {
+      ofstream out(tmp_name, ios::binary);
+      if (!out.is_open()) {
+        throw PonoException("Failed to open snapshot file " + tmp_name);
+      }
+
+      put<uint8_t>(table_, END_ENTRY);
+
+      out.write(header.data(), header.size());
+      out.write(table_.data(), table_.size());
+      out.write(members_.data(), members_.size());
+      if (!out.good()) {
+        throw PonoException("Failed to write snapshot file " + tmp_name);
+      }
+    }
+    if (rename(tmp_name.c_str(), filename.c_str())) {
+      throw PonoException("Failed to write snapshot file " + filename);
+    }
+
+    logger.log(1,
+               "Wrote snapshot {} with {} sorts and {} terms",
+               filename,
+               sort_ids_.size(),
+               term_ids_.size());
+  }
+
+  /** @return the common header for a file with the given magic */
+  static string header(const char (&magic)[8], SolverEnum se)
+  {
+    string h(magic, sizeof(magic));
+    put<uint32_t>(h, snapshot_version);
+    put<uint32_t>(h, snapshot_byte_order);
+    put<uint32_t>(h, se);
+    return h;
+  }
+
+  template <class T>
+  static void put(string & buf, T v)
+  {
+    buf.append(reinterpret_cast<const char *>(&v), sizeof(T));
+  }
+
+  static void put_string(string & buf, const string & s)
+  {
+    put<uint64_t>(buf, s.size());
+    buf.append(s);
+  }
+
+ protected:
+  void put_ids(string & buf, const vector<uint64_t> & ids)
+  {
+    put<uint64_t>(buf, ids.size());
+    for (const auto & id : ids) {
+      put<uint64_t>(buf, id);
+    }
+  }
+
+  /** Appends the entry for t, its children must already be in the table */
+  void add_term(const Term & t, EntryKind kind)
+  {
+    // the sort might need to be added first
+    uint64_t sid = sort_id(t->get_sort());
+
+    put<uint8_t>(table_, kind);
+    put<uint64_t>(table_, sid);
+    if (kind == SYMBOL_ENTRY) {
+      put_string(table_, t->to_string());
+    } else if (kind == VALUE_ENTRY) {
+      put_value(t);
+    } else if (kind == CONST_ARRAY_ENTRY) {
+      put<uint64_t>(table_, term_ids_.at(*(t->begin())));
+    } else {
+      Op op = t->get_op();
+      put<uint32_t>(table_, op.prim_op);
+      put<uint64_t>(table_, op.num_idx);
+      put<uint64_t>(table_, op.idx0);
+      put<uint64_t>(table_, op.idx1);
+      vector<uint64_t> children;
+      for (const auto & c : t) {
+        children.push_back(term_ids_.at(c));
+      }
+      put_ids(table_, children);
+    }
+
+    uint64_t id = term_ids_.size();
+    term_ids_[t] = id;
+  }
+
+  /** Stores a value as a base and a string of digits */
+  void put_value(const Term & t)
+  {
+    string val = t->to_string();
+    SortKind sk = t->get_sort()->get_sort_kind();
+    uint8_t base = 10;
+    if (sk == BOOL) {
+      // solvers that alias Bool and BV1 might print it as a bit-vector
+      val = (val == "true" || val == "#b1") ? "true" : "false";
+    } else if (sk == BV && val.substr(0, 2) == "#b") {
+      base = 2;
+      val = val.substr(2);
+    } else if (sk == BV && val.substr(0, 2) == "#x") {
+      base = 16;
+      val = val.substr(2);
+    } else if (sk == BV && val.substr(0, 5) == "(_ bv") {
+      val = val.substr(5, val.find(' ', 5) - 5);
+    } else if (sk == INT || sk == REAL) {
+      val = arith_value(val);
+    } else {
+      throw PonoException("Cannot snapshot value: " + val);
+    }
+    put<uint8_t>(table_, base);
+    put_string(table_, val);
+  }
+
+  string table_;    ///< sort and term entries in dependency order
+  string members_;  ///< members of the transition system and properties
+  unordered_map<Sort, uint64_t> sort_ids_;
+  unordered_map<Term, uint64_t> term_ids_;
+};
+
+/** Read-only memory mapping of a whole file */
+class MappedFile
+{
+ public:
+  MappedFile(const string & filename) : data_(nullptr), size_(0)
+  {
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw PonoException("Failed to open snapshot file " + filename);
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+      close(fd);
+      throw PonoException("Failed to stat snapshot file " + filename);
+    }
+    size_ = st.st_size;
+    if (size_) {
+      data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    // the mapping stays valid after closing the file descriptor
+    close(fd);
+    if (data_ == MAP_FAILED) {
+      throw PonoException("Failed to map snapshot file " + filename);
+    }
+  }
+
+  ~MappedFile()
+  {
+    if (data_ && data_ != MAP_FAILED) {
+      munmap(data_, size_);
+    }
+  }
+
+  const char * data() const { return static_cast<const char *>(data_); }
+  size_t size() const { return size_; }
+
+ private:
+  MappedFile(const MappedFile &) = delete;
+  MappedFile & operator=(const MappedFile &) = delete;
+
+  void * data_;
+  size_t size_;
+};
+
+/** Reads fields from a snapshot in memory */
+class SnapshotReader
+{
+ public:
+  SnapshotReader(const char * data, size_t size)
+      : pos_(data), end_(data + size)
+  {
+  }
+
+  template <class T>
+  T get()
+  {
+    check_available(sizeof(T));
+    T v;
+    memcpy(&v, pos_, sizeof(T));
+    pos_ += sizeof(T);
+    return v;
+  }
+
+  string get_string()
+  {
+    uint64_t len = get<uint64_t>();
+    check_available(len);
+    string s(pos_, len);
+    pos_ += len;
+    return s;
+  }
+
+  void skip(uint64_t n)
+  {
+    check_available(n);
+    pos_ += n;
+  }
+
+  void check_available(uint64_t n) const
+  {
+    if (n > static_cast<uint64_t>(end_ - pos_)) {
+      throw PonoException("Truncated snapshot file");
+    }
+  }
+
+ private:
+  const char * pos_;
+  const char * end_;
+};
+
+/** Checks the common header of a file with the given magic
+ *  @return the solver the file was written with
+ */
+SolverEnum read_header(SnapshotReader & in,
+                       const MappedFile & file,
+                       const char (&magic)[8],
+                       const string & filename)
+{
+  in.check_available(sizeof(magic));
+  if (memcmp(file.data(), magic, sizeof(magic))) {
+    throw PonoException(filename + " is not a pono snapshot");
+  }
+  in.skip(sizeof(magic));
+  if (in.get<uint32_t>() != snapshot_version) {
+    throw PonoException("Unsupported snapshot version in " + filename);
+  }
+  if (in.get<uint32_t>() != snapshot_byte_order) {
+    throw PonoException("Snapshot " + filename
+                        + " was written on a machine with a different "
+                          "byte order");
+  }
+  return static_cast<SolverEnum>(in.get<uint32_t>());
+}
+
+/** Rebuilds the sort and term table in solver
+ *  @param in the reader, positioned at the start of the table
+ *  @param solver the solver to create sorts and terms with
+ *  @param make_sym creates (or looks up) a symbol with a name and sort
+ *  @param terms populated with the terms in table order
+ */
+void read_table(SnapshotReader & in,
+                const SmtSolver & solver,
+                const function<Term(const string &, const Sort &)> & make_sym,
+                vector<Term> & terms)
+{
+  vector<Sort> sorts;
+  auto sort_at = [&sorts](uint64_t id) -> const Sort & {
+    if (id >= sorts.size()) {
+      throw PonoException("Corrupted snapshot: unknown sort index");
+    }
+    return sorts[id];
+  };
+  auto term_at = [&terms](uint64_t id) -> const Term & {
+    if (id >= terms.size()) {
+      throw PonoException("Corrupted snapshot: unknown term index");
+    }
+    return terms[id];
+  };
+  auto get_ids = [&in]() {
+    uint64_t n = in.get<uint64_t>();
+    in.check_available(n * sizeof(uint64_t));
+    vector<uint64_t> ids(n);
+    for (auto & id : ids) {
+      id = in.get<uint64_t>();
+    }
+    return ids;
+  };
+
+  uint8_t kind;
+  while ((kind = in.get<uint8_t>()) != END_ENTRY) {
+    if (kind == SORT_ENTRY) {
+      uint8_t sk = in.get<uint8_t>();
+      SortVec subsorts;
+      switch (sk) {
+        case BOOL:
+        case INT:
+        case REAL: sorts.push_back(solver->make_sort(SortKind(sk))); break;
+        case BV:
+          sorts.push_back(solver->make_sort(BV, in.get<uint64_t>()));
+          break;
+        case ARRAY:
+        case FUNCTION:
+          for (const auto & id : get_ids()) {
+            subsorts.push_back(sort_at(id));
+          }
+          if (sk == ARRAY && subsorts.size() != 2) {
+            throw PonoException("Corrupted snapshot: malformed array sort");
+          }
+          sorts.push_back((sk == ARRAY) ? solver->make_sort(
+                              ARRAY, subsorts[0], subsorts[1])
+                                        : solver->make_sort(FUNCTION, subsorts));
+          break;
+        case UNINTERPRETED: {
+          string name = in.get_string();
+          sorts.push_back(solver->make_sort(name, in.get<uint64_t>()));
+          break;
+        }
+        default: throw PonoException("Corrupted snapshot: unknown sort kind");
+      }
+      continue;
+    }
+
+    Sort sort = sort_at(in.get<uint64_t>());
+    if (kind == SYMBOL_ENTRY) {
+      terms.push_back(make_sym(in.get_string(), sort));
+    } else if (kind == VALUE_ENTRY) {
+      uint8_t base = in.get<uint8_t>();
+      string val = in.get_string();
+      terms.push_back((sort->get_sort_kind() == BOOL)
+                          ? solver->make_term(val == "true")
+                          : solver->make_term(val, sort, base));
+    } else if (kind == CONST_ARRAY_ENTRY) {
+      terms.push_back(solver->make_term(term_at(in.get<uint64_t>()), sort));
+    } else if (kind == OP_ENTRY) {
+      Op op;
+      op.prim_op = static_cast<PrimOp>(in.get<uint32_t>());
+      op.num_idx = in.get<uint64_t>();
+      op.idx0 = in.get<uint64_t>();
+      op.idx1 = in.get<uint64_t>();
+      if (op.prim_op >= NUM_OPS_AND_NULL) {
+        throw PonoException("Corrupted snapshot: unknown operator");
+      }
+      TermVec children;
+      for (const auto & id : get_ids()) {
+        children.push_back(term_at(id));
+      }
+      terms.push_back(solver->make_term(op, children));
+    } else {
+      throw PonoException("Corrupted snapshot: unknown entry");
+    }
+  }
+
+  logger.log(1,
+             "Read snapshot table with {} sorts and {} terms",
+             sorts.size(),
+             terms.size());
+}
+
+}  // namespace
+
+void write_ts_snapshot(const string & filename,
+                       const TransitionSystem & ts,
+                       const TermVec & props)
+{
+  SnapshotWriter w;
+  string & members = w.members();
+
+  w.put_terms(ts.init_conjuncts_);
+  w.put_terms(ts.trans_conjuncts_);
+  w.put_terms(ts.statevars_);
+  w.put_terms(ts.next_statevars_);
+  w.put_terms(ts.inputvars_);
+
+  SnapshotWriter::put<uint64_t>(members, ts.named_terms_.size());
+  for (const auto & elem : ts.named_terms_) {
+    SnapshotWriter::put_string(members, elem.first);
+    w.put_term(elem.second);
+  }
+  SnapshotWriter::put<uint64_t>(members, ts.term_to_name_.size());
+  for (const auto & elem : ts.term_to_name_) {
+    w.put_term(elem.first);
+    SnapshotWriter::put_string(members, elem.second);
+  }
+
+  w.put_term_map(ts.state_updates_);
+  w.put_term_map(ts.next_map_);
+  w.put_term_map(ts.curr_map_);
+
+  SnapshotWriter::put<uint64_t>(members, ts.constraints_.size());
+  for (const auto & e : ts.constraints_) {
+    w.put_term(e.first);
+    SnapshotWriter::put<uint8_t>(members, e.second);
+  }
+
+  w.put_terms(props);
+
+  string header =
+      SnapshotWriter::header(snapshot_magic, ts.solver()->get_solver_enum());
+  SnapshotWriter::put<uint8_t>(header, ts.is_functional());
+  SnapshotWriter::put<uint8_t>(header, ts.is_deterministic());
+  w.dump(filename, header);
+}
+
+TermVec read_ts_snapshot(const string & filename, TransitionSystem & ts)
+{
+  if (ts.statevars_.size() || ts.inputvars_.size()) {
+    throw PonoException("Expecting an empty transition system to read "
+                        + filename);
+  }
+
+  MappedFile file(filename);
+  SnapshotReader in(file.data(), file.size());
+
+  SolverEnum writer_se = read_header(in, file, snapshot_magic, filename);
+  bool functional = in.get<uint8_t>();
+  bool deterministic = in.get<uint8_t>();
+
+  if (ts.functional_ && !functional) {
+    throw PonoException("Cannot read a relational snapshot into a "
+                        "functional transition system");
+  }
+
+  const SmtSolver & solver = ts.solver_;
+  bool writer_aliasing =
+      get_solver_attributes(writer_se).count(BOOL_BV1_ALIASING);
+  bool reader_aliasing =
+      get_solver_attributes(solver->get_solver_enum()).count(BOOL_BV1_ALIASING);
+  if (writer_aliasing != reader_aliasing) {
+    // the term structure might rely on Bool and BV1 being the same sort
+    // rebuild with the original kind of solver and translate (with casts)
+    logger.log(1,
+               "Snapshot {} written with {}, reading through a translation",
+               filename,
+               to_string(writer_se));
+    TransitionSystem tmp(create_solver(writer_se));
+    TermVec tmp_props = read_ts_snapshot(filename, tmp);
+    TermTranslator tt(solver);
+    TransitionSystem translated(tmp, tt);
+    swap(ts, translated);
+    TermVec props;
+    for (const auto & p : tmp_props) {
+      props.push_back(tt.transfer_term(p, BOOL));
+    }
+    return props;
+  }
+
+  vector<Term> terms;
+  read_table(in, solver, [&solver](const string & name, const Sort & sort) {
+    return solver->make_symbol(name, sort);
+  }, terms);
+  auto term_at = [&terms](uint64_t id) -> const Term & {
+    if (id >= terms.size()) {
+      throw PonoException("Corrupted snapshot: unknown term index");
+    }
+    return terms[id];
+  };
+
+  // transition system members
+  auto get_term = [&]() { return term_at(in.get<uint64_t>()); };
+  auto get_term_set = [&](UnorderedTermSet & out) {
+    uint64_t n = in.get<uint64_t>();
+    for (uint64_t i = 0; i < n; ++i) {
+      out.insert(get_term());
+    }
+  };
+  auto get_term_map = [&](UnorderedTermMap & out) {
+    uint64_t n = in.get<uint64_t>();
+    for (uint64_t i = 0; i < n; ++i) {
+      Term key = get_term();
+      out[key] = get_term();
+    }
+  };
+
+  auto get_term_vec = [&](TermVec & out) {
+    uint64_t n = in.get<uint64_t>();
+    for (uint64_t i = 0; i < n; ++i) {
+      out.push_back(get_term());
+    }
+  };
+
+  get_term_vec(ts.init_conjuncts_);
+  get_term_vec(ts.trans_conjuncts_);
+  // conjunctions are rebuilt on demand
+  ts.init_ = nullptr;
+  ts.trans_ = nullptr;
+  get_term_set(ts.statevars_);
+  get_term_set(ts.next_statevars_);
+  get_term_set(ts.inputvars_);
+
+  uint64_t n = in.get<uint64_t>();
+  for (uint64_t i = 0; i < n; ++i) {
+    string name = in.get_string();
+    ts.named_terms_[name] = get_term();
+  }
+  n = in.get<uint64_t>();
+  for (uint64_t i = 0; i < n; ++i) {
+    Term t = get_term();
+    ts.term_to_name_[t] = in.get_string();
+  }
+
+  get_term_map(ts.state_updates_);
+  get_term_map(ts.next_map_);
+  get_term_map(ts.curr_map_);
+
+  n = in.get<uint64_t>();
+  for (uint64_t i = 0; i < n; ++i) {
+    Term c = get_term();
+    ts.constraints_.push_back({ c, in.get<uint8_t>() });
+  }
+
+  TermVec props;
+  n = in.get<uint64_t>();
+  for (uint64_t i = 0; i < n; ++i) {
+    props.push_back(get_term());
+  }
+
+  ts.functional_ = functional;
+  ts.deterministic_ = deterministic;
+
+  return props;
+}
+
+void write_term_lists(const string & filename,
+                      const TransitionSystem & ts,
+                      const vector<uint64_t> & meta,
+                      const vector<TermVec> & lists)
+{
+  SnapshotWriter w;
+  string & members = w.members();
+
+  SnapshotWriter::put<uint64_t>(members, meta.size());
+  for (const auto & m : meta) {
+    SnapshotWriter::put<uint64_t>(members, m);
+  }
+  SnapshotWriter::put<uint64_t>(members, lists.size());
+  for (const auto & l : lists) {
+    w.put_terms(l);
+  }
+
+  w.dump(filename,
+         SnapshotWriter::header(term_lists_magic,
+                                ts.solver()->get_solver_enum()));
+}
+
+vector<TermVec> read_term_lists(const string & filename,
+                                const TransitionSystem & ts,
+                                vector<uint64_t> & meta)
+{
+  MappedFile file(filename);
+  SnapshotReader in(file.data(), file.size());
+  SolverEnum writer_se = read_header(in, file, term_lists_magic, filename);
+
+  const SmtSolver & solver = ts.solver();
+  if (get_solver_attributes(writer_se).count(BOOL_BV1_ALIASING)
+      != get_solver_attributes(solver->get_solver_enum())
+             .count(BOOL_BV1_ALIASING)) {
+    throw PonoException(filename + " was written with "
+                        + to_string(writer_se)
+                        + " which treats Bool and BV1 differently");
+  }
+
+  vector<Term> terms;
+  read_table(in, solver, [&ts](const string & name, const Sort & sort) {
+    Term sym = ts.lookup(name);
+    if (sym->get_sort() != sort) {
+      throw PonoException("Sort mismatch for " + name + " in term list");
+    }
+    return sym;
+  }, terms);
+
+  auto get_term = [&]() -> const Term & {
+    uint64_t id = in.get<uint64_t>();
+    if (id >= terms.size()) {
+      throw PonoException("Corrupted snapshot: unknown term index");
+    }
+    return terms[id];
+  };
+
+  meta.clear();
+  uint64_t n = in.get<uint64_t>();
+  for (uint64_t i = 0; i < n; ++i) {
+    meta.push_back(in.get<uint64_t>());
+  }
+
+  vector<TermVec> lists;
+  n = in.get<uint64_t>();
+  for (uint64_t i = 0; i < n; ++i) {
+    lists.push_back({});
+    uint64_t len = in.get<uint64_t>();
+    for (uint64_t j = 0; j < len; ++j) {
+      lists.back().push_back(get_term());
+    }
+  }
+  return lists;
+}
+
+}  // namespace pono
@@ -0,0 +1,78 @@
+/*********************                                                        */
+/*! \file ts_snapshot.h
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Compact binary snapshots of a TransitionSystem and its properties
+**        that can be reloaded into any solver without re-parsing the
+**        original model.
+**
+**        The file holds a table of sorts and a table of terms in which
+**        every shared subterm appears once and refers to its children by
+**        index, followed by the members of the TransitionSystem. It is
+**        read back through a memory mapping.
+**
+**/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "core/ts.h"
+#include "smt-switch/smt.h"
+
+namespace pono {
+
+/** Writes ts and props to a binary snapshot file
+ *  @param filename the file to write
+ *  @param ts the transition system
+ *  @param props properties over ts to store alongside the system
+ *  throws a PonoException if ts contains terms that cannot be stored
+ *  (e.g. quantified formulas)
+ */
+void write_ts_snapshot(const std::string & filename,
+                       const TransitionSystem & ts,
+                       const smt::TermVec & props = {});
+
+/** Reads a binary snapshot into ts, rebuilding all terms in ts.solver()
+ *  @param filename the file to read
+ *  @param ts an empty transition system, if it is functional then the
+ *         snapshot must be of a functional system as well
+ *  @return the properties stored in the snapshot
+ */
+smt::TermVec read_ts_snapshot(const std::string & filename,
+                              TransitionSystem & ts);
+
+/** Writes lists of terms over ts (e.g. learned lemmas) to a binary file
+ *  that uses the same term table as the snapshots
+ *  @param filename the file to write
+ *  @param ts the transition system the terms are over
+ *  @param meta integers to store alongside the terms
+ *  @param lists the lists of terms
+ */
+void write_term_lists(const std::string & filename,
+                      const TransitionSystem & ts,
+                      const std::vector<uint64_t> & meta,
+                      const std::vector<smt::TermVec> & lists);
+
+/** Reads a file written by write_term_lists into the solver of ts
+ *  Symbols are looked up by name in ts instead of being declared
+ *  @param filename the file to read
+ *  @param ts the transition system the terms are over
+ *  @param meta populated with the stored integers
+ *  @return the lists of terms
+ *  throws a PonoException if a symbol is not a named term of ts
+ */
+std::vector<smt::TermVec> read_term_lists(const std::string & filename,
+                                          const TransitionSystem & ts,
+                                          std::vector<uint64_t> & meta);
+
+}  // namespace pono
@@ -37,15 +37,47 @@ Unroller::~Unroller() {}
 
 Term Unroller::at_time(const Term & t, unsigned int k)
 {
-  UnorderedTermMap & cache = var_cache_at_time(k);
+  const UnorderedTermMap & var_cache = var_cache_at_time(k);
 
-  // if t is a variable, it will be cached
-  auto it = cache.find(t);
-  if (it != cache.end()) {
-    return it->second;
+  while (subterm_cache_.size() <= k) {
+    subterm_cache_.push_back(UnorderedTermMap());
+  }
+
+  return rebuild(t, subterm_cache_[k], [&var_cache](const Term & leaf) {
+    auto it = var_cache.find(leaf);
+    return (it == var_cache.end()) ? leaf : it->second;
+  });
+}
+
+Term Unroller::time_shift(const Term & timed_t, unsigned int j, unsigned int k)
+{
+  if (j == k) {
+    return timed_t;
   }
 
-  return solver_->substitute(t, cache);
+  // only valid for this call, the shifted terms
+  // are not reused as often as unrolled terms
+  UnorderedTermMap cache;
+  return rebuild(timed_t, cache, [this, j, k](const Term & leaf) {
+    auto it = var_times_.find(leaf);
+    if (it == var_times_.end()) {
+      // not an unrolled variable
+      return leaf;
+    }
+    if (it->second + k < j) {
+      throw PonoException("Cannot shift " + leaf->to_string()
+                          + " before time 0");
+    }
+    return var_at_time(untime_cache_.at(leaf), it->second + k - j);
+  });
+}
+
+void Unroller::clear_subterm_cache_before(unsigned int k)
+{
+  for (size_t t = 0; t < k && t < subterm_cache_.size(); ++t) {
+    // release the memory instead of only emptying the map
+    UnorderedTermMap().swap(subterm_cache_[t]);
+  }
 }
 
 Term Unroller::untime(const Term & t) const
@@ -133,6 +165,8 @@ UnorderedTermMap & Unroller::var_cache_at_time(unsigned int k)
   // timed-var-term-map
   if (current_num_vars > num_vars_) {
     num_vars_ = current_num_vars;
+    // unrolled subterms might contain the new variables untimed
+    subterm_cache_.clear();
     size_t t = 0;
     for (UnorderedTermMap & st : time_cache_) {
       for (auto v : ts_.statevars()) {
@@ -154,4 +188,52 @@ UnorderedTermMap & Unroller::var_cache_at_time(unsigned int k)
   return var_cache;
 }
 
+Term Unroller::rebuild(const Term & t,
+                      UnorderedTermMap & cache,
+                      const function<Term(const Term &)> & map_leaf)
+{
+  // iterative post-order traversal, unrolled terms can be very deep
+  TermVec to_visit({ t });
+  TermVec children;
+  Term cur;
+  while (!to_visit.empty()) {
+    cur = to_visit.back();
+    if (cache.find(cur) != cache.end()) {
+      to_visit.pop_back();
+      continue;
+    }
+
+    Op op = cur->get_op();
+    if (op.is_null()) {
+      // symbols, values and constant arrays
+      cache[cur] = map_leaf(cur);
+      to_visit.pop_back();
+      continue;
+    }
+
+    bool children_done = true;
+    for (const auto & c : cur) {
+      if (cache.find(c) == cache.end()) {
+        to_visit.push_back(c);
+        children_done = false;
+      }
+    }
+    if (!children_done) {
+      continue;
+    }
+
+    to_visit.pop_back();
+    children.clear();
+    bool changed = false;
+    for (const auto & c : cur) {
+      const Term & new_c = cache.at(c);
+      changed |= (new_c != c);
+      children.push_back(new_c);
+    }
+    cache[cur] = changed ? solver_->make_term(op, children) : cur;
+  }
+
+  return cache.at(t);
+}
+
 }  // namespace pono
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <functional>
+
 #include "core/ts.h"
 
 #include "smt-switch/smt.h"
@@ -50,6 +52,38 @@ class Unroller
    */
   virtual smt::Term at_time(const smt::Term & t, unsigned int k);
 
+  /** Moves a term that was unrolled at time j to time k
+   *  by renaming every timed variable v@i to v@(i + k - j)
+   *  This walks the timed term once and does not need the
+   *  original (untimed) term
+   *
+   *  Note: only sound when every variable is unrolled at every
+   *        time step, e.g. not for a FunctionalUnroller
+   *
+   *  @param timed_t a term over unrolled variables
+   *  @param j the time timed_t was unrolled at
+   *  @param k the time to move timed_t to
+   *  @return the term at time k
+   *  throws a PonoException if a variable would end up before time 0
+   */
+  virtual smt::Term time_shift(const smt::Term & timed_t,
+                               unsigned int j,
+                               unsigned int k);
+
+  /** Drops the memoized unrolled subterms
+   *  at_time keeps every unrolled subterm for every time step so that
+   *  shared subterms are only substituted once per time step across calls
+   */
+  void clear_subterm_cache() { subterm_cache_.clear(); }
+
+  /** Drops the memoized unrolled subterms of the times before k
+   *  Engines that no longer unroll at those times use this to bound
+   *  the memory used by the unroller, e.g. for terms that are only
+   *  unrolled once such as interpolants
+   *  @param k the first time to keep the memoized subterms of
+   */
+  void clear_subterm_cache_before(unsigned int k);
+
   smt::Term untime(const smt::Term & t) const;
 
   /** Returns the time of an unrolled variable
@@ -78,6 +112,16 @@ class Unroller
   smt::Term var_at_time(const smt::Term & v, unsigned int k);
   virtual smt::UnorderedTermMap & var_cache_at_time(unsigned int k);
 
+  /** Rebuilds t bottom-up, replacing leaves with map_leaf
+   *  @param t the term to rebuild
+   *  @param cache results for subterms, read and extended by this call
+   *  @param map_leaf the replacement for a symbol or value
+   *  @return the rebuilt term
+   */
+  smt::Term rebuild(const smt::Term & t,
+                    smt::UnorderedTermMap & cache,
+                    const std::function<smt::Term(const smt::Term &)> & map_leaf);
+
   const TransitionSystem & ts_;
   const smt::SmtSolver solver_;
   const std::string time_id_;
@@ -85,6 +129,7 @@ class Unroller
   typedef std::vector<smt::UnorderedTermMap> TimeCache;
   TimeCache time_cache_;
   TimeCache time_var_map_;
+  TimeCache subterm_cache_;  ///< untimed subterm to its unrolling, per time
   smt::UnorderedTermMap untime_cache_;
   std::unordered_map<smt::Term, size_t> var_times_;
 
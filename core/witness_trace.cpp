@@ -0,0 +1,212 @@
+/*********************                                                        */
+/*! \file witness_trace.cpp
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Columnar storage of the values of a counterexample trace.
+**
+**/
+
+#include "core/witness_trace.h"
+
+#include <cassert>
+#include <cstring>
+
+#include "gmpxx.h"
+#include "utils/exceptions.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+WitnessTrace::WitnessTrace(const TermVec & signals) : num_frames_(0)
+{
+  for (const auto & s : signals) {
+    if (index_.find(s) != index_.end()) {
+      continue;
+    }
+    index_[s] = signals_.size();
+    signals_.push_back(s);
+
+    Column c;
+    Sort sort = s->get_sort();
+    SortKind sk = sort->get_sort_kind();
+    c.width = (sk == BOOL) ? 1 : ((sk == BV) ? sort->get_width() : 0);
+    c.num_words = (c.width + 63) / 64;
+    columns_.push_back(c);
+  }
+}
+
+WitnessTrace WitnessTrace::from_maps(const TermVec & signals,
+                                     const vector<UnorderedTermMap> & cex)
+{
+  WitnessTrace trace(signals);
+  TermVec values(trace.num_signals());
+  for (const auto & m : cex) {
+    for (size_t i = 0; i < values.size(); ++i) {
+      auto it = m.find(trace.signals_[i]);
+      values[i] = (it == m.end()) ? nullptr : it->second;
+    }
+    trace.add_frame(values);
+  }
+  return trace;
+}
+
+void WitnessTrace::add_frame(const TermVec & values)
+{
+  assert(values.size() == columns_.size());
+  for (size_t i = 0; i < columns_.size(); ++i) {
+    Column & c = columns_[i];
+    const Term & v = values[i];
+    c.present.push_back(v != nullptr);
+    if (!c.width) {
+      c.terms.push_back(v);
+      continue;
+    }
+    c.words.resize(c.words.size() + c.num_words, 0);
+    if (v) {
+      pack(v, c.width, &c.words[c.words.size() - c.num_words]);
+    }
+  }
+  num_frames_++;
+}
+
+bool WitnessTrace::find(const Term & t, size_t & idx) const
+{
+  auto it = index_.find(t);
+  if (it == index_.end()) {
+    return false;
+  }
+  idx = it->second;
+  return true;
+}
+
+bool WitnessTrace::has_value(size_t sig, size_t frame) const
+{
+  return columns_.at(sig).present.at(frame);
+}
+
+const uint64_t * WitnessTrace::words(size_t sig, size_t frame) const
+{
+  const Column & c = columns_.at(sig);
+  assert(c.width);
+  return &c.words.at(frame * c.num_words);
+}
+
+string WitnessTrace::bits(size_t sig, size_t frame) const
+{
+  return words_to_bits(words(sig, frame), columns_[sig].width);
+}
+
+const Term & WitnessTrace::term_value(size_t sig, size_t frame) const
+{
+  const Column & c = columns_.at(sig);
+  assert(!c.width);
+  return c.terms.at(frame);
+}
+
+bool WitnessTrace::same_value(size_t sig, size_t frame1, size_t frame2) const
+{
+  const Column & c = columns_.at(sig);
+  if (c.present.at(frame1) != c.present.at(frame2)) {
+    return false;
+  }
+  if (!c.width) {
+    return c.terms[frame1] == c.terms[frame2];
+  }
+  return !memcmp(&c.words[frame1 * c.num_words],
+                 &c.words[frame2 * c.num_words],
+                 c.num_words * sizeof(uint64_t));
+}
+
+string WitnessTrace::value_bits(const Term & v)
+{
+  Sort sort = v->get_sort();
+  size_t width = (sort->get_sort_kind() == BV) ? sort->get_width() : 1;
+  vector<uint64_t> w((width + 63) / 64, 0);
+  pack(v, width, w.data());
+  return words_to_bits(w.data(), width);
+}
+
+string WitnessTrace::value_decimal(const Term & v)
+{
+  size_t width = v->get_sort()->get_width();
+  vector<uint64_t> w((width + 63) / 64, 0);
+  pack(v, width, w.data());
+  if (w.size() == 1) {
+    return std::to_string(w[0]);
+  }
+  mpz_class z;
+  mpz_import(z.get_mpz_t(), w.size(), -1, sizeof(uint64_t), 0, 0, w.data());
+  return z.get_str(10);
+}
+
+void WitnessTrace::pack(const Term & v, size_t width, uint64_t * out)
+{
+  size_t num_words = (width + 63) / 64;
+  memset(out, 0, num_words * sizeof(uint64_t));
+
+  if (v->get_sort()->get_sort_kind() == BOOL) {
+    string s = v->to_string();
+    out[0] = (s == "true" || s == "#b1");
+    return;
+  }
+
+  if (width <= 64) {
+    try {
+      out[0] = v->to_int();
+      return;
+    }
+    catch (std::exception & e) {
+      // fall back on the string representation
+    }
+  }
+
+  string val = v->to_string();
+  if (val.substr(0, 2) == "#b") {
+    // one character per bit, most significant first
+    size_t n = val.size() - 2;
+    for (size_t i = 0; i < n && i < width; ++i) {
+      if (val[val.size() - 1 - i] == '1') {
+        out[i / 64] |= (uint64_t(1) << (i % 64));
+      }
+    }
+  } else if (val.substr(0, 2) == "#x") {
+    size_t n = val.size() - 2;
+    for (size_t i = 0; i < n && 4 * i < width; ++i) {
+      char ch = val[val.size() - 1 - i];
+      uint64_t digit = isdigit(ch) ? ch - '0' : (tolower(ch) - 'a' + 10);
+      out[(4 * i) / 64] |= (digit << ((4 * i) % 64));
+    }
+  } else if (val.substr(0, 5) == "(_ bv") {
+    mpz_class z(val.substr(5, val.find(' ', 5) - 5));
+    size_t count = 0;
+    vector<uint64_t> w(mpz_sizeinbase(z.get_mpz_t(), 2) / 64 + 1, 0);
+    mpz_export(w.data(), &count, -1, sizeof(uint64_t), 0, 0, z.get_mpz_t());
+    for (size_t i = 0; i < count && i < num_words; ++i) {
+      out[i] = w[i];
+    }
+  } else {
+    throw PonoException("Don't know how to interpret value: " + val);
+  }
+}
+
+string WitnessTrace::words_to_bits(const uint64_t * w, size_t width)
+{
+  string res(width, '0');
+  for (size_t i = 0; i < width; ++i) {
+    if ((w[i / 64] >> (i % 64)) & 1) {
+      res[width - 1 - i] = '1';
+    }
+  }
+  return res;
+}
+
+}  // namespace pono
@@ -0,0 +1,113 @@
+/*********************                                                        */
+/*! \file witness_trace.h
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Columnar storage of the values of a counterexample trace.
+**        Bit-vector and boolean values are packed into 64-bit words once,
+**        so printers never need to parse the solver's value strings.
+**        Other values (e.g. arrays) are kept as terms.
+**
+**/
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "smt-switch/smt.h"
+
+namespace pono {
+
+class WitnessTrace
+{
+ public:
+  WitnessTrace() : num_frames_(0) {}
+
+  /** @param signals the (untimed) terms to record values for */
+  WitnessTrace(const smt::TermVec & signals);
+
+  /** Builds a trace from a witness of maps
+   *  @param signals the terms to record, duplicates are ignored
+   *  @param cex the value of each term at each frame,
+   *         terms without a value in a frame are recorded as missing
+   */
+  static WitnessTrace from_maps(const smt::TermVec & signals,
+                                const std::vector<smt::UnorderedTermMap> & cex);
+
+  /** Appends a frame
+   *  @param values values[i] is the value of signals()[i] in this frame
+   *         or null if it has no value
+   */
+  void add_frame(const smt::TermVec & values);
+
+  size_t num_frames() const { return num_frames_; }
+  size_t num_signals() const { return signals_.size(); }
+  const smt::TermVec & signals() const { return signals_; }
+
+  /** @param t a term
+   *  @param idx set to the index of t if it is a signal
+   *  @return true iff t is a signal of this trace
+   */
+  bool find(const smt::Term & t, size_t & idx) const;
+
+  bool has_value(size_t sig, size_t frame) const;
+
+  /** @return true iff the values of sig are packed (bit-vectors and
+   *          booleans), false if they are kept as terms
+   */
+  bool is_packed(size_t sig) const { return columns_[sig].width > 0; }
+
+  /** @return the bit-width of a packed signal (1 for booleans) */
+  size_t width(size_t sig) const { return columns_[sig].width; }
+
+  /** @return the packed value of sig, least significant word first */
+  const uint64_t * words(size_t sig, size_t frame) const;
+
+  /** @return the binary digits of a packed value, most significant first */
+  std::string bits(size_t sig, size_t frame) const;
+
+  /** @return the value of a signal that is not packed */
+  const smt::Term & term_value(size_t sig, size_t frame) const;
+
+  /** @return true iff sig has the same value (or is missing) in both frames */
+  bool same_value(size_t sig, size_t frame1, size_t frame2) const;
+
+  /** Converts a bit-vector or boolean value to binary digits
+   *  most significant first
+   */
+  static std::string value_bits(const smt::Term & v);
+
+  /** Converts a bit-vector value to a decimal string */
+  static std::string value_decimal(const smt::Term & v);
+
+  /** Packs a bit-vector or boolean value into out[0 .. (width+63)/64) */
+  static void pack(const smt::Term & v, size_t width, uint64_t * out);
+
+  /** Converts packed words to binary digits, most significant first */
+  static std::string words_to_bits(const uint64_t * w, size_t width);
+
+ protected:
+  struct Column
+  {
+    size_t width;  ///< 0 if the values are kept as terms
+    size_t num_words;  ///< words per frame
+    std::vector<uint64_t> words;
+    std::vector<bool> present;
+    smt::TermVec terms;
+  };
+
+  smt::TermVec signals_;
+  std::unordered_map<smt::Term, size_t> index_;
+  std::vector<Column> columns_;
+  size_t num_frames_;
+};
+
+}  // namespace pono
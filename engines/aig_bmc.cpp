@@ -0,0 +1,140 @@
+/*********************                                                        */
+/*! \file aig_bmc.cpp
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Bounded model checking on the bit-blasted system.
+**
+**/
+
+#include "engines/aig_bmc.h"
+
+#include "utils/logger.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+AigBmc::AigBmc(const Property & p,
+               const TransitionSystem & ts,
+               const SmtSolver & solver,
+               PonoOptions opt)
+    : super(p, ts, solver, opt)
+{
+  engine_ = Engine::AIG_BMC;
+}
+
+AigBmc::~AigBmc() {}
+
+void AigBmc::initialize()
+{
+  if (initialized_) {
+    return;
+  }
+
+  super::initialize();
+
+  sat_.set_terminate([this]() { return interrupted(); });
+  add_frame();
+}
+
+ProverResult AigBmc::check_until(int k)
+{
+  initialize();
+
+  for (int i = reached_k_ + 1; i <= k; ++i) {
+    if (interrupted()) {
+      logger.log(1, "AigBmc interrupted at bound: {}", i);
+      return ProverResult::UNKNOWN;
+    }
+    SatResult res;
+    if (!step(i, res)) {
+      compute_witness_frames(i);
+      return ProverResult::FALSE;
+    } else if (res == SatResult::UNKNOWN) {
+      logger.log(1, "AigBmc interrupted at bound: {}", i);
+      return ProverResult::UNKNOWN;
+    }
+  }
+  return ProverResult::UNKNOWN;
+}
+
+void AigBmc::add_frame()
+{
+  frames_.push_back(new_copy(sat_));
+  vector<int> & map = frames_.back();
+  const vector<Aig::Latch> & latches = aig_.latches();
+
+  if (frames_.size() == 1) {
+    for (const auto & l : latches) {
+      int x = encode(sat_, map, l.lit);
+      if (l.init == Aig::aig_true) {
+        sat_.add_clause({ x });
+      } else if (l.init == Aig::aig_false) {
+        sat_.add_clause({ -x });
+      }
+    }
+  } else {
+    // the latches of this frame are the next states of the previous one
+    vector<int> & prev = frames_[frames_.size() - 2];
+    for (const auto & l : latches) {
+      map[Aig::var(l.lit)] = encode(sat_, prev, l.next);
+    }
+  }
+
+  for (auto c : aig_.constraints()) {
+    sat_.add_clause({ encode(sat_, map, c) });
+  }
+}
+
+bool AigBmc::step(int i, SatResult & res)
+{
+  res = SatResult::UNSAT;
+  if (i <= reached_k_) {
+    return true;
+  }
+
+  while (frames_.size() <= (size_t)i) {
+    add_frame();
+  }
+
+  logger.log(1, "Checking aig-bmc at bound: {}", i);
+  int bad = encode(sat_, frames_[i], bad_lit_);
+  res = sat_.solve({ bad });
+  if (res == SatResult::SAT) {
+    return false;
+  } else if (res == SatResult::UNSAT) {
+    // the bad state is unreachable at this bound from now on
+    sat_.add_clause({ -bad });
+    ++reached_k_;
+  }
+  return true;
+}
+
+void AigBmc::compute_witness_frames(int i)
+{
+  vector<bool> latch_vals, input_vals;
+  for (int j = 0; j <= i; ++j) {
+    vector<int> & map = frames_[j];
+    latch_vals.clear();
+    for (const auto & l : aig_.latches()) {
+      latch_vals.push_back(sat_.value(encode(sat_, map, l.lit)));
+    }
+    input_vals.clear();
+    for (auto in : aig_.inputs()) {
+      int x = map[Aig::var(in)];
+      // inputs outside of the cone of the property are free
+      input_vals.push_back(x ? sat_.value(x) : false);
+    }
+    add_witness_frame(latch_vals, input_vals);
+  }
+}
+
+}  // namespace pono
@@ -0,0 +1,57 @@
+/*********************                                                        */
+/*! \file aig_bmc.h
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Bounded model checking on the bit-blasted system.
+**        The system is unrolled incrementally in a single SatSolver, and
+**        the bad state of each bound is checked as an assumption.
+**
+**/
+
+#pragma once
+
+#include "engines/aig_prover.h"
+
+namespace pono {
+
+class AigBmc : public AigProver
+{
+ public:
+  AigBmc(const Property & p,
+         const TransitionSystem & ts,
+         const smt::SmtSolver & solver,
+         PonoOptions opt = PonoOptions());
+
+  ~AigBmc();
+
+  typedef AigProver super;
+
+  void initialize() override;
+
+  ProverResult check_until(int k) override;
+
+ protected:
+  /** Unrolls one more frame */
+  void add_frame();
+
+  /** @return false if the bad state is reachable at bound i
+   *          (the result of the solver is stored in res)
+   */
+  bool step(int i, SatResult & res);
+
+  void compute_witness_frames(int i);
+
+  SatSolver sat_;
+  /** per frame, the SAT variables of the graph variables */
+  std::vector<std::vector<int>> frames_;
+
+};  // class AigBmc
+
+}  // namespace pono
@@ -0,0 +1,460 @@
+/*********************                                                        */
+/*! \file aig_ic3.cpp
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief IC3 / PDR on the bit-blasted system.
+**
+**/
+
+#include "engines/aig_ic3.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "utils/logger.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+AigIC3::AigIC3(const Property & p,
+               const TransitionSystem & ts,
+               const SmtSolver & solver,
+               PonoOptions opt)
+    : super(p, ts, solver, opt), bad_sat_(0)
+{
+  engine_ = Engine::AIG_IC3;
+}
+
+AigIC3::~AigIC3() {}
+
+void AigIC3::initialize()
+{
+  if (initialized_) {
+    return;
+  }
+
+  super::initialize();
+
+  sat_.set_terminate([this]() { return interrupted(); });
+
+  map_ = new_copy(sat_);
+  for (auto in : aig_.inputs()) {
+    encode(sat_, map_, in);
+  }
+  const vector<Aig::Latch> & latches = aig_.latches();
+  for (const auto & l : latches) {
+    encode(sat_, map_, l.lit);
+  }
+  for (const auto & l : latches) {
+    next_.push_back(encode(sat_, map_, l.next));
+  }
+  for (auto c : aig_.constraints()) {
+    sat_.add_clause({ encode(sat_, map_, c) });
+  }
+  bad_sat_ = encode(sat_, map_, bad_lit_);
+
+  // frame 0 is the initial states
+  act_.push_back(sat_.new_var());
+  frames_.push_back({});
+  for (const auto & l : latches) {
+    if (l.init != l.lit) {
+      int x = map_[Aig::var(l.lit)];
+      sat_.add_clause({ -act_[0], (l.init == Aig::aig_true) ? x : -x });
+    }
+  }
+}
+
+ProverResult AigIC3::check_until(int k)
+{
+  initialize();
+
+  for (int i = reached_k_ + 1; i <= k; ++i) {
+    if (interrupted()) {
+      logger.log(1, "AigIC3: interrupted at frame {}", i);
+      return ProverResult::UNKNOWN;
+    }
+    ProverResult res = step(i);
+    if (res != ProverResult::UNKNOWN) {
+      return res;
+    } else if (reached_k_ < i) {
+      logger.log(1, "AigIC3: interrupted at frame {}", i);
+      return ProverResult::UNKNOWN;
+    }
+  }
+  return ProverResult::UNKNOWN;
+}
+
+ProverResult AigIC3::step(int i)
+{
+  if (i <= reached_k_) {
+    return ProverResult::UNKNOWN;
+  }
+
+  if (reached_k_ < 0) {
+    logger.log(1, "Checking if initial states satisfy property");
+    SatResult r = sat_.solve({ act_[0], bad_sat_ });
+    if (r == SatResult::SAT) {
+      obligations_.push_back(extract(0, -1));
+      reconstruct_trace(0);
+      return ProverResult::FALSE;
+    } else if (r == SatResult::UNSAT) {
+      reached_k_ = 0;
+    }
+    return ProverResult::UNKNOWN;
+  }
+
+  if (frames_.size() < (size_t)i + 1) {
+    push_frame();
+  }
+  assert(frames_.size() == (size_t)i + 1);
+
+  logger.log(1, "Blocking phase at frame {}", i);
+  if (!block_all()) {
+    return ProverResult::FALSE;
+  } else if (interrupted()) {
+    return ProverResult::UNKNOWN;
+  }
+
+  logger.log(1, "Propagation phase at frame {}", i);
+  ProverResult res = propagate_all();
+  if (res == ProverResult::TRUE || interrupted()) {
+    return res;
+  }
+
+  ++reached_k_;
+  return ProverResult::UNKNOWN;
+}
+
+bool AigIC3::block_all()
+{
+  size_t k = frames_.size() - 1;
+  vector<int> assumps = frame_assumptions(k);
+  assumps.push_back(bad_sat_);
+
+  while (true) {
+    SatResult r = sat_.solve(assumps);
+    if (r != SatResult::SAT) {
+      return true;
+    }
+
+    obligations_.clear();
+    queue_.clear();
+    obligations_.push_back(extract(k, -1));
+    queue_.insert({ k, SIZE_MAX });
+
+    while (!queue_.empty()) {
+      if (interrupted()) {
+        return true;
+      }
+
+      size_t oi = SIZE_MAX - queue_.begin()->second;
+      queue_.erase(queue_.begin());
+      Obligation & o = obligations_[oi];
+
+      if (!o.idx || intersects_init(state_cube(o.state))) {
+        // reached an initial state
+        reconstruct_trace(oi);
+        return false;
+      }
+
+      if (is_blocked(o)) {
+        if (o.idx < k) {
+          ++o.idx;
+          queue_.insert({ o.idx, SIZE_MAX - oi });
+        }
+        continue;
+      }
+
+      Cube s = state_cube(o.state);
+      Cube core;
+      r = rel_ind(o.idx - 1, s, &core);
+      if (r == SatResult::UNKNOWN) {
+        return true;
+      } else if (r == SatResult::SAT) {
+        // block the predecessor first
+        size_t pi = obligations_.size();
+        obligations_.push_back(extract(o.idx - 1, oi));
+        queue_.insert({ o.idx - 1, SIZE_MAX - pi });
+        queue_.insert({ o.idx, SIZE_MAX - oi });
+        continue;
+      }
+
+      init_fix(core, s);
+      generalize(o.idx, core);
+
+      // push the cube as far as possible
+      size_t j = o.idx;
+      while (j < k && rel_ind(j, core, nullptr) == SatResult::UNSAT) {
+        ++j;
+      }
+      logger.log(3, "Blocked a cube of size {} at frame {}", core.size(), j);
+      add_lemma(j, core);
+      if (j < k) {
+        // look for longer counterexamples through the same state
+        o.idx = j + 1;
+        queue_.insert({ o.idx, SIZE_MAX - oi });
+      }
+    }
+  }
+}
+
+ProverResult AigIC3::propagate_all()
+{
+  push_frame();
+  size_t k = frames_.size() - 2;
+  for (size_t i = 1; i <= k; ++i) {
+    vector<Cube> cubes = frames_[i];
+    for (const auto & c : cubes) {
+      Cube core;
+      SatResult r = rel_ind(i, c, &core);
+      if (r == SatResult::UNKNOWN) {
+        return ProverResult::UNKNOWN;
+      } else if (r == SatResult::UNSAT) {
+        init_fix(core, c);
+        add_lemma(i + 1, core);
+      }
+    }
+
+    if (frames_[i].empty()) {
+      // F[i] = F[i+1] is an inductive invariant
+      logger.log(1, "AigIC3: found a fixpoint at frame {}", i);
+      TermVec clauses;
+      bool expressible = true;
+      for (size_t j = i + 1; j < frames_.size() && expressible; ++j) {
+        for (const auto & c : frames_[j]) {
+          Term clause;
+          for (auto l : c) {
+            Term t = latch_term(Aig::make_lit(Aig::var(l), false));
+            if (!t) {
+              expressible = false;
+              break;
+            }
+            // the clause is the negation of the cube
+            t = Aig::is_negated(l) ? t : solver_->make_term(Not, t);
+            clause = clause ? solver_->make_term(Or, clause, t) : t;
+          }
+          if (!expressible) {
+            break;
+          }
+          clauses.push_back(clause ? clause : solver_->make_term(false));
+        }
+      }
+      if (expressible) {
+        invar_ = solver_->make_term(true);
+        for (const auto & c : clauses) {
+          invar_ = solver_->make_term(And, invar_, c);
+        }
+      } else {
+        logger.log(1,
+                   "AigIC3: the invariant uses latches added by "
+                   "bit-blasting");
+      }
+      return ProverResult::TRUE;
+    }
+  }
+  return ProverResult::UNKNOWN;
+}
+
+void AigIC3::push_frame()
+{
+  frames_.push_back({});
+  act_.push_back(sat_.new_var());
+}
+
+vector<int> AigIC3::frame_assumptions(size_t i) const
+{
+  if (!i) {
+    return { act_[0] };
+  }
+  vector<int> res;
+  for (size_t j = i; j < act_.size(); ++j) {
+    res.push_back(act_[j]);
+  }
+  return res;
+}
+
+SatResult AigIC3::rel_ind(size_t i, const Cube & c, Cube * core)
+{
+  // temporary clause !c, disabled after the query
+  int tmp = sat_.new_var();
+  vector<int> clause({ -tmp });
+  for (auto l : c) {
+    clause.push_back(-cur_lit(l));
+  }
+  sat_.add_clause(clause);
+
+  vector<int> assumps = frame_assumptions(i);
+  assumps.push_back(tmp);
+  for (auto l : c) {
+    assumps.push_back(next_lit(l));
+  }
+  SatResult r = sat_.solve(assumps);
+  if (r == SatResult::UNSAT && core) {
+    core->clear();
+    for (auto l : c) {
+      if (sat_.failed(next_lit(l))) {
+        core->push_back(l);
+      }
+    }
+  }
+  sat_.add_clause({ -tmp });
+  return r;
+}
+
+void AigIC3::generalize(size_t i, Cube & c)
+{
+  Cube lits = c;
+  for (auto l : lits) {
+    if (c.size() <= 1) {
+      break;
+    }
+    auto it = lower_bound(c.begin(), c.end(), l);
+    if (it == c.end() || *it != l) {
+      // already dropped by a core
+      continue;
+    }
+    Cube cand = c;
+    cand.erase(cand.begin() + (it - c.begin()));
+    if (intersects_init(cand)) {
+      continue;
+    }
+    Cube core;
+    SatResult r = rel_ind(i - 1, cand, &core);
+    if (r == SatResult::UNSAT) {
+      init_fix(core, cand);
+      c = core;
+    } else if (r == SatResult::UNKNOWN) {
+      return;
+    }
+  }
+}
+
+bool AigIC3::intersects_init(const Cube & c) const
+{
+  const vector<Aig::Latch> & latches = aig_.latches();
+  for (auto l : c) {
+    const Aig::Latch & latch = latches[aig_.latch_index(
+        Aig::make_lit(Aig::var(l), false))];
+    if (latch.init == latch.lit) {
+      continue;
+    }
+    // the literal is false initially
+    if ((latch.init == Aig::aig_true) == Aig::is_negated(l)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void AigIC3::init_fix(Cube & c, const Cube & full) const
+{
+  if (!intersects_init(c)) {
+    return;
+  }
+  for (auto l : full) {
+    if (!intersects_init({ l })) {
+      c.insert(lower_bound(c.begin(), c.end(), l), l);
+      return;
+    }
+  }
+  assert(false);
+}
+
+void AigIC3::add_lemma(size_t i, const Cube & c)
+{
+  for (size_t j = 1; j <= i; ++j) {
+    vector<Cube> & frame = frames_[j];
+    size_t k = 0;
+    for (size_t m = 0; m < frame.size(); ++m) {
+      if (!includes(
+              frame[m].begin(), frame[m].end(), c.begin(), c.end())) {
+        frame[k++] = frame[m];
+      }
+    }
+    frame.resize(k);
+  }
+  frames_[i].push_back(c);
+
+  vector<int> clause({ -act_[i] });
+  for (auto l : c) {
+    clause.push_back(-cur_lit(l));
+  }
+  sat_.add_clause(clause);
+}
+
+bool AigIC3::is_blocked(const Obligation & o) const
+{
+  for (size_t j = o.idx; j < frames_.size(); ++j) {
+    for (const auto & c : frames_[j]) {
+      bool contains = true;
+      for (auto l : c) {
+        size_t idx = aig_.latch_index(Aig::make_lit(Aig::var(l), false));
+        if (o.state[idx] == Aig::is_negated(l)) {
+          contains = false;
+          break;
+        }
+      }
+      if (contains) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+AigIC3::Obligation AigIC3::extract(size_t idx, int succ) const
+{
+  Obligation o;
+  for (const auto & l : aig_.latches()) {
+    o.state.push_back(sat_.value(map_[Aig::var(l.lit)]));
+  }
+  for (auto in : aig_.inputs()) {
+    o.inputs.push_back(sat_.value(map_[Aig::var(in)]));
+  }
+  o.idx = idx;
+  o.succ = succ;
+  return o;
+}
+
+AigIC3::Cube AigIC3::state_cube(const vector<bool> & state) const
+{
+  const vector<Aig::Latch> & latches = aig_.latches();
+  Cube res;
+  res.reserve(latches.size());
+  for (size_t i = 0; i < latches.size(); ++i) {
+    res.push_back(Aig::negate_if(latches[i].lit, !state[i]));
+  }
+  sort(res.begin(), res.end());
+  return res;
+}
+
+int AigIC3::cur_lit(AigLit l) const
+{
+  int x = map_[Aig::var(l)];
+  return Aig::is_negated(l) ? -x : x;
+}
+
+int AigIC3::next_lit(AigLit l) const
+{
+  int x = next_[aig_.latch_index(Aig::make_lit(Aig::var(l), false))];
+  return Aig::is_negated(l) ? -x : x;
+}
+
+void AigIC3::reconstruct_trace(int o)
+{
+  witness_.clear();
+  for (int i = o; i >= 0; i = obligations_[i].succ) {
+    add_witness_frame(obligations_[i].state, obligations_[i].inputs);
+  }
+}
+
+}  // namespace pono
@@ -0,0 +1,126 @@
+/*********************                                                        */
+/*! \file aig_ic3.h
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief IC3 / PDR on the bit-blasted system.
+**        Frames are sets of cubes over latches, encoded in a single
+**        SatSolver with one activation literal per frame (a cube in
+**        frame i is blocked in all frames up to i). Next states are the
+**        next state functions of the latches, so no primed copy of the
+**        graph is needed. Proof obligations are full states.
+**
+**/
+
+#pragma once
+
+#include <deque>
+#include <set>
+
+#include "engines/aig_prover.h"
+
+namespace pono {
+
+class AigIC3 : public AigProver
+{
+ public:
+  AigIC3(const Property & p,
+         const TransitionSystem & ts,
+         const smt::SmtSolver & solver,
+         PonoOptions opt = PonoOptions());
+
+  ~AigIC3();
+
+  typedef AigProver super;
+
+  void initialize() override;
+
+  ProverResult check_until(int k) override;
+
+  size_t witness_length() const override { return witness_.size() - 1; }
+
+ protected:
+  typedef std::vector<AigLit> Cube;  ///< latch literals, sorted
+
+  struct Obligation
+  {
+    std::vector<bool> state;   ///< values of the latches
+    std::vector<bool> inputs;  ///< values of the inputs in this state
+    size_t idx;                ///< the frame to block the state in
+    int succ;                  ///< successor obligation, -1 for a bad state
+  };
+
+  ProverResult step(int i);
+
+  /** Blocks the bad states in the frontier frame
+   *  @return false if a counterexample was found, true if the bad states
+   *          were blocked or if the search was interrupted
+   */
+  bool block_all();
+
+  /** Propagates cubes forward after adding a frame
+   *  @return TRUE if a fixpoint was found (and sets invar_), UNKNOWN
+   *          otherwise
+   */
+  ProverResult propagate_all();
+
+  void push_frame();
+
+  /** @return the activation literals for frame i */
+  std::vector<int> frame_assumptions(size_t i) const;
+
+  /** Checks whether c is inductive relative to frame i:
+   *  F[i] /\ !c /\ T /\ c'
+   *  @param core if not null and unsat, set to the literals of c whose next
+   *         states were needed
+   */
+  SatResult rel_ind(size_t i, const Cube & c, Cube * core);
+
+  /** Drops literals of c, keeping it inductive relative to frame i-1 */
+  void generalize(size_t i, Cube & c);
+
+  /** @return true if c contains an initial state */
+  bool intersects_init(const Cube & c) const;
+
+  /** Adds back a literal of full to c if c contains an initial state
+   *  full must not contain an initial state
+   */
+  void init_fix(Cube & c, const Cube & full) const;
+
+  /** Adds c to frame i and removes the cubes it subsumes */
+  void add_lemma(size_t i, const Cube & c);
+
+  bool is_blocked(const Obligation & o) const;
+
+  /** Reads a state and its inputs from the last model */
+  Obligation extract(size_t idx, int succ) const;
+
+  Cube state_cube(const std::vector<bool> & state) const;
+
+  int cur_lit(AigLit l) const;
+  int next_lit(AigLit l) const;
+
+  /** Fills witness_ from an obligation reaching the bad states */
+  void reconstruct_trace(int o);
+
+  SatSolver sat_;
+  std::vector<int> map_;   ///< SAT variables of the current state copy
+  std::vector<int> next_;  ///< SAT literals of the next state functions
+  int bad_sat_;
+
+  std::vector<std::vector<Cube>> frames_;  ///< frames_[0] is unused (init)
+  std::vector<int> act_;  ///< activation literals, act_[0] is for init
+
+  std::deque<Obligation> obligations_;
+  /** obligations to handle, the lowest frame and the newest first */
+  std::set<std::pair<size_t, size_t>> queue_;
+
+};  // class AigIC3
+
+}  // namespace pono
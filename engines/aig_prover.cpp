@@ -0,0 +1,122 @@
+/*********************                                                        */
+/*! \file aig_prover.cpp
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Base class for the bit-level engines.
+**
+**/
+
+#include "engines/aig_prover.h"
+
+#include <cassert>
+
+#include "core/aig_cnf.h"
+#include "utils/exceptions.h"
+#include "utils/logger.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+AigProver::AigProver(const Property & p,
+                     const TransitionSystem & ts,
+                     const SmtSolver & solver,
+                     PonoOptions opt)
+    : super(p, ts, solver, opt), bad_lit_(Aig::aig_false)
+{
+}
+
+AigProver::~AigProver() {}
+
+void AigProver::initialize()
+{
+  if (initialized_) {
+    return;
+  }
+
+  super::initialize();
+
+  blaster_.reset(new BitBlaster(ts_, aig_));
+  bad_lit_ = blaster_->blast(bad_).at(0);
+  aig_.add_bad(bad_lit_);
+
+  // named terms are part of witnesses, they are evaluated on the graph
+  for (const auto & elem : ts_.named_terms()) {
+    const Term & t = elem.second;
+    if (ts_.is_curr_var(t) || ts_.is_input_var(t)) {
+      continue;
+    }
+    try {
+      blaster_->blast(t);
+      named_terms_.push_back(t);
+    }
+    catch (PonoException & e) {
+      logger.log(
+          2, "Named term {} is not in witnesses: {}", elem.first, e.what());
+    }
+  }
+
+  logger.log(1,
+             "Bit-blasted to {} inputs, {} latches and {} and gates",
+             aig_.inputs().size(),
+             aig_.latches().size(),
+             aig_.num_ands());
+}
+
+vector<int> AigProver::new_copy(SatSolver & sat)
+{
+  return aig_new_copy(aig_, sat);
+}
+
+int AigProver::encode(SatSolver & sat, vector<int> & map, AigLit l)
+{
+  return aig_encode(aig_, sat, map, l);
+}
+
+void AigProver::add_witness_frame(const vector<bool> & latch_vals,
+                                  const vector<bool> & input_vals)
+{
+  vector<bool> vals = aig_.eval(latch_vals, input_vals);
+
+  witness_.push_back(UnorderedTermMap());
+  UnorderedTermMap & frame = witness_.back();
+  for (const auto & sv : blaster_->states()) {
+    frame[sv] = blaster_->eval(sv, vals);
+  }
+  for (const auto & iv : blaster_->inputs()) {
+    frame[iv] = blaster_->eval(iv, vals);
+  }
+  for (const auto & t : named_terms_) {
+    frame[t] = blaster_->eval(t, vals);
+  }
+}
+
+Term AigProver::latch_term(AigLit l) const
+{
+  assert(!Aig::is_negated(l));
+  for (const auto & sv : blaster_->states()) {
+    const vector<AigLit> & bits = blaster_->var_bits(sv);
+    for (size_t i = 0; i < bits.size(); ++i) {
+      if (bits[i] != l) {
+        continue;
+      }
+      if (sv->get_sort()->get_sort_kind() == BOOL) {
+        return sv;
+      }
+      Term bit = solver_->make_term(Op(Extract, i, i), sv);
+      return solver_->make_term(
+          Equal, bit, solver_->make_term(1, solver_->make_sort(BV, 1)));
+    }
+  }
+  return Term();
+}
+
+}  // namespace pono
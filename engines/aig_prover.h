@@ -0,0 +1,87 @@
+/*********************                                                        */
+/*! \file aig_prover.h
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Base class for the bit-level engines.
+**        The system is bit-blasted to an and-inverter graph once, and the
+**        engines query a SatSolver over literals of the graph, without
+**        creating terms. Terms are only created for witnesses and
+**        invariants.
+**
+**/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "core/aig.h"
+#include "core/bit_blaster.h"
+#include "engines/prover.h"
+#include "smt/sat_solver.h"
+
+namespace pono {
+
+class AigProver : public Prover
+{
+ public:
+  /** @param ts a functional transition system over booleans and
+   *         bit-vectors, see BitBlaster
+   */
+  AigProver(const Property & p,
+            const TransitionSystem & ts,
+            const smt::SmtSolver & solver,
+            PonoOptions opt = PonoOptions());
+
+  virtual ~AigProver();
+
+  typedef Prover super;
+
+  /** Bit-blasts the system and the bad states
+   *  throws a PonoException if the system cannot be bit-blasted
+   */
+  void initialize() override;
+
+ protected:
+  /** @return a map for a new copy of the graph in sat, only the constant
+   *          is mapped
+   */
+  std::vector<int> new_copy(SatSolver & sat);
+
+  /** Encodes the cone of l in one copy of the graph
+   *  @param sat the solver to add the gates to
+   *  @param map SAT variables of the graph variables in this copy (0 if not
+   *         encoded yet), inputs and latches that are not mapped get fresh
+   *         variables
+   *  @return the SAT literal of l
+   */
+  int encode(SatSolver & sat, std::vector<int> & map, AigLit l);
+
+  /** Appends a state of the system to witness_
+   *  @param latch_vals the values of aig_.latches()
+   *  @param input_vals the values of aig_.inputs()
+   */
+  void add_witness_frame(const std::vector<bool> & latch_vals,
+                         const std::vector<bool> & input_vals);
+
+  /** @return a term for a latch literal, null if the latch is not a bit
+   *          of a state variable
+   */
+  smt::Term latch_term(AigLit l) const;
+
+  Aig aig_;
+  std::unique_ptr<BitBlaster> blaster_;
+  AigLit bad_lit_;
+
+  /** named terms that could be bit-blasted, for witnesses */
+  smt::TermVec named_terms_;
+};
+
+}  // namespace pono
@@ -51,6 +51,10 @@ ProverResult Bmc::check_until(int k)
   initialize();
 
   for (int i = reached_k_ + 1; i <= k; ++i) {
+    if (interrupted()) {
+      logger.log(1, "Bmc interrupted at bound: {}", i);
+      return ProverResult::UNKNOWN;
+    }
     if (!step(i)) {
       compute_witness();
       return ProverResult::FALSE;
@@ -80,6 +84,10 @@ bool Bmc::step(int i)
     solver_->pop();
     ++reached_k_;
   }
+  if (i > 0) {
+    // step i + 1 unrolls trans at time i and bad at time i + 1
+    unroller_.clear_subterm_cache_before(i - 1);
+  }
 
   return res;
 }
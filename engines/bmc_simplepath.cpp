@@ -37,6 +37,10 @@ ProverResult BmcSimplePath::check_until(int k)
   initialize();
 
   for (int i = 0; i <= k; ++i) {
+    if (interrupted()) {
+      logger.log(1, "BmcSimplePath interrupted at bound: {}", i);
+      return ProverResult::UNKNOWN;
+    }
     logger.log(1, "Checking Bmc at bound: {}", i);
     if (!base_step(i)) {
       compute_witness();
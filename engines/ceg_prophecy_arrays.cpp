@@ -85,6 +85,9 @@ ProverResult CegProphecyArrays<MsatIC3IA>::prove()
     // Refine the system
     // heuristic -- stop refining when no new axioms are needed.
     do {
+      if (super::interrupted()) {
+        return ProverResult::UNKNOWN;
+      }
       if (!CegProphecyArrays::cegar_refine()) {
         // real counterexample
         return ProverResult::FALSE;
@@ -98,6 +101,7 @@ ProverResult CegProphecyArrays<MsatIC3IA>::prove()
                                     super::engine_, false);
     shared_ptr<Prover> prover = make_prover(super::engine_, latest_prop,
                                             abs_ts_, s, super::options_);
+    prover->set_cancel_token(super::cancel_token_);
     res = prover->prove();
 
     if (res == ProverResult::FALSE) {
@@ -137,6 +141,9 @@ ProverResult CegProphecyArrays<Prover_T>::check_until(int k)
     // Refine the system
     // heuristic -- stop refining when no new axioms are needed.
     do {
+      if (super::interrupted()) {
+        return ProverResult::UNKNOWN;
+      }
       if (!CegProphecyArrays::cegar_refine()) {
         return ProverResult::FALSE;
       }
@@ -150,6 +157,7 @@ ProverResult CegProphecyArrays<Prover_T>::check_until(int k)
                                       super::engine_, false);
       shared_ptr<Prover> prover = make_prover(super::engine_, latest_prop,
                                               abs_ts_, s, super::options_);
+      prover->set_cancel_token(super::cancel_token_);
       res = prover->check_until(k);
 
       if (res == ProverResult::FALSE) {
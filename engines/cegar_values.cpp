@@ -194,6 +194,9 @@ ProverResult CegarValues<Prover_T>::check_until(int k)
     res = super::check_until(k);
 
     if (res == ProverResult::FALSE) {
+      if (super::interrupted()) {
+        return ProverResult::UNKNOWN;
+      }
       if (!cegar_refine()) {
         return ProverResult::FALSE;
       }
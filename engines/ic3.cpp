@@ -18,6 +18,7 @@
 #include <random>
 
 #include "assert.h"
+#include "core/ternary_simulator.h"
 #include "utils/term_analysis.h"
 
 using namespace smt;
@@ -91,6 +92,21 @@ void IC3::predecessor_generalization(size_t i,
     return;
   }
 
+  if (options_.ic3_ternary_pregen_ && ts_.is_deterministic()) {
+    // the successor is a function of the predecessor and the inputs, drop
+    // the literals it does not depend on without solver calls
+    UnorderedTermMap inputs;
+    for (const auto & iv : ts_.inputvars()) {
+      inputs[iv] = solver_->get_value(iv);
+    }
+    TermVec red_cube_lits =
+        TernarySimulator(ts_).generalize(cube_lits, inputs, c);
+    if (red_cube_lits.size()) {
+      pred = ic3formula_conjunction(red_cube_lits);
+    }
+    return;
+  }
+
   Term formula = make_and(input_lits);
   if (ts_.is_deterministic()) {
     // NOTE: need to use full trans, not just trans_label_ here
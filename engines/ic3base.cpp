@@ -17,8 +17,14 @@
 
 #include "engines/ic3base.h"
 
+#include <exception>
+#include <fstream>
+#include <thread>
+
 #include "assert.h"
+#include "core/ts_snapshot.h"
 #include "smt/available_solvers.h"
+#include "utils/invariant_miner.h"
 #include "utils/logger.h"
 #include "utils/term_analysis.h"
 
@@ -40,23 +46,6 @@ static bool term_hash_lt(const smt::Term & t0, const smt::Term & t1)
   return (t0->hash() < t1->hash());
 }
 
-/** Syntactic subsumption check for clauses: ? a subsumes b ?
- *  @param IC3Formula a
- *  @param IC3Formula b
- *  returns true iff 'a subsumes b'
- */
-static bool subsumes(const IC3Formula &a, const IC3Formula &b)
-{
-  assert(a.disjunction);
-  assert(a.disjunction == b.disjunction);
-  const TermVec &ac = a.children;
-  const TermVec &bc = b.children;
-  // NOTE: IC3Formula children are sorted on construction
-  //       Uses unique id of term, from term->get_id()
-  return ac.size() <= bc.size()
-         && std::includes(bc.begin(), bc.end(), ac.begin(), ac.end());
-}
-
 /** ProofGoalQueue */
 
 ProofGoalQueue::~ProofGoalQueue() { clear(); }
@@ -87,6 +76,225 @@ void ProofGoalQueue::pop() { queue_.pop(); }
 
 bool ProofGoalQueue::empty() const { return queue_.empty(); }
 
+/** LemmaIndex */
+
+void LemmaIndex::clear()
+{
+  lemmas_.clear();
+  occurs_.clear();
+  by_term_.clear();
+  num_dead_ = 0;
+}
+
+void LemmaIndex::add(const IC3Formula & c, size_t i)
+{
+  assert(c.disjunction);
+  size_t id = lemmas_.size();
+  lemmas_.push_back({ c.term, c.children, signature(c.children), i, false });
+  for (const auto & l : c.children) {
+    occurs_[l].push_back(id);
+  }
+  by_term_[c.term].push_back(id);
+}
+
+void LemmaIndex::remove(const IC3Formula & c, size_t i)
+{
+  auto it = by_term_.find(c.term);
+  if (it == by_term_.end()) {
+    return;
+  }
+  for (auto id : it->second) {
+    if (!lemmas_[id].dead && lemmas_[id].frame == i) {
+      kill(id);
+      break;
+    }
+  }
+  compact();
+}
+
+bool LemmaIndex::subsumes(const IC3Formula & c, size_t i) const
+{
+  assert(c.disjunction);
+  const TermVec & cl = c.children;
+  uint64_t sig = signature(cl);
+  for (const auto & l : cl) {
+    auto it = occurs_.find(l);
+    if (it == occurs_.end()) {
+      continue;
+    }
+    for (auto id : it->second) {
+      const Lemma & a = lemmas_[id];
+      // each lemma is only checked at the occurrence of its first literal
+      if (a.dead || a.frame < i || a.lits[0] != l || (a.sig & ~sig)
+          || a.lits.size() > cl.size()) {
+        continue;
+      }
+      if (std::includes(cl.begin(), cl.end(), a.lits.begin(), a.lits.end())) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void LemmaIndex::remove_subsumed(const IC3Formula & c,
+                                 size_t i,
+                                 vector<pair<size_t, Term>> & out)
+{
+  assert(c.disjunction);
+  const TermVec & cl = c.children;
+  // a subsumed lemma contains every literal of c, it is enough to look at
+  // the shortest occurrence list
+  const vector<size_t> * candidates = nullptr;
+  for (const auto & l : cl) {
+    auto it = occurs_.find(l);
+    if (it == occurs_.end()) {
+      return;
+    }
+    if (!candidates || it->second.size() < candidates->size()) {
+      candidates = &it->second;
+    }
+  }
+  if (!candidates) {
+    return;
+  }
+
+  uint64_t sig = signature(cl);
+  for (auto id : *candidates) {
+    const Lemma & b = lemmas_[id];
+    if (b.dead || b.frame > i || (sig & ~b.sig) || cl.size() > b.lits.size()) {
+      continue;
+    }
+    if (std::includes(b.lits.begin(), b.lits.end(), cl.begin(), cl.end())) {
+      out.push_back({ b.frame, b.term });
+      kill(id);
+    }
+  }
+  compact();
+}
+
+uint64_t LemmaIndex::signature(const TermVec & lits)
+{
+  uint64_t sig = 0;
+  for (const auto & l : lits) {
+    sig |= uint64_t(1) << (l->hash() % 64);
+  }
+  return sig;
+}
+
+void LemmaIndex::kill(size_t id)
+{
+  assert(!lemmas_[id].dead);
+  lemmas_[id].dead = true;
+  ++num_dead_;
+}
+
+void LemmaIndex::compact()
+{
+  if (num_dead_ < 64 || 2 * num_dead_ < lemmas_.size()) {
+    return;
+  }
+  vector<Lemma> live;
+  live.reserve(lemmas_.size() - num_dead_);
+  for (auto & a : lemmas_) {
+    if (!a.dead) {
+      live.push_back(std::move(a));
+    }
+  }
+  clear();
+  for (auto & a : live) {
+    size_t id = lemmas_.size();
+    for (const auto & l : a.lits) {
+      occurs_[l].push_back(id);
+    }
+    by_term_[a.term].push_back(id);
+    lemmas_.push_back(std::move(a));
+  }
+}
+
+/** FrameSolver */
+
+FrameSolver::FrameSolver(const SmtSolver & solver, const Term & trans)
+    : solver_(solver), to_solver_(solver), min_frame_(0)
+{
+  trans_label_ = solver_->make_symbol("__frame_solver_trans_label",
+                                      solver_->make_sort(BOOL));
+  solver_->assert_formula(
+      solver_->make_term(Implies, trans_label_, transfer(trans)));
+}
+
+void FrameSolver::add(const Term & t) { solver_->assert_formula(transfer(t)); }
+
+void FrameSolver::add_lemma(const Term & t, size_t i)
+{
+  while (frame_labels_.size() <= i) {
+    frame_labels_.push_back(solver_->make_symbol(
+        "__frame_solver_frame_label_" + std::to_string(frame_labels_.size()),
+        solver_->make_sort(BOOL)));
+  }
+  solver_->assert_formula(
+      solver_->make_term(Implies, frame_labels_[i], transfer(t)));
+}
+
+bool FrameSolver::rel_ind(const Term & not_c,
+                          const TermVec & next_lits,
+                          vector<bool> & in_core)
+{
+  solver_->push();
+  solver_->assert_formula(not_c);
+  TermVec assumps;
+  assumps.reserve(next_lits.size() + 1);
+  for (const auto & nl : next_lits) {
+    auto it = labels_.find(nl);
+    if (it == labels_.end()) {
+      Term lbl = solver_->make_symbol(
+          "__frame_solver_label_" + std::to_string(labels_.size()),
+          solver_->make_sort(BOOL));
+      it = labels_.insert({ nl, lbl }).first;
+    }
+    solver_->assert_formula(solver_->make_term(Implies, it->second, nl));
+    assumps.push_back(it->second);
+  }
+  assumps.push_back(trans_label_);
+  for (size_t i = min_frame_; i < frame_labels_.size(); ++i) {
+    assumps.push_back(frame_labels_[i]);
+  }
+
+  Result r = solver_->check_sat_assuming(assumps);
+  assert(!r.is_unknown());
+  if (r.is_unsat()) {
+    UnorderedTermSet core;
+    solver_->get_unsat_assumptions(core);
+    in_core.resize(next_lits.size());
+    for (size_t i = 0; i < next_lits.size(); ++i) {
+      in_core[i] = core.find(assumps[i]) != core.end();
+    }
+  }
+  solver_->pop();
+  return r.is_unsat();
+}
+
+bool FrameSolver::intersects(const Term & t)
+{
+  solver_->push();
+  solver_->assert_formula(t);
+  Result r;
+  if (min_frame_ < frame_labels_.size()) {
+    TermVec assumps(frame_labels_.begin() + min_frame_, frame_labels_.end());
+    r = solver_->check_sat_assuming(assumps);
+  } else {
+    r = solver_->check_sat();
+  }
+  assert(!r.is_unknown());
+  solver_->pop();
+  return r.is_sat();
+}
+
+Term FrameSolver::transfer(const Term & t)
+{
+  return to_solver_.transfer_term(t, BOOL);
+}
+
 /** IC3Base */
 
 IC3Base::IC3Base(const Property & p,
@@ -99,12 +307,21 @@ IC3Base::IC3Base(const Property & p,
       solver_context_(0),
       num_check_sat_since_reset_(0),
       failed_to_reset_solver_(false),
-      approx_pregen_(false)
+      approx_pregen_(false),
+      lemma_exchange_id_(0),
+      checkpoint_restored_(false),
+      last_checkpoint_(chrono::steady_clock::now())
 {
 }
 
 IC3Base::~IC3Base() {}
 
+void IC3Base::set_lemma_exchange(shared_ptr<LemmaExchange> lx)
+{
+  lemma_exchange_ = lx;
+  lemma_exchange_id_ = lemma_exchange_->add_participant(ts_);
+}
+
 void IC3Base::initialize()
 {
   if (initialized_) {
@@ -126,6 +343,9 @@ void IC3Base::initialize()
   assert(solver_context_ == 0);  // expecting to be at base context level
 
   frames_.clear();
+  lemma_index_.clear();
+  frame_solvers_.clear();
+  prop_workers_.clear();
   frame_labels_.clear();
   // first frame is always the initial states
   push_frame();
@@ -159,11 +379,22 @@ ProverResult IC3Base::check_until(int k)
   // ever initializing base classes
   assert(initialized_);
 
+  if (options_.mine_invariants_ && reached_k_ < 0) {
+    size_t num_mined = add_mined_invariants();
+    logger.log(1, "IC3Base: added {} mined invariants to F[1]", num_mined);
+  }
+
   ProverResult res;
   RefineResult ref_res;
   int i = reached_k_ + 1;
   assert(reached_k_ + 1 >= 0);
   while (i <= k) {
+    if (interrupted()) {
+      logger.log(1, "IC3Base: interrupted at frame {}", i);
+      update_checkpoint(true);
+      return ProverResult::UNKNOWN;
+    }
+
     res = step(i);
 
     if (res == ProverResult::FALSE) {
@@ -187,8 +418,15 @@ ProverResult IC3Base::check_until(int k)
     if (res != ProverResult::UNKNOWN) {
       return res;
     }
+
+    if (reached_k_ >= 1 && !solver_context_) {
+      // might warm-start and skip ahead
+      update_checkpoint(false);
+      i = reached_k_ + 1;
+    }
   }
 
+  update_checkpoint(true);
   return ProverResult::UNKNOWN;
 }
 
@@ -264,6 +502,12 @@ IC3Formula IC3Base::inductive_generalization(size_t i, const IC3Formula & c)
   logger.log(
       3, "trying to generalize an IC3Formula of size {}", c.children.size());
 
+  if (options_.ic3_ctg_) {
+    IC3Formula block = ic3formula_negate(ctg_generalization(i, c, 0));
+    assert(block.disjunction);
+    return block;
+  }
+
   // TODO use unsat core reducer
   // TODO use ic3_gen_max_iter_ option or remove it
   //      maybe default zero could mean unbounded
@@ -330,6 +574,99 @@ IC3Formula IC3Base::inductive_generalization(size_t i, const IC3Formula & c)
   return block;
 }
 
+IC3Formula IC3Base::ctg_generalization(size_t i,
+                                       const IC3Formula & c,
+                                       size_t depth)
+{
+  assert(!solver_context_);
+  assert(!c.disjunction);
+
+  // literals that occur often in lemmas are likely needed, try to drop the
+  // others first
+  TermVec order = c.children;
+  auto activity = [this](const Term & l) {
+    auto it = lit_activity_.find(l);
+    return it == lit_activity_.end() ? 0.0 : it->second;
+  };
+  std::stable_sort(
+      order.begin(), order.end(), [&activity](const Term & a, const Term & b) {
+        return activity(a) < activity(b);
+      });
+
+  IC3Formula gen = c;
+  for (const auto & l : order) {
+    if (gen.children.size() <= 1) {
+      break;
+    }
+    TermVec children;
+    children.reserve(gen.children.size());
+    for (const auto & cc : gen.children) {
+      if (cc != l) {
+        children.push_back(cc);
+      }
+    }
+    if (children.size() == gen.children.size()) {
+      // already dropped by an unsat core or a join
+      continue;
+    }
+    IC3Formula cand = ic3formula_conjunction(children);
+    if (ctg_down(i, cand, depth)) {
+      gen = cand;
+    }
+  }
+
+  for (const auto & l : gen.children) {
+    lit_activity_[l] += 1.0;
+  }
+
+  logger.log(3,
+             "ctg generalization at depth {} reduced {} literals to {}",
+             depth,
+             c.children.size(),
+             gen.children.size());
+  return gen;
+}
+
+bool IC3Base::ctg_down(size_t i, IC3Formula & c, size_t depth)
+{
+  size_t num_ctgs = 0;
+  IC3Formula out;
+  TermVec join;
+  while (true) {
+    if (check_intersects_initial(c.term)) {
+      return false;
+    }
+    if (ctg_rel_ind_check(i, c, out, join)) {
+      c = out;
+      return true;
+    }
+
+    // out is a counterexample to generalization, try blocking it at i-1
+    if (depth < options_.ic3_ctg_depth_ && num_ctgs < options_.ic3_ctg_max_
+        && i > 1 && !check_intersects_initial(out.term)) {
+      IC3Formula ctg = out;
+      TermVec unused;
+      if (ctg_rel_ind_check(i - 1, ctg, out, unused)) {
+        ++num_ctgs;
+        IC3Formula blocking =
+            ic3formula_negate(ctg_generalization(i - 1, out, depth + 1));
+        size_t j = find_highest_frame(i - 1, blocking);
+        constrain_frame(j, blocking);
+        continue;
+      }
+    }
+
+    // keep the literals that hold in the counterexample, which is then
+    // no longer outside of c
+    num_ctgs = 0;
+    assert(join.size() < c.children.size());
+    if (join.empty()) {
+      return false;
+    }
+    c = ic3formula_conjunction(join);
+  }
+}
+
 void IC3Base::predecessor_generalization(size_t i,
                                          const Term & c,
                                          IC3Formula & pred)
@@ -384,16 +721,33 @@ ProverResult IC3Base::step(int i)
   // at this point there are reached_k_ + 1 frames that don't
   // intersect bad, and reached_k_ + 2 frames overall
   assert(reached_k_ == frontier_idx());
+
+  if (lemma_exchange_) {
+    size_t num_imported = import_lemmas();
+    logger.log(2, "Imported {} lemmas from other instances", num_imported);
+  }
+
   logger.log(1, "Blocking phase at frame {}", i);
   if (!block_all()) {
     // counter-example
     return ProverResult::FALSE;
   }
 
+  if (interrupted()) {
+    // block_all stops early when interrupted, so the frontier
+    // is not guaranteed to block bad -- can't propagate
+    return ProverResult::UNKNOWN;
+  }
+
   logger.log(1, "Propagation phase at frame {}", i);
   // propagation phase
   push_frame();
   for (size_t j = 1; j < frontier_idx(); ++j) {
+    if (interrupted()) {
+      // the frames are still valid without propagating the rest
+      logger.log(1, "IC3Base: interrupted during propagation at frame {}", j);
+      break;
+    }
     if (propagate(j)) {
       assert(j + 1 < frames_.size());
       // save the invariant
@@ -470,38 +824,11 @@ bool IC3Base::rel_ind_check(size_t i,
   assert(!c.disjunction);
 
   assert(solver_context_ == 0);
-  push_solver_context();
-
-  // F[i-1]
-  assert_frame_labels(i - 1);
-  // -c
-  solver_->assert_formula(solver_->make_term(Not, c.term));
-  // Trans
-  assert_trans_label();
-
-  // use assumptions for c' so we can get cheap initial
-  // generalization if the check is unsat
-
-  // NOTE: relying on same order between assumps_ and c.children
-  assumps_.clear();
-  {
-    // TODO shuffle assumps and (a copy of) c.children
-    //      if random seed is set
-    Term lbl, ccnext;
-    for (const auto & cc : c.children) {
-      ccnext = ts_.next(cc);
-      lbl = label(ccnext);
-      if (lbl != ccnext && !is_global_label(lbl)) {
-        // only need to add assertion if the label is not the same as ccnext
-        // could be the same if ccnext is already a literal
-        // and is not already in a global assumption
-        solver_->assert_formula(solver_->make_term(Implies, lbl, ccnext));
-      }
-      assumps_.push_back(lbl);
-    }
+  if (options_.ic3_frame_solvers_ && !get_pred) {
+    return frame_rel_ind_check(i, c, out);
   }
 
-  Result r = check_sat_assuming(assumps_);
+  Result r = check_rel_ind_query(i, c);
   if (r.is_sat()) {
     if (get_pred) {
       out = get_model_ic3formula();
@@ -513,36 +840,9 @@ bool IC3Base::rel_ind_check(size_t i,
       }
     }
     assert(ic3formula_check_valid(out));
-  } else if (options_.ic3_unsatcore_gen_) {
-    assert(r.is_unsat());  // not expecting to get unknown
-
-    // Use unsat core to get cheap generalization
-    UnorderedTermSet core;
-    solver_->get_unsat_assumptions(core);
-    assert(core.size());
-
-    TermVec gen;  // cheap unsat-core generalization of c
-    TermVec rem;  // conjuncts removed by unsat core
-    // might need to be re-added if it
-    // ends up intersecting with initial
-    assert(assumps_.size() == c.children.size());
-    for (size_t i = 0; i < assumps_.size(); ++i) {
-      if (core.find(assumps_.at(i)) == core.end()) {
-        rem.push_back(c.children.at(i));
-      } else {
-        gen.push_back(c.children.at(i));
-      }
-    }
-
-    fix_if_intersects_initial(gen, rem);
-    assert(gen.size() >= core.size());
-
-    // keep it as a conjunction for now
-    out = ic3formula_conjunction(gen);
   } else {
     assert(r.is_unsat());  // not expecting to get unknown
-    // don't generalize with an unsat core, just keep c
-    out = c;
+    out = reduce_with_unsat_core(c);
   }
 
   pop_solver_context();
@@ -566,6 +866,35 @@ bool IC3Base::rel_ind_check(size_t i,
   return r.is_unsat();
 }
 
+bool IC3Base::ctg_rel_ind_check(size_t i,
+                                const IC3Formula & c,
+                                IC3Formula & out,
+                                TermVec & join)
+{
+  assert(i > 0);
+  assert(i < frames_.size());
+  assert(!c.disjunction);
+
+  assert(solver_context_ == 0);
+  Result r = check_rel_ind_query(i, c);
+  if (r.is_sat()) {
+    out = get_model_ic3formula();
+    join.clear();
+    for (const auto & cc : c.children) {
+      if (solver_->get_value(cc) == solver_true_) {
+        join.push_back(cc);
+      }
+    }
+  } else {
+    assert(r.is_unsat());  // not expecting to get unknown
+    out = reduce_with_unsat_core(c);
+  }
+  pop_solver_context();
+  assert(!solver_context_);
+
+  return r.is_unsat();
+}
+
 // Helper methods
 
 bool IC3Base::block_all()
@@ -579,6 +908,13 @@ bool IC3Base::block_all()
     proof_goals.new_proof_goal(goal, frontier_idx(), nullptr);
 
     while (!proof_goals.empty()) {
+      if (interrupted()) {
+        // give up on the remaining proof goals
+        // caller checks interrupted() before using the frames
+        proof_goals.clear();
+        return true;
+      }
+
       const ProofGoal * pg = proof_goals.top();
 
       if (!pg->idx) {
@@ -632,6 +968,9 @@ bool IC3Base::block_all()
         assert(collateral.term);
         assert(collateral.children.size());
         constrain_frame(idx, collateral);
+        if (lemma_exchange_) {
+          lemma_exchange_->publish(lemma_exchange_id_, collateral.children);
+        }
 
         // re-add the proof goal at a higher frame if not blocked
         // up to the frontier
@@ -654,20 +993,214 @@ bool IC3Base::block_all()
   return true;
 }
 
-bool IC3Base::is_blocked(const ProofGoal * pg)
+size_t IC3Base::import_lemmas()
 {
-  // syntactic check
-  for (size_t i = pg->idx; i < frames_.size(); ++i) {
-    const vector<IC3Formula> & Fi = frames_.at(i);
-    for (size_t j = 0; j < Fi.size(); ++j) {
-      if (subsumes(Fi[j], ic3formula_negate(pg->target))) {
-        return true;
+  assert(!solver_context_);
+  assert(lemma_exchange_);
+
+  size_t num_imported = 0;
+  IC3Formula gen;
+  for (const auto & children : lemma_exchange_->collect(lemma_exchange_id_)) {
+    IC3Formula clause = ic3formula_disjunction(children);
+    if (!ic3formula_check_valid(clause) || !ts_.only_curr(clause.term)) {
+      // e.g. learned by a different flavor of IC3
+      continue;
+    }
+
+    IC3Formula cube = ic3formula_negate(clause);
+    if (check_intersects_initial(cube.term)
+        || !rel_ind_check(1, cube, gen, false)) {
+      // not valid in F[1] of this instance
+      continue;
+    }
+
+    clause = ic3formula_negate(gen);
+    size_t idx = find_highest_frame(1, clause);
+    constrain_frame(idx, clause);
+    num_imported++;
+  }
+  return num_imported;
+}
+
+size_t IC3Base::add_mined_invariants()
+{
+  assert(!solver_context_);
+  assert(frames_.size() > 1);
+
+  InvariantMiner miner(ts_, solver_, options_);
+  size_t num_added = 0;
+  for (const auto & children : miner.mine()) {
+    IC3Formula clause = ic3formula_disjunction(children);
+    if (!ic3formula_check_valid(clause)) {
+      continue;
+    }
+    constrain_frame(1, clause);
+    num_added++;
+  }
+  return num_added;
+}
+
+void IC3Base::save_checkpoint(const string & filename) const
+{
+  // meta: engine, frontier, number of lemmas in frames 1 to frontier
+  vector<uint64_t> meta = { static_cast<uint64_t>(engine_),
+                            frames_.size() - 1 };
+  // first list is the abstraction, then one list per lemma
+  vector<TermVec> lists = { abstraction_terms() };
+  for (size_t i = 1; i < frames_.size(); ++i) {
+    meta.push_back(frames_[i].size());
+    for (const auto & c : frames_[i]) {
+      lists.push_back(c.children);
+    }
+  }
+  write_term_lists(filename, ts_, meta, lists);
+  logger.log(1,
+             "IC3Base: saved checkpoint {} with {} frames and {} lemmas",
+             filename,
+             frames_.size(),
+             lists.size() - 1);
+}
+
+size_t IC3Base::restore_checkpoint(const string & filename)
+{
+  assert(!solver_context_);
+  assert(reached_k_ == 1);
+  assert(frontier_idx() == 1);
+
+  vector<uint64_t> meta;
+  vector<TermVec> lists;
+  try {
+    lists = read_term_lists(filename, ts_, meta);
+  }
+  catch (PonoException & e) {
+    logger.log(0, "Warning: ignoring IC3 checkpoint {}: {}", filename, e.what());
+    return 0;
+  }
+
+  size_t num_lemmas = 0;
+  for (size_t i = 2; i < meta.size(); ++i) {
+    num_lemmas += meta[i];
+  }
+  if (meta.size() < 2 || lists.empty() || meta.size() != meta[1] + 2
+      || lists.size() != num_lemmas + 1) {
+    logger.log(0, "Warning: ignoring malformed IC3 checkpoint {}", filename);
+    return 0;
+  }
+  if (meta[0] != engine_) {
+    logger.log(1,
+               "IC3Base: checkpoint {} was written by {}",
+               filename,
+               to_string(static_cast<Engine>(meta[0])));
+  }
+
+  restore_abstraction(lists[0]);
+
+  // lemmas that hold in the initial states
+  // with the highest frame they can be restored to
+  vector<pair<IC3Formula, size_t>> candidates;
+  size_t pos = 1;
+  for (size_t lvl = 1; lvl <= meta[1]; ++lvl) {
+    for (size_t n = 0; n < meta[lvl + 1]; ++n) {
+      IC3Formula clause = ic3formula_disjunction(lists[pos++]);
+      if (!ic3formula_check_valid(clause) || !ts_.only_curr(clause.term)
+          || check_intersects_initial(ic3formula_negate(clause).term)) {
+        continue;
       }
+      candidates.push_back({ clause, lvl });
+    }
+  }
+
+  size_t num_restored = 0;
+  IC3Formula gen;
+  for (size_t j = 1; !candidates.empty(); ++j) {
+    // a lemma that is not inductive relative to F[j-1]
+    // won't be relative to any later frame either
+    size_t k = 0;
+    for (size_t l = 0; l < candidates.size(); ++l) {
+      const IC3Formula & clause = candidates[l].first;
+      if (!rel_ind_check(j, ic3formula_negate(clause), gen, false)) {
+        continue;
+      }
+      // moves the lemma up from frame j-1 if it was there
+      constrain_frame(j, clause);
+      if (j == 1) {
+        num_restored++;
+      }
+      if (candidates[l].second > j) {
+        candidates[k++] = candidates[l];
+      }
+    }
+    candidates.resize(k);
+
+    if (candidates.empty()) {
+      break;
+    }
+
+    // only open a new frame once the frontier blocks bad
+    push_solver_context();
+    assert_frame_labels(j);
+    solver_->assert_formula(ts_.next(bad_));
+    solver_->assert_formula(trans_label_);
+    Result r = check_sat();
+    pop_solver_context();
+    if (!r.is_unsat()) {
+      break;
+    }
+    push_frame();
+    ++reached_k_;
+    assert(reached_k_ == frontier_idx());
+  }
+
+  logger.log(1,
+             "IC3Base: restored {} of {} lemmas and {} frames from {}",
+             num_restored,
+             num_lemmas,
+             frames_.size(),
+             filename);
+  return num_restored;
+}
+
+void IC3Base::update_checkpoint(bool force)
+{
+  const string & filename = options_.ic3_checkpoint_;
+  if (filename.empty() || solver_context_) {
+    return;
+  }
+
+  // a forced save (e.g. on cancellation) always writes the checkpoint
+  if (!force && !checkpoint_restored_ && reached_k_ == 1) {
+    checkpoint_restored_ = true;
+    ifstream f(filename);
+    if (f.good()) {
+      f.close();
+      restore_checkpoint(filename);
+      return;
     }
   }
 
+  auto now = chrono::steady_clock::now();
+  if (!force
+      && now - last_checkpoint_
+             < chrono::seconds(options_.ic3_checkpoint_interval_)) {
+    return;
+  }
+  last_checkpoint_ = now;
+  save_checkpoint(filename);
+}
+
+bool IC3Base::is_blocked(const ProofGoal * pg)
+{
+  // syntactic check
+  if (lemma_index_.subsumes(ic3formula_negate(pg->target), pg->idx)) {
+    return true;
+  }
+
   // now semantic check
   assert(solver_context_ == 0);
+  if (options_.ic3_frame_solvers_) {
+    FrameSolver & fs = frame_solver(pg->idx);
+    return !fs.intersects(fs.transfer(pg->target.term));
+  }
 
   push_solver_context();
   assert_frame_labels(pg->idx);
@@ -685,6 +1218,17 @@ bool IC3Base::propagate(size_t i)
 
   vector<IC3Formula> & Fi = frames_.at(i);
 
+  // a worker needs enough lemmas to pay for its thread
+  const size_t min_lemmas_per_worker = 8;
+  size_t num_workers = options_.ic3_prop_threads_;
+  if (!num_workers) {
+    num_workers = std::max(1u, thread::hardware_concurrency());
+  }
+  num_workers = std::min(num_workers, Fi.size() / min_lemmas_per_worker);
+  if (num_workers > 1) {
+    return parallel_propagate(i, num_workers);
+  }
+
   size_t k = 0;
   IC3Formula gen;
   for (size_t j = 0; j < Fi.size(); ++j) {
@@ -704,7 +1248,9 @@ bool IC3Base::propagate(size_t i)
     } else {
       // have to keep this one at this frame
       Fi[k++] = c;
+      continue;
     }
+    lemma_index_.remove(c, i);
   }
 
   // get rid of garbage at end of frame
@@ -713,6 +1259,110 @@ bool IC3Base::propagate(size_t i)
   return Fi.empty();
 }
 
+bool IC3Base::parallel_propagate(size_t i, size_t num_workers)
+{
+  assert(!solver_context_);
+  assert(num_workers > 1);
+
+  vector<IC3Formula> & Fi = frames_.at(i);
+  const size_t n = Fi.size();
+
+  // the workers are built once (and again when trans changes), new
+  // lemmas are added to them by constrain_frame
+  if (ts_.trans() != prop_workers_trans_) {
+    prop_workers_.clear();
+    prop_workers_trans_ = ts_.trans();
+  }
+  while (prop_workers_.size() < num_workers) {
+    SmtSolver s = create_reducer_for(solver_->get_solver_enum(),
+                                     Engine::IC3IA_ENGINE,
+                                     options_.logging_smt_solver_);
+    prop_workers_.emplace_back(new FrameSolver(s, ts_.trans()));
+    FrameSolver & fs = *prop_workers_.back();
+    fs.add(smart_not(bad_));
+    for (size_t j = 1; j < frames_.size(); ++j) {
+      for (const auto & c : frames_[j]) {
+        fs.add_lemma(c.term, j);
+      }
+    }
+    logger.log(
+        3, "IC3Base: created propagation worker {}", prop_workers_.size());
+  }
+
+  // the terms of the engine are only touched here, the workers only use
+  // their own solver
+  vector<FrameSolver *> workers;
+  for (size_t t = 0; t < num_workers; ++t) {
+    workers.push_back(prop_workers_[t].get());
+    workers.back()->set_frame(i);
+  }
+  vector<Term> not_cubes(n);
+  vector<TermVec> next_lits(n);
+  vector<IC3Formula> cubes;
+  cubes.reserve(n);
+  for (size_t j = 0; j < n; ++j) {
+    FrameSolver & fs = *workers[j % num_workers];
+    cubes.push_back(ic3formula_negate(Fi[j]));
+    not_cubes[j] = fs.transfer(solver_->make_term(Not, cubes[j].term));
+    for (const auto & cc : cubes[j].children) {
+      next_lits[j].push_back(fs.transfer(ts_.next(cc)));
+    }
+  }
+
+  // worker t checks lemmas t, t + num_workers, ...
+  vector<char> pushed(n, false);
+  vector<vector<bool>> cores(n);
+  vector<exception_ptr> errors(num_workers);
+  vector<thread> threads;
+  threads.reserve(num_workers);
+  for (size_t t = 0; t < num_workers; ++t) {
+    threads.emplace_back([&, t]() {
+      try {
+        for (size_t j = t; j < n; j += num_workers) {
+          pushed[j] =
+              workers[t]->rel_ind(not_cubes[j], next_lits[j], cores[j]);
+        }
+      }
+      catch (...) {
+        errors[t] = current_exception();
+      }
+    });
+  }
+  for (auto & th : threads) {
+    th.join();
+  }
+  for (const auto & e : errors) {
+    if (e) {
+      rethrow_exception(e);
+    }
+  }
+
+  size_t k = 0;
+  for (size_t j = 0; j < n; ++j) {
+    if (!pushed[j]) {
+      // have to keep this one at this frame
+      Fi[k++] = Fi[j];
+      continue;
+    }
+    IC3Formula gen = options_.ic3_unsatcore_gen_
+                         ? reduce_to_core(cubes[j], cores[j])
+                         : cubes[j];
+    lemma_index_.remove(Fi[j], i);
+    constrain_frame(i + 1, ic3formula_negate(gen), false);
+  }
+  logger.log(3,
+             "IC3Base: {} threads pushed {} of {} lemmas from frame {}",
+             num_workers,
+             n - k,
+             n,
+             i);
+
+  // get rid of garbage at end of frame
+  Fi.resize(k);
+
+  return Fi.empty();
+}
+
 void IC3Base::predecessor_generalization_and_fix(size_t i,
                                                  const Term & c,
                                                  IC3Formula & pred)
@@ -781,11 +1431,19 @@ void IC3Base::constrain_frame(size_t i, const IC3Formula & constraint,
   assert(ts_.only_curr(constraint.term));
 
   if (new_constraint) {
-    for (size_t j = 1; j <= i; ++j) {
-      vector<IC3Formula> & Fj = frames_.at(j);
+    vector<pair<size_t, Term>> removed;
+    lemma_index_.remove_subsumed(constraint, i, removed);
+    // only the frames that lost a lemma need to be compacted
+    unordered_map<size_t, UnorderedTermSet> removed_by_frame;
+    for (const auto & r : removed) {
+      removed_by_frame[r.first].insert(r.second);
+    }
+    for (const auto & elem : removed_by_frame) {
+      vector<IC3Formula> & Fj = frames_.at(elem.first);
+      const UnorderedTermSet & terms = elem.second;
       size_t k = 0;
       for (size_t l = 0; l < Fj.size(); ++l) {
-        if (!subsumes(constraint, Fj[l])) {
+        if (terms.find(Fj[l].term) == terms.end()) {
           Fj[k++] = Fj[l];
         }
       }
@@ -797,6 +1455,14 @@ void IC3Base::constrain_frame(size_t i, const IC3Formula & constraint,
 
   constrain_frame_label(i, constraint);
   frames_.at(i).push_back(constraint);
+  lemma_index_.add(constraint, i);
+  // the frame solvers of frames above i don't need it
+  for (size_t j = 1; j <= i && j < frame_solvers_.size(); ++j) {
+    frame_solvers_[j]->add(constraint.term);
+  }
+  for (auto & w : prop_workers_) {
+    w->add_lemma(constraint.term, i);
+  }
 }
 
 void IC3Base::constrain_frame_label(size_t i, const IC3Formula & constraint)
@@ -890,6 +1556,138 @@ void IC3Base::fix_if_intersects_initial(TermVec & to_keep, const TermVec & rem)
   }
 }
 
+Result IC3Base::check_rel_ind_query(size_t i, const IC3Formula & c)
+{
+  push_solver_context();
+
+  // F[i-1]
+  assert_frame_labels(i - 1);
+  // -c
+  solver_->assert_formula(solver_->make_term(Not, c.term));
+  // Trans
+  assert_trans_label();
+
+  // use assumptions for c' so we can get cheap initial
+  // generalization if the check is unsat
+
+  // NOTE: relying on same order between assumps_ and c.children
+  assumps_.clear();
+  {
+    // TODO shuffle assumps and (a copy of) c.children
+    //      if random seed is set
+    Term lbl, ccnext;
+    for (const auto & cc : c.children) {
+      ccnext = ts_.next(cc);
+      lbl = label(ccnext);
+      if (lbl != ccnext && !is_global_label(lbl)) {
+        // only need to add assertion if the label is not the same as ccnext
+        // could be the same if ccnext is already a literal
+        // and is not already in a global assumption
+        solver_->assert_formula(solver_->make_term(Implies, lbl, ccnext));
+      }
+      assumps_.push_back(lbl);
+    }
+  }
+
+  return check_sat_assuming(assumps_);
+}
+
+IC3Formula IC3Base::reduce_with_unsat_core(const IC3Formula & c)
+{
+  if (!options_.ic3_unsatcore_gen_) {
+    // don't generalize with an unsat core, just keep c
+    return c;
+  }
+
+  // Use unsat core to get cheap generalization
+  UnorderedTermSet core;
+  solver_->get_unsat_assumptions(core);
+  assert(core.size());
+
+  assert(assumps_.size() == c.children.size());
+  vector<bool> in_core(assumps_.size());
+  for (size_t i = 0; i < assumps_.size(); ++i) {
+    in_core[i] = core.find(assumps_.at(i)) != core.end();
+  }
+  return reduce_to_core(c, in_core);
+}
+
+IC3Formula IC3Base::reduce_to_core(const IC3Formula & c,
+                                   const vector<bool> & in_core)
+{
+  TermVec gen;  // cheap unsat-core generalization of c
+  TermVec rem;  // conjuncts removed by unsat core
+  // might need to be re-added if it
+  // ends up intersecting with initial
+  assert(in_core.size() == c.children.size());
+  for (size_t i = 0; i < in_core.size(); ++i) {
+    if (in_core[i]) {
+      gen.push_back(c.children.at(i));
+    } else {
+      rem.push_back(c.children.at(i));
+    }
+  }
+
+  fix_if_intersects_initial(gen, rem);
+
+  // keep it as a conjunction for now
+  return ic3formula_conjunction(gen);
+}
+
+FrameSolver & IC3Base::frame_solver(size_t i)
+{
+  assert(i < frames_.size());
+  if (ts_.init() != frame_solvers_init_
+      || ts_.trans() != frame_solvers_trans_) {
+    frame_solvers_.clear();
+    frame_solvers_init_ = ts_.init();
+    frame_solvers_trans_ = ts_.trans();
+  }
+
+  while (frame_solvers_.size() <= i) {
+    size_t k = frame_solvers_.size();
+    SmtSolver s = create_reducer_for(solver_->get_solver_enum(),
+                                     Engine::IC3IA_ENGINE,
+                                     options_.logging_smt_solver_);
+    frame_solvers_.emplace_back(new FrameSolver(s, ts_.trans()));
+    FrameSolver & fs = *frame_solvers_.back();
+    if (k == 0) {
+      fs.add(ts_.init());
+    } else {
+      fs.add(smart_not(bad_));
+      for (size_t j = k; j < frames_.size(); ++j) {
+        for (const auto & c : frames_[j]) {
+          fs.add(c.term);
+        }
+      }
+    }
+    logger.log(3, "IC3Base: created the solver for frame {}", k);
+  }
+
+  return *frame_solvers_[i];
+}
+
+bool IC3Base::frame_rel_ind_check(size_t i,
+                                  const IC3Formula & c,
+                                  IC3Formula & out)
+{
+  assert(!c.disjunction);
+  FrameSolver & fs = frame_solver(i - 1);
+  TermVec next_lits;
+  next_lits.reserve(c.children.size());
+  for (const auto & cc : c.children) {
+    next_lits.push_back(fs.transfer(ts_.next(cc)));
+  }
+
+  vector<bool> in_core;
+  bool unsat = fs.rel_ind(
+      fs.transfer(solver_->make_term(Not, c.term)), next_lits, in_core);
+  if (unsat) {
+    out = options_.ic3_unsatcore_gen_ ? reduce_to_core(c, in_core) : c;
+  }
+  return unsat;
+}
+
 size_t IC3Base::find_highest_frame(size_t i, IC3Formula & u)
 {
   assert(!solver_context_);
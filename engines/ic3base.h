@@ -64,8 +64,14 @@
 #pragma once
 
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
 #include <queue>
+#include <unordered_map>
+#include <utility>
 
+#include "engines/lemma_exchange.h"
 #include "engines/prover.h"
 #include "smt-switch/utils.h"
 
@@ -153,6 +159,127 @@ class ProofGoalQueue
   std::vector<ProofGoal *> store_;
 };
 
+/**
+ * Index over the lemmas (disjunctions) of the frames for syntactic
+ * subsumption checks.
+ * Each lemma keeps a 64-bit signature with one bit set per literal, which
+ * rejects most candidates without comparing literals, and each literal
+ * keeps an occurrence list of the lemmas containing it, so a query only
+ * visits lemmas that share a literal with the clause.
+ * The literals of a lemma are expected sorted as in IC3Formula.
+ */
+class LemmaIndex
+{
+ public:
+  LemmaIndex() : num_dead_(0) {}
+
+  void clear();
+
+  /** Adds lemma c to frame i */
+  void add(const IC3Formula & c, size_t i);
+
+  /** Removes one copy of lemma c from frame i, if there is one */
+  void remove(const IC3Formula & c, size_t i);
+
+  /** @return true iff a lemma in a frame >= i subsumes the clause c */
+  bool subsumes(const IC3Formula & c, size_t i) const;
+
+  /** Removes the lemmas in frames <= i that are subsumed by the clause c
+   *  @param out the frames and terms of the removed lemmas are appended
+   */
+  void remove_subsumed(const IC3Formula & c,
+                       size_t i,
+                       std::vector<std::pair<size_t, smt::Term>> & out);
+
+  /** @return the number of lemmas in the index */
+  size_t size() const { return lemmas_.size() - num_dead_; }
+
+ private:
+  struct Lemma
+  {
+    smt::Term term;
+    smt::TermVec lits;
+    uint64_t sig;
+    size_t frame;
+    bool dead;
+  };
+
+  static uint64_t signature(const smt::TermVec & lits);
+
+  void kill(size_t id);
+
+  /** drops removed lemmas once they dominate the index */
+  void compact();
+
+  std::vector<Lemma> lemmas_;
+  /** lemmas containing a literal */
+  std::unordered_map<smt::Term, std::vector<size_t>> occurs_;
+  /** lemmas with a given term */
+  std::unordered_map<smt::Term, std::vector<size_t>> by_term_;
+  size_t num_dead_;
+};
+
+/**
+ * A separate solver holding a translated copy of the transition relation
+ * and of a single frame, for relative inductiveness queries that only need
+ * a result and an unsat core (no model).
+ * Used for option --ic3-frame-solvers: a query on frame i only sees the
+ * constraints of frame i, without activation literals for the others.
+ * Also used by the worker threads of option --ic3-prop-threads, which hold
+ * the lemmas of every frame behind activation literals (add_lemma).
+ */
+class FrameSolver
+{
+ public:
+  /** @param solver a fresh solver with unsat assumptions enabled
+   *  @param trans the transition relation (over the terms of the engine)
+   */
+  FrameSolver(const smt::SmtSolver & solver, const smt::Term & trans);
+
+  /** Adds a constraint (over the terms of the engine) to the frame */
+  void add(const smt::Term & t);
+
+  /** Adds a lemma of frame i (over the terms of the engine), which is only
+   *  used by queries on frames up to i (see set_frame)
+   */
+  void add_lemma(const smt::Term & t, size_t i);
+
+  /** Makes the next queries use the lemmas of frames i and above
+   *  (the constraints given to add are always used)
+   */
+  void set_frame(size_t i) { min_frame_ = i; }
+
+  /** @return the boolean term t of the engine over this solver
+   *  the queries below take translated terms, so they can run in another
+   *  thread than the engine once the terms are translated
+   */
+  smt::Term transfer(const smt::Term & t);
+
+  /** Checks whether F /\ not_c /\ T /\ c' is unsat
+   *  @param not_c the negation of a conjunction c, over current states
+   *  @param next_lits the children of c over next states
+   *  @param in_core if unsat, set to whether each child of next_lits is in
+   *         the unsat core
+   *  @return true iff the query is unsat
+   */
+  bool rel_ind(const smt::Term & not_c,
+               const smt::TermVec & next_lits,
+               std::vector<bool> & in_core);
+
+  /** @return true iff F /\ t is satisfiable */
+  bool intersects(const smt::Term & t);
+
+ private:
+  smt::SmtSolver solver_;
+  smt::TermTranslator to_solver_;
+  smt::Term trans_label_;
+  /** assumption labels for the next state literals (over solver_) */
+  smt::UnorderedTermMap labels_;
+  /** activation literals of the lemmas of each frame (add_lemma) */
+  smt::TermVec frame_labels_;
+  size_t min_frame_;  ///< first frame whose lemmas are used in queries
+};
+
 class IC3Base : public Prover
 {
  public:
@@ -177,10 +304,34 @@ class IC3Base : public Prover
 
   size_t witness_length() const override;
 
+  /** Shares learned lemmas with other IC3 instances through lx
+   *  Newly learned frame lemmas are published, and lemmas from
+   *  other instances are imported at the beginning of each step
+   *  if they are inductive relative to this instance's frames.
+   *  Meant for instances of the same IC3 flavor running concurrently.
+   *  @param lx the exchange shared by all the instances
+   */
+  void set_lemma_exchange(std::shared_ptr<LemmaExchange> lx);
+
+  /** Saves the frames and the abstraction (if any) to a checkpoint file
+   *  that a later run on the same system can warm-start from
+   *  With option --ic3-checkpoint this is done periodically (see
+   *  --ic3-checkpoint-interval) and whenever check_until returns unknown
+   *  @param filename the file to write
+   */
+  void save_checkpoint(const std::string & filename) const;
+
  protected:
 
   smt::UnsatCoreReducer reducer_;
 
+  std::shared_ptr<LemmaExchange> lemma_exchange_;  ///< null if not sharing
+  size_t lemma_exchange_id_;  ///< this instance's id in lemma_exchange_
+
+  bool checkpoint_restored_;  ///< warm-start from options_.ic3_checkpoint_
+                              ///< has been attempted
+  std::chrono::steady_clock::time_point last_checkpoint_;
+
   ///< keeps track of the current context-level of the solver
   // NOTE: if solver is passed in, it could be off
   //       currently no way to check
@@ -209,6 +360,25 @@ class IC3Base : public Prover
   ///< which changes depending on the implementation
   std::vector<std::vector<IC3Formula>> frames_;
 
+  ///< solvers per frame (option --ic3-frame-solvers), frame_solvers_[i]
+  ///< holds the constraints of frames i and above
+  std::vector<std::unique_ptr<FrameSolver>> frame_solvers_;
+  smt::Term frame_solvers_init_;   ///< init the frame solvers were built for
+  smt::Term frame_solvers_trans_;  ///< trans the frame solvers were built for
+
+  ///< solvers of the worker threads of parallel_propagate, kept across
+  ///< calls and holding the lemmas of all the frames
+  std::vector<std::unique_ptr<FrameSolver>> prop_workers_;
+  smt::Term prop_workers_trans_;  ///< trans the workers were built for
+
+  ///< activity of the literals in learned lemmas, used to order the
+  ///< literal drop attempts of counterexample-guided generalization
+  std::unordered_map<smt::Term, double> lit_activity_;
+
+  ///< syntactic subsumption index over the lemmas in frames_
+  ///< kept in sync with every change to frames_
+  LemmaIndex lemma_index_;
+
   ///< priority queue of outstanding proof goals
   // labels for activating assertions
   smt::Term init_label_;       ///< label to activate init
@@ -349,6 +519,18 @@ class IC3Base : public Prover
     return REFINE_NONE;
   }
 
+  /** Returns the terms describing the current abstraction
+   *  they are saved in checkpoints and given back to restore_abstraction
+   *  By default there is no abstraction
+   */
+  virtual smt::TermVec abstraction_terms() const { return {}; }
+
+  /** Restores the abstraction from a checkpoint
+   *  called at the base context before any lemma is restored
+   *  @param terms the terms returned by abstraction_terms when saving
+   */
+  virtual void restore_abstraction(const smt::TermVec & terms) {}
+
   /** Check if a transition from the frontier can result in a bad state
    *  @param out an IC3Formula to populate with a state in the frontier
    *         that can reach bad in one step
@@ -400,6 +582,46 @@ class IC3Base : public Prover
                      IC3Formula & out,
                      bool get_pred = true);
 
+  /** Relative inductiveness check for counterexample-guided generalization
+   *  Same query as rel_ind_check, but c does not have to be a proof goal
+   *  (its predecessors may be in lower frames) and the predecessor is
+   *  the full model, without predecessor generalization.
+   *  @param i the frame number
+   *  @param c the IC3Formula to check (a conjunction)
+   *  @param out if the query is UNSAT, c reduced as in rel_ind_check
+   *             if it is SAT, the predecessor
+   *  @param join if the query is SAT, set to the children of c that hold in
+   *         the predecessor
+   *  @return true iff c is inductive relative to frame i-1
+   */
+  bool ctg_rel_ind_check(size_t i,
+                         const IC3Formula & c,
+                         IC3Formula & out,
+                         smt::TermVec & join);
+
+  /** Counterexample-guided inductive generalization (option --ic3-ctg)
+   *  Tries to drop each literal of c, least active first. A failed drop
+   *  is retried after blocking the counterexamples to generalization at
+   *  frame i-1 (recursively, up to --ic3-ctg-depth), and otherwise the
+   *  candidate is weakened to the literals that hold in the counterexample.
+   *  @requires !rel_ind_check(i, c, _)
+   *  @param i the frame number to generalize against
+   *  @param c the IC3Formula to generalize (a conjunction)
+   *  @param depth the recursion depth
+   *  @return a sub-conjunction of c that is inductive relative to F[i-1]
+   */
+  IC3Formula ctg_generalization(size_t i, const IC3Formula & c, size_t depth);
+
+  /** Weakens c until it is inductive relative to F[i-1], blocking
+   *  counterexamples to generalization on the way
+   *  @param i the frame number
+   *  @param c the candidate (a conjunction), updated in place on success
+   *  @param depth the recursion depth
+   *  @return true iff a sub-conjunction of c is inductive relative to F[i-1]
+   *          and does not intersect the initial states
+   */
+  bool ctg_down(size_t i, IC3Formula & c, size_t depth);
+
   // Helper methods
 
   /** Attempt to block all proof goals
@@ -410,6 +632,38 @@ class IC3Base : public Prover
    */
   bool block_all();
 
+  /** Imports the lemmas published by other instances to lemma_exchange_
+   *  A lemma is added to the highest frame it is inductive relative to
+   *  and dropped if it is not even inductive relative to the initial states
+   *  @return the number of imported lemmas
+   */
+  size_t import_lemmas();
+
+  /** Adds the invariants found by an InvariantMiner to the first frame
+   *  They are inductive, so propagation carries them forward.
+   *  Invariants that are not valid IC3Formulas for this flavor are skipped.
+   *  @return the number of added invariants
+   */
+  size_t add_mined_invariants();
+
+  /** Warm-starts from a checkpoint written by save_checkpoint
+   *  Expects the first frame to be done (reached_k_ == 1).
+   *  Saved lemmas are not trusted: each lemma is added to the highest
+   *  frame (up to the one it was saved in) it is inductive relative to,
+   *  and a new frame is only opened once the frontier blocks bad.
+   *  A checkpoint for a different system thus only costs time.
+   *  @param filename the checkpoint file
+   *  @return the number of restored lemmas
+   */
+  size_t restore_checkpoint(const std::string & filename);
+
+  /** Restores options_.ic3_checkpoint_ on the first call without force
+   *  and saves it when force is set or the checkpoint interval has passed
+   *  No-op without option --ic3-checkpoint
+   *  @param force save regardless of the interval
+   */
+  void update_checkpoint(bool force);
+
   /** Check if the given proof goal is already blocked
    *  @param pg the proof goal
    *  @return true iff the proof goal is already blocked
@@ -423,6 +677,17 @@ class IC3Base : public Prover
    */
   bool propagate(size_t i);
 
+  /** propagate for option --ic3-prop-threads: the lemmas of frame i are
+   *  checked by worker threads, each with its own solver holding F[i] and
+   *  a disjoint subset of the lemmas, and the results are merged back into
+   *  the frames afterwards. The worker solvers are kept across calls and
+   *  get new lemmas through constrain_frame
+   *  @param i the frame index to propagate
+   *  @param num_workers the number of worker threads, at least 2
+   *  @return true iff all the clauses are propagated
+   */
+  bool parallel_propagate(size_t i, size_t num_workers);
+
   /** Calls predecessor_generalization to generalize the current
    *  model (assumes the current context is satisfiable)
    *  Then if approx_pregen_ is true will do a solver call
@@ -497,6 +762,42 @@ class IC3Base : public Prover
   void fix_if_intersects_initial(smt::TermVec & to_keep,
                                  const smt::TermVec & rem);
 
+  /** Pushes a solver context with F[i-1] /\ !c /\ T and checks it under
+   *  assumptions (in assumps_) for the children of c'
+   *  the caller pops the context
+   *  @param i the frame number
+   *  @param c the IC3Formula to check (a conjunction)
+   *  @return the result of the query
+   */
+  smt::Result check_rel_ind_query(size_t i, const IC3Formula & c);
+
+  /** Reduces c with the unsat core of a failed check_rel_ind_query
+   *  if option ic3_unsatcore_gen_ is set
+   *  @requires the solver_ context is currently unsatisfiable
+   *  @param c the checked IC3Formula
+   *  @return a sub-conjunction of c which does not intersect the initial
+   *          states if c does not
+   */
+  IC3Formula reduce_with_unsat_core(const IC3Formula & c);
+
+  /** Reduces c to the children marked in in_core, adding removed children
+   *  back if the result intersects the initial states
+   *  @param c the checked IC3Formula (a conjunction)
+   *  @param in_core for each child of c, whether it is kept
+   *  @return a sub-conjunction of c
+   */
+  IC3Formula reduce_to_core(const IC3Formula & c,
+                            const std::vector<bool> & in_core);
+
+  /** @return the solver holding frame i (option --ic3-frame-solvers)
+   *  Solvers are created on demand, and rebuilt when the transition
+   *  system changed (e.g. after a refinement)
+   */
+  FrameSolver & frame_solver(size_t i);
+
+  /** rel_ind_check without a predecessor, on the solver of frame i-1 */
+  bool frame_rel_ind_check(size_t i, const IC3Formula & c, IC3Formula & out);
+
   /** Returns the highest frame this unit can be pushed to
    *  @param i the starting frame index
    *  @param u the IC3Formula to check how far it can be pushed
@@ -389,6 +389,22 @@ void IC3IA::reabstract()
   }
 }
 
+TermVec IC3IA::abstraction_terms() const
+{
+  return TermVec(predset_.begin(), predset_.end());
+}
+
+void IC3IA::restore_abstraction(const TermVec & terms)
+{
+  size_t num_new = 0;
+  for (const auto & p : terms) {
+    if (ts_.only_curr(p) && add_predicate(p)) {
+      num_new++;
+    }
+  }
+  logger.log(1, "{} predicates restored from checkpoint", num_new);
+}
+
 bool IC3IA::add_predicate(const Term & pred)
 {
   if (predset_.find(pred) != predset_.end()) {
@@ -109,6 +109,12 @@ class IC3IA : public IC3
 
   bool is_global_label(const smt::Term & l) const override;
 
+  /** Returns the current predicates */
+  smt::TermVec abstraction_terms() const override;
+
+  /** Adds the predicates of a checkpoint */
+  void restore_abstraction(const smt::TermVec & terms) override;
+
   // specific to IC3IA
 
   void reabstract();
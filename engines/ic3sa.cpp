@@ -779,6 +779,25 @@ void IC3SA::construct_partition(const EquivalenceClasses & ec,
   }
 }
 
+TermVec IC3SA::abstraction_terms() const
+{
+  TermVec terms(predset_.begin(), predset_.end());
+  for (const auto & elem : term_abstraction_) {
+    terms.insert(terms.end(), elem.second.begin(), elem.second.end());
+  }
+  return terms;
+}
+
+void IC3SA::restore_abstraction(const TermVec & terms)
+{
+  for (const auto & t : terms) {
+    // same as terms learned from refinement
+    for (const auto & nt : add_to_term_abstraction(t)) {
+      get_free_symbolic_consts(nt, projection_set_);
+    }
+  }
+}
+
 UnorderedTermSet IC3SA::add_to_term_abstraction(const Term & term)
 {
   UnorderedTermSet new_terms;
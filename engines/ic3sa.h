@@ -101,6 +101,12 @@ class IC3SA : public IC3
 
   void initialize() override;
 
+  /** Returns the predicates and terms of the syntactic abstraction */
+  smt::TermVec abstraction_terms() const override;
+
+  /** Adds the predicates and terms of a checkpoint to the abstraction */
+  void restore_abstraction(const smt::TermVec & terms) override;
+
   // IC3SA specific methods
 
   RefineResult ic3sa_refine_functional(smt::Term & learned_lemma);
@@ -91,6 +91,10 @@ ProverResult InterpolantMC::check_until(int k)
 
   try {
     for (int i = 0; i <= k; ++i) {
+      if (interrupted()) {
+        logger.log(1, "InterpolantMC interrupted at bound: {}", i);
+        return ProverResult::UNKNOWN;
+      }
       if (step(i)) {
         return ProverResult::TRUE;
       } else if (concrete_cex_) {
@@ -183,6 +187,9 @@ bool InterpolantMC::step(int i)
   transB_ =
       solver_->make_term(And, transB_, unroller_.at_time(ts_.trans(), i));
   ++reached_k_;
+  // step i + 1 unrolls bad and trans at time i + 1, drop the memo of
+  // the earlier times, including the interpolants mapped to time 0
+  unroller_.clear_subterm_cache_before(i - 1);
 
   return false;
 }
@@ -15,6 +15,7 @@
  **/
 
 #include "kinduction.h"
+#include "utils/invariant_miner.h"
 #include "utils/logger.h"
 
 using namespace smt;
@@ -47,6 +48,18 @@ void KInduction::initialize()
   init0_ = unroller_.at_time(ts_.init(), 0);
   false_ = solver_->make_term(false);
   simple_path_ = solver_->make_term(true);
+
+  mined_invar_ = solver_->make_term(true);
+  if (options_.mine_invariants_) {
+    InvariantMiner miner(ts_, solver_, options_);
+    for (const auto & clause : miner.mine()) {
+      Term c = clause.at(0);
+      for (size_t i = 1; i < clause.size(); ++i) {
+        c = solver_->make_term(Or, c, clause[i]);
+      }
+      mined_invar_ = solver_->make_term(And, mined_invar_, c);
+    }
+  }
 }
 
 ProverResult KInduction::check_until(int k)
@@ -54,6 +67,10 @@ ProverResult KInduction::check_until(int k)
   initialize();
 
   for (int i = reached_k_ + 1; i <= k; ++i) {
+    if (interrupted()) {
+      logger.log(1, "KInduction interrupted at bound: {}", i);
+      return ProverResult::UNKNOWN;
+    }
     logger.log(1, "Checking k-induction base case at bound: {}", i);
     if (!base_step(i)) {
       compute_witness();
@@ -63,6 +80,11 @@ ProverResult KInduction::check_until(int k)
     if (inductive_step(i)) {
       return ProverResult::TRUE;
     }
+    if (i > 0) {
+      // the next base step unrolls at time i + 1, the next inductive step
+      // at i + 2 and only the state variables are unrolled at earlier times
+      unroller_.clear_subterm_cache_before(i - 1);
+    }
   }
   return ProverResult::UNKNOWN;
 }
@@ -85,6 +107,8 @@ bool KInduction::base_step(int i)
   const Term &prop = solver_->make_term(Not, bad_);
   solver_->assert_formula(unroller_.at_time(ts_.trans(), i));
   solver_->assert_formula(unroller_.at_time(prop, i));
+  // holds in every reachable state, strengthens the inductive step
+  solver_->assert_formula(unroller_.at_time(mined_invar_, i));
 
   return true;
 }
@@ -98,6 +122,7 @@ bool KInduction::inductive_step(int i)
   solver_->push();
   solver_->assert_formula(simple_path_);
   solver_->assert_formula(unroller_.at_time(bad_, i + 1));
+  solver_->assert_formula(unroller_.at_time(mined_invar_, i + 1));
 
   if (ts_.statevars().size() && check_simple_path_lazy(i + 1)) {
     return true;
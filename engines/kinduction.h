@@ -45,6 +45,8 @@ class KInduction : public Prover
   smt::Term init0_;
   smt::Term false_;
   smt::Term simple_path_;
+  smt::Term mined_invar_;  ///< invariants from option mine-invariants
+                           ///< (true if none), assumed in every step
 
 };  // class KInduction
 
@@ -0,0 +1,118 @@
+/*********************                                                        */
+/*! \file lemma_exchange.cpp
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief A thread-safe exchange of learned frame lemmas between IC3
+**        instances running concurrently on their own solvers.
+**
+**/
+
+#include "engines/lemma_exchange.h"
+
+#include <cassert>
+
+#include "smt/available_solvers.h"
+#include "utils/exceptions.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+LemmaExchange::LemmaExchange(SolverEnum se)
+    // logging solver keeps the exact term structure of the literals
+    : hub_(create_solver(se, true, false, false))
+{
+}
+
+size_t LemmaExchange::add_participant(const TransitionSystem & ts)
+{
+  lock_guard<mutex> lock(mutex_);
+
+  size_t id = participants_.size();
+  participants_.push_back({ unique_ptr<TermTranslator>(new TermTranslator(hub_)),
+                            unique_ptr<TermTranslator>(
+                                new TermTranslator(ts.solver())),
+                            0 });
+  Participant & part = participants_.back();
+  UnorderedTermMap & to_hub_cache = part.to_hub->get_cache();
+  UnorderedTermMap & from_hub_cache = part.from_hub->get_cache();
+
+  if (id && hub_statevars_.size() != ts.statevars().size()) {
+    participants_.pop_back();
+    throw PonoException(
+        "LemmaExchange participants must share the same state variables");
+  }
+
+  for (const auto & sv : ts.statevars()) {
+    const string name = sv->to_string();
+    auto it = hub_statevars_.find(name);
+    Term hub_sv;
+    if (it != hub_statevars_.end()) {
+      hub_sv = it->second;
+    } else if (!id) {
+      // first participant determines the state variables
+      hub_sv = part.to_hub->transfer_term(sv);
+      hub_statevars_[name] = hub_sv;
+    } else {
+      participants_.pop_back();
+      throw PonoException("LemmaExchange participant has unknown state var "
+                          + name);
+    }
+    to_hub_cache[sv] = hub_sv;
+    from_hub_cache[hub_sv] = sv;
+  }
+
+  return id;
+}
+
+void LemmaExchange::publish(size_t id, const TermVec & children)
+{
+  lock_guard<mutex> lock(mutex_);
+  assert(id < participants_.size());
+
+  Participant & part = participants_[id];
+  lemmas_.push_back({ id, {} });
+  TermVec & hub_children = lemmas_.back().children;
+  hub_children.reserve(children.size());
+  for (const auto & c : children) {
+    hub_children.push_back(part.to_hub->transfer_term(c, BOOL));
+  }
+}
+
+vector<TermVec> LemmaExchange::collect(size_t id)
+{
+  lock_guard<mutex> lock(mutex_);
+  assert(id < participants_.size());
+
+  Participant & part = participants_[id];
+  vector<TermVec> res;
+  for (; part.cursor < lemmas_.size(); ++part.cursor) {
+    const Lemma & l = lemmas_[part.cursor];
+    if (l.origin == id) {
+      continue;
+    }
+    res.push_back({});
+    TermVec & children = res.back();
+    children.reserve(l.children.size());
+    for (const auto & c : l.children) {
+      children.push_back(part.from_hub->transfer_term(c, BOOL));
+    }
+  }
+  return res;
+}
+
+size_t LemmaExchange::num_lemmas() const
+{
+  lock_guard<mutex> lock(mutex_);
+  return lemmas_.size();
+}
+
+}  // namespace pono
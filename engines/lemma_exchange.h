@@ -0,0 +1,98 @@
+/*********************                                                        */
+/*! \file lemma_exchange.h
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief A thread-safe exchange of learned frame lemmas between IC3
+**        instances running concurrently on their own solvers.
+**
+**        Lemmas are stored in a private hub solver. Publishing translates
+**        a lemma from the publisher's solver into the hub, and collecting
+**        translates it from the hub into the collector's solver. Both
+**        happen under a lock, so a participant only ever touches its own
+**        solver and the hub.
+**
+**/
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/ts.h"
+#include "smt-switch/smt.h"
+#include "smt-switch/term_translator.h"
+
+namespace pono {
+
+class LemmaExchange
+{
+ public:
+  /** @param se the kind of solver used to store the lemmas */
+  LemmaExchange(smt::SolverEnum se);
+
+  ~LemmaExchange() {}
+
+  /** Registers a new participant
+   *  all participants must have the same state variables (by name)
+   *  @param ts the transition system of the participant
+   *         (built with the participant's solver)
+   *  @return the id of the participant
+   */
+  size_t add_participant(const TransitionSystem & ts);
+
+  /** Publishes a lemma learned by a participant
+   *  @param id the participant's id
+   *  @param children the literals of the learned clause
+   *         (over current state variables) in the participant's solver
+   */
+  void publish(size_t id, const smt::TermVec & children);
+
+  /** Collects the lemmas published by other participants since the last
+   *  call to collect with this id
+   *  @param id the participant's id
+   *  @return a vector of clauses (as a vector of literals) in the
+   *          participant's solver
+   *  NOTE: the lemmas are only known to be valid for the publisher's
+   *        frames, the caller is responsible for checking them
+   */
+  std::vector<smt::TermVec> collect(size_t id);
+
+  /** Returns the number of lemmas published so far */
+  size_t num_lemmas() const;
+
+ protected:
+  struct Participant
+  {
+    std::unique_ptr<smt::TermTranslator> to_hub;
+    std::unique_ptr<smt::TermTranslator> from_hub;
+    size_t cursor;  ///< index of the next lemma to collect
+  };
+
+  struct Lemma
+  {
+    size_t origin;  ///< id of the participant that published it
+    smt::TermVec children;  ///< literals in the hub solver
+  };
+
+  mutable std::mutex mutex_;  ///< protects everything below
+
+  smt::SmtSolver hub_;
+
+  std::unordered_map<std::string, smt::Term> hub_statevars_;
+
+  std::vector<Participant> participants_;
+
+  std::vector<Lemma> lemmas_;
+};
+
+}  // namespace pono
@@ -18,6 +18,7 @@
 #include <algorithm>
 #include <random>
 
+#include "core/ternary_simulator.h"
 #include "smt-switch/utils.h"
 #include "smt/available_solvers.h"
 #include "utils/logger.h"
@@ -261,7 +262,21 @@ void ModelBasedIC3::predecessor_generalization(size_t i,
     return;
   }
 
-  if (options_.ic3_pregen_ && !options_.ic3_functional_preimage_) {
+  if (options_.ic3_pregen_ && !options_.ic3_functional_preimage_
+      && options_.ic3_ternary_pregen_ && ts_.is_deterministic()) {
+    // the successor is a function of the predecessor and the inputs, drop
+    // the values it does not depend on without solver calls
+    UnorderedTermMap inputs;
+    for (const auto &v : inputvars) {
+      inputs[v] = model.at(v);
+    }
+    TermVec red_cube_lits =
+        TernarySimulator(ts_).generalize(cube_lits, inputs, c);
+    if (red_cube_lits.size()) {
+      pred = ic3formula_conjunction(red_cube_lits);
+    }
+
+  } else if (options_.ic3_pregen_ && !options_.ic3_functional_preimage_) {
     // add congruent equalities to cube_lits
     for (const auto &v : statevars) {
       Term t = ds.find(v);
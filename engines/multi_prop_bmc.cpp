@@ -0,0 +1,185 @@
+/*********************                                                        */
+/*! \file multi_prop_bmc.cpp
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Bounded model checking of many properties over a single shared
+**        unrolling. The transition relation is asserted once per bound
+**        and each open property is checked under an assumption.
+**        Properties are retired as soon as they fail.
+**
+**/
+
+#include "engines/multi_prop_bmc.h"
+
+#include <cassert>
+
+#include "utils/exceptions.h"
+#include "utils/logger.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+/** Returns the conjunction of all the properties
+ *  used as the Prover-level property
+ */
+static Property all_props(const TransitionSystem & ts, const TermVec & props)
+{
+  if (props.empty()) {
+    throw PonoException("MultiPropBmc expects at least one property");
+  }
+
+  const SmtSolver & s = ts.solver();
+  Term conj = props[0];
+  for (size_t i = 1; i < props.size(); ++i) {
+    conj = s->make_term(And, conj, props[i]);
+  }
+  return Property(s, conj);
+}
+
+MultiPropBmc::MultiPropBmc(const TermVec & props,
+                           const TransitionSystem & ts,
+                           const SmtSolver & solver,
+                           PonoOptions opt)
+    : super(all_props(ts, props), ts, solver, opt), props_(props)
+{
+  engine_ = Engine::BMC;
+}
+
+MultiPropBmc::~MultiPropBmc() {}
+
+void MultiPropBmc::initialize()
+{
+  if (initialized_) {
+    return;
+  }
+
+  super::initialize();
+
+  bads_.clear();
+  for (const auto & p : props_) {
+    Term tp = (solver_ == orig_ts_.solver())
+                  ? p
+                  : to_prover_solver_.transfer_term(p, BOOL);
+    Term bad = solver_->make_term(Not, tp);
+    if (!ts_.only_curr(bad)) {
+      throw PonoException(
+          "Property should not contain inputs or next state variables");
+    }
+    bads_.push_back(bad);
+  }
+
+  results_.assign(props_.size(), ProverResult::UNKNOWN);
+  cex_lengths_.assign(props_.size(), 0);
+  witnesses_.assign(props_.size(), {});
+  failed_.clear();
+
+  // NOTE: same as Bmc, assumes this solver is only used for model checking
+  // these properties once
+  solver_->assert_formula(unroller_.at_time(ts_.init(), 0));
+}
+
+ProverResult MultiPropBmc::check_until(int k)
+{
+  initialize();
+
+  for (int i = reached_k_ + 1; i <= k; ++i) {
+    if (failed_.size() == props_.size()) {
+      // nothing left to check
+      break;
+    }
+    if (interrupted()) {
+      logger.log(1, "MultiPropBmc interrupted at bound: {}", i);
+      break;
+    }
+    step(i);
+  }
+
+  return failed_.empty() ? ProverResult::UNKNOWN : ProverResult::FALSE;
+}
+
+bool MultiPropBmc::witness(std::vector<UnorderedTermMap> & out)
+{
+  if (failed_.empty()) {
+    throw PonoException("MultiPropBmc: no property failed, no witness");
+  }
+  return prop_witness(failed_[0], out);
+}
+
+size_t MultiPropBmc::prop_witness_length(size_t idx) const
+{
+  if (results_.at(idx) != ProverResult::FALSE) {
+    throw PonoException("MultiPropBmc: property " + std::to_string(idx)
+                        + " has no counterexample");
+  }
+  return cex_lengths_[idx];
+}
+
+bool MultiPropBmc::prop_witness(size_t idx,
+                                std::vector<UnorderedTermMap> & out)
+{
+  if (!witnesses_.at(idx).size()) {
+    throw PonoException(
+        "MultiPropBmc: no witness for property " + std::to_string(idx)
+        + ". Make sure that it failed and witness generation is enabled.");
+  }
+  return transfer_witness(witnesses_[idx], out);
+}
+
+bool MultiPropBmc::step(int i)
+{
+  if (i <= reached_k_) {
+    return true;
+  }
+
+  if (i > 0) {
+    // shared by all the properties
+    solver_->assert_formula(unroller_.at_time(ts_.trans(), i - 1));
+  }
+
+  logger.log(1, "Checking multi-property bmc at bound: {}", i);
+
+  bool res = true;
+  for (size_t j = 0; j < bads_.size(); ++j) {
+    if (results_[j] != ProverResult::UNKNOWN) {
+      continue;
+    }
+
+    // activation literal so the query can be made under an assumption
+    Term lbl = solver_->make_symbol(
+        "__bad_label_" + std::to_string(j) + "_" + std::to_string(i),
+        solver_->make_sort(BOOL));
+    solver_->assert_formula(
+        solver_->make_term(Implies, lbl, unroller_.at_time(bads_[j], i)));
+
+    Result r = solver_->check_sat_assuming({ lbl });
+    if (r.is_sat()) {
+      logger.log(1, "Property {} failed at bound: {}", j, i);
+      res = false;
+      results_[j] = ProverResult::FALSE;
+      cex_lengths_[j] = i;
+      failed_.push_back(j);
+      if (options_.witness_) {
+        assert(witness_.empty());
+        compute_witness();
+        witnesses_[j] = std::move(witness_);
+        witness_.clear();
+      }
+    }
+    // retire the label, it's never used again
+    solver_->assert_formula(solver_->make_term(Not, lbl));
+  }
+
+  ++reached_k_;
+  return res;
+}
+
+}  // namespace pono
@@ -0,0 +1,87 @@
+/*********************                                                        */
+/*! \file multi_prop_bmc.h
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Bounded model checking of many properties over a single shared
+**        unrolling. The transition relation is asserted once per bound
+**        and each open property is checked under an assumption.
+**        Properties are retired as soon as they fail.
+**
+**/
+
+#pragma once
+
+#include "engines/prover.h"
+
+namespace pono {
+
+class MultiPropBmc : public Prover
+{
+ public:
+  /** @param props the properties to check (over ts's solver)
+   *  the Prover-level property is the conjunction of all of them
+   */
+  MultiPropBmc(const smt::TermVec & props,
+               const TransitionSystem & ts,
+               const smt::SmtSolver & solver,
+               PonoOptions opt = PonoOptions());
+
+  ~MultiPropBmc();
+
+  typedef Prover super;
+
+  void initialize() override;
+
+  /** Checks all open properties up to bound k
+   *  @return FALSE if any property has failed, otherwise UNKNOWN
+   */
+  ProverResult check_until(int k) override;
+
+  /** Returns the witness of the first property that failed */
+  bool witness(std::vector<smt::UnorderedTermMap> & out) override;
+
+  size_t num_props() const { return props_.size(); };
+
+  /** Returns the result of property idx
+   *  FALSE if it failed, otherwise UNKNOWN
+   */
+  ProverResult prop_result(size_t idx) const { return results_.at(idx); };
+
+  /** Returns the indices of the properties in the order they failed */
+  const std::vector<size_t> & failed_props() const { return failed_; };
+
+  /** Returns the length of the counterexample for property idx
+   *  (the number of transitions)
+   */
+  size_t prop_witness_length(size_t idx) const;
+
+  /** Populates the witness for property idx over the original
+   *  transition system
+   *  @requires prop_result(idx) == FALSE and options_.witness_
+   *  @return true on success
+   */
+  bool prop_witness(size_t idx, std::vector<smt::UnorderedTermMap> & out);
+
+ protected:
+  /** Checks all open properties at bound i
+   *  @return true iff no property failed at this bound
+   */
+  bool step(int i);
+
+  smt::TermVec props_;  ///< the properties in the original solver
+  smt::TermVec bads_;   ///< negated properties in solver_
+  std::vector<ProverResult> results_;
+  std::vector<size_t> failed_;  ///< property indices in order of failure
+  std::vector<size_t> cex_lengths_;
+  std::vector<std::vector<smt::UnorderedTermMap>> witnesses_;
+
+};  // class MultiPropBmc
+
+}  // namespace pono
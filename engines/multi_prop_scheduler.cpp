@@ -0,0 +1,229 @@
+/*********************                                                        */
+/*! \file multi_prop_scheduler.cpp
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Checks many properties of one transition system on a pool of
+**        worker threads.
+**
+**/
+
+#include "engines/multi_prop_scheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "modifiers/static_coi.h"
+#include "smt/available_solvers.h"
+#include "utils/exceptions.h"
+#include "utils/fcoi.h"
+#include "utils/logger.h"
+#include "utils/make_provers.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+/** Returns the representative of i in a union-find forest
+ *  with path halving
+ */
+static size_t find_root(vector<size_t> & parent, size_t i)
+{
+  while (parent[i] != i) {
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return i;
+}
+
+MultiPropScheduler::MultiPropScheduler(const TransitionSystem & ts,
+                                       const TermVec & props,
+                                       PonoOptions opt)
+    : ts_(ts), props_(props), options_(opt)
+{
+  for (const auto & p : props_) {
+    if (!ts_.only_curr(p)) {
+      throw PonoException(
+          "Property should not contain inputs or next state variables");
+    }
+  }
+  // slicing is done per cluster here, not by the provers
+  options_.static_coi_ = false;
+  compute_clusters();
+}
+
+vector<ProverResult> MultiPropScheduler::run(size_t num_threads)
+{
+  results_.assign(props_.size(), ProverResult::UNKNOWN);
+
+  // keep properties of the same cluster close together
+  // so proven facts are available to the rest of the cluster sooner
+  vector<size_t> jobs;
+  jobs.reserve(props_.size());
+  for (const auto & cluster : clusters_) {
+    jobs.insert(jobs.end(), cluster.begin(), cluster.end());
+  }
+
+  if (!num_threads) {
+    num_threads = std::max(1u, thread::hardware_concurrency());
+  }
+  num_threads = std::min(num_threads, jobs.size());
+  logger.log(1,
+             "Checking {} properties in {} clusters with {} threads",
+             props_.size(),
+             clusters_.size(),
+             num_threads);
+
+  atomic<size_t> next_job(0);
+  vector<thread> workers;
+  workers.reserve(num_threads);
+  for (size_t t = 0; t < num_threads; ++t) {
+    workers.emplace_back([this, &jobs, &next_job]() {
+      size_t j;
+      while ((j = next_job++) < jobs.size()) {
+        run_job(jobs[j]);
+      }
+    });
+  }
+  for (auto & w : workers) {
+    w.join();
+  }
+
+  return results_;
+}
+
+void MultiPropScheduler::compute_clusters()
+{
+  clusters_.clear();
+  cluster_ts_.clear();
+  cluster_assumptions_.clear();
+  cluster_of_.assign(props_.size(), 0);
+
+  if (!ts_.is_functional()) {
+    // FunctionalConeOfInfluence requires a functional system
+    logger.log(1, "Not a functional system, using a single cluster");
+    clusters_.push_back({});
+    for (size_t i = 0; i < props_.size(); ++i) {
+      clusters_.back().push_back(i);
+    }
+    cluster_ts_.push_back(ts_);
+    cluster_assumptions_.push_back({});
+    return;
+  }
+
+  vector<size_t> parent(props_.size());
+  for (size_t i = 0; i < parent.size(); ++i) {
+    parent[i] = i;
+  }
+
+  FunctionalConeOfInfluence coi(ts_, options_.verbosity_);
+  // maps a state variable to a property that has it in its cone
+  unordered_map<Term, size_t> owner_idx;
+  for (size_t i = 0; i < props_.size(); ++i) {
+    coi.compute_coi({ props_[i] });
+    for (const auto & sv : coi.statevars_in_coi()) {
+      auto it = owner_idx.find(sv);
+      if (it == owner_idx.end()) {
+        owner_idx[sv] = i;
+      } else {
+        parent[find_root(parent, i)] = find_root(parent, it->second);
+      }
+    }
+  }
+
+  unordered_map<size_t, size_t> root2cluster;
+  for (size_t i = 0; i < props_.size(); ++i) {
+    size_t root = find_root(parent, i);
+    auto it = root2cluster.find(root);
+    if (it == root2cluster.end()) {
+      root2cluster[root] = clusters_.size();
+      clusters_.push_back({});
+    }
+    cluster_of_[i] = root2cluster.at(root);
+    clusters_[cluster_of_[i]].push_back(i);
+  }
+
+  for (const auto & cluster : clusters_) {
+    TermVec cluster_props;
+    for (const auto & i : cluster) {
+      cluster_props.push_back(props_[i]);
+    }
+    cluster_ts_.push_back(ts_);
+    StaticConeOfInfluence slice(
+        cluster_ts_.back(), cluster_props, options_.verbosity_);
+    cluster_assumptions_.push_back({});
+  }
+}
+
+void MultiPropScheduler::run_job(size_t idx)
+{
+  const size_t c = cluster_of_.at(idx);
+  const Engine e = options_.engine_;
+
+  shared_ptr<Prover> prover;
+  {
+    lock_guard<mutex> lock(source_mutex_);
+    TransitionSystem ts = cluster_ts_[c];
+    for (const auto & a : cluster_assumptions_[c]) {
+      ts.add_invar(a);
+    }
+    logger.log(1,
+               "Checking property {} assuming {} proven facts",
+               idx,
+               cluster_assumptions_[c].size());
+
+    SmtSolver s = create_solver_for(
+        options_.smt_solver_, e, options_.logging_smt_solver_);
+    prover = make_prover(e, Property(ts.solver(), props_[idx]), ts, s, options_);
+    prover->initialize();
+  }
+
+  ProverResult r;
+  try {
+    // HACK MSAT_IC3IA does not support check_until
+    r = (e == MSAT_IC3IA) ? prover->prove()
+                          : prover->check_until(options_.bound_);
+  }
+  catch (std::exception & ex) {
+    logger.log(0, "Property {} failed with: {}", idx, ex.what());
+    r = ProverResult::ERROR;
+  }
+
+  lock_guard<mutex> lock(source_mutex_);
+  results_[idx] = r;
+
+  vector<UnorderedTermMap> cex;
+  if (r == ProverResult::FALSE && options_.witness_) {
+    prover->witness(cex);
+  } else if (r == ProverResult::TRUE) {
+    Term fact = props_[idx];
+    try {
+      fact = prover->invar();
+    }
+    catch (PonoException & ex) {
+      // engine does not produce invariants, the property
+      // holds in every reachable state anyway
+    }
+    cluster_assumptions_[c].push_back(fact);
+  }
+
+  if (callback_) {
+    callback_(idx, r, cex);
+  }
+
+  // the prover holds terms of the original solver
+  // must be destroyed under the lock
+  cex.clear();
+  prover.reset();
+}
+
+}  // namespace pono
@@ -0,0 +1,115 @@
+/*********************                                                        */
+/*! \file multi_prop_scheduler.h
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Checks many properties of one transition system on a pool of
+**        worker threads.
+**
+**        Properties with overlapping cones of influence are clustered
+**        and share one sliced transition system. Once a property of a
+**        cluster is proven, its invariant (or the property itself) is
+**        assumed when checking the remaining properties of the cluster.
+**
+**        Every prover gets its own solver. All accesses to terms of the
+**        original solver (building provers, translating results and
+**        destroying provers) are serialized by a lock because the
+**        underlying solvers are not thread-safe.
+**
+**/
+
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "core/ts.h"
+#include "engines/prover.h"
+#include "options/options.h"
+#include "smt-switch/smt.h"
+
+namespace pono {
+
+class MultiPropScheduler
+{
+ public:
+  /** Called as soon as a property is resolved
+   *  @param idx the index of the property
+   *  @param r the result
+   *  @param cex the counterexample over the property's cluster transition
+   *         system if r is FALSE and witnesses are enabled
+   *  NOTE: calls are serialized, but come from worker threads
+   */
+  typedef std::function<void(size_t idx,
+                             ProverResult r,
+                             const std::vector<smt::UnorderedTermMap> & cex)>
+      ResultCallback;
+
+  /** @param ts the transition system
+   *  @param props the properties to check (only over current state vars)
+   *  @param opt the options for the provers, uses opt.engine_ and opt.bound_
+   */
+  MultiPropScheduler(const TransitionSystem & ts,
+                     const smt::TermVec & props,
+                     PonoOptions opt = PonoOptions());
+
+  ~MultiPropScheduler() {}
+
+  void set_result_callback(ResultCallback cb) { callback_ = cb; };
+
+  /** Checks all properties
+   *  @param num_threads the number of worker threads
+   *         0 means the number of hardware threads
+   *  @return the results indexed like the properties
+   */
+  std::vector<ProverResult> run(size_t num_threads = 0);
+
+  /** Returns the clusters of property indices
+   *  each cluster shares one sliced transition system
+   */
+  const std::vector<std::vector<size_t>> & clusters() const
+  {
+    return clusters_;
+  };
+
+  /** Returns the transition system for a cluster */
+  const TransitionSystem & cluster_ts(size_t c) const
+  {
+    return cluster_ts_.at(c);
+  };
+
+ protected:
+  /** Groups properties with overlapping cones of influence
+   *  and slices the transition system for each group
+   *  non-functional systems are kept as a single unsliced cluster
+   */
+  void compute_clusters();
+
+  /** Checks property idx, called from a worker thread */
+  void run_job(size_t idx);
+
+  TransitionSystem ts_;
+  smt::TermVec props_;
+  PonoOptions options_;
+
+  std::vector<std::vector<size_t>> clusters_;
+  std::vector<size_t> cluster_of_;  ///< cluster index of each property
+  std::vector<TransitionSystem> cluster_ts_;
+  ///< proven facts (over the original solver) assumed in each cluster
+  std::vector<smt::TermVec> cluster_assumptions_;
+
+  std::vector<ProverResult> results_;
+
+  ResultCallback callback_;
+
+  std::mutex source_mutex_;  ///< protects terms of the original solver
+};
+
+}  // namespace pono
@@ -0,0 +1,256 @@
+/*********************                                                        */
+/*! \file portfolio.cpp
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief An in-process portfolio that runs several engines on the same
+**        transition system in parallel threads. Each engine gets its own
+**        solver and the first definitive result interrupts the others.
+**
+**/
+
+#include "engines/portfolio.h"
+
+#include <cassert>
+#include <chrono>
+#include <thread>
+
+#include "engines/ic3base.h"
+#include "smt/available_solvers.h"
+#include "utils/logger.h"
+#include "utils/make_provers.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+Portfolio::Portfolio(const Property & p,
+                     const TransitionSystem & ts,
+                     const SmtSolver & solver,
+                     PonoOptions opt)
+    : super(p, ts, solver, opt),
+      winner_engine_(Engine::NONE),
+      winner_result_(ProverResult::UNKNOWN)
+{
+  engine_ = Engine::PORTFOLIO;
+  for (size_t i = 0; i < options_.portfolio_engines_.size(); ++i) {
+    configs_.push_back(options_);
+    configs_.back().engine_ = options_.portfolio_engines_[i];
+    configs_.back().random_seed_ = options_.random_seed_ + i;
+  }
+}
+
+Portfolio::Portfolio(const Property & p,
+                     const TransitionSystem & ts,
+                     const SmtSolver & solver,
+                     const vector<PonoOptions> & configs,
+                     PonoOptions opt)
+    : super(p, ts, solver, opt),
+      configs_(configs),
+      winner_engine_(Engine::NONE),
+      winner_result_(ProverResult::UNKNOWN)
+{
+  engine_ = Engine::PORTFOLIO;
+}
+
+Portfolio::~Portfolio() {}
+
+void Portfolio::initialize()
+{
+  if (initialized_) {
+    return;
+  }
+
+  super::initialize();
+
+  if (configs_.empty()) {
+    throw PonoException("Portfolio requires at least one engine");
+  }
+
+  if (options_.portfolio_share_lemmas_) {
+    lemma_exchange_ = make_shared<LemmaExchange>(options_.smt_solver_);
+  }
+
+  for (const auto & opts : configs_) {
+    Engine e = opts.engine_;
+    if (e == PORTFOLIO) {
+      throw PonoException("Portfolio engine cannot be nested");
+    }
+
+    // every engine needs its own solver so they can run concurrently
+    SmtSolver s = create_solver_for(opts.smt_solver_,
+                                    e,
+                                    opts.logging_smt_solver_,
+                                    opts.ceg_prophecy_arrays_);
+
+    shared_ptr<Prover> prover;
+    if (opts.cegp_abs_vals_) {
+      prover = make_cegar_values_prover(e, orig_property_, orig_ts_, s, opts);
+    } else if (opts.ceg_bv_arith_) {
+      prover =
+          make_cegar_bv_arith_prover(e, orig_property_, orig_ts_, s, opts);
+    } else if (opts.ceg_prophecy_arrays_) {
+      prover = make_ceg_proph_prover(e, orig_property_, orig_ts_, s, opts);
+    } else {
+      prover = make_prover(e, orig_property_, orig_ts_, s, opts);
+    }
+    assert(prover);
+
+    shared_ptr<IC3Base> ic3 = dynamic_pointer_cast<IC3Base>(prover);
+    if (lemma_exchange_ && ic3) {
+      ic3->set_lemma_exchange(lemma_exchange_);
+    }
+
+    // budgets and cancellation of the portfolio apply to every engine
+    prover->set_cancel_token(make_shared<CancelToken>(cancel_token_));
+    prover->initialize();
+    provers_.push_back(prover);
+  }
+  logger.log(1, "Portfolio initialized {} engines", provers_.size());
+}
+
+ProverResult Portfolio::check_until(int k)
+{
+  initialize();
+
+  if (winner_) {
+    // already have a definitive result
+    return winner_result_;
+  }
+
+  if (interrupted()) {
+    return ProverResult::UNKNOWN;
+  }
+
+  results_.clear();
+  for (const auto & opts : configs_) {
+    results_.push_back({ opts.engine_, ProverResult::UNKNOWN, 0.0, "" });
+  }
+
+  vector<thread> workers;
+  workers.reserve(provers_.size());
+  for (size_t i = 0; i < provers_.size(); ++i) {
+    workers.emplace_back([this, i, k]() { run_prover(i, k); });
+  }
+  for (auto & w : workers) {
+    w.join();
+  }
+
+  ProverResult res = ProverResult::UNKNOWN;
+  size_t num_errors = 0;
+  for (const auto & r : results_) {
+    logger.log(1,
+               "Portfolio: {} returned {} after {:.3f}s",
+               to_string(r.engine),
+               to_string(r.result),
+               r.seconds);
+    if (r.result == ProverResult::ERROR) {
+      logger.log(
+          1, "Portfolio: {} failed with: {}", to_string(r.engine), r.error);
+      num_errors++;
+    }
+  }
+
+  if (winner_) {
+    res = winner_result_;
+  }
+
+  if (!winner_ && num_errors == results_.size()) {
+    throw PonoException("Portfolio: all engines failed. First error: "
+                        + results_.at(0).error);
+  }
+
+  if (res == ProverResult::TRUE) {
+    try {
+      // invar_ is expected to use this prover's solver
+      Term winv = winner_->invar();
+      invar_ = (solver_ == orig_ts_.solver())
+                   ? winv
+                   : to_prover_solver_.transfer_term(winv, BOOL);
+    }
+    catch (PonoException & e) {
+      logger.log(1,
+                 "Portfolio: winning engine {} has no invariant",
+                 to_string(winner_engine_));
+    }
+  }
+
+  return res;
+}
+
+bool Portfolio::witness(std::vector<UnorderedTermMap> & out)
+{
+  if (!winner_) {
+    throw PonoException(
+        "Portfolio: no engine found a counterexample, can't get witness");
+  }
+  return winner_->witness(out);
+}
+
+size_t Portfolio::witness_length() const
+{
+  if (!winner_) {
+    throw PonoException(
+        "Portfolio: no engine found a counterexample, can't get witness");
+  }
+  return winner_->witness_length();
+}
+
+void Portfolio::interrupt()
+{
+  super::interrupt();
+  for (auto & p : provers_) {
+    p->interrupt();
+  }
+}
+
+void Portfolio::run_prover(size_t idx, int k)
+{
+  const shared_ptr<Prover> & prover = provers_.at(idx);
+  EngineResult & er = results_.at(idx);
+  auto start = chrono::steady_clock::now();
+
+  try {
+    if (er.engine == MSAT_IC3IA) {
+      // HACK MSAT_IC3IA does not support check_until
+      er.result = prover->prove();
+    } else {
+      er.result = prover->check_until(k);
+    }
+  }
+  catch (std::exception & e) {
+    er.result = ProverResult::ERROR;
+    er.error = e.what();
+  }
+
+  er.seconds =
+      chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+  if (er.result != ProverResult::TRUE && er.result != ProverResult::FALSE) {
+    return;
+  }
+
+  lock_guard<mutex> lock(winner_mutex_);
+  if (winner_) {
+    // another engine finished first
+    return;
+  }
+  winner_ = prover;
+  winner_engine_ = er.engine;
+  winner_result_ = er.result;
+  logger.log(1, "Portfolio: {} finished first", to_string(er.engine));
+  for (size_t i = 0; i < provers_.size(); ++i) {
+    if (i != idx) {
+      provers_[i]->interrupt();
+    }
+  }
+}
+
+}  // namespace pono
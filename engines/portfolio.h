@@ -0,0 +1,111 @@
+/*********************                                                        */
+/*! \file portfolio.h
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief An in-process portfolio that runs several engines on the same
+**        transition system in parallel threads. Each engine gets its own
+**        solver and the first definitive result interrupts the others.
+**
+**/
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "engines/lemma_exchange.h"
+#include "engines/prover.h"
+
+namespace pono {
+
+class Portfolio : public Prover
+{
+ public:
+  /** Per-engine outcome of the last call to check_until */
+  struct EngineResult
+  {
+    Engine engine;
+    ProverResult result;
+    double seconds;     ///< wall-clock time spent in the engine
+    std::string error;  ///< exception message if result is ERROR
+  };
+
+  /** The engines to run are taken from opt.portfolio_engines_
+   *  each one gets a fresh solver of kind opt.smt_solver_
+   *  the i-th engine uses random seed opt.random_seed_ + i
+   */
+  Portfolio(const Property & p,
+            const TransitionSystem & ts,
+            const smt::SmtSolver & solver,
+            PonoOptions opt = PonoOptions());
+
+  /** Runs one engine per configuration in configs
+   *  e.g. the same IC3 variant with different generalization options
+   *  the engine of each instance is configs[i].engine_
+   */
+  Portfolio(const Property & p,
+            const TransitionSystem & ts,
+            const smt::SmtSolver & solver,
+            const std::vector<PonoOptions> & configs,
+            PonoOptions opt = PonoOptions());
+
+  ~Portfolio();
+
+  typedef Prover super;
+
+  /** Creates and initializes all the sub-provers
+   *  this is done sequentially in the calling thread because
+   *  copying the transition system reads terms from the original
+   *  solver, which is not thread-safe
+   */
+  void initialize() override;
+
+  ProverResult check_until(int k) override;
+
+  bool witness(std::vector<smt::UnorderedTermMap> & out) override;
+
+  size_t witness_length() const override;
+
+  /** Interrupts the portfolio and all running sub-provers */
+  void interrupt() override;
+
+  /** Returns the engine that produced the result
+   *  or Engine::NONE if no engine returned TRUE or FALSE
+   */
+  Engine winner() const { return winner_engine_; };
+
+  /** Returns the results of each engine from the last check_until call
+   *  in the order of the configurations
+   */
+  const std::vector<EngineResult> & results() const { return results_; };
+
+ protected:
+  /** Runs sub-prover idx up to bound k and records its result
+   *  called from a worker thread
+   */
+  void run_prover(size_t idx, int k);
+
+  std::vector<PonoOptions> configs_;
+  std::vector<std::shared_ptr<Prover>> provers_;
+  std::vector<EngineResult> results_;
+
+  std::mutex winner_mutex_;  ///< protects the winner_* members
+  std::shared_ptr<Prover> winner_;
+  Engine winner_engine_;
+  ProverResult winner_result_;
+
+  ///< shared by the IC3 instances if opt.portfolio_share_lemmas_
+  std::shared_ptr<LemmaExchange> lemma_exchange_;
+
+};  // class Portfolio
+
+}  // namespace pono
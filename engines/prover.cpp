@@ -47,8 +47,11 @@ Prover::Prover(const Property & p,
               ? orig_property_.prop()
               : to_prover_solver_.transfer_term(orig_property_.prop(), BOOL))),
       options_(opt),
-      engine_(Engine::NONE)
+      engine_(Engine::NONE),
+      cancel_token_(std::make_shared<CancelToken>())
 {
+  cancel_token_->set_time_limit(options_.time_limit_);
+  cancel_token_->set_memory_limit(options_.memory_limit_);
 }
 
 Prover::~Prover() {}
@@ -81,6 +84,12 @@ bool Prover::witness(std::vector<UnorderedTermMap> & out)
         "a counterexample and that the engine supports witness generation.");
   }
 
+  return transfer_witness(witness_, out);
+}
+
+bool Prover::transfer_witness(const std::vector<UnorderedTermMap> & wit,
+                              std::vector<UnorderedTermMap> & out)
+{
   function<Term(const Term &, SortKind)> transfer_to_prover_as;
   function<Term(const Term &, SortKind)> transfer_to_orig_ts_as;
   TermTranslator to_orig_ts_solver(orig_ts_.solver());
@@ -89,12 +98,8 @@ bool Prover::witness(std::vector<UnorderedTermMap> & out)
     transfer_to_prover_as = [](const Term & t, SortKind sk) { return t; };
     transfer_to_orig_ts_as = [](const Term & t, SortKind sk) { return t; };
   } else {
-    /* TODO: double-check that transferring terms still works as
-       intended in this branch when COI is used. */
-    if (options_.static_coi_)
-      throw PonoException(
-          "Temporary restriction: cone-of-influence analysis "
-          "currently incompatible with witness generation.");
+    // NOTE: with static COI, orig_ts_ is the reduced system and the
+    //       witness is completed for the full system by the caller
     // need to add symbols to cache
     UnorderedTermMap & cache = to_orig_ts_solver.get_cache();
     for (const auto &v : orig_ts_.statevars()) {
@@ -117,7 +122,7 @@ bool Prover::witness(std::vector<UnorderedTermMap> & out)
   // Some backends don't support full witnesses
   // it will still populate state variables, but will return false instead of
   // true
-  for (auto wit_map : witness_) {
+  for (const auto & wit_map : wit) {
     out.push_back(UnorderedTermMap());
     UnorderedTermMap & map = out.back();
 
@@ -169,18 +174,24 @@ Term Prover::invar()
   return to_orig_ts(invar_, BOOL);
 }
 
+void Prover::interrupt() { cancel_token_->cancel(); }
+
+bool Prover::interrupted() const { return cancel_token_->cancelled(); }
+
+void Prover::set_cancel_token(const shared_ptr<CancelToken> & token)
+{
+  if (!token) {
+    throw PonoException("Cancel token must be non-null");
+  }
+  cancel_token_ = token;
+}
+
 Term Prover::to_orig_ts(Term t, SortKind sk)
 {
   if (solver_ == orig_ts_.solver()) {
     // don't need to transfer terms if the solvers are the same
     return t;
   } else {
-    /* TODO: double-check that transferring terms still works as
-       intended in this branch when COI is used. */
-    if (options_.static_coi_)
-      throw PonoException(
-          "Temporary restriction: cone-of-influence analysis "
-          "currently incompatible with witness generation.");
     // need to add symbols to cache
     TermTranslator to_orig_ts_solver(orig_ts_.solver());
     UnorderedTermMap & cache = to_orig_ts_solver.get_cache();
@@ -206,25 +217,34 @@ bool Prover::compute_witness()
 {
   // TODO: make sure the solver state is SAT
 
+  // state and input variables are usually named as well
+  // only query each of them once per frame
+  TermVec signals;
+  UnorderedTermSet seen;
+  for (const auto &v : ts_.statevars()) {
+    if (seen.insert(v).second) {
+      signals.push_back(v);
+    }
+  }
+  for (const auto &v : ts_.inputvars()) {
+    if (seen.insert(v).second) {
+      signals.push_back(v);
+    }
+  }
+  for (const auto &elem : ts_.named_terms()) {
+    if (seen.insert(elem.second).second) {
+      signals.push_back(elem.second);
+    }
+  }
+
+  witness_.reserve(witness_.size() + reached_k_ + 2);
   for (int i = 0; i <= reached_k_ + 1; ++i) {
     witness_.push_back(UnorderedTermMap());
     UnorderedTermMap & map = witness_.back();
+    map.reserve(signals.size());
 
-    for (const auto &v : ts_.statevars()) {
-      const Term &vi = unroller_.at_time(v, i);
-      const Term &r = solver_->get_value(vi);
-      map[v] = r;
-    }
-
-    for (const auto &v : ts_.inputvars()) {
-      const Term &vi = unroller_.at_time(v, i);
-      const Term &r = solver_->get_value(vi);
-      map[v] = r;
-    }
-
-    for (const auto &elem : ts_.named_terms()) {
-      const Term &ti = unroller_.at_time(elem.second, i);
-      map[elem.second] = solver_->get_value(ti);
+    for (const auto &v : signals) {
+      map[v] = solver_->get_value(unroller_.at_time(v, i));
     }
   }
 
@@ -16,12 +16,15 @@
 
 #pragma once
 
+#include <memory>
+
 #include "core/prop.h"
 #include "core/proverresult.h"
 #include "core/ts.h"
 #include "core/unroller.h"
 #include "options/options.h"
 #include "smt-switch/smt.h"
+#include "utils/cancel_token.h"
 
 namespace pono {
 
@@ -66,6 +69,34 @@ class Prover
    */
   smt::Term invar();
 
+  /** Requests that a running check_until / prove returns early
+   *  Engines poll for this between solver calls and return
+   *  ProverResult::UNKNOWN once they notice it. The engine state
+   *  (e.g. reached bound, IC3 frames) is kept, so checking can be resumed
+   *  after resetting the cancel token.
+   *  Safe to call from a different thread than the one running the engine.
+   */
+  virtual void interrupt();
+
+  /** Returns true if interrupt() has been called on this prover
+   *  or the time / memory budget of its cancel token is exhausted
+   */
+  bool interrupted() const;
+
+  /** Replaces the cancel token, e.g. to share one token between provers
+   *  Must be set before calling initialize
+   *  @param token the new token, must be non-null
+   */
+  void set_cancel_token(const std::shared_ptr<CancelToken> & token);
+
+  /** @return the cancel token polled by this prover
+   *  use it to set budgets or register callbacks on cancellation
+   */
+  const std::shared_ptr<CancelToken> & cancel_token() const
+  {
+    return cancel_token_;
+  };
+
  protected:
   /** Take a term from the Prover's solver
    *  to the original transition system's solver
@@ -85,6 +116,16 @@ class Prover
    */
   smt::Term to_orig_ts(smt::Term t);
 
+  /** Take a witness with terms from the Prover's solver
+   *  and translate it to the original transition system's solver
+   *  @param wit the witness over the Prover's ts_ (e.g. witness_)
+   *  @param out the vector to populate with the translated witness
+   *  @return true if the witness is complete, false if it only
+   *          has values for the state variables
+   */
+  bool transfer_witness(const std::vector<smt::UnorderedTermMap> & wit,
+                        std::vector<smt::UnorderedTermMap> & out);
+
   /** Default implementation for computing a witness
    *  Assumes that this engine is unrolling-based and that the solver
    *   state is currently satisfiable with a counterexample trace
@@ -126,5 +167,7 @@ class Prover
 
   smt::Term invar_; ///< populated with an invariant if the engine supports it
 
+  std::shared_ptr<CancelToken> cancel_token_;  ///< polled by the engines
+
 };
 }  // namespace pono
@@ -0,0 +1,135 @@
+/*********************                                                        */
+/*! \file random_sim.cpp
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Bug hunting with random simulation.
+**
+**/
+
+#include "engines/random_sim.h"
+
+#include <chrono>
+
+#include "utils/logger.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+RandomSimulation::RandomSimulation(const Property & p,
+                                   const TransitionSystem & ts,
+                                   const SmtSolver & solver,
+                                   PonoOptions opt)
+    : super(p, ts, solver, opt), num_traces_(0)
+{
+}
+
+RandomSimulation::~RandomSimulation() {}
+
+void RandomSimulation::initialize()
+{
+  if (initialized_) {
+    return;
+  }
+
+  super::initialize();
+
+  sim_.reset(new Simulator(ts_));
+  sim_->add_signal(bad_);
+}
+
+ProverResult RandomSimulation::check_until(int k)
+{
+  initialize();
+
+  auto start = chrono::steady_clock::now();
+  size_t cycles = 0;
+  for (size_t i = 0; i < options_.sim_seeds_; ++i) {
+    if (interrupted()) {
+      logger.log(1, "Random simulation interrupted after {} traces", i);
+      return ProverResult::UNKNOWN;
+    }
+
+    uint64_t seed = options_.random_seed_ + num_traces_++;
+    int bad_step = run_trace(seed, k, nullptr);
+    if (bad_step >= 0) {
+      logger.log(1,
+                 "Random simulation reached a bad state at step {} of trace "
+                 "{}",
+                 bad_step,
+                 i);
+      // replay the trace to record it
+      witness_.clear();
+      run_trace(seed, bad_step, &witness_);
+      reached_k_ = bad_step - 1;
+      return ProverResult::FALSE;
+    }
+    cycles += k + 1;
+  }
+
+  double secs =
+      chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  logger.log(1,
+             "Random simulation of {} traces with {} steps each found no "
+             "counterexample ({} steps per second)",
+             options_.sim_seeds_,
+             k,
+             secs > 0 ? cycles / secs : 0);
+  return ProverResult::UNKNOWN;
+}
+
+int RandomSimulation::run_trace(uint64_t seed,
+                                int k,
+                                vector<UnorderedTermMap> * frames)
+{
+  sim_->seed(seed);
+
+  // inputs first, initial values can read them
+  // the last attempt leaves the uninitialized states at zero
+  bool init_ok = false;
+  for (size_t a = 0; !init_ok && a <= max_redraws_; ++a) {
+    sim_->randomize_inputs();
+    init_ok = sim_->reset(a < max_redraws_);
+  }
+  if (!init_ok) {
+    return -1;
+  }
+
+  for (int i = 0; i <= k; ++i) {
+    sim_->eval();
+    // the inputs of the initial state were chosen together with it
+    for (size_t a = 0; i > 0 && !sim_->constraints_hold() && a < max_redraws_;
+         ++a) {
+      sim_->randomize_inputs();
+      sim_->eval();
+    }
+    if (!sim_->constraints_hold()) {
+      return -1;
+    }
+
+    if (frames) {
+      frames->push_back(UnorderedTermMap());
+      sim_->get_frame(frames->back());
+    }
+    if (sim_->get(bad_)) {
+      return i;
+    }
+
+    if (!frames && (i & 1023) == 1023 && interrupted()) {
+      return -1;
+    }
+    sim_->advance();
+    sim_->randomize_inputs();
+  }
+  return -1;
+}
+
+}  // namespace pono
@@ -0,0 +1,73 @@
+/*********************                                                        */
+/*! \file random_sim.h
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Bug hunting with random simulation. Used as a cheap first stage
+**        before the formal engines (see --sim-first). It can only find
+**        counterexamples, so it never returns TRUE.
+**
+**/
+
+#pragma once
+
+#include <memory>
+
+#include "core/simulator.h"
+#include "engines/prover.h"
+
+namespace pono {
+
+class RandomSimulation : public Prover
+{
+ public:
+  /** @param ts a functional transition system, see Simulator for the
+   *         supported sorts and operators
+   *  Uses options sim_seeds_ (number of traces) and random_seed_
+   */
+  RandomSimulation(const Property & p,
+                   const TransitionSystem & ts,
+                   const smt::SmtSolver & solver,
+                   PonoOptions opt = PonoOptions());
+
+  ~RandomSimulation();
+
+  typedef Prover super;
+
+  /** Compiles the system, throws a PonoException if it cannot be simulated
+   */
+  void initialize() override;
+
+  /** Simulates sim_seeds_ random traces of k transitions
+   *  @return FALSE if one of them reaches a bad state, otherwise UNKNOWN
+   */
+  ProverResult check_until(int k) override;
+
+ protected:
+  /** Simulates one trace from a seed
+   *  Inputs that violate the constraints are redrawn a few times
+   *  before the trace is abandoned.
+   *  @param seed the seed of the trace, a trace is reproducible from it
+   *  @param k the number of transitions
+   *  @param frames if non-null, populated with the values of every state
+   *  @return the step that reached a bad state or -1
+   */
+  int run_trace(uint64_t seed,
+                int k,
+                std::vector<smt::UnorderedTermMap> * frames);
+
+  std::unique_ptr<Simulator> sim_;
+
+  size_t num_traces_;  ///< traces simulated so far, used to derive seeds
+
+  static const size_t max_redraws_ = 8;
+
+};  // class RandomSimulation
+
+}  // namespace pono
@@ -0,0 +1,313 @@
+/*********************                                                        */
+/*! \file aiger_encoder.cpp
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Reads AIGER files into an Aig and encodes it as a transition
+**        system over booleans.
+**
+**/
+
+#include "frontends/aiger_encoder.h"
+
+#include <fstream>
+#include <sstream>
+#include <unordered_set>
+
+#include "utils/exceptions.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+namespace {
+
+/** Reads the next line with a single literal */
+uint64_t read_lit(istream & in, const string & section)
+{
+  string line;
+  uint64_t l;
+  if (!getline(in, line) || !(istringstream(line) >> l)) {
+    throw PonoException("Expected a literal in the AIGER " + section
+                        + " section");
+  }
+  return l;
+}
+
+/** Reads a number of the binary and section */
+uint64_t read_delta(istream & in)
+{
+  uint64_t x = 0;
+  unsigned shift = 0;
+  int ch;
+  while (true) {
+    ch = in.get();
+    if (ch == EOF) {
+      throw PonoException("Unexpected end of the AIGER and section");
+    }
+    x |= uint64_t(ch & 0x7f) << shift;
+    if (!(ch & 0x80)) {
+      return x;
+    }
+    shift += 7;
+  }
+}
+
+}  // namespace
+
+AigerEncoder::AigerEncoder(string filename, TransitionSystem & ts)
+    : ts_(ts), solver_(ts.solver())
+{
+  ifstream in(filename, ios::binary);
+  if (!in.is_open()) {
+    throw PonoException("Could not open AIGER file " + filename);
+  }
+  parse(in);
+  encode();
+}
+
+AigerEncoder::AigerEncoder(istream & in, TransitionSystem & ts)
+    : ts_(ts), solver_(ts.solver())
+{
+  parse(in);
+  encode();
+}
+
+AigerEncoder::AigerEncoder(const Aig & aig,
+                           const vector<string> & input_names,
+                           const vector<string> & latch_names,
+                           TransitionSystem & ts)
+    : ts_(ts),
+      solver_(ts.solver()),
+      aig_(aig),
+      input_names_(input_names),
+      latch_names_(latch_names)
+{
+  if (input_names_.size() != aig_.inputs().size()
+      || latch_names_.size() != aig_.latches().size()) {
+    throw PonoException("AigerEncoder expects a name per input and latch");
+  }
+  encode();
+}
+
+void AigerEncoder::parse(istream & in)
+{
+  string header;
+  getline(in, header);
+  istringstream hs(header);
+  string fmt;
+  uint64_t M, I, L, O, A;
+  uint64_t B = 0, C = 0, J = 0, F = 0;
+  if (!(hs >> fmt >> M >> I >> L >> O >> A)
+      || (fmt != "aag" && fmt != "aig")) {
+    throw PonoException("Invalid AIGER header: " + header);
+  }
+  // optional AIGER 1.9 counts
+  hs >> B >> C >> J >> F;
+  if (J || F) {
+    throw PonoException("AIGER justice and fairness are not supported");
+  }
+  bool binary = (fmt == "aig");
+
+  var_map_[0] = Aig::aig_false;
+
+  for (uint64_t i = 0; i < I; ++i) {
+    uint64_t l = binary ? 2 * (i + 1) : read_lit(in, "input");
+    var_map_[l >> 1] = aig_.make_input();
+    input_names_.push_back("i" + std::to_string(i));
+  }
+
+  vector<uint64_t> latch_lits, next_lits, init_lits;
+  for (uint64_t i = 0; i < L; ++i) {
+    string line;
+    if (!getline(in, line)) {
+      throw PonoException("Expected a latch in the AIGER file");
+    }
+    istringstream ls(line);
+    uint64_t l = 2 * (I + i + 1);
+    uint64_t next;
+    if ((!binary && !(ls >> l)) || !(ls >> next)) {
+      throw PonoException("Invalid AIGER latch: " + line);
+    }
+    uint64_t init = 0;
+    ls >> init;
+    latch_lits.push_back(l);
+    next_lits.push_back(next);
+    init_lits.push_back(init);
+    var_map_[l >> 1] = aig_.make_latch();
+    latch_names_.push_back("l" + std::to_string(i));
+  }
+
+  vector<uint64_t> outputs, bads, constraints;
+  for (uint64_t i = 0; i < O; ++i) {
+    outputs.push_back(read_lit(in, "output"));
+  }
+  for (uint64_t i = 0; i < B; ++i) {
+    bads.push_back(read_lit(in, "bad state"));
+  }
+  for (uint64_t i = 0; i < C; ++i) {
+    constraints.push_back(read_lit(in, "constraint"));
+  }
+
+  for (uint64_t i = 0; i < A; ++i) {
+    uint64_t lhs, rhs0, rhs1;
+    if (binary) {
+      lhs = 2 * (I + L + i + 1);
+      rhs0 = lhs - read_delta(in);
+      rhs1 = rhs0 - read_delta(in);
+    } else {
+      string line;
+      if (!getline(in, line) || !(istringstream(line) >> lhs >> rhs0 >> rhs1))
+      {
+        throw PonoException("Invalid AIGER and gate: " + line);
+      }
+    }
+    file_ands_[lhs >> 1] = { rhs0, rhs1 };
+  }
+
+  // symbol table, up to the comment section
+  string line;
+  while (getline(in, line) && line != "c") {
+    if (line.size() < 2 || (line[0] != 'i' && line[0] != 'l')) {
+      continue;
+    }
+    size_t space = line.find(' ');
+    if (space == string::npos || space + 1 == line.size()) {
+      continue;
+    }
+    size_t idx = stoull(line.substr(1, space - 1));
+    string name = line.substr(space + 1);
+    if (line[0] == 'i' && idx < input_names_.size()) {
+      input_names_[idx] = name;
+    } else if (line[0] == 'l' && idx < latch_names_.size()) {
+      latch_names_[idx] = name;
+    }
+  }
+
+  for (uint64_t i = 0; i < L; ++i) {
+    AigLit latch = var_map_.at(latch_lits[i] >> 1);
+    aig_.set_next(latch, lit(next_lits[i]));
+    if (init_lits[i] == latch_lits[i]) {
+      // uninitialized
+      continue;
+    } else if (init_lits[i] > 1) {
+      throw PonoException("Invalid AIGER latch initial value "
+                          + std::to_string(init_lits[i]));
+    }
+    aig_.set_init(latch, init_lits[i] ? Aig::aig_true : Aig::aig_false);
+  }
+
+  for (auto c : constraints) {
+    aig_.add_constraint(lit(c));
+  }
+  // without bad states, the outputs are the bad states (AIGER 1.0)
+  for (auto b : (B ? bads : outputs)) {
+    aig_.add_bad(lit(b));
+  }
+}
+
+AigLit AigerEncoder::lit(uint64_t file_lit)
+{
+  uint64_t v = file_lit >> 1;
+  // iterative post-order traversal, the graph can be very deep
+  vector<uint64_t> to_visit({ v });
+  while (!to_visit.empty()) {
+    uint64_t u = to_visit.back();
+    if (var_map_.find(u) != var_map_.end()) {
+      to_visit.pop_back();
+      continue;
+    }
+    auto it = file_ands_.find(u);
+    if (it == file_ands_.end()) {
+      throw PonoException("AIGER literal " + std::to_string(2 * u)
+                          + " is not defined");
+    } else if (to_visit.size() > file_ands_.size() + 1) {
+      throw PonoException("Cyclic AIGER and gates");
+    }
+
+    uint64_t a = it->second.first >> 1;
+    uint64_t b = it->second.second >> 1;
+    bool ready = true;
+    for (auto x : { a, b }) {
+      if (var_map_.find(x) == var_map_.end()) {
+        to_visit.push_back(x);
+        ready = false;
+      }
+    }
+    if (ready) {
+      to_visit.pop_back();
+      AigLit la = Aig::negate_if(var_map_.at(a), it->second.first & 1);
+      AigLit lb = Aig::negate_if(var_map_.at(b), it->second.second & 1);
+      var_map_[u] = aig_.make_and(la, lb);
+    }
+  }
+  return Aig::negate_if(var_map_.at(v), file_lit & 1);
+}
+
+void AigerEncoder::encode()
+{
+  Sort boolsort = solver_->make_sort(BOOL);
+
+  unordered_set<string> used;
+  auto unique_name = [&used](const string & name) {
+    string res = name;
+    for (size_t k = 1; used.find(res) != used.end(); ++k) {
+      res = name + "_" + std::to_string(k);
+    }
+    used.insert(res);
+    return res;
+  };
+
+  // and gates are created after their fanins, so variables are in
+  // topological order
+  TermVec terms(aig_.num_vars());
+  terms[0] = solver_->make_term(false);
+  auto term = [&terms, this](AigLit l) {
+    const Term & t = terms[Aig::var(l)];
+    return Aig::is_negated(l) ? solver_->make_term(Not, t) : t;
+  };
+
+  const vector<AigLit> & inputs = aig_.inputs();
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    Term t = ts_.make_inputvar(unique_name(input_names_[i]), boolsort);
+    terms[Aig::var(inputs[i])] = t;
+    inputsvec_.push_back(t);
+  }
+  const vector<Aig::Latch> & latches = aig_.latches();
+  for (size_t i = 0; i < latches.size(); ++i) {
+    Term t = ts_.make_statevar(unique_name(latch_names_[i]), boolsort);
+    terms[Aig::var(latches[i].lit)] = t;
+    statesvec_.push_back(t);
+  }
+
+  for (uint32_t v = 0; v < aig_.num_vars(); ++v) {
+    if (aig_.is_and(v)) {
+      terms[v] =
+          solver_->make_term(And, term(aig_.fanin0(v)), term(aig_.fanin1(v)));
+    }
+  }
+
+  for (size_t i = 0; i < latches.size(); ++i) {
+    const Aig::Latch & l = latches[i];
+    if (l.init != l.lit) {
+      ts_.constrain_init(term(Aig::negate_if(l.lit, l.init == Aig::aig_false)));
+    }
+    ts_.assign_next(statesvec_[i], term(l.next));
+  }
+
+  for (auto c : aig_.constraints()) {
+    ts_.add_constraint(term(c));
+  }
+  for (auto b : aig_.bad()) {
+    propvec_.push_back(solver_->make_term(Not, term(b)));
+  }
+}
+
+}  // namespace pono
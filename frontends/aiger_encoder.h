@@ -0,0 +1,83 @@
+/*********************                                                        */
+/*! \file aiger_encoder.h
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Reads AIGER files (ASCII .aag and binary .aig, including the
+**        bad state and invariant constraint sections of AIGER 1.9)
+**        into an Aig and encodes it as a transition system over booleans.
+**        Without a bad state section, the outputs are the bad states.
+**
+**/
+
+#pragma once
+
+#include <istream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/aig.h"
+#include "core/ts.h"
+#include "smt-switch/smt.h"
+
+namespace pono {
+
+class AigerEncoder
+{
+ public:
+  AigerEncoder(std::string filename, TransitionSystem & ts);
+
+  /** @param in the contents of an AIGER file */
+  AigerEncoder(std::istream & in, TransitionSystem & ts);
+
+  /** Encodes a graph that was built in memory
+   *  @param input_names names of the inputs of aig
+   *  @param latch_names names of the latches of aig
+   */
+  AigerEncoder(const Aig & aig,
+               const std::vector<std::string> & input_names,
+               const std::vector<std::string> & latch_names,
+               TransitionSystem & ts);
+
+  /** @return one property per bad state, the negation of the bad state */
+  const smt::TermVec & propvec() const { return propvec_; }
+  const smt::TermVec & inputsvec() const { return inputsvec_; }
+  const smt::TermVec & statesvec() const { return statesvec_; }
+
+  /** @return the graph that was read, with inputs and latches in file order
+   */
+  const Aig & aig() const { return aig_; }
+
+ protected:
+  void parse(std::istream & in);
+  void encode();
+
+  /** @return the literal of the graph for a literal of the file */
+  AigLit lit(uint64_t file_lit);
+
+  TransitionSystem & ts_;
+  const smt::SmtSolver & solver_;
+
+  Aig aig_;
+
+  // ands of the file, which in ASCII files can be in any order
+  std::unordered_map<uint64_t, std::pair<uint64_t, uint64_t>> file_ands_;
+  // variables of the file to literals of aig_
+  std::unordered_map<uint64_t, AigLit> var_map_;
+
+  std::vector<std::string> input_names_;
+  std::vector<std::string> latch_names_;
+
+  smt::TermVec propvec_;
+  smt::TermVec inputsvec_;
+  smt::TermVec statesvec_;
+};
+
+}  // namespace pono
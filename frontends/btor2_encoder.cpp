@@ -20,6 +20,7 @@
 #include "utils/logger.h"
 
 #include <iostream>
+#include <memory>
 #include "assert.h"
 
 using namespace smt;
@@ -189,49 +190,38 @@ TermVec BTOR2Encoder::lazy_convert(const TermVec & tvec) const
 // output (with name)
 // for Verilog :  output reg xxx;
 
-// this function go over the file and record this case
-// when we encounter it again we shall replace the state's name
-void BTOR2Encoder::preprocess(const std::string& filename) {
-  FILE * input_file = fopen(filename.c_str(), "r");
-
-  if (!input_file) {
-    throw PonoException("Could not open " + filename);
-  }
-
-  reader_ = btor2parser_new();
-
-  if (!btor2parser_read_lines(reader_, input_file)) {
-    throw PonoException(std::string(btor2parser_error(reader_)));
-  }
-
-  it_ = btor2parser_iter_init(reader_);
+// this function goes over the remaining lines and records this case
+// when we encounter such a state we shall replace the state's name
+// it only runs once, the first time a state without a name is seen
+// and only looks at the lines already read into memory
+void BTOR2Encoder::collect_state_names(int64_t state_id, Btor2LineIterator it)
+{
+  state_names_collected_ = true;
 
-  std::unordered_set<uint64_t> unamed_state_ids;
-  while ((l_ = btor2parser_iter_next(&it_))) {
+  std::unordered_set<uint64_t> unamed_state_ids({ (uint64_t)state_id });
+  Btor2Line * l;
+  while ((l = btor2parser_iter_next(&it))) {
   
-    if (l_->tag == BTOR2_TAG_state) {
-      if (!l_->symbol) { // if we see state has no name, record it
-        unamed_state_ids.insert(l_->id);
+    if (l->tag == BTOR2_TAG_state) {
+      if (!l->symbol) { // if we see state has no name, record it
+        unamed_state_ids.insert(l->id);
       }
-    } else if (l_->tag == BTOR2_TAG_output && l_->symbol) {
+    } else if (l->tag == BTOR2_TAG_output && l->symbol) {
       // if we see an output with name
-      if (l_->nargs == 0)
-        throw PonoException("Missing term for id " + std::to_string(l_->id));
+      if (l->nargs == 0)
+        throw PonoException("Missing term for id " + std::to_string(l->id));
       // we'd like to know if it refers to a state without name
-      auto pos = unamed_state_ids.find(l_->args[0]); // so, *pos is its btor id
+      auto pos = unamed_state_ids.find(l->args[0]); // so, *pos is its btor id
       if ( pos != unamed_state_ids.end()) {
         // in such case, we record that we can name if with this new name
         auto state_name_pos = state_renaming_table.find(*pos);
         if ( state_name_pos == state_renaming_table.end() ) {
-          state_renaming_table.insert(std::make_pair(*pos, l_->symbol));
+          state_renaming_table.insert(std::make_pair(*pos, l->symbol));
         } // otherwise we already have a name for it, then just ignore this one
       }
     } // end of if input
   } // end of while
-
-  fclose(input_file);
-  btor2parser_delete(reader_);
-} // end of preprocess
+} // end of collect_state_names
 
 void BTOR2Encoder::parse(const std::string filename)
 {
@@ -241,9 +231,15 @@ void BTOR2Encoder::parse(const std::string filename)
     throw PonoException("Could not open " + filename);
   }
 
-  reader_ = btor2parser_new();
+  // the file is only read once, the lines are kept by the parser
+  // which is released on return, even if encoding fails
+  std::unique_ptr<Btor2Parser, decltype(&btor2parser_delete)> parser(
+      btor2parser_new(), btor2parser_delete);
+  reader_ = parser.get();
 
-  if (!btor2parser_read_lines(reader_, input_file)) {
+  bool read = btor2parser_read_lines(reader_, input_file);
+  fclose(input_file);
+  if (!read) {
     throw PonoException(std::string(btor2parser_error(reader_)));
   }
 
@@ -290,6 +286,9 @@ void BTOR2Encoder::parse(const std::string filename)
       if (l_->symbol) {
         symbol_ = l_->symbol;
       } else {
+        if (!state_names_collected_) {
+          collect_state_names(l_->id, it_);
+        }
         auto renaming_lookup_pos = state_renaming_table.find(l_->id);
         if (renaming_lookup_pos != state_renaming_table.end() )
           symbol_ = renaming_lookup_pos->second;
@@ -755,7 +754,12 @@ void BTOR2Encoder::parse(const std::string filename)
     assert(l_->tag == BTOR2_TAG_sort || terms_.find(l_->id) != terms_.end());
   }
 
-  fclose(input_file);
-  btor2parser_delete(reader_);
+  reader_ = nullptr;
+  // per-line lookup tables are not needed after parsing
+  // release them instead of keeping them for the lifetime of the encoder
+  std::unordered_map<int, Term>().swap(terms_);
+  std::unordered_map<int, Sort>().swap(sorts_);
+  termargs_.clear();
+  termargs_.shrink_to_fit();
 }
 }  // namespace pono
@@ -40,7 +40,6 @@ class BTOR2Encoder
   BTOR2Encoder(std::string filename, TransitionSystem & ts)
       : ts_(ts), solver_(ts.solver())
   {
-    preprocess(filename);
     parse(filename);
   };
 
@@ -64,9 +63,12 @@ class BTOR2Encoder
   // and lazily converts them to the majority
   smt::TermVec lazy_convert(const smt::TermVec &) const;
   
-  // preprocess a btor2 file
-  void preprocess(const std::string & filename);
-  // parse a btor2 file
+  // looks ahead from it for outputs that name unnamed states
+  // called lazily, the first time a state without a name is encountered
+  // @param state_id the id of that state
+  // @param it iterator pointing to the line after that state
+  void collect_state_names(int64_t state_id, Btor2LineIterator it);
+  // parse a btor2 file in a single pass
   void parse(const std::string filename);
 
   // Important members
@@ -79,6 +81,7 @@ class BTOR2Encoder
   smt::TermVec statesvec_;
   std::map<uint64_t, smt::Term> no_next_states_;
   std::unordered_map<uint64_t, std::string> state_renaming_table;
+  bool state_names_collected_{ false };
 
   // Useful variables
   smt::Sort linesort_;
@@ -0,0 +1,195 @@
+/*********************                                                        */
+/*! \file aig_reducer.cpp
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Replaces a transition system by its bit-blasted and reduced
+**        and-inverter graph.
+**
+**/
+
+#include "modifiers/aig_reducer.h"
+
+#include <string>
+
+#include "core/fts.h"
+#include "core/witness_trace.h"
+#include "frontends/aiger_encoder.h"
+#include "utils/exceptions.h"
+#include "utils/logger.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+AigReducer::AigReducer(TransitionSystem & ts, Term & prop)
+    : orig_ts_(ts), bad_(Aig::aig_false)
+{
+  const SmtSolver & solver = orig_ts_.solver();
+  blaster_.reset(new BitBlaster(orig_ts_, aig_));
+  bad_ = blaster_->blast(solver->make_term(Not, prop)).at(0);
+  aig_.add_bad(bad_);
+
+  // named terms are evaluated on the original graph for witnesses
+  for (const auto & elem : orig_ts_.named_terms()) {
+    const Term & t = elem.second;
+    if (orig_ts_.is_curr_var(t) || orig_ts_.is_input_var(t)) {
+      continue;
+    }
+    try {
+      blaster_->blast(t);
+      named_terms_.push_back(t);
+    }
+    catch (PonoException & e) {
+      logger.log(
+          2, "Named term {} is not in witnesses: {}", elem.first, e.what());
+    }
+  }
+
+  sweeper_.reset(new AigSweeper(aig_));
+  sweeper_->reduce();
+  const Aig & red = sweeper_->result();
+
+  logger.log(1,
+             "AIG reduction: {} -> {} latches, {} -> {} and gates ({} "
+             "merged gates, {} merged latches)",
+             aig_.latches().size(),
+             red.latches().size(),
+             aig_.num_ands(),
+             red.num_ands(),
+             sweeper_->num_merged_ands(),
+             sweeper_->num_merged_latches());
+
+  // names of the bits of the original variables
+  vector<string> orig_input_names(aig_.inputs().size());
+  vector<string> orig_latch_names(aig_.latches().size());
+  auto bit_name = [](const Term & v, size_t i, size_t width) {
+    return v->to_string() + ((width > 1) ? "[" + std::to_string(i) + "]" : "");
+  };
+  for (const auto & iv : blaster_->inputs()) {
+    const vector<AigLit> & bits = blaster_->var_bits(iv);
+    for (size_t i = 0; i < bits.size(); ++i) {
+      orig_input_names[aig_.input_index(bits[i])] =
+          bit_name(iv, i, bits.size());
+    }
+  }
+  for (const auto & sv : blaster_->states()) {
+    const vector<AigLit> & bits = blaster_->var_bits(sv);
+    for (size_t i = 0; i < bits.size(); ++i) {
+      orig_latch_names[aig_.latch_index(bits[i])] =
+          bit_name(sv, i, bits.size());
+    }
+  }
+
+  // the variables of the reduced graph are named after the original bits
+  // they come from, with a prefix to keep the symbols unique
+  vector<string> input_names(red.inputs().size());
+  vector<string> latch_names(red.latches().size());
+  for (size_t i = 0; i < aig_.inputs().size(); ++i) {
+    AigLit m = sweeper_->map(Aig::var(aig_.inputs()[i]));
+    if (m != AigSweeper::lit_undef) {
+      string & name = input_names[red.input_index(m)];
+      name = orig_input_names[i].empty() ? "i" + std::to_string(i)
+                                         : orig_input_names[i];
+    }
+  }
+  for (size_t i = 0; i < aig_.latches().size(); ++i) {
+    AigLit m = sweeper_->map(Aig::var(aig_.latches()[i].lit));
+    if (m == AigSweeper::lit_undef || Aig::is_negated(m) || !Aig::var(m)) {
+      continue;
+    }
+    string & name = latch_names[red.latch_index(m)];
+    if (name.empty()) {
+      name = orig_latch_names[i].empty() ? "l" + std::to_string(i)
+                                         : orig_latch_names[i];
+    }
+  }
+  for (auto & name : input_names) {
+    name = "aig." + name;
+  }
+  for (auto & name : latch_names) {
+    name = "aig." + name;
+  }
+
+  FunctionalTransitionSystem reduced(solver);
+  AigerEncoder enc(red, input_names, latch_names, reduced);
+  inputs_ = enc.inputsvec();
+  states_ = enc.statesvec();
+
+  ts = reduced;
+  prop = enc.propvec().at(0);
+}
+
+bool AigReducer::complete_witness(vector<UnorderedTermMap> & witness) const
+{
+  if (witness.empty()) {
+    return false;
+  }
+
+  const Aig & red = sweeper_->result();
+  auto bit = [](const UnorderedTermMap & m, const Term & v) {
+    auto it = m.find(v);
+    return it != m.end() && WitnessTrace::value_bits(it->second) == "1";
+  };
+
+  // the initial state of the witness, latches outside of the reduced
+  // graph start from their initial value
+  const vector<Aig::Latch> & latches = aig_.latches();
+  vector<bool> latch_vals(latches.size());
+  for (size_t i = 0; i < latches.size(); ++i) {
+    AigLit m = sweeper_->map(Aig::var(latches[i].lit));
+    if (m == AigSweeper::lit_undef) {
+      latch_vals[i] = (latches[i].init == Aig::aig_true);
+    } else if (!Aig::var(m)) {
+      latch_vals[i] = Aig::is_negated(m);
+    } else {
+      const Term & sv =
+          states_[red.latch_index(Aig::make_lit(Aig::var(m), false))];
+      latch_vals[i] = (bit(witness[0], sv) != Aig::is_negated(m));
+    }
+  }
+
+  vector<UnorderedTermMap> res;
+  vector<bool> input_vals(aig_.inputs().size());
+  vector<bool> vals;
+  for (const auto & frame : witness) {
+    for (size_t i = 0; i < input_vals.size(); ++i) {
+      AigLit m = sweeper_->map(Aig::var(aig_.inputs()[i]));
+      input_vals[i] = (m != AigSweeper::lit_undef)
+                      && bit(frame, inputs_[red.input_index(m)]);
+    }
+    vals = aig_.eval(latch_vals, input_vals);
+
+    res.push_back(UnorderedTermMap());
+    UnorderedTermMap & orig_frame = res.back();
+    for (const auto & sv : blaster_->states()) {
+      orig_frame[sv] = blaster_->eval(sv, vals);
+    }
+    for (const auto & iv : blaster_->inputs()) {
+      orig_frame[iv] = blaster_->eval(iv, vals);
+    }
+    for (const auto & t : named_terms_) {
+      orig_frame[t] = blaster_->eval(t, vals);
+    }
+
+    for (size_t i = 0; i < latches.size(); ++i) {
+      latch_vals[i] = Aig::lit_value(vals, latches[i].next);
+    }
+  }
+
+  witness = res;
+  if (!Aig::lit_value(vals, bad_)) {
+    logger.log(0, "AIG reduction: mapped witness does not reach a bad state");
+    return false;
+  }
+  return true;
+}
+
+}  // namespace pono
@@ -0,0 +1,72 @@
+/*********************                                                        */
+/*! \file aig_reducer.h
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Replaces a transition system by its bit-blasted and reduced
+**        and-inverter graph (see AigSweeper), encoded over booleans, so
+**        that any engine can run on the reduced system.
+**
+**/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "core/aig.h"
+#include "core/aig_sweeper.h"
+#include "core/bit_blaster.h"
+#include "core/ts.h"
+#include "smt-switch/smt.h"
+
+namespace pono {
+
+class AigReducer
+{
+ public:
+  /** Reduces the system on construction
+   *  @param ts a functional transition system over booleans and
+   *         bit-vectors, replaced by the reduced system
+   *  @param prop the property (over current state variables), replaced by
+   *         the property of the reduced system
+   *  throws a PonoException if ts cannot be bit-blasted, ts and prop are
+   *  not changed then
+   */
+  AigReducer(TransitionSystem & ts, smt::Term & prop);
+
+  /** Maps a witness of the reduced system to the original system
+   *  The inputs of the witness are replayed on the original graph from the
+   *  initial state of the witness. Inputs that were removed get the value
+   *  zero.
+   *  @param witness a witness over the reduced system, replaced by a witness
+   *         over the variables and named terms of the original system
+   *  @return true iff the mapped witness reaches the bad states
+   */
+  bool complete_witness(std::vector<smt::UnorderedTermMap> & witness) const;
+
+  /** @return a copy of the transition system before the reduction */
+  const TransitionSystem & orig_ts() const { return orig_ts_; }
+
+ protected:
+  TransitionSystem orig_ts_;
+  Aig aig_;  ///< the graph of orig_ts_
+  std::unique_ptr<BitBlaster> blaster_;
+  std::unique_ptr<AigSweeper> sweeper_;
+  AigLit bad_;
+
+  smt::TermVec named_terms_;  ///< named terms of orig_ts_ that were blasted
+
+  // variables of the reduced system, per input and latch of the reduced
+  // graph
+  smt::TermVec inputs_;
+  smt::TermVec states_;
+};
+
+}  // namespace pono
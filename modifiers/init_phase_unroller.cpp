@@ -0,0 +1,350 @@
+/*********************                                                        */
+/*! \file init_phase_unroller.cpp
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Temporal decomposition of a functional transition system.
+**
+**/
+
+#include "modifiers/init_phase_unroller.h"
+
+#include "assert.h"
+#include "core/fts.h"
+#include "smt-switch/utils.h"
+#include "smt/available_solvers.h"
+#include "utils/exceptions.h"
+#include "utils/logger.h"
+#include "utils/term_walkers.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+namespace {
+
+/** @return a fresh symbol for variable v at step k of the phase */
+Term phase_symbol(const SmtSolver & solver, const Term & v, size_t k)
+{
+  const string base =
+      "__internal_pono_init" + std::to_string(k) + "_" + v->to_string();
+  string name = base;
+  // the phase may have been unrolled before in the same solver
+  for (size_t n = 1;; ++n) {
+    try {
+      solver->get_symbol(name);
+    }
+    catch (SmtException & e) {
+      break;
+    }
+    name = base + "_" + std::to_string(n);
+  }
+  return solver->make_symbol(name, v->get_sort());
+}
+
+}  // namespace
+
+InitPhaseUnroller::InitPhaseUnroller(TransitionSystem & ts,
+                                     const TermVec & props,
+                                     size_t num_steps)
+    : orig_ts_(ts), num_steps_(num_steps)
+{
+  if (!ts.is_functional()) {
+    throw PonoException(
+        "Initialization phase unrolling requires a functional system");
+  }
+
+  const SmtSolver & solver = orig_ts_.solver();
+  const Term true_ = solver->make_term(true);
+  WordLevelRewriter rw(solver);
+
+  // queries run in a fresh solver, the solver of the system will be used by
+  // the engine
+  SmtSolver checker = create_solver(solver->get_solver_enum());
+  TermTranslator to_checker(checker);
+  TermTranslator to_orig(solver);
+  auto checker_term = [&to_checker](const Term & t) {
+    return to_checker.transfer_term(t, t->get_sort()->get_sort_kind());
+  };
+  size_t num_asserted = 0;
+  auto assert_conditions = [&]() {
+    for (; num_asserted < conditions_.size(); ++num_asserted) {
+      const Term & c = conditions_[num_asserted];
+      if (c != true_) {
+        checker->assert_formula(checker_term(c));
+      }
+    }
+  };
+
+  // states with an initial value start with it, the others with a symbol
+  steps_.resize(num_steps_ + 1);
+  UnorderedTermMap & first = steps_[0];
+  for (const auto & c : orig_ts_.init_conjuncts()) {
+    if (c->get_op() != Equal) {
+      continue;
+    }
+    TermVec children;
+    for (auto child : c) {
+      children.push_back(child);
+    }
+    assert(children.size() == 2);
+    for (size_t i = 0; i < 2; ++i) {
+      if (orig_ts_.is_curr_var(children[i]) && children[1 - i]->is_value()) {
+        first[children[i]] = children[1 - i];
+      }
+    }
+  }
+  for (const auto & sv : orig_ts_.statevars()) {
+    if (first.find(sv) == first.end()) {
+      first[sv] = phase_symbol(solver, sv, 0);
+    }
+  }
+  for (const auto & c : orig_ts_.init_conjuncts()) {
+    conditions_.push_back(rw.rewrite(at_step(c, 0)));
+  }
+
+  for (size_t k = 0; k < num_steps_; ++k) {
+    UnorderedTermMap & curr = steps_[k];
+    for (const auto & iv : orig_ts_.inputvars()) {
+      curr[iv] = phase_symbol(solver, iv, k);
+    }
+    assert_conditions();
+
+    for (const auto & p : props) {
+      checker->push();
+      checker->assert_formula(
+          checker->make_term(Not, checker_term(rw.rewrite(at_step(p, k)))));
+      Result r = checker->check_sat();
+      checker->pop();
+      if (!r.is_unsat()) {
+        throw PonoException("A property may fail at step " + std::to_string(k)
+                            + " of the initialization phase");
+      }
+    }
+
+    for (const auto & c : orig_ts_.constraints()) {
+      conditions_.push_back(rw.rewrite(at_step(c.first, k)));
+    }
+    assert_conditions();
+
+    UnorderedTermMap & next = steps_[k + 1];
+    TermVec candidates;
+    for (const auto & sv : orig_ts_.statevars()) {
+      auto it = orig_ts_.state_updates().find(sv);
+      if (it == orig_ts_.state_updates().end()) {
+        next[sv] = phase_symbol(solver, sv, k + 1);
+        continue;
+      }
+      Term t = rw.rewrite(at_step(it->second, k));
+      next[sv] = t;
+      const SortKind sk = t->get_sort()->get_sort_kind();
+      if (!t->is_value() && (sk == BV || sk == BOOL)) {
+        candidates.push_back(sv);
+      }
+    }
+
+    // find the states with the same value in every trace, starting from
+    // the values in one trace
+    Result r = checker->check_sat();
+    if (!r.is_sat()) {
+      throw PonoException("The initialization phase has no trace of length "
+                          + std::to_string(k + 1));
+    }
+    UnorderedTermMap vals;
+    for (const auto & sv : candidates) {
+      vals[sv] = checker->get_value(checker_term(next.at(sv)));
+    }
+    while (candidates.size()) {
+      Term differ;
+      for (const auto & sv : candidates) {
+        Term d = checker->make_term(
+            Not,
+            checker->make_term(Equal, checker_term(next.at(sv)), vals.at(sv)));
+        differ = differ ? checker->make_term(Or, differ, d) : d;
+      }
+      checker->push();
+      checker->assert_formula(differ);
+      r = checker->check_sat();
+      if (r.is_unsat()) {
+        checker->pop();
+        break;
+      } else if (!r.is_sat()) {
+        checker->pop();
+        throw PonoException("Unknown result in the initialization phase");
+      }
+      TermVec same;
+      for (const auto & sv : candidates) {
+        if (checker->get_value(checker_term(next.at(sv))) == vals.at(sv)) {
+          same.push_back(sv);
+        }
+      }
+      checker->pop();
+      assert(same.size() < candidates.size());
+      candidates = same;
+    }
+    for (const auto & sv : candidates) {
+      next[sv] = to_orig.transfer_term(
+          vals.at(sv), sv->get_sort()->get_sort_kind());
+    }
+  }
+
+  // symbols needed to describe the reached states, and the conditions
+  // over them (through shared symbols)
+  // the other conditions are satisfiable on their own, because the
+  // conditions are satisfiable together and share no symbols with them
+  const UnorderedTermMap & last = steps_.back();
+  size_t num_constant = 0;
+  for (const auto & elem : last) {
+    get_free_symbolic_consts(elem.second, frozen_);
+    num_constant += elem.second->is_value();
+  }
+  vector<UnorderedTermSet> cond_symbols(conditions_.size());
+  vector<bool> kept(conditions_.size(), false);
+  for (size_t i = 0; i < conditions_.size(); ++i) {
+    get_free_symbolic_consts(conditions_[i], cond_symbols[i]);
+  }
+  bool grown = true;
+  while (grown) {
+    grown = false;
+    for (size_t i = 0; i < conditions_.size(); ++i) {
+      if (kept[i]) {
+        continue;
+      }
+      for (const auto & v : cond_symbols[i]) {
+        if (frozen_.find(v) != frozen_.end()) {
+          kept[i] = true;
+          break;
+        }
+      }
+      if (kept[i]) {
+        frozen_.insert(cond_symbols[i].begin(), cond_symbols[i].end());
+        grown = true;
+      }
+    }
+  }
+
+  FunctionalTransitionSystem reduced(solver);
+  for (const auto & sv : orig_ts_.statevars()) {
+    reduced.add_statevar(sv, orig_ts_.next(sv));
+  }
+  for (const auto & iv : orig_ts_.inputvars()) {
+    reduced.add_inputvar(iv);
+  }
+  for (const auto & v : frozen_) {
+    Term next = solver->make_symbol(v->to_string() + ".next", v->get_sort());
+    reduced.add_statevar(v, next);
+    reduced.assign_next(v, v);
+  }
+  for (const auto & sv : orig_ts_.statevars()) {
+    reduced.constrain_init(solver->make_term(Equal, sv, last.at(sv)));
+  }
+  for (size_t i = 0; i < conditions_.size(); ++i) {
+    if (kept[i]) {
+      reduced.constrain_init(conditions_[i]);
+    }
+  }
+  for (const auto & elem : orig_ts_.state_updates()) {
+    reduced.assign_next(elem.first, elem.second);
+  }
+  for (const auto & c : orig_ts_.constraints()) {
+    reduced.add_constraint(c.first, c.second);
+  }
+  for (const auto & elem : orig_ts_.named_terms()) {
+    reduced.name_term(elem.first, elem.second);
+  }
+
+  logger.log(1,
+             "Unrolled {} steps of the initialization phase: {} of {} state "
+             "variables are constant, {} frozen variables",
+             num_steps_,
+             num_constant,
+             orig_ts_.statevars().size(),
+             frozen_.size());
+
+  ts = reduced;
+}
+
+bool InitPhaseUnroller::complete_witness(
+    vector<UnorderedTermMap> & witness) const
+{
+  if (witness.empty()) {
+    return true;
+  }
+
+  // solve in a fresh solver, so the solver of the system (which may
+  // still be used by a prover) is not touched
+  const SmtSolver & solver = orig_ts_.solver();
+  SmtSolver checker = create_solver(solver->get_solver_enum());
+  TermTranslator to_checker(checker);
+  TermTranslator to_orig(solver);
+  auto checker_term = [&to_checker](const Term & t) {
+    return to_checker.transfer_term(t, t->get_sort()->get_sort_kind());
+  };
+
+  const Term true_ = solver->make_term(true);
+  for (const auto & c : conditions_) {
+    if (c != true_) {
+      checker->assert_formula(checker_term(c));
+    }
+  }
+  // the phase ends in the first state of the witness
+  const UnorderedTermMap & first = witness[0];
+  for (const auto & elem : steps_.back()) {
+    auto it = first.find(elem.first);
+    if (it != first.end()) {
+      checker->assert_formula(checker->make_term(
+          Equal, checker_term(elem.second), checker_term(it->second)));
+    }
+  }
+  for (const auto & v : frozen_) {
+    auto it = first.find(v);
+    if (it != first.end()) {
+      checker->assert_formula(
+          checker->make_term(Equal, checker_term(v), checker_term(it->second)));
+    }
+  }
+
+  Result r = checker->check_sat();
+  if (!r.is_sat()) {
+    logger.log(0, "Failed to reconstruct the initialization phase");
+    return false;
+  }
+
+  vector<UnorderedTermMap> prefix(num_steps_);
+  for (size_t k = 0; k < num_steps_; ++k) {
+    UnorderedTermMap & valmap = prefix[k];
+    auto record = [&](const Term & t, const Term & t_at_k) {
+      const SortKind sk = t->get_sort()->get_sort_kind();
+      valmap[t] = to_orig.transfer_term(
+          checker->get_value(checker_term(t_at_k)), sk);
+    };
+    for (const auto & elem : steps_[k]) {
+      record(elem.first, elem.second);
+    }
+    for (const auto & elem : orig_ts_.named_terms()) {
+      record(elem.second, at_step(elem.second, k));
+    }
+  }
+
+  for (auto & valmap : witness) {
+    for (const auto & v : frozen_) {
+      valmap.erase(v);
+    }
+  }
+  witness.insert(witness.begin(), prefix.begin(), prefix.end());
+  return true;
+}
+
+Term InitPhaseUnroller::at_step(const Term & t, size_t k) const
+{
+  return orig_ts_.solver()->substitute(t, steps_.at(k));
+}
+
+}  // namespace pono
@@ -0,0 +1,82 @@
+/*********************                                                        */
+/*! \file init_phase_unroller.h
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Temporal decomposition of a functional transition system.
+**        The first steps (e.g. a reset sequence) are unrolled
+**        symbolically and the states reached after them become the
+**        initial states of a new system.
+**
+**/
+
+#pragma once
+
+#include <vector>
+
+#include "core/ts.h"
+#include "smt-switch/smt.h"
+
+namespace pono {
+
+class InitPhaseUnroller
+{
+ public:
+  /** Unrolls the initialization phase on construction
+   *  The states after num_steps steps are computed as terms over the
+   *  initial states and the inputs of the phase. States that have the same
+   *  value in every trace of the phase are found with a solver and
+   *  replaced by that value. The remaining initial states and inputs of
+   *  the phase that are needed to describe the reached states become
+   *  frozen state variables (their update is themselves), so the initial
+   *  states of the new system are exactly the states reached after the
+   *  phase.
+   *  @param ts a functional transition system, replaced by the new system
+   *  @param props properties over ts, which are checked during the phase
+   *  @param num_steps the number of steps to unroll
+   *  throws a PonoException if ts is not functional, if a property may
+   *  fail during the phase or if the phase has no trace, ts is not changed
+   *  then
+   */
+  InitPhaseUnroller(TransitionSystem & ts,
+                    const smt::TermVec & props,
+                    size_t num_steps);
+
+  /** Prepends the initialization phase to a witness of the new system
+   *  @param witness a witness over the new system, replaced by a witness
+   *         over the variables and named terms of the original system
+   *  @return true iff the phase could be reconstructed
+   */
+  bool complete_witness(std::vector<smt::UnorderedTermMap> & witness) const;
+
+  /** @return a copy of the transition system before the transformation */
+  const TransitionSystem & orig_ts() const { return orig_ts_; }
+
+  /** @return the variables added to the new system, which are constant */
+  const smt::UnorderedTermSet & frozen_vars() const { return frozen_; }
+
+ protected:
+  /** @return t at step k of the phase, k <= num_steps_ */
+  smt::Term at_step(const smt::Term & t, size_t k) const;
+
+  TransitionSystem orig_ts_;
+  size_t num_steps_;
+
+  // per step, the state and input variables of the original system as
+  // terms over the symbols of the phase (there are no inputs at the last
+  // step)
+  std::vector<smt::UnorderedTermMap> steps_;
+
+  /** initial state constraints and constraints of the phase */
+  smt::TermVec conditions_;
+
+  smt::UnorderedTermSet frozen_;
+};
+
+}  // namespace pono
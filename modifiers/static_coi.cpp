@@ -18,6 +18,7 @@
 
 #include "assert.h"
 #include "smt-switch/utils.h"
+#include "smt/available_solvers.h"
 #include "utils/logger.h"
 
 using namespace smt;
@@ -28,7 +29,7 @@ namespace pono {
 StaticConeOfInfluence::StaticConeOfInfluence(TransitionSystem & ts,
                                              const TermVec & to_keep,
                                              int verbosity)
-    : ts_(ts), verbosity_(verbosity), coi_(ts_, verbosity_)
+    : ts_(ts), orig_ts_(ts), verbosity_(verbosity), coi_(ts_, verbosity_)
 {
   logger.log(1, "Starting static cone-of-influence (COI) analysis:");
   logger.log(1, "  - input variables: {}", ts_.inputvars().size());
@@ -45,6 +46,8 @@ StaticConeOfInfluence::StaticConeOfInfluence(TransitionSystem & ts,
   assert(statevars_in_coi.size() <= ts_.statevars().size());
   assert(inputvars_in_coi.size() <= ts_.inputvars().size());
 
+  statevars_in_coi_ = statevars_in_coi;
+  inputvars_in_coi_ = inputvars_in_coi;
   ts_.rebuild_trans_based_on_coi(statevars_in_coi, inputvars_in_coi);
 
   // NOTE: Cannot expect ts_.statevars().size() == statevars_in_coi.size()
@@ -69,4 +72,113 @@ StaticConeOfInfluence::StaticConeOfInfluence(TransitionSystem & ts,
              "not be removed from system");
 }
 
+bool StaticConeOfInfluence::complete_witness(
+    std::vector<UnorderedTermMap> & witness) const
+{
+  // simulate in a fresh solver, so the solver of the system (which may
+  // still be used by a prover) is not touched
+  const SmtSolver & orig_solver = orig_ts_.solver();
+  SmtSolver sim = create_solver(orig_solver->get_solver_enum());
+  TermTranslator to_sim(sim);
+  TermTranslator to_orig(orig_solver);
+  TransitionSystem sim_ts(orig_ts_, to_sim);
+
+  auto sim_term = [&to_sim](const Term & t) {
+    return to_sim.transfer_term(t, t->get_sort()->get_sort_kind());
+  };
+
+  TermVec removed_states;
+  for (const auto & v : orig_ts_.statevars()) {
+    if (statevars_in_coi_.find(v) == statevars_in_coi_.end()) {
+      removed_states.push_back(v);
+    }
+  }
+  logger.log(1,
+             "COI: completing witness of length {} for {} removed state "
+             "variables",
+             witness.size(),
+             removed_states.size());
+
+  // pins the value of (the next state of) v to its value in the witness
+  auto assert_value = [&](const UnorderedTermMap & valmap,
+                          const Term & v,
+                          bool next) {
+    auto it = valmap.find(v);
+    if (it == valmap.end()) {
+      return;
+    }
+    Term sv = sim_term(v);
+    if (next) {
+      sv = sim_ts.next(sv);
+    }
+    sim->assert_formula(
+        sim->make_term(Equal, sv, sim_term(it->second)));
+  };
+
+  // values of the removed state variables in the current frame
+  UnorderedTermMap removed_vals;
+  for (size_t k = 0; k < witness.size(); ++k) {
+    const bool last = (k + 1 == witness.size());
+    sim->push();
+
+    if (!k) {
+      sim->assert_formula(sim_ts.init());
+    }
+    for (const auto & v : statevars_in_coi_) {
+      assert_value(witness[k], v, false);
+    }
+    for (const auto & v : inputvars_in_coi_) {
+      assert_value(witness[k], v, false);
+    }
+    for (const auto & elem : removed_vals) {
+      sim->assert_formula(sim->make_term(Equal, elem.first, elem.second));
+    }
+
+    if (!last) {
+      sim->assert_formula(sim_ts.trans());
+      for (const auto & v : statevars_in_coi_) {
+        assert_value(witness[k + 1], v, true);
+      }
+    } else {
+      for (const auto & c : sim_ts.constraints()) {
+        sim->assert_formula(c.first);
+      }
+    }
+
+    Result r = sim->check_sat();
+    if (!r.is_sat()) {
+      logger.log(0, "COI: failed to complete witness at frame {}", k);
+      sim->pop();
+      return false;
+    }
+
+    UnorderedTermMap & valmap = witness[k];
+    auto record = [&](const Term & t) {
+      const SortKind sk = t->get_sort()->get_sort_kind();
+      valmap[t] = to_orig.transfer_term(sim->get_value(sim_term(t)), sk);
+    };
+    for (const auto & v : orig_ts_.statevars()) {
+      record(v);
+    }
+    for (const auto & v : orig_ts_.inputvars()) {
+      record(v);
+    }
+    for (const auto & elem : orig_ts_.named_terms()) {
+      record(elem.second);
+    }
+
+    removed_vals.clear();
+    if (!last) {
+      for (const auto & v : removed_states) {
+        Term sv = sim_term(v);
+        removed_vals[sv] = sim->get_value(sim_ts.next(sv));
+      }
+    }
+
+    sim->pop();
+  }
+
+  return true;
+}
+
 }  // namespace pono
@@ -33,9 +33,25 @@ class StaticConeOfInfluence
                         const smt::TermVec & to_keep,
                         int verbosity = 1);
 
+  /** Completes a witness of the reduced system for the original system
+   *  Variables outside the cone-of-influence get their values by
+   *  simulating the removed logic forward, one frame at a time, from the
+   *  values in the witness. Removed inputs are unconstrained and get any
+   *  value that is consistent with the system.
+   *  @param witness a witness over the reduced system, the values of all
+   *         variables and named terms of the original system are
+   *         added to it in place
+   *  @return true iff every frame could be completed
+   */
+  bool complete_witness(std::vector<smt::UnorderedTermMap> & witness) const;
+
+  /** @return a copy of the transition system before the reduction */
+  const TransitionSystem & orig_ts() const { return orig_ts_; }
+
  protected:
 
   TransitionSystem & ts_;
+  TransitionSystem orig_ts_;
   int verbosity_;
 
   FunctionalConeOfInfluence coi_;  ///< class for computing symbols in
@@ -43,5 +59,9 @@ class StaticConeOfInfluence
 
   unsigned int orig_num_statevars_;
   unsigned int orig_num_inputvars_;
+
+  // variables kept in the reduced system
+  smt::UnorderedTermSet statevars_in_coi_;
+  smt::UnorderedTermSet inputvars_in_coi_;
 };
 }  // namespace pono
@@ -0,0 +1,392 @@
+/*********************                                                        */
+/*! \file ts_simplifier.cpp
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Word-level simplification of a functional transition system.
+**
+**/
+
+#include "modifiers/ts_simplifier.h"
+
+#include "assert.h"
+#include "core/fts.h"
+#include "smt-switch/utils.h"
+#include "smt/available_solvers.h"
+#include "utils/exceptions.h"
+#include "utils/logger.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+TransitionSystemSimplifier::TransitionSystemSimplifier(TransitionSystem & ts,
+                                                       TermVec & props)
+    : orig_ts_(ts), solver_(ts.solver())
+{
+  if (!ts.is_functional()) {
+    throw PonoException("Simplification requires a functional system");
+  }
+
+  // initial values of the form x = value
+  for (const auto & c : orig_ts_.init_conjuncts()) {
+    if (c->get_op() != Equal) {
+      continue;
+    }
+    TermVec children;
+    for (auto child : c) {
+      children.push_back(child);
+    }
+    assert(children.size() == 2);
+    for (size_t i = 0; i < 2; ++i) {
+      const Term & v = children[i];
+      const Term & val = children[1 - i];
+      if (orig_ts_.is_curr_var(v) && val->is_value()) {
+        init_vals_[v] = val;
+      }
+    }
+  }
+
+  // inputs of the properties are kept, constraints may not be checked in
+  // the last state of a trace
+  for (const auto & p : props) {
+    get_free_symbolic_consts(p, prop_vars_);
+  }
+
+  size_t num_constants = 0, num_inlined = 0, num_merged = 0;
+  size_t changed;
+  do {
+    changed = propagate_constants();
+    num_constants += changed;
+    size_t inlined = inline_inputs();
+    num_inlined += inlined;
+    changed += inlined;
+    size_t merged = merge_states();
+    num_merged += merged;
+    changed += merged;
+  } while (changed);
+
+  logger.log(1,
+             "Simplification: {} constant state variables, {} merged state "
+             "variables, {} inlined inputs",
+             num_constants,
+             num_merged,
+             num_inlined);
+
+  // rebuild the system over the remaining variables
+  FunctionalTransitionSystem reduced(solver_);
+  for (const auto & sv : orig_ts_.statevars()) {
+    if (subst_.find(sv) == subst_.end()) {
+      reduced.add_statevar(sv, orig_ts_.next(sv));
+    }
+  }
+  for (const auto & iv : orig_ts_.inputvars()) {
+    if (subst_.find(iv) == subst_.end()) {
+      reduced.add_inputvar(iv);
+    }
+  }
+
+  Term true_ = solver_->make_term(true);
+  // constraints added to init are also init conjuncts of the original
+  // system, only add them once
+  UnorderedTermSet init_added;
+  for (const auto & c : orig_ts_.constraints()) {
+    Term sc = simplify(c.first);
+    if (sc != true_) {
+      // constraints over inputs only apply to the transitions, even if
+      // the inputs were inlined
+      bool to_init_and_next = c.second && orig_ts_.only_curr(c.first);
+      reduced.add_constraint(sc, to_init_and_next);
+      if (to_init_and_next) {
+        init_added.insert(sc);
+      }
+    }
+  }
+  for (const auto & c : orig_ts_.init_conjuncts()) {
+    Term sc = simplify(c);
+    if (sc != true_ && init_added.insert(sc).second) {
+      reduced.constrain_init(sc);
+    }
+  }
+  for (const auto & elem : orig_ts_.state_updates()) {
+    if (subst_.find(elem.first) == subst_.end()) {
+      reduced.assign_next(elem.first, simplify(elem.second));
+    }
+  }
+  for (const auto & elem : orig_ts_.named_terms()) {
+    reduced.name_term(elem.first, simplify(elem.second));
+  }
+  for (auto & p : props) {
+    p = simplify(p);
+  }
+
+  logger.log(1,
+             "Simplification: {} remaining state variables, {} original",
+             reduced.statevars().size(),
+             orig_ts_.statevars().size());
+  logger.log(1,
+             "Simplification: {} remaining input variables, {} original",
+             reduced.inputvars().size(),
+             orig_ts_.inputvars().size());
+
+  ts = reduced;
+}
+
+bool TransitionSystemSimplifier::complete_witness(
+    vector<UnorderedTermMap> & witness) const
+{
+  // evaluate in a fresh solver, so the solver of the system (which may
+  // still be used by a prover) is not touched
+  const SmtSolver & orig_solver = orig_ts_.solver();
+  SmtSolver sim = create_solver(orig_solver->get_solver_enum());
+  TermTranslator to_sim(sim);
+  TermTranslator to_orig(orig_solver);
+
+  auto sim_term = [&to_sim](const Term & t) {
+    return to_sim.transfer_term(t, t->get_sort()->get_sort_kind());
+  };
+
+  for (size_t k = 0; k < witness.size(); ++k) {
+    UnorderedTermMap & valmap = witness[k];
+    sim->push();
+    for (const auto & elem : valmap) {
+      const Term & v = elem.first;
+      if (orig_ts_.is_curr_var(v) || orig_ts_.is_input_var(v)) {
+        sim->assert_formula(
+            sim->make_term(Equal, sim_term(v), sim_term(elem.second)));
+      }
+    }
+    for (const auto & elem : subst_) {
+      sim->assert_formula(
+          sim->make_term(Equal, sim_term(elem.first), sim_term(elem.second)));
+    }
+
+    Result r = sim->check_sat();
+    if (!r.is_sat()) {
+      logger.log(
+          0, "Simplification: failed to complete witness at frame {}", k);
+      sim->pop();
+      return false;
+    }
+
+    auto record = [&](const Term & t) {
+      const SortKind sk = t->get_sort()->get_sort_kind();
+      valmap[t] = to_orig.transfer_term(sim->get_value(sim_term(t)), sk);
+    };
+    for (const auto & v : orig_ts_.statevars()) {
+      record(v);
+    }
+    for (const auto & v : orig_ts_.inputvars()) {
+      record(v);
+    }
+    for (const auto & elem : orig_ts_.named_terms()) {
+      record(elem.second);
+    }
+    sim->pop();
+  }
+
+  return true;
+}
+
+size_t TransitionSystemSimplifier::propagate_constants()
+{
+  TermVec candidates;
+  for (const auto & sv : orig_ts_.statevars()) {
+    if (is_candidate(sv)) {
+      candidates.push_back(sv);
+    }
+  }
+
+  // assume all candidates are constant, and drop the ones whose update
+  // does not give back the constant under that assumption
+  bool dropped = true;
+  while (dropped && candidates.size()) {
+    UnorderedTermMap assumed = subst_;
+    for (const auto & sv : candidates) {
+      assumed[sv] = init_vals_.at(sv);
+    }
+    WordLevelRewriter rw(solver_, assumed);
+    TermVec kept;
+    for (const auto & sv : candidates) {
+      if (rw.rewrite(orig_ts_.state_updates().at(sv)) == assumed.at(sv)) {
+        kept.push_back(sv);
+      }
+    }
+    dropped = kept.size() < candidates.size();
+    candidates = kept;
+  }
+
+  UnorderedTermMap batch;
+  for (const auto & sv : candidates) {
+    batch[sv] = init_vals_.at(sv);
+  }
+  add_substitution(batch);
+  return batch.size();
+}
+
+size_t TransitionSystemSimplifier::inline_inputs()
+{
+  Term true_ = solver_->make_term(true);
+  size_t num_inlined = 0;
+  for (const auto & c : orig_ts_.constraints()) {
+    TermVec conjuncts;
+    conjunctive_partition(simplify(c.first), conjuncts);
+    for (auto conj : conjuncts) {
+      // earlier conjuncts may have been inlined
+      conj = simplify(conj);
+
+      Term x, e;
+      if (orig_ts_.is_input_var(conj)) {
+        x = conj;
+        e = true_;
+      } else if (conj->get_op() == Not
+                 && orig_ts_.is_input_var(*(conj->begin()))) {
+        x = *(conj->begin());
+        e = solver_->make_term(false);
+      } else if (conj->get_op() == Equal) {
+        TermVec children;
+        for (auto child : conj) {
+          children.push_back(child);
+        }
+        assert(children.size() == 2);
+        UnorderedTermSet free_vars;
+        for (size_t i = 0; i < 2 && !x; ++i) {
+          const Term & v = children[i];
+          const Term & other = children[1 - i];
+          if (!orig_ts_.is_input_var(v) || !orig_ts_.no_next(other)
+              || prop_vars_.find(v) != prop_vars_.end()) {
+            continue;
+          }
+          free_vars.clear();
+          get_free_symbolic_consts(other, free_vars);
+          if (free_vars.find(v) == free_vars.end()) {
+            x = v;
+            e = other;
+          }
+        }
+      }
+
+      if (x && subst_.find(x) == subst_.end()
+          && prop_vars_.find(x) == prop_vars_.end()) {
+        add_substitution({ { x, e } });
+        ++num_inlined;
+      }
+    }
+  }
+  return num_inlined;
+}
+
+size_t TransitionSystemSimplifier::merge_states()
+{
+  // candidate classes have the same initial value
+  vector<TermVec> classes;
+  {
+    unordered_map<Term, TermVec> by_init;
+    TermVec order;
+    for (const auto & sv : orig_ts_.statevars()) {
+      if (!is_candidate(sv)) {
+        continue;
+      }
+      const Term & val = init_vals_.at(sv);
+      TermVec & cls = by_init[val];
+      if (cls.empty()) {
+        order.push_back(val);
+      }
+      cls.push_back(sv);
+    }
+    for (const auto & val : order) {
+      if (by_init.at(val).size() > 1) {
+        classes.push_back(by_init.at(val));
+      }
+    }
+  }
+
+  // assume every class is merged into its first member, and split classes
+  // by the updates under that assumption until they agree
+  bool split = true;
+  while (split && classes.size()) {
+    UnorderedTermMap assumed = subst_;
+    for (const auto & cls : classes) {
+      for (size_t i = 1; i < cls.size(); ++i) {
+        assumed[cls[i]] = cls[0];
+      }
+    }
+    WordLevelRewriter rw(solver_, assumed);
+
+    split = false;
+    vector<TermVec> refined;
+    for (const auto & cls : classes) {
+      unordered_map<Term, size_t> by_update;
+      size_t first = refined.size();
+      for (const auto & sv : cls) {
+        Term u = rw.rewrite(orig_ts_.state_updates().at(sv));
+        auto it = by_update.find(u);
+        if (it == by_update.end()) {
+          by_update[u] = refined.size();
+          refined.push_back({ sv });
+        } else {
+          refined[it->second].push_back(sv);
+        }
+      }
+      split |= (refined.size() - first > 1);
+    }
+
+    classes.clear();
+    for (auto & cls : refined) {
+      if (cls.size() > 1) {
+        classes.push_back(cls);
+      }
+    }
+  }
+
+  UnorderedTermMap batch;
+  for (const auto & cls : classes) {
+    for (size_t i = 1; i < cls.size(); ++i) {
+      batch[cls[i]] = cls[0];
+    }
+  }
+  add_substitution(batch);
+  return batch.size();
+}
+
+void TransitionSystemSimplifier::add_substitution(
+    const UnorderedTermMap & batch)
+{
+  if (batch.empty()) {
+    return;
+  }
+  for (auto & elem : subst_) {
+    elem.second = solver_->substitute(elem.second, batch);
+  }
+  for (const auto & elem : batch) {
+    assert(subst_.find(elem.first) == subst_.end());
+    subst_[elem.first] = elem.second;
+  }
+  rewriter_.reset();
+}
+
+Term TransitionSystemSimplifier::simplify(const Term & t)
+{
+  if (!rewriter_) {
+    rewriter_.reset(new WordLevelRewriter(solver_, subst_));
+  }
+  return rewriter_->rewrite(t);
+}
+
+bool TransitionSystemSimplifier::is_candidate(const Term & sv) const
+{
+  const SortKind sk = sv->get_sort()->get_sort_kind();
+  return (sk == BV || sk == BOOL) && subst_.find(sv) == subst_.end()
+         && init_vals_.find(sv) != init_vals_.end()
+         && orig_ts_.state_updates().find(sv)
+                != orig_ts_.state_updates().end();
+}
+
+}  // namespace pono
@@ -0,0 +1,101 @@
+/*********************                                                        */
+/*! \file ts_simplifier.h
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Word-level simplification of a functional transition system.
+**        Removes constant state variables, merges state variables that
+**        are equal in every reachable state, inlines inputs that are
+**        fixed by a constraint and rewrites the remaining terms.
+**
+**/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "core/ts.h"
+#include "smt-switch/smt.h"
+#include "utils/term_walkers.h"
+
+namespace pono {
+
+class TransitionSystemSimplifier
+{
+ public:
+  /** Simplifies the system on construction
+   *  Repeats until nothing changes:
+   *   - state variables whose update always gives back their initial
+   *     value are replaced by that value
+   *   - inputs x constrained by x = e (x does not occur in e) are replaced
+   *     by e
+   *   - state variables with the same initial value whose updates are the
+   *     same once they are merged are replaced by one of them
+   *  Constants and merges are found optimistically: all candidates are
+   *  assumed first, and candidates whose update does not match under the
+   *  assumption are dropped until the rest is consistent, which makes
+   *  them hold in every reachable state by induction.
+   *  @param ts a functional transition system, replaced by the simplified
+   *         system
+   *  @param props properties over ts, replaced by simplified properties
+   *  throws a PonoException if ts is not functional, ts and props are
+   *  not changed then
+   */
+  TransitionSystemSimplifier(TransitionSystem & ts, smt::TermVec & props);
+
+  /** Completes a witness of the simplified system for the original system
+   *  The removed variables get the values of the terms that replaced
+   *  them.
+   *  @param witness a witness over the simplified system, the values of
+   *         all variables and named terms of the original system are added
+   *         to it in place
+   *  @return true iff every frame could be completed
+   */
+  bool complete_witness(std::vector<smt::UnorderedTermMap> & witness) const;
+
+  /** @return a copy of the transition system before the simplification */
+  const TransitionSystem & orig_ts() const { return orig_ts_; }
+
+  /** @return the removed variables, mapped to terms over the variables of
+   *          the simplified system
+   */
+  const smt::UnorderedTermMap & substitution() const { return subst_; }
+
+ protected:
+  /** @return the number of state variables that were found constant */
+  size_t propagate_constants();
+
+  /** @return the number of inputs that were inlined */
+  size_t inline_inputs();
+
+  /** @return the number of state variables that were merged */
+  size_t merge_states();
+
+  /** Adds replacements, which must be over variables that are kept */
+  void add_substitution(const smt::UnorderedTermMap & batch);
+
+  /** @return t with the replacements applied and rewritten */
+  smt::Term simplify(const smt::Term & t);
+
+  /** @return true iff sv can be removed by a constant or a merge */
+  bool is_candidate(const smt::Term & sv) const;
+
+  TransitionSystem orig_ts_;
+  smt::SmtSolver solver_;
+
+  smt::UnorderedTermMap init_vals_;  ///< state variables to their init value
+  smt::UnorderedTermMap subst_;  ///< removed variables to their replacement
+  smt::UnorderedTermSet prop_vars_;  ///< variables of the properties
+
+  /** rewriter for the current subst_, reset when it grows */
+  std::unique_ptr<WordLevelRewriter> rewriter_;
+};
+
+}  // namespace pono
@@ -16,6 +16,7 @@
 
 #include "options/options.h"
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <vector>
 #include "optionparser.h"
@@ -36,6 +37,9 @@ enum optionIndex
   VERBOSITY,
   RANDOM_SEED,
   VCDNAME,
+  VCDSIGNALS,
+  VCDREGEX,
+  VCDCOI,
   WITNESS,
   STATICCOI,
   SHOW_INVAR,
@@ -50,6 +54,12 @@ enum optionIndex
   IC3_GEN_MAX_ITER,
   IC3_FUNCTIONAL_PREIMAGE,
   NO_IC3_UNSATCORE_GEN,
+  IC3_CTG,
+  IC3_CTG_DEPTH,
+  IC3_CTG_MAX,
+  IC3_FRAME_SOLVERS,
+  IC3_PROP_THREADS,
+  IC3_TERNARY_PREGEN,
   NO_IC3IA_REDUCE_PREDS,
   NO_IC3SA_FUNC_REFINE,
   MBIC3_INDGEN_MODE,
@@ -68,7 +78,24 @@ enum optionIndex
   SYGUS_OP_LVL,
   SYGUS_TERM_MODE,
   IC3SA_INITIAL_TERMS_LVL,
-  IC3SA_INTERP
+  IC3SA_INTERP,
+  PORTFOLIO_ENGINES,
+  PORTFOLIO_SHARE_LEMMAS,
+  BMC_ALL_PROPS,
+  CHECK_ALL_PROPS,
+  JOBS,
+  TIME_LIMIT,
+  MEMORY_LIMIT,
+  IC3_CHECKPOINT,
+  IC3_CHECKPOINT_INTERVAL,
+  SAVE_SNAPSHOT,
+  SIM_FIRST,
+  SIM_CYCLES,
+  SIM_SEEDS,
+  MINE_INVARIANTS,
+  AIG_REDUCE,
+  SIMPLIFY,
+  UNROLL_INIT
 };
 
 struct Arg : public option::Arg
@@ -118,7 +145,9 @@ const option::Descriptor usage[] = {
     "engine",
     Arg::NonEmpty,
     "  --engine, -e <engine> \tSelect engine from [bmc, bmc-sp, ind, "
-    "interp, mbic3, ic3bits, ic3ia, msat-ic3ia, ic3sa, sygus-pdr]." },
+    "interp, mbic3, ic3bits, ic3ia, msat-ic3ia, ic3sa, sygus-pdr, "
+    "aig-bmc, aig-ic3, portfolio]. The aig engines bit-blast the system "
+    "and use a built-in SAT solver." },
   { BOUND,
     0,
     "k",
@@ -148,7 +177,29 @@ const option::Descriptor usage[] = {
     "",
     "vcd",
     Arg::NonEmpty,
-    "  --vcd \tName of Value Change Dump (VCD) if witness exists." },
+    "  --vcd \tName of Value Change Dump (VCD) if witness exists. "
+    "A name ending in .gz is written compressed (requires zlib)." },
+  { VCDSIGNALS,
+    0,
+    "",
+    "vcd-signals",
+    Arg::NonEmpty,
+    "  --vcd-signals \tComma-separated globs ('*', '?') of the signal names "
+    "to write to the VCD (default: all signals)." },
+  { VCDREGEX,
+    0,
+    "",
+    "vcd-regex",
+    Arg::NonEmpty,
+    "  --vcd-regex \tWrite the signals whose name matches this regex to the "
+    "VCD (combined with --vcd-signals by union)." },
+  { VCDCOI,
+    0,
+    "",
+    "vcd-coi",
+    Arg::None,
+    "  --vcd-coi \tOnly write signals in the cone-of-influence of the "
+    "property to the VCD." },
   { SMT_SOLVER,
     0,
     "",
@@ -250,6 +301,54 @@ const option::Descriptor usage[] = {
     " variants but also runs the risk of myopic over-generalization. Some IC3"
     " variants have better inductive generalization and do better with this"
     " option." },
+  { IC3_CTG,
+    0,
+    "",
+    "ic3-ctg",
+    Arg::None,
+    "  --ic3-ctg \tUse counterexample-guided inductive generalization in "
+    "ic3 (IC3, IC3Bits, MBIC3 with --mbic3-indgen-mode 0 and IC3IA): "
+    "counterexamples to dropping a literal are blocked at the previous "
+    "frame and literals are tried in order of activity." },
+  { IC3_CTG_DEPTH,
+    0,
+    "",
+    "ic3-ctg-depth",
+    Arg::Numeric,
+    "  --ic3-ctg-depth \tMax recursion depth for blocking counterexamples "
+    "to generalization with --ic3-ctg (default: 1)." },
+  { IC3_CTG_MAX,
+    0,
+    "",
+    "ic3-ctg-max",
+    Arg::Numeric,
+    "  --ic3-ctg-max \tMax number of counterexamples to generalization "
+    "blocked per literal drop attempt with --ic3-ctg (default: 3)." },
+  { IC3_FRAME_SOLVERS,
+    0,
+    "",
+    "ic3-frame-solvers",
+    Arg::None,
+    "  --ic3-frame-solvers \tUse a separate solver per frame in ic3 for the "
+    "queries that don't need a model (generalization, propagation and "
+    "blocked checks). Lemmas are only added to the solvers of the frames "
+    "they hold in." },
+  { IC3_PROP_THREADS,
+    0,
+    "",
+    "ic3-prop-threads",
+    Arg::Numeric,
+    "  --ic3-prop-threads \tNumber of threads pushing the lemmas of a frame "
+    "in ic3 propagation, each with its own solver (default: 1, 0 for the "
+    "number of hardware threads)." },
+  { IC3_TERNARY_PREGEN,
+    0,
+    "",
+    "ic3-ternary-pregen",
+    Arg::None,
+    "  --ic3-ternary-pregen \tGeneralize predecessors in ic3 with ternary "
+    "simulation of the next state functions instead of unsat cores (only "
+    "for deterministic systems, requires --ic3-pregen for mbic3)." },
   { NO_IC3IA_REDUCE_PREDS,
     0,
     "",
@@ -386,6 +485,144 @@ const option::Descriptor usage[] = {
     Arg::None,
     "  --ic3sa-interp \tuse interpolants to find more terms during refinement "
     "(default: off)" },
+  { PORTFOLIO_ENGINES,
+    0,
+    "",
+    "portfolio-engines",
+    Arg::NonEmpty,
+    "  --portfolio-engines <engine list> \tComma-separated list of engines "
+    "run in parallel threads by the portfolio engine. The first definitive "
+    "result is reported. An engine can be repeated, each instance uses a "
+    "different random seed (default: bmc,ind,mbic3)." },
+  { PORTFOLIO_SHARE_LEMMAS,
+    0,
+    "",
+    "portfolio-share-lemmas",
+    Arg::None,
+    "  --portfolio-share-lemmas \tShare learned lemmas between the IC3 "
+    "instances of the portfolio (default: false)" },
+  { BMC_ALL_PROPS,
+    0,
+    "",
+    "bmc-all-props",
+    Arg::None,
+    "  --bmc-all-props \tCheck all properties in the file with a single "
+    "shared bmc unrolling and report a result per property. Ignores --prop "
+    "(only supported with bmc)." },
+  { CHECK_ALL_PROPS,
+    0,
+    "",
+    "check-all-props",
+    Arg::None,
+    "  --check-all-props \tCheck all properties in the file on a pool of "
+    "threads, one prover per property with the selected engine. Properties "
+    "with overlapping cones of influence share a sliced system and proven "
+    "properties are assumed for the rest. Ignores --prop." },
+  { JOBS,
+    0,
+    "",
+    "jobs",
+    Arg::Numeric,
+    "  --jobs \tNumber of worker threads for --check-all-props "
+    "(default: 0, the number of hardware threads)" },
+  { SAVE_SNAPSHOT,
+    0,
+    "",
+    "save-snapshot",
+    Arg::NonEmpty,
+    "  --save-snapshot <file> \tWrite the parsed transition system and its "
+    "properties to a binary snapshot. Files with extension .ptss are "
+    "read back as snapshots instead of being parsed." },
+  { TIME_LIMIT,
+    0,
+    "",
+    "time-limit",
+    Arg::Numeric,
+    "  --time-limit \tWall-clock budget in seconds, counted from the start of "
+    "checking. Engines stop between solver calls and return unknown once it "
+    "is exhausted (default: 0, no limit)" },
+  { MEMORY_LIMIT,
+    0,
+    "",
+    "memory-limit",
+    Arg::Numeric,
+    "  --memory-limit \tPeak memory budget in megabytes. Engines stop between "
+    "solver calls and return unknown once it is exhausted (default: 0, no "
+    "limit)" },
+  { IC3_CHECKPOINT,
+    0,
+    "",
+    "ic3-checkpoint",
+    Arg::NonEmpty,
+    "  --ic3-checkpoint <file> \tPeriodically save the IC3 frames to <file> "
+    "and when stopping early. If the file exists, IC3 warm-starts from it, "
+    "re-checking every saved lemma (only for IC3 engines)." },
+  { IC3_CHECKPOINT_INTERVAL,
+    0,
+    "",
+    "ic3-checkpoint-interval",
+    Arg::Numeric,
+    "  --ic3-checkpoint-interval \tMinimum number of seconds between two "
+    "IC3 checkpoints (default: 600)" },
+  { SIM_FIRST,
+    0,
+    "",
+    "sim-first",
+    Arg::None,
+    "  --sim-first \tSimulate random traces before running the engine and "
+    "stop with a counterexample if one of them reaches a bad state (only "
+    "for functional systems)" },
+  { SIM_CYCLES,
+    0,
+    "",
+    "sim-cycles",
+    Arg::Numeric,
+    "  --sim-cycles \tNumber of steps of each random trace of --sim-first "
+    "(default: 1000)" },
+  { SIM_SEEDS,
+    0,
+    "",
+    "sim-seeds",
+    Arg::Numeric,
+    "  --sim-seeds \tNumber of random traces of --sim-first, seeded from "
+    "--random-seed (default: 64)" },
+  { MINE_INVARIANTS,
+    0,
+    "",
+    "mine-invariants",
+    Arg::None,
+    "  --mine-invariants \tPropose invariants (constants, equivalences and "
+    "implications between state variables) from --sim-seeds random traces "
+    "of --sim-cycles steps, and start IC3 and k-induction from the ones "
+    "that are proven inductive (only for functional systems)" },
+  { AIG_REDUCE,
+    0,
+    "",
+    "aig-reduce",
+    Arg::None,
+    "  --aig-reduce \tBit-blast the system to an and-inverter graph, reduce "
+    "it with rewriting, SAT sweeping and latch correspondence, and run the "
+    "engine on the reduced system. Witnesses are mapped back to the "
+    "original system, invariants are over the reduced system (only for "
+    "functional systems over booleans and bit-vectors)" },
+  { SIMPLIFY,
+    0,
+    "",
+    "simplify",
+    Arg::None,
+    "  --simplify \tSimplify the system before the engine: propagate constant "
+    "registers, merge registers with the same initial value and update, "
+    "inline inputs fixed by constraints and rewrite extracts, concats and "
+    "ites (only for functional systems)" },
+  { UNROLL_INIT,
+    0,
+    "",
+    "unroll-init",
+    Arg::Numeric,
+    "  --unroll-init \tUnroll this many initial steps (e.g. the --resetsteps "
+    "of a reset sequence), check the property on them, and start the "
+    "engine from the states reached after them. Witnesses include the "
+    "unrolled steps (only for functional systems, default: 0 (disabled))" },
   { 0, 0, 0, 0, 0, 0 }
 };
 /*********************************** end Option Handling setup
@@ -404,6 +641,9 @@ const std::unordered_set<Engine> ic3_variants_set({ IC3_BOOL,
 const std::unordered_set<Engine> & ic3_variants() { return ic3_variants_set; }
 
 const std::string PonoOptions::default_profiling_log_filename_ = "";
+const std::vector<Engine> PonoOptions::default_portfolio_engines_({ BMC,
+                                                                     KIND,
+                                                                     MBIC3 });
 
 Engine PonoOptions::to_engine(std::string s)
 {
@@ -469,6 +709,9 @@ ProverResult PonoOptions::parse_and_set_options(int argc,
           vcd_name_ = opt.arg;
           witness_ = true;  // implicitly enabling witness
           break;
+        case VCDSIGNALS: vcd_signals_ = opt.arg; break;
+        case VCDREGEX: vcd_regex_ = opt.arg; break;
+        case VCDCOI: vcd_coi_ = true; break;
         case SMT_SOLVER: {
           if (opt.arg == std::string("btor")) {
             smt_solver_ = smt::BTOR;
@@ -501,6 +744,12 @@ ProverResult PonoOptions::parse_and_set_options(int argc,
           break;
         case IC3_FUNCTIONAL_PREIMAGE: ic3_functional_preimage_ = true; break;
         case NO_IC3_UNSATCORE_GEN: ic3_unsatcore_gen_ = false; break;
+        case IC3_CTG: ic3_ctg_ = true; break;
+        case IC3_CTG_DEPTH: ic3_ctg_depth_ = atoi(opt.arg); break;
+        case IC3_CTG_MAX: ic3_ctg_max_ = atoi(opt.arg); break;
+        case IC3_FRAME_SOLVERS: ic3_frame_solvers_ = true; break;
+        case IC3_PROP_THREADS: ic3_prop_threads_ = atoi(opt.arg); break;
+        case IC3_TERNARY_PREGEN: ic3_ternary_pregen_ = true; break;
         case NO_IC3IA_REDUCE_PREDS: ic3ia_reduce_preds_ = false;
         case NO_IC3SA_FUNC_REFINE: ic3sa_func_refine_ = false; break;
         case PROFILING_LOG_FILENAME:
@@ -533,7 +782,44 @@ ProverResult PonoOptions::parse_and_set_options(int argc,
           }
           break;
         }
-        case IC3SA_INTERP: ic3sa_interp_ = true;
+        case IC3SA_INTERP: ic3sa_interp_ = true; break;
+        case PORTFOLIO_ENGINES: {
+          portfolio_engines_.clear();
+          std::stringstream ss(opt.arg);
+          std::string e;
+          while (std::getline(ss, e, ',')) {
+            if (e.empty()) {
+              continue;
+            }
+            Engine pe = to_engine(e);
+            if (pe == PORTFOLIO) {
+              throw PonoException("Portfolio engine cannot be nested");
+            }
+            portfolio_engines_.push_back(pe);
+          }
+          if (portfolio_engines_.empty()) {
+            throw PonoException("Expecting at least one portfolio engine");
+          }
+          break;
+        }
+        case PORTFOLIO_SHARE_LEMMAS: portfolio_share_lemmas_ = true; break;
+        case BMC_ALL_PROPS: bmc_all_props_ = true; break;
+        case CHECK_ALL_PROPS: check_all_props_ = true; break;
+        case JOBS: jobs_ = atoi(opt.arg); break;
+        case TIME_LIMIT: time_limit_ = atoi(opt.arg); break;
+        case MEMORY_LIMIT: memory_limit_ = atoi(opt.arg); break;
+        case IC3_CHECKPOINT: ic3_checkpoint_ = opt.arg; break;
+        case IC3_CHECKPOINT_INTERVAL:
+          ic3_checkpoint_interval_ = atoi(opt.arg);
+          break;
+        case SAVE_SNAPSHOT: snapshot_name_ = opt.arg; break;
+        case SIM_FIRST: sim_first_ = true; break;
+        case SIM_CYCLES: sim_cycles_ = atoi(opt.arg); break;
+        case SIM_SEEDS: sim_seeds_ = atoi(opt.arg); break;
+        case MINE_INVARIANTS: mine_invariants_ = true; break;
+        case AIG_REDUCE: aig_reduce_ = true; break;
+        case SIMPLIFY: simplify_ = true; break;
+        case UNROLL_INIT: unroll_init_ = atoi(opt.arg); break;
         case UNKNOWN_OPTION:
           // not possible because Arg::Unknown returns ARG_ILLEGAL
           // which aborts the parse with an error
@@ -557,6 +843,41 @@ ProverResult PonoOptions::parse_and_set_options(int argc,
           "CVC4 cannot handle multiple solver instances, and thus does not "
           "currently support IC3 variants.");
     }
+
+    if (ic3_ctg_ && engine_ == Engine::MBIC3 && mbic3_indgen_mode != 0) {
+      throw PonoException(
+          "--ic3-ctg is only supported by mbic3 with --mbic3-indgen-mode 0");
+    }
+
+    if (bmc_all_props_ && engine_ != Engine::BMC) {
+      throw PonoException("--bmc-all-props is only supported with bmc");
+    }
+
+    if (bmc_all_props_ && (pseudo_init_prop_ || assume_prop_ || aig_reduce_)) {
+      throw PonoException(
+          "--bmc-all-props is incompatible with --pseudo-init-prop, "
+          "--assume-prop and --aig-reduce");
+    }
+
+    if (check_all_props_
+        && (bmc_all_props_ || pseudo_init_prop_ || assume_prop_
+            || aig_reduce_)) {
+      throw PonoException(
+          "--check-all-props is incompatible with --bmc-all-props, "
+          "--pseudo-init-prop, --assume-prop and --aig-reduce");
+    }
+
+    if (check_all_props_ && smt_solver_ == smt::CVC4) {
+      throw PonoException(
+          "CVC4 cannot handle multiple solver instances, and thus does not "
+          "currently support --check-all-props.");
+    }
+
+    if (smt_solver_ == smt::CVC4 && engine_ == Engine::PORTFOLIO) {
+      throw PonoException(
+          "CVC4 cannot handle multiple solver instances, and thus does not "
+          "currently support the portfolio engine.");
+    }
   }
   catch (PonoException & ce) {
     cout << ce.what() << endl;
@@ -632,6 +953,18 @@ string to_string(Engine e)
       res = "sygus-pdr";
       break;
     }
+    case AIG_BMC: {
+      res = "aig-bmc";
+      break;
+    }
+    case AIG_IC3: {
+      res = "aig-ic3";
+      break;
+    }
+    case PORTFOLIO: {
+      res = "portfolio";
+      break;
+    }
     default: {
       throw PonoException("Unhandled engine: " + std::to_string(e));
     }
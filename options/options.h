@@ -19,6 +19,7 @@
 #include <iostream>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "core/proverresult.h"
 #include "smt-switch/smt.h"
@@ -39,7 +40,10 @@ enum Engine
   IC3IA_ENGINE,
   MSAT_IC3IA,
   IC3SA_ENGINE,
-  SYGUS_PDR
+  SYGUS_PDR,
+  AIG_BMC,
+  AIG_IC3,
+  PORTFOLIO
   // NOTE: if adding an IC3 variant,
   // make sure to update ic3_variants_set in options/options.cpp
   // used for setting solver options appropriately
@@ -65,7 +69,10 @@ const std::unordered_map<std::string, Engine> str2engine(
       { "ic3ia", IC3IA_ENGINE },
       { "msat-ic3ia", MSAT_IC3IA },
       { "ic3sa", IC3SA_ENGINE },
-      { "sygus-pdr", SYGUS_PDR } });
+      { "sygus-pdr", SYGUS_PDR },
+      { "aig-bmc", AIG_BMC },
+      { "aig-ic3", AIG_IC3 },
+      { "portfolio", PORTFOLIO } });
 
 // SyGuS mode option
 enum SyGuSTermMode{
@@ -92,6 +99,7 @@ class PonoOptions
         bound_(default_bound_),
         verbosity_(default_verbosity_),
         witness_(default_witness_),
+        vcd_coi_(default_vcd_coi_),
         reset_bnd_(default_reset_bnd_),
         random_seed_(default_random_seed),
         smt_solver_(default_smt_solver_),
@@ -105,6 +113,12 @@ class PonoOptions
         mbic3_indgen_mode(default_mbic3_indgen_mode),
         ic3_functional_preimage_(default_ic3_functional_preimage_),
         ic3_unsatcore_gen_(default_ic3_unsatcore_gen_),
+        ic3_ctg_(default_ic3_ctg_),
+        ic3_ctg_depth_(default_ic3_ctg_depth_),
+        ic3_ctg_max_(default_ic3_ctg_max_),
+        ic3_frame_solvers_(default_ic3_frame_solvers_),
+        ic3_prop_threads_(default_ic3_prop_threads_),
+        ic3_ternary_pregen_(default_ic3_ternary_pregen_),
         ic3ia_reduce_preds_(default_ic3ia_reduce_preds_),
         ic3sa_func_refine_(default_ic3sa_func_refine_),
         profiling_log_filename_(default_profiling_log_filename_),
@@ -127,7 +141,22 @@ class PonoOptions
         sygus_use_operator_abstraction_(
             default_sygus_use_operator_abstraction_),
         ic3sa_initial_terms_lvl_(default_ic3sa_initial_terms_lvl_),
-        ic3sa_interp_(default_ic3sa_interp_)
+        ic3sa_interp_(default_ic3sa_interp_),
+        portfolio_engines_(default_portfolio_engines_),
+        portfolio_share_lemmas_(default_portfolio_share_lemmas_),
+        bmc_all_props_(default_bmc_all_props_),
+        check_all_props_(default_check_all_props_),
+        jobs_(default_jobs_),
+        time_limit_(default_time_limit_),
+        memory_limit_(default_memory_limit_),
+        ic3_checkpoint_interval_(default_ic3_checkpoint_interval_),
+        sim_first_(default_sim_first_),
+        sim_cycles_(default_sim_cycles_),
+        sim_seeds_(default_sim_seeds_),
+        mine_invariants_(default_mine_invariants_),
+        aig_reduce_(default_aig_reduce_),
+        simplify_(default_simplify_),
+        unroll_init_(default_unroll_init_)
   {
   }
 
@@ -159,6 +188,9 @@ class PonoOptions
   unsigned int random_seed_;
   bool witness_;
   std::string vcd_name_;
+  std::string vcd_signals_;  ///< comma-separated globs of signals in the VCD
+  std::string vcd_regex_;    ///< regex of signals in the VCD
+  bool vcd_coi_;  ///< only write signals in the cone-of-influence to the VCD
   std::string reset_name_;
   size_t reset_bnd_;
   std::string clock_name_;
@@ -177,6 +209,15 @@ class PonoOptions
   bool ic3_functional_preimage_; ///< functional preimage in IC3
   bool ic3_unsatcore_gen_;  ///< generalize a cube during relative inductiveness
                             ///< check with unsatcore
+  bool ic3_ctg_;  ///< counterexample-guided inductive generalization in IC3
+  unsigned int ic3_ctg_depth_;  ///< max recursion depth of ctg generalization
+  unsigned int ic3_ctg_max_;    ///< max blocked ctgs per literal drop attempt
+  bool ic3_frame_solvers_;  ///< one solver per frame for IC3 queries that
+                            ///< don't need a model
+  size_t ic3_prop_threads_;  ///< threads for ic3 propagation, 0 for hardware
+                             ///< threads
+  bool ic3_ternary_pregen_;  ///< predecessor generalization with ternary
+                             ///< simulation in IC3 (deterministic systems)
   bool ic3ia_reduce_preds_;  ///< reduce predicates with unsatcore in IC3IA
   bool ic3sa_func_refine_;  ///< try functional unrolling in refinement
   std::string profiling_log_filename_;
@@ -204,6 +245,25 @@ class PonoOptions
   size_t ic3sa_initial_terms_lvl_;  ///< configures where to find terms for
                                     ///< initial abstraction
   bool ic3sa_interp_;
+  // portfolio options
+  std::vector<Engine> portfolio_engines_;  ///< engines raced by the portfolio
+  bool portfolio_share_lemmas_;  ///< share lemmas between portfolio IC3s
+  bool bmc_all_props_;  ///< check all properties with one bmc unrolling
+  bool check_all_props_;  ///< check all properties on a pool of threads
+  size_t jobs_;  ///< number of worker threads, 0 for hardware threads
+  std::string snapshot_name_;  ///< write the parsed system to this snapshot
+  size_t time_limit_;    ///< wall-clock budget per prover in seconds, 0 for none
+  size_t memory_limit_;  ///< peak memory budget in megabytes, 0 for none
+  std::string ic3_checkpoint_;  ///< file to save / warm-start IC3 frames
+  size_t ic3_checkpoint_interval_;  ///< seconds between IC3 checkpoints
+  bool sim_first_;  ///< hunt for bugs with random simulation first
+  size_t sim_cycles_;  ///< length of the random simulation traces
+  size_t sim_seeds_;  ///< number of random simulation traces
+  bool mine_invariants_;  ///< seed engines with invariants mined from
+                          ///< random simulation
+  bool aig_reduce_;  ///< reduce the bit-blasted system before the engine
+  bool simplify_;  ///< word-level simplification before the engine
+  size_t unroll_init_;  ///< initial steps to unroll before the engine
 
  private:
   // Default options
@@ -213,6 +273,7 @@ class PonoOptions
   static const unsigned int default_verbosity_ = 0;
   static const unsigned int default_random_seed = 0;
   static const bool default_witness_ = false;
+  static const bool default_vcd_coi_ = false;
   static const bool default_static_coi_ = false;
   static const bool default_show_invar_ = false;
   static const bool default_check_invar_ = false;
@@ -227,6 +288,12 @@ class PonoOptions
   static const unsigned int default_mbic3_indgen_mode = 0;
   static const bool default_ic3_functional_preimage_ = false;
   static const bool default_ic3_unsatcore_gen_ = true;
+  static const bool default_ic3_ctg_ = false;
+  static const unsigned int default_ic3_ctg_depth_ = 1;
+  static const unsigned int default_ic3_ctg_max_ = 3;
+  static const bool default_ic3_frame_solvers_ = false;
+  static const size_t default_ic3_prop_threads_ = 1;
+  static const bool default_ic3_ternary_pregen_ = false;
   static const bool default_ic3ia_reduce_preds_ = true;
   static const bool default_ic3sa_func_refine_ = true;
   static const std::string default_profiling_log_filename_;
@@ -250,6 +317,21 @@ class PonoOptions
   // default is the highest level
   static const size_t default_ic3sa_initial_terms_lvl_ = 4;
   static const bool default_ic3sa_interp_ = false;
+  static const std::vector<Engine> default_portfolio_engines_;
+  static const bool default_portfolio_share_lemmas_ = false;
+  static const bool default_bmc_all_props_ = false;
+  static const bool default_check_all_props_ = false;
+  static const size_t default_jobs_ = 0;
+  static const size_t default_time_limit_ = 0;
+  static const size_t default_memory_limit_ = 0;
+  static const size_t default_ic3_checkpoint_interval_ = 600;
+  static const bool default_sim_first_ = false;
+  static const size_t default_sim_cycles_ = 1000;
+  static const size_t default_sim_seeds_ = 64;
+  static const bool default_mine_invariants_ = false;
+  static const bool default_aig_reduce_ = false;
+  static const bool default_simplify_ = false;
+  static const size_t default_unroll_init_ = 0;
 };
 
 // Useful functions for printing etc...
@@ -15,7 +15,10 @@
 **/
 
 #include <csignal>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <sstream>
 #include "assert.h"
 
 #ifdef WITH_PROFILING
@@ -28,12 +31,20 @@
 #endif
 
 #include "core/fts.h"
+#include "core/ts_snapshot.h"
+#include "engines/multi_prop_bmc.h"
+#include "engines/multi_prop_scheduler.h"
+#include "engines/random_sim.h"
+#include "frontends/aiger_encoder.h"
 #include "frontends/btor2_encoder.h"
 #include "frontends/smv_encoder.h"
+#include "modifiers/aig_reducer.h"
 #include "modifiers/control_signals.h"
+#include "modifiers/init_phase_unroller.h"
 #include "modifiers/mod_ts_prop.h"
 #include "modifiers/prop_monitor.h"
 #include "modifiers/static_coi.h"
+#include "modifiers/ts_simplifier.h"
 #include "options/options.h"
 #include "printers/btor2_witness_printer.h"
 #include "printers/vcd_witness_printer.h"
@@ -47,20 +58,84 @@ using namespace pono;
 using namespace smt;
 using namespace std;
 
-ProverResult check_prop(PonoOptions pono_options,
-                        Term & prop,
-                        TransitionSystem & ts,
-                        const SmtSolver & s,
-                        std::vector<UnorderedTermMap> & cex)
+// The modifications of prepare_props that witnesses of the modified
+// system need to be mapped back through
+struct PropsReductions
 {
-  // get property name before it is rewritten
-  const string prop_name = ts.get_name(prop);
+  std::unique_ptr<InitPhaseUnroller> init_unroller;
+  std::unique_ptr<TransitionSystemSimplifier> simplifier;
+  std::unique_ptr<StaticConeOfInfluence> coi;
+  std::unique_ptr<AigReducer> aig_reducer;
+};
+
+// Maps a witness of the system modified by prepare_props back to the
+// original system, returns false if that fails
+bool complete_witness(const PropsReductions & reductions,
+                      std::vector<UnorderedTermMap> & cex)
+{
+  if (reductions.aig_reducer
+      && !reductions.aig_reducer->complete_witness(cex)) {
+    logger.log(0,
+               "Failed to map the witness back through the AIG "
+               "reduction. Not suitable for printing.");
+    return false;
+  }
+  if (reductions.coi && !reductions.coi->complete_witness(cex)) {
+    logger.log(0,
+               "Failed to complete the witness outside of the "
+               "cone-of-influence. Not suitable for printing.");
+    return false;
+  }
+  if (reductions.simplifier && !reductions.simplifier->complete_witness(cex)) {
+    logger.log(0,
+               "Failed to complete the witness of the simplified system. "
+               "Not suitable for printing.");
+    return false;
+  }
+  if (reductions.init_unroller
+      && !reductions.init_unroller->complete_witness(cex)) {
+    logger.log(0,
+               "Failed to prepend the initialization phase to the "
+               "witness. Not suitable for printing.");
+    return false;
+  }
+  return true;
+}
 
-  logger.log(1, "Solving property: {}", prop_name);
-  logger.log(3, "INIT:\n{}", ts.init());
-  logger.log(3, "TRANS:\n{}", ts.trans());
+// Sets ts back to the system before the first modification of
+// prepare_props that a completed witness is expressed over
+void restore_orig_ts(const PropsReductions & reductions,
+                     TransitionSystem & ts)
+{
+  if (reductions.init_unroller) {
+    ts = reductions.init_unroller->orig_ts();
+  } else if (reductions.simplifier) {
+    ts = reductions.simplifier->orig_ts();
+  } else if (reductions.coi) {
+    ts = reductions.coi->orig_ts();
+  } else if (reductions.aig_reducer) {
+    ts = reductions.aig_reducer->orig_ts();
+  }
+}
+
+// Applies the option-dependent modifications to the transition system
+// and to every property in props
+// --pseudo-init-prop, --assume-prop and --aig-reduce rewrite the system
+// for a single property and throw if props has more than one
+void prepare_props(const PonoOptions & pono_options,
+                   TermVec & props,
+                   TransitionSystem & ts,
+                   const SmtSolver & s,
+                   PropsReductions & reductions)
+{
+  if ((pono_options.pseudo_init_prop_ || pono_options.assume_prop_
+       || pono_options.aig_reduce_)
+      && props.size() != 1) {
+    throw PonoException(
+        "--pseudo-init-prop, --assume-prop and --aig-reduce only support "
+        "checking a single property");
+  }
 
-  // modify the transition system and property based on options
   if (!pono_options.clock_name_.empty()) {
     Term clock_symbol = ts.lookup(pono_options.clock_name_);
     toggle_clock(ts, clock_symbol);
@@ -79,20 +154,41 @@ ProverResult check_prop(PonoOptions pono_options,
                                 : s->make_term(Not, reset_symbol);
     }
     Term reset_done = add_reset_seq(ts, reset_symbol, pono_options.reset_bnd_);
-    // guard the property with reset_done
-    prop = ts.solver()->make_term(Implies, reset_done, prop);
+    // guard the properties with reset_done
+    for (auto & prop : props) {
+      prop = ts.solver()->make_term(Implies, reset_done, prop);
+    }
   }
 
+  if (pono_options.unroll_init_) {
+    try {
+      reductions.init_unroller.reset(
+          new InitPhaseUnroller(ts, props, pono_options.unroll_init_));
+    }
+    catch (PonoException & e) {
+      logger.log(1, "Skipping initialization phase unrolling: {}", e.what());
+    }
+  }
+
+  if (pono_options.simplify_) {
+    try {
+      reductions.simplifier.reset(new TransitionSystemSimplifier(ts, props));
+    }
+    catch (PonoException & e) {
+      logger.log(1, "Skipping simplification: {}", e.what());
+    }
+  }
 
   if (pono_options.static_coi_) {
     /* Compute the set of state/input variables related to the
-       bad-state property. Based on that information, rebuild the
+       bad-state properties. Based on that information, rebuild the
        transition relation of the transition system. */
-    StaticConeOfInfluence coi(ts, { prop }, pono_options.verbosity_);
+    reductions.coi.reset(
+        new StaticConeOfInfluence(ts, props, pono_options.verbosity_));
   }
 
   if (pono_options.pseudo_init_prop_) {
-    ts = pseudo_init_and_prop(ts, prop);
+    ts = pseudo_init_and_prop(ts, props[0]);
   }
 
   if (pono_options.promote_inputvars_) {
@@ -100,20 +196,51 @@ ProverResult check_prop(PonoOptions pono_options,
     assert(!ts.inputvars().size());
   }
 
-  if (!ts.only_curr(prop)) {
-    logger.log(1,
-               "Got next state or input variables in property. "
-               "Generating a monitor state.");
-    prop = add_prop_monitor(ts, prop);
+  for (auto & prop : props) {
+    if (!ts.only_curr(prop)) {
+      logger.log(1,
+                 "Got next state or input variables in property. "
+                 "Generating a monitor state.");
+      prop = add_prop_monitor(ts, prop);
+    }
   }
 
   if (pono_options.assume_prop_) {
     // NOTE: crucial that pseudo_init_prop and add_prop_monitor passes are
     // before this pass. Can't assume the non-delayed prop and also
     // delay it
-    prop_in_trans(ts, prop);
+    prop_in_trans(ts, props[0]);
   }
 
+  if (pono_options.aig_reduce_) {
+    try {
+      reductions.aig_reducer.reset(new AigReducer(ts, props[0]));
+    }
+    catch (PonoException & e) {
+      logger.log(1, "Skipping AIG reduction: {}", e.what());
+    }
+  }
+}
+
+ProverResult check_prop(PonoOptions pono_options,
+                        Term & prop,
+                        TransitionSystem & ts,
+                        const SmtSolver & s,
+                        std::vector<UnorderedTermMap> & cex)
+{
+  // get property name before it is rewritten
+  const string prop_name = ts.get_name(prop);
+
+  logger.log(1, "Solving property: {}", prop_name);
+  logger.log(3, "INIT:\n{}", ts.init());
+  logger.log(3, "TRANS:\n{}", ts.trans());
+
+  // modify the transition system and property based on options
+  TermVec props({ prop });
+  PropsReductions reductions;
+  prepare_props(pono_options, props, ts, s, reductions);
+  prop = props[0];
+
   Property p(s, prop, prop_name);
 
   // end modification of the transition system and property
@@ -121,7 +248,26 @@ ProverResult check_prop(PonoOptions pono_options,
   Engine eng = pono_options.engine_;
 
   std::shared_ptr<Prover> prover;
-  if (pono_options.cegp_abs_vals_) {
+  ProverResult r = pono::UNKNOWN;
+  if (pono_options.sim_first_) {
+    try {
+      prover = std::make_shared<RandomSimulation>(p, ts, s, pono_options);
+      r = prover->check_until(pono_options.sim_cycles_);
+    }
+    catch (PonoException & e) {
+      logger.log(1, "Skipping random simulation: {}", e.what());
+    }
+    if (r != FALSE) {
+      prover.reset();
+    }
+  }
+
+  if (prover) {
+    // random simulation found a counterexample
+  } else if (eng == PORTFOLIO) {
+    // the portfolio applies the CEGAR options to each of its engines
+    prover = make_prover(eng, p, ts, s, pono_options);
+  } else if (pono_options.cegp_abs_vals_) {
     prover = make_cegar_values_prover(eng, p, ts, s, pono_options);
   } else if (pono_options.ceg_bv_arith_) {
     prover = make_cegar_bv_arith_prover(eng, p, ts, s, pono_options);
@@ -136,8 +282,10 @@ ProverResult check_prop(PonoOptions pono_options,
   //       consider calling prover for CegProphecyArrays (so that underlying
   //       model checker runs prove unbounded) or possibly, have a command line
   //       flag to pick between the two
-  ProverResult r;
-  if (pono_options.engine_ == MSAT_IC3IA)
+  if (r == FALSE) {
+    // already solved by random simulation
+  }
+  else if (pono_options.engine_ == MSAT_IC3IA)
   {
     // HACK MSAT_IC3IA does not support check_until
     r = prover->prove();
@@ -153,6 +301,8 @@ ProverResult check_prop(PonoOptions pono_options,
       logger.log(
           0,
           "Only got a partial witness from engine. Not suitable for printing.");
+    } else {
+      complete_witness(reductions, cex);
     }
   }
 
@@ -180,9 +330,213 @@ ProverResult check_prop(PonoOptions pono_options,
       throw PonoException("Invariant Check FAILED");
     }
   }
+
+  if (cex.size()) {
+    // print the completed witness over all signals of the design
+    restore_orig_ts(reductions, ts);
+  }
   return r;
 }
 
+// Writes cex to the VCD file given in the options, keeping only the
+// signals selected by --vcd-signals, --vcd-regex and --vcd-coi
+void write_vcd(const PonoOptions & pono_options,
+               const TransitionSystem & ts,
+               const Term & prop,
+               const std::vector<UnorderedTermMap> & cex)
+{
+  VCDSignalFilter filter;
+  std::istringstream globs(pono_options.vcd_signals_);
+  std::string glob;
+  while (std::getline(globs, glob, ',')) {
+    if (!glob.empty()) {
+      filter.globs.push_back(glob);
+    }
+  }
+  filter.regex = pono_options.vcd_regex_;
+  if (pono_options.vcd_coi_) {
+    filter.coi_of.push_back(prop);
+  }
+
+  VCDWitnessPrinter vcdprinter(ts, cex);
+  vcdprinter.dump_trace_to_file(pono_options.vcd_name_, filter);
+}
+
+// Checks all the properties with a single bmc unrolling
+// results and cexs are indexed by the position of the property in props
+void check_props_bmc(PonoOptions pono_options,
+                     TermVec props,
+                     TransitionSystem & ts,
+                     const SmtSolver & s,
+                     std::vector<ProverResult> & results,
+                     std::vector<std::vector<UnorderedTermMap>> & cexs)
+{
+  logger.log(
+      1, "Solving {} properties with a shared bmc unrolling", props.size());
+
+  PropsReductions reductions;
+  prepare_props(pono_options, props, ts, s, reductions);
+
+  MultiPropBmc bmc(props, ts, s, pono_options);
+  bmc.check_until(pono_options.bound_);
+
+  results.clear();
+  cexs.clear();
+  cexs.resize(props.size());
+  for (size_t i = 0; i < props.size(); ++i) {
+    results.push_back(bmc.prop_result(i));
+    if (results.back() == FALSE && pono_options.witness_) {
+      bool success = bmc.prop_witness(i, cexs[i]);
+      if (!success) {
+        logger.log(0,
+                   "Only got a partial witness for property {}. Not suitable "
+                   "for printing.",
+                   i);
+        cexs[i].clear();
+      } else if (!complete_witness(reductions, cexs[i])) {
+        cexs[i].clear();
+      }
+    }
+  }
+}
+
+// Returns the result in the output format of the competitions
+std::string result_str(ProverResult r)
+{
+  switch (r) {
+    case FALSE: return "sat";
+    case TRUE: return "unsat";
+    case ERROR: return "error";
+    default: return "unknown";
+  }
+}
+
+// Returns FALSE if any property failed, TRUE if all of them hold
+// and otherwise ERROR or UNKNOWN
+ProverResult combine_results(const std::vector<ProverResult> & results)
+{
+  ProverResult res = TRUE;
+  for (const auto & r : results) {
+    if (r == FALSE) {
+      return FALSE;
+    } else if (r == ERROR) {
+      res = ERROR;
+    } else if (r == pono::UNKNOWN && res == TRUE) {
+      res = pono::UNKNOWN;
+    }
+  }
+  return res;
+}
+
+// Checks all the properties on a pool of threads
+// print_result is called as soon as a property is resolved
+// results are indexed by the position of the property in props
+std::vector<ProverResult> check_props_parallel(
+    PonoOptions pono_options,
+    TermVec props,
+    TransitionSystem & ts,
+    const SmtSolver & s,
+    std::function<void(size_t, ProverResult)> print_result)
+{
+  logger.log(1,
+             "Solving {} properties with {} in parallel",
+             props.size(),
+             to_string(pono_options.engine_));
+
+  // witnesses are not produced in this mode
+  PropsReductions reductions;
+  prepare_props(pono_options, props, ts, s, reductions);
+
+  MultiPropScheduler scheduler(ts, props, pono_options);
+  scheduler.set_result_callback(
+      [&print_result](size_t idx,
+                      ProverResult r,
+                      const std::vector<UnorderedTermMap> & cex) {
+        print_result(idx, r);
+      });
+  return scheduler.run(pono_options.jobs_);
+}
+
+// Checks the properties of a system without a BTOR2 encoder
+// and prints the results in the SMV output format
+ProverResult check_and_print(PonoOptions pono_options,
+                             const TermVec & propvec,
+                             TransitionSystem & ts,
+                             const SmtSolver & s)
+{
+  ProverResult res;
+
+  unsigned int num_props = propvec.size();
+  if (pono_options.prop_idx_ >= num_props) {
+    throw PonoException(
+        "Property index " + to_string(pono_options.prop_idx_)
+        + " is greater than the number of properties in file "
+        + pono_options.filename_ + " (" + to_string(num_props) + ")");
+  }
+
+  if (pono_options.bmc_all_props_) {
+    vector<ProverResult> results;
+    vector<vector<UnorderedTermMap>> cexs;
+    check_props_bmc(pono_options, propvec, ts, s, results, cexs);
+    res = pono::UNKNOWN;
+    for (size_t i = 0; i < results.size(); ++i) {
+      logger.log(0, "Property {} is {}", i, to_string(results[i]));
+      if (results[i] == FALSE) {
+        res = FALSE;
+        cout << "sat" << endl;
+        for (size_t t = 0; t < cexs[i].size(); t++) {
+          cout << "AT TIME " << t << endl;
+          for (auto elem : cexs[i][t]) {
+            cout << "\t" << elem.first << " : " << elem.second << endl;
+          }
+        }
+      } else {
+        cout << "unknown" << endl;
+      }
+    }
+  } else if (pono_options.check_all_props_) {
+    vector<ProverResult> results = check_props_parallel(
+        pono_options, propvec, ts, s, [](size_t i, ProverResult r) {
+          // called from worker threads, but never concurrently
+          logger.log(0, "Property {} is {}", i, to_string(r));
+          cout << result_str(r) << endl;
+        });
+    res = combine_results(results);
+  } else {
+    Term prop = propvec[pono_options.prop_idx_];
+    // get property name before it is rewritten
+
+    std::vector<UnorderedTermMap> cex;
+    res = check_prop(pono_options, prop, ts, s, cex);
+    // we assume that a prover never returns 'ERROR'
+    assert(res != ERROR);
+
+    logger.log(
+        0, "Property {} is {}", pono_options.prop_idx_, to_string(res));
+
+    if (res == FALSE) {
+      cout << "sat" << endl;
+      assert(pono_options.witness_ || cex.size() == 0);
+      for (size_t t = 0; t < cex.size(); t++) {
+        cout << "AT TIME " << t << endl;
+        for (auto elem : cex[t]) {
+          cout << "\t" << elem.first << " : " << elem.second << endl;
+        }
+      }
+      assert(pono_options.witness_ || pono_options.vcd_name_.empty());
+      if (!pono_options.vcd_name_.empty()) {
+        write_vcd(pono_options, ts, prop, cex);
+      }
+    } else if (res == TRUE) {
+      cout << "unsat" << endl;
+    } else {
+      assert(res == pono::UNKNOWN);
+      cout << "unknown" << endl;
+    }
+  }
+  return res;
+}
+
 // Note: signal handlers are registered only when profiling is enabled.
 void profiling_sig_handler(int sig)
 {
@@ -257,13 +611,6 @@ int main(int argc, char ** argv)
 
     // limitations with COI
     if (pono_options.static_coi_) {
-      if (pono_options.witness_) {
-        logger.log(
-            0,
-            "Warning: disabling witness production. Temporary restriction -- "
-            "Cannot produce witness with option --static-coi");
-        pono_options.witness_ = false;
-      }
       if (pono_options.pseudo_init_prop_) {
         // Issue explained here:
         // https://github.com/upscale-project/pono/pull/160 will be resolved
@@ -274,6 +621,13 @@ int main(int argc, char ** argv)
                    "well together currently.");
       }
     }
+    if (pono_options.check_all_props_ && pono_options.witness_) {
+      logger.log(
+          0,
+          "Warning: disabling witness production. Temporary restriction -- "
+          "Cannot produce witness with option --check-all-props");
+      pono_options.witness_ = false;
+    }
     // default options for IC3SA
     if (pono_options.engine_ == IC3SA_ENGINE) {
       // IC3SA expects all state variables
@@ -290,6 +644,9 @@ int main(int argc, char ** argv)
       FunctionalTransitionSystem fts(s);
       BTOR2Encoder btor_enc(pono_options.filename_, fts);
       const TermVec & propvec = btor_enc.propvec();
+      if (!pono_options.snapshot_name_.empty()) {
+        write_ts_snapshot(pono_options.snapshot_name_, fts, propvec);
+      }
       unsigned int num_props = propvec.size();
       if (pono_options.prop_idx_ >= num_props) {
         throw PonoException(
@@ -298,32 +655,60 @@ int main(int argc, char ** argv)
             + pono_options.filename_ + " (" + to_string(num_props) + ")");
       }
 
-      Term prop = propvec[pono_options.prop_idx_];
-
-      vector<UnorderedTermMap> cex;
-      res = check_prop(pono_options, prop, fts, s, cex);
-      // we assume that a prover never returns 'ERROR'
-      assert(res != ERROR);
-
-      // print btor output
-      if (res == FALSE) {
-        cout << "sat" << endl;
-        cout << "b" << pono_options.prop_idx_ << endl;
-        assert(pono_options.witness_ || !cex.size());
-        if (cex.size()) {
-          print_witness_btor(btor_enc, cex);
-          if (!pono_options.vcd_name_.empty()) {
-            VCDWitnessPrinter vcdprinter(fts, cex);
-            vcdprinter.dump_trace_to_file(pono_options.vcd_name_);
+      if (pono_options.bmc_all_props_) {
+        vector<ProverResult> results;
+        vector<vector<UnorderedTermMap>> cexs;
+        check_props_bmc(pono_options, propvec, fts, s, results, cexs);
+        res = pono::UNKNOWN;
+        for (size_t i = 0; i < results.size(); ++i) {
+          if (results[i] == FALSE) {
+            res = FALSE;
+            cout << "sat" << endl;
+            cout << "b" << i << endl;
+            if (cexs[i].size()) {
+              print_witness_btor(btor_enc, cexs[i]);
+            }
+          } else {
+            assert(results[i] == pono::UNKNOWN);
+            cout << "unknown" << endl;
+            cout << "b" << i << endl;
           }
         }
-      } else if (res == TRUE) {
-        cout << "unsat" << endl;
-        cout << "b" << pono_options.prop_idx_ << endl;
+      } else if (pono_options.check_all_props_) {
+        vector<ProverResult> results = check_props_parallel(
+            pono_options, propvec, fts, s, [](size_t i, ProverResult r) {
+              // called from worker threads, but never concurrently
+              cout << result_str(r) << endl;
+              cout << "b" << i << endl;
+            });
+        res = combine_results(results);
       } else {
-        assert(res == pono::UNKNOWN);
-        cout << "unknown" << endl;
-        cout << "b" << pono_options.prop_idx_ << endl;
+        Term prop = propvec[pono_options.prop_idx_];
+
+        vector<UnorderedTermMap> cex;
+        res = check_prop(pono_options, prop, fts, s, cex);
+        // we assume that a prover never returns 'ERROR'
+        assert(res != ERROR);
+
+        // print btor output
+        if (res == FALSE) {
+          cout << "sat" << endl;
+          cout << "b" << pono_options.prop_idx_ << endl;
+          assert(pono_options.witness_ || !cex.size());
+          if (cex.size()) {
+            print_witness_btor(btor_enc, cex);
+            if (!pono_options.vcd_name_.empty()) {
+              write_vcd(pono_options, fts, prop, cex);
+            }
+          }
+        } else if (res == TRUE) {
+          cout << "unsat" << endl;
+          cout << "b" << pono_options.prop_idx_ << endl;
+        } else {
+          assert(res == pono::UNKNOWN);
+          cout << "unknown" << endl;
+          cout << "b" << pono_options.prop_idx_ << endl;
+        }
       }
 
     } else if (file_ext == "smv") {
@@ -331,45 +716,30 @@ int main(int argc, char ** argv)
       RelationalTransitionSystem rts(s);
       SMVEncoder smv_enc(pono_options.filename_, rts);
       const TermVec & propvec = smv_enc.propvec();
-      unsigned int num_props = propvec.size();
-      if (pono_options.prop_idx_ >= num_props) {
-        throw PonoException(
-            "Property index " + to_string(pono_options.prop_idx_)
-            + " is greater than the number of properties in file "
-            + pono_options.filename_ + " (" + to_string(num_props) + ")");
+      if (!pono_options.snapshot_name_.empty()) {
+        write_ts_snapshot(pono_options.snapshot_name_, rts, propvec);
       }
+      res = check_and_print(pono_options, propvec, rts, s);
 
-      Term prop = propvec[pono_options.prop_idx_];
-      // get property name before it is rewritten
-
-      std::vector<UnorderedTermMap> cex;
-      res = check_prop(pono_options, prop, rts, s, cex);
-      // we assume that a prover never returns 'ERROR'
-      assert(res != ERROR);
-
-      logger.log(
-          0, "Property {} is {}", pono_options.prop_idx_, to_string(res));
-
-      if (res == FALSE) {
-        cout << "sat" << endl;
-        assert(pono_options.witness_ || cex.size() == 0);
-        for (size_t t = 0; t < cex.size(); t++) {
-          cout << "AT TIME " << t << endl;
-          for (auto elem : cex[t]) {
-            cout << "\t" << elem.first << " : " << elem.second << endl;
-          }
-        }
-        assert(pono_options.witness_ || pono_options.vcd_name_.empty());
-        if (!pono_options.vcd_name_.empty()) {
-          VCDWitnessPrinter vcdprinter(rts, cex);
-          vcdprinter.dump_trace_to_file(pono_options.vcd_name_);
-        }
-      } else if (res == TRUE) {
-        cout << "unsat" << endl;
-      } else {
-        assert(res == pono::UNKNOWN);
-        cout << "unknown" << endl;
+    } else if (file_ext == "aag" || file_ext == "aig") {
+      logger.log(2, "Parsing AIGER file: {}", pono_options.filename_);
+      FunctionalTransitionSystem fts(s);
+      AigerEncoder aiger_enc(pono_options.filename_, fts);
+      const TermVec & propvec = aiger_enc.propvec();
+      if (!pono_options.snapshot_name_.empty()) {
+        write_ts_snapshot(pono_options.snapshot_name_, fts, propvec);
       }
+      res = check_and_print(pono_options, propvec, fts, s);
+
+    } else if (file_ext == "ptss") {
+      logger.log(2, "Reading snapshot: {}", pono_options.filename_);
+      TransitionSystem ts(s);
+      TermVec propvec = read_ts_snapshot(pono_options.filename_, ts);
+      if (!pono_options.snapshot_name_.empty()) {
+        write_ts_snapshot(pono_options.snapshot_name_, ts, propvec);
+      }
+      res = check_and_print(pono_options, propvec, ts, s);
+
     } else {
       throw PonoException("Unrecognized file extension " + file_ext
                           + " for file " + pono_options.filename_);
@@ -19,59 +19,13 @@
 #include <sstream>
 #include <vector>
 
-#include "gmpxx.h"
-
+#include "core/witness_trace.h"
 #include "smt-switch/smt.h"
 
 #include "utils/logger.h"
 
 namespace pono {
 
-std::string as_bits(std::string val)
-{
-  // TODO: this makes assumptions on format of value from boolector
-  //       to support other solvers, we need to be more general
-  std::string res = val;
-
-  if (val.length() < 2) {
-    throw PonoException("Don't know how to interpret value: " + val);
-  }
-
-  if (res.substr(0, 2) == "#b") {
-    // remove the #b prefix
-    res = res.substr(2, val.length() - 2);
-  } else if (res.substr(0, 2) == "#x") {
-    throw PonoException("Not supporting hexadecimal format yet.");
-  } else {
-    res = res.substr(5, res.length() - 5);
-    std::istringstream iss(res);
-    std::vector<std::string> tokens(std::istream_iterator<std::string>{ iss },
-                                    std::istream_iterator<std::string>());
-
-    if (tokens.size() != 2) {
-      throw PonoException("Failed to interpret " + val);
-    }
-
-    res = tokens[0];
-    // get rid of ")"
-    std::string width_str = tokens[1].substr(0, tokens[1].length() - 1);
-    size_t width = std::stoull(width_str);
-    mpz_class cval(res);
-    res = cval.get_str(2);
-    size_t strlen = res.length();
-
-    if (strlen < width) {
-      // pad with zeros
-      res = std::string(width - strlen, '0') + res;
-    } else if (strlen > width) {
-      // remove prepended zeros
-      res = res.erase(0, strlen - width);
-    }
-    return res;
-  }
-  return res;
-}
-
 void print_btor_vals_at_time(const smt::TermVec & vec,
                              const smt::UnorderedTermMap & valmap,
                              unsigned int time)
@@ -81,12 +35,10 @@ void print_btor_vals_at_time(const smt::TermVec & vec,
   for (size_t i = 0, size = vec.size(); i < size; ++i) {
     sk = vec[i]->get_sort()->get_sort_kind();
     if (sk == smt::BV) {
-      // TODO: this makes assumptions on format of value from boolector
-      //       to support other solvers, we need to be more general
       logger.log(0,
                  "{} {} {}@{}",
                  i,
-                 as_bits(valmap.at(vec[i])->to_string()),
+                 WitnessTrace::value_bits(valmap.at(vec[i])),
                  vec[i],
                  time);
     } else if (sk == smt::ARRAY) {
@@ -101,8 +53,8 @@ void print_btor_vals_at_time(const smt::TermVec & vec,
         logger.log(0,
                    "{} [{}] {} {}@{}",
                    i,
-                   as_bits(store_children[1]->to_string()),
-                   as_bits(store_children[2]->to_string()),
+                   WitnessTrace::value_bits(store_children[1]),
+                   WitnessTrace::value_bits(store_children[2]),
                    vec[i],
                    time);
         tmp = store_children[0];
@@ -111,8 +63,12 @@ void print_btor_vals_at_time(const smt::TermVec & vec,
       if (tmp->get_op().is_null()
           && tmp->get_sort()->get_sort_kind() == smt::ARRAY) {
         smt::Term const_val = *(tmp->begin());
-        logger.log(
-            0, "{} {} {}@{}", i, as_bits(const_val->to_string()), vec[i], time);
+        logger.log(0,
+                   "{} {} {}@{}",
+                   i,
+                   WitnessTrace::value_bits(const_val),
+                   vec[i],
+                   time);
       }
 
     } else {
@@ -130,13 +86,10 @@ void print_btor_vals_at_time(const std::map<uint64_t, smt::Term> m,
   for (auto entry : m) {
     sk = entry.second->get_sort()->get_sort_kind();
     if (sk == smt::BV) {
-      // TODO: this makes assumptions on format of value from boolector
-      //       to support other solvers, we need to be more general
-      // Remove the #b prefix
       logger.log(0,
                  "{} {} {}@{}",
                  entry.first,
-                 as_bits(valmap.at(entry.second)->to_string()),
+                 WitnessTrace::value_bits(valmap.at(entry.second)),
                  entry.second,
                  time);
     } else if (sk == smt::ARRAY) {
@@ -151,8 +104,8 @@ void print_btor_vals_at_time(const std::map<uint64_t, smt::Term> m,
         logger.log(0,
                    "{} [{}] {} {}@{}",
                    entry.first,
-                   as_bits(store_children[1]->to_string()),
-                   as_bits(store_children[2]->to_string()),
+                   WitnessTrace::value_bits(store_children[1]),
+                   WitnessTrace::value_bits(store_children[2]),
                    entry.second,
                    time);
         tmp = store_children[0];
@@ -164,7 +117,7 @@ void print_btor_vals_at_time(const std::map<uint64_t, smt::Term> m,
         logger.log(0,
                    "{} {} {}@{}",
                    entry.first,
-                   as_bits(const_val->to_string()),
+                   WitnessTrace::value_bits(const_val),
                    entry.second,
                    time);
       }
@@ -15,14 +15,19 @@
  **/
 
 #include "utils/logger.h"
-#include "frontends/btor2_encoder.h"
-#include "smt-switch/boolector_factory.h"
+#include "utils/term_analysis.h"
 
 #include "vcd_witness_printer.h"
 
 #include <algorithm>
+#include <cassert>
 #include <fstream>
 #include <iostream>
+#include <regex>
+
+#ifdef WITH_ZLIB
+#include <zlib.h>
+#endif
 
 using namespace smt;
 using namespace std;
@@ -37,6 +42,9 @@ static const char date_time_format [] = "%A %Y/%m/%d  %H:%M:%S";
 // $version PONO $end
 // $timescale 1 ns $end
 
+// flush the output buffer once it is larger than this
+static const size_t vcd_buffer_size = 1 << 16;
+
 // ------------- HELPER FUNCTIONS ------------------ //
 
 static std::vector<std::string> split(const std::string& str,
@@ -63,195 +71,310 @@ static std::string width2range(uint64_t w) {
   return "";
 }
 
-// copied from btor2_witness_printer,
-// so that we don't need to include
-// because its header contains also 
-// implementation, this creates troubles
-static std::string as_bits(std::string val)
+// match a name against a glob with '*' and '?' wildcards
+static bool glob_match(const std::string & pattern, const std::string & name)
 {
-  // TODO: this makes assumptions on format of value from boolector
-  //       to support other solvers, we need to be more general
-  std::string res = val;
+  size_t p = 0, n = 0;
+  size_t star = std::string::npos, star_n = 0;
+  while (n < name.size()) {
+    if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+      ++p;
+      ++n;
+    } else if (p < pattern.size() && pattern[p] == '*') {
+      star = p++;
+      star_n = n;
+    } else if (star != std::string::npos) {
+      // let the last star absorb one more character
+      p = star + 1;
+      n = ++star_n;
+    } else {
+      return false;
+    }
+  }
+  while (p < pattern.size() && pattern[p] == '*')
+    ++p;
+  return p == pattern.size();
+}
 
-  if (val.length() < 2) {
-    throw PonoException("Don't know how to interpret value: " + val);
+bool static is_bad_state_pattern(const std::string & n) {
+  auto dot_pos = n.rfind(':');
+  for (auto pos = dot_pos + 1; pos < n.length(); ++pos) {
+    char ch = n.at(pos);
+    if (isdigit(ch) || ch == '.' || ch == '-')
+      continue;
+    return false;
   }
+  return true;
+}
 
-  if (res.substr(0, 2) == "#b") {
-    // #b prefix -> b
-    res = res.substr(1, val.length() - 1);
-  } else if (res.substr(0, 2) == "#x") {
-    throw PonoException("Not supporting hexadecimal format yet.");
+// ------------- CLASS FUNCTIONS ------------------ //
+
+VCDStreamWriter::VCDStreamWriter(const TransitionSystem & ts,
+                                 const std::string & vcd_file_name,
+                                 const VCDSignalFilter & filter)
+    : ts_(ts),
+      file_name_(vcd_file_name),
+      filter_(filter),
+      signals_collected_(false),
+      header_written_(false),
+      closed_(false),
+      tick_(0),
+      gz_(nullptr),
+      hash_id_cnt_(0),
+      property_id_cnt_(0)
+{
+  bool compress = vcd_file_name.size() > 3
+                  && vcd_file_name.substr(vcd_file_name.size() - 3) == ".gz";
+  if (compress) {
+#ifdef WITH_ZLIB
+    gz_ = gzopen(vcd_file_name.c_str(), "wb");
+    if (!gz_)
+      throw PonoException("Unable to write to : " + vcd_file_name);
+#else
+    throw PonoException("Writing " + vcd_file_name
+                        + " requires building pono with zlib");
+#endif
   } else {
-    res = res.substr(5, res.length() - 5);
-    std::istringstream iss(res);
-    std::vector<std::string> tokens(std::istream_iterator<std::string>{ iss },
-                                    std::istream_iterator<std::string>());
+    fout_.open(vcd_file_name);
+    if (!fout_.is_open())
+      throw PonoException("Unable to write to : " + vcd_file_name);
+  }
 
-    if (tokens.size() != 2) {
-      throw PonoException("Failed to interpret " + val);
+  if (!filter_.regex.empty()) {
+    try {
+      regex_ = std::regex(filter_.regex);
     }
-
-    res = tokens[0];
-    // get rid of ")"
-    std::string width_str = tokens[1].substr(0, tokens[1].length() - 1);
-    size_t width = std::stoull(width_str);
-    mpz_class cval(res);
-    res = cval.get_str(2);
-    size_t strlen = res.length();
-
-    if (strlen < width) {
-      // pad with zeros
-      res = std::string(width - strlen, '0') + res;
-    } else if (strlen > width) {
-      // remove prepended zeros
-      res = res.erase(0, strlen - width);
+    catch (std::regex_error & e) {
+      throw PonoException("Invalid signal regex: " + filter_.regex);
     }
-    return res;
   }
-  return res;
+  if (!filter_.coi_of.empty())
+    compute_coi();
 }
 
-// convert boolector value to decimal
-static std::string as_decimal(std::string val)
+VCDStreamWriter::~VCDStreamWriter()
 {
-  // TODO: this makes assumptions on format of value from boolector
-  //       to support other solvers, we need to be more general
-  std::string res = val;
+  try {
+    close();
+  }
+  catch (std::exception & e) {
+    logger.log(1, "Failed to close {}: {}", file_name_, e.what());
+  }
+}
+
+void VCDStreamWriter::emit(const std::string & s)
+{
+  buf_ += s;
+  if (buf_.size() >= vcd_buffer_size)
+    flush();
+}
 
-  if (val.length() < 2) {
-    throw PonoException("Don't know how to interpret value: " + val);
+void VCDStreamWriter::flush()
+{
+  if (buf_.empty())
+    return;
+#ifdef WITH_ZLIB
+  if (gz_) {
+    if (gzwrite((gzFile)gz_, buf_.data(), buf_.size()) != (int)buf_.size())
+      throw PonoException("Failed to write to : " + file_name_);
+    buf_.clear();
+    return;
   }
+#endif
+  fout_.write(buf_.data(), buf_.size());
+  if (!fout_)
+    throw PonoException("Failed to write to : " + file_name_);
+  buf_.clear();
+}
 
-  if (res.substr(0, 2) == "#b") {
-    // #b prefix -> b
-    res = res.substr(2, val.length() - 1);
-    mpz_class cval(res, 2);
-    res = cval.get_str(10);
-  } else if (res.substr(0, 2) == "#x") {
-    throw PonoException("Not supporting hexadecimal format yet.");
-  } else {
-    res = res.substr(5, res.length() - 5);
-    std::istringstream iss(res);
-    std::vector<std::string> tokens(std::istream_iterator<std::string>{ iss },
-                                    std::istream_iterator<std::string>());
+void VCDStreamWriter::compute_coi()
+{
+  // add the variables of a transition constraint to the cone
+  // if it constrains the next state of a variable in the cone,
+  // or relates current-state variables of the cone
+  for (const auto & t : filter_.coi_of) {
+    for (const auto & v : get_free_symbols(t)) {
+      coi_vars_.insert(ts_.is_next_var(v) ? ts_.curr(v) : v);
+    }
+  }
 
-    if (tokens.size() != 2) {
-      throw PonoException("Failed to interpret " + val);
+  std::vector<UnorderedTermSet> conjunct_vars;
+  for (const auto & c : ts_.trans_conjuncts()) {
+    conjunct_vars.push_back(get_free_symbols(c));
+  }
+  std::vector<bool> used(conjunct_vars.size(), false);
+
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t i = 0; i < conjunct_vars.size(); ++i) {
+      if (used[i])
+        continue;
+      bool relevant = false;
+      bool has_next = false;
+      for (const auto & v : conjunct_vars[i]) {
+        if (ts_.is_next_var(v)) {
+          has_next = true;
+          relevant |= coi_vars_.find(ts_.curr(v)) != coi_vars_.end();
+        }
+      }
+      if (!has_next) {
+        // a constraint over current state (and input) variables
+        for (const auto & v : conjunct_vars[i]) {
+          relevant |= coi_vars_.find(v) != coi_vars_.end();
+        }
+      }
+      if (!relevant)
+        continue;
+      used[i] = true;
+      changed = true;
+      for (const auto & v : conjunct_vars[i]) {
+        coi_vars_.insert(ts_.is_next_var(v) ? ts_.curr(v) : v);
+      }
     }
+  }
+  logger.log(1, "VCD: {} variables in the cone-of-influence", coi_vars_.size());
+}
 
-    res = tokens[0];
-    // get rid of ")"
-    std::string width_str = tokens[1].substr(0, tokens[1].length() - 1);
-    size_t width = std::stoull(width_str);
-    mpz_class cval(res);
-    res = cval.get_str(10);
-    return res;
+bool VCDStreamWriter::selected(const std::string & name,
+                               const smt::Term & ast) const
+{
+  if (!filter_.globs.empty() || !filter_.regex.empty()) {
+    bool matched = false;
+    for (const auto & g : filter_.globs) {
+      if (glob_match(g, name)) {
+        matched = true;
+        break;
+      }
+    }
+    if (!matched && !filter_.regex.empty()) {
+      matched = std::regex_search(name, regex_);
+    }
+    if (!matched)
+      return false;
   }
-  return res;
+
+  if (!filter_.coi_of.empty()) {
+    for (const auto & v : get_free_symbols(ast)) {
+      if (coi_vars_.find(v) == coi_vars_.end())
+        return false;
+    }
+  }
+  return true;
 }
 
-// ------------- CLASS FUNCTIONS ------------------ //
+void VCDStreamWriter::declare_array_indices(const smt::UnorderedTermMap & valmap)
+{
+  if (signals_collected_) {
+    logger.log(1, "VCD: signals already selected, ignoring new array indices");
+    return;
+  }
 
-VCDWitnessPrinter::VCDWitnessPrinter(
-    const TransitionSystem & ts, const std::vector<smt::UnorderedTermMap> & cex)
-    : inputs_(ts.inputvars()),
-      states_(ts.statevars()),
-      named_terms_(ts.named_terms()),
-      cex_(cex),
-      hash_id_cnt_(0),
-      property_id_cnt_(0)
+  for (auto && state : ts_.statevars()) {
+    if (state->get_sort()->get_sort_kind() != smt::ARRAY)
+      continue;
+    auto array_assign_pos = valmap.find(state);
+    if (array_assign_pos == valmap.end())
+      continue; // we find no assignment at this step
+    declare_array_value(state, array_assign_pos->second);
+  }
+}
+
+void VCDStreamWriter::declare_array_value(const smt::Term & state,
+                                          const smt::Term & value)
+{
+  // peel the (store (store ...) ), find the indices
+  auto & indices = array_indices_[state];
+  smt::Term tmp = value;
+  smt::TermVec store_children(3);
+  while (tmp->get_op() == smt::Store) {
+    int num = 0;
+    for (auto c : tmp) {
+      store_children[num] = c;
+      num++;
+    }
+    indices.insert(WitnessTrace::value_decimal(store_children[1]));
+    tmp = store_children[0];
+  }
+
+  if (tmp->get_op().is_null() && tmp->is_value())
+    array_has_default_.insert(state);
+}
+
+const smt::TermVec & VCDStreamWriter::signals()
 {
+  collect_signals();
+  return signals_;
+}
+
+void VCDStreamWriter::collect_signals()
+{
+  if (signals_collected_)
+    return;
+  signals_collected_ = true;
+
   // figure out the variables and their scopes
-  for (auto && name_term_pair : named_terms_) {
+  for (auto && name_term_pair : ts_.named_terms()) {
     // It seems that next_var now will also go into named_terms
-    if (ts.is_next_var(name_term_pair.second))
+    if (ts_.is_next_var(name_term_pair.second))
       continue;
 
-    bool is_reg = 
-      std::find(states_.begin(), states_.end(), name_term_pair.second)
-      != states_.end();
+    bool is_reg = ts_.is_curr_var(name_term_pair.second);
     auto sk = name_term_pair.second->get_sort()->get_sort_kind();
     if (sk == smt::ARRAY) {
       continue; // let's not worry about array so far
     }
+    if (!selected(name_term_pair.first, name_term_pair.second))
+      continue;
     check_insert_scope(name_term_pair.first, is_reg, name_term_pair.second);
   }
 
-  for (auto && state : states_) {
-    if(state->get_sort()->get_sort_kind() == smt::ARRAY) {
-      // we need to preprocess cex to know the indices
-      std::unordered_set<std::string> indices;
-      bool has_default_value = false;
-
-      for(auto && valmap : cex) { // for each step 
-        auto array_assign_pos = valmap.find(state);
-        if ( array_assign_pos == valmap.end() )
-          continue; // we find no assignment at this step
-          // should not be the case, but we skip anyway
-        // peel the (store (store ...) ), find the indices
-        
-        smt::Term tmp = array_assign_pos->second;
-        smt::TermVec store_children(3);
-        while (tmp->get_op() == smt::Store) {
-          int num = 0;
-          for (auto c : tmp) {
-            store_children[num] = c;
-            num++;
-          }
-          indices.insert(as_decimal(store_children[1]->to_string()));
-          tmp = store_children[0];
-        }
-
-        if (tmp->get_op().is_null() && tmp->is_value())
-          has_default_value = true;
-      } // for each frame, collect 
-      check_insert_scope_array(state->to_string(), indices, has_default_value, state );
+  for (auto && state : ts_.statevars()) {
+    std::string name = state->to_string();
+    if (!selected(name, state))
+      continue;
+    if (state->get_sort()->get_sort_kind() == smt::ARRAY) {
+      check_insert_scope_array(name,
+                               array_indices_[state],
+                               array_has_default_.count(state),
+                               state);
     }
     else
-      check_insert_scope(state->to_string(), true, state);
+      check_insert_scope(name, true, state);
   }
 
-  for (auto && input : inputs_) {
+  for (auto && input : ts_.inputvars()) {
     if(input->get_sort()->get_sort_kind() == smt::ARRAY)
       continue;
-    check_insert_scope(input->to_string(), false, input);
+    std::string name = input->to_string();
+    if (!selected(name, input))
+      continue;
+    check_insert_scope(name, false, input);
   }
 
-} // VCDWitnessPrinter -- constructor
+  for (auto && sig_bv_ptr : allsig_bv_)
+    signals_.push_back(sig_bv_ptr->ast);
+  for (auto && sig_array_ptr : allsig_array_)
+    signals_.push_back(sig_array_ptr->ast);
 
-void VCDWitnessPrinter::debug_dump() const
-{
-  for (uint64_t fidx = 0; fidx < cex_.size(); ++ fidx) {
-    logger.log(3, "------------- CEX : F{} -----------------", fidx);
-    for (auto && t : cex_.at(fidx)) {
-      logger.log(3, "{} -> {}", t.first->to_string(), t.second->to_string() );
-    }
-  }
-}  // debug_dump
+  logger.log(1,
+             "VCD: writing {} signals and {} arrays to {}",
+             allsig_bv_.size(),
+             allsig_array_.size(),
+             file_name_);
+} // collect_signals
 
-std::string VCDWitnessPrinter::new_hash_id() {
+std::string VCDStreamWriter::new_hash_id() {
   return "v" + std::to_string(hash_id_cnt_++);
 }
 
-std::string VCDWitnessPrinter::new_property_id() {
+std::string VCDStreamWriter::new_property_id() {
   return "assert(property" + std::to_string(property_id_cnt_++)+")";
 }
 
-bool static is_bad_state_pattern(const std::string & n) {
-  auto dot_pos = n.rfind(':');
-  for (auto pos = dot_pos + 1; pos < n.length(); ++pos) {
-    char ch = n.at(pos);
-    if (isdigit(ch) || ch == '.' || ch == '-')
-      continue;
-    return false;
-  }
-  return true;
-}
-
-void VCDWitnessPrinter::check_insert_scope(std::string full_name,
-                                           bool is_reg,
-                                           const smt::Term & ast)
+void VCDStreamWriter::check_insert_scope(std::string full_name,
+                                         bool is_reg,
+                                         const smt::Term & ast)
 {
   // yosys could use $... for internal unnamed nodes,
   // which maybe we don't want at all
@@ -267,11 +390,11 @@ void VCDWitnessPrinter::check_insert_scope(std::string full_name,
   // so the check is mostly unuseful.
   // But it does not hurt to have it.
   // There is just one exception, that is the
-  // name after bad state: 
+  // name after bad state:
   // Yosys will output something like this:
   //
   //   155 bad 154 ./ridecore-src-buggy/topsim.v:101.13-112.8|./ridecore-src-buggy/pipeline.v:2005.11-2006.28
-  // 
+  //
   // and the symbols and dots will overwhelm the later code that
   // tries to sort out the hierarchy of the signal.
   // Actually this is not signal name at all.
@@ -295,7 +418,8 @@ void VCDWitnessPrinter::check_insert_scope(std::string full_name,
     }
   } // at the end of this loop, we are at the scope to insert our variable
   const auto & short_name = scopes.back();
-  uint64_t width = ast->get_sort()->get_width();
+  const Sort & sort = ast->get_sort();
+  uint64_t width = sort->get_sort_kind() == smt::BOOL ? 1 : sort->get_width();
 
   std::map<std::string, VCDSignal> & signal_set = is_reg ? root->regs : root->wires;
 
@@ -308,14 +432,14 @@ void VCDWitnessPrinter::check_insert_scope(std::string full_name,
   auto hashid = new_hash_id();
   signal_set.emplace(short_name,
     VCDSignal(
-      short_name + width2range(width), 
+      short_name + width2range(width),
       full_name,  hashid , ast, width));
   allsig_bv_.push_back( &(signal_set.at(short_name)) );
 } // end of check_insert_scope
 
-void VCDWitnessPrinter::check_insert_scope_array(
+void VCDStreamWriter::check_insert_scope_array(
     std::string full_name,
-    const std::unordered_set<std::string> & indices,
+    const std::set<std::string> & indices,
     bool has_default,
     const smt::Term & ast)
 {
@@ -352,12 +476,11 @@ void VCDWitnessPrinter::check_insert_scope_array(
   if (has_default)
     indices2hash.emplace("default", new_hash_id());
   allsig_array_.push_back( &(signal_set.at(short_name)) );
-  // to do: add indices and their hashes
 } // end of check_insert_scope_array
 
 
 
-void VCDWitnessPrinter::dump_current_scope(std::ostream & fout, const VCDScope *scope) const {
+void VCDStreamWriter::dump_current_scope(std::ostream & fout, const VCDScope *scope) const {
   for (auto && r : scope->regs) {
     fout << "$var reg " << r.second.data_width << " " << r.second.hash << " "
          << r.second.vcd_name << " $end" << std::endl;
@@ -381,11 +504,8 @@ void VCDWitnessPrinter::dump_current_scope(std::ostream & fout, const VCDScope *
   }
 } // end of dump_current_scope
 
-void VCDWitnessPrinter::DumpScopes(std::ostream & fout) const {
-  dump_current_scope(fout, &root_scope_);
-}
-
-void VCDWitnessPrinter::GenHeader(std::ostream & fout) const {
+void VCDStreamWriter::GenHeader() {
+  std::ostringstream fout;
   fout << "$date" << std::endl;
   {
     char buffer [100];
@@ -400,214 +520,169 @@ void VCDWitnessPrinter::GenHeader(std::ostream & fout) const {
   fout << "$end" << std::endl;
   fout << "$version PONO $end" << std::endl;
   fout << "$timescale 1 ns $end" << std::endl;
-  DumpScopes(fout);
+  dump_current_scope(fout, &root_scope_);
   fout << "$enddefinitions $end" << std::endl;
+  emit(fout.str());
 } // end of GenHeader
 
-void VCDWitnessPrinter::dump_all(const smt::UnorderedTermMap & valmap,
-  std::unordered_map<std::string, std::string> & valbuf,
-  uint64_t t, std::ostream & fout) const {
-  for (auto && sig_bv_ptr : allsig_bv_) {
-    auto pos = valmap.find(sig_bv_ptr->ast);
-    if (pos == valmap.end()) {
-      logger.log(1, "missing value in provided trace @{}: {}" ,
-        t,
-        sig_bv_ptr->full_name);
-      continue;
-    }
-    auto val = as_bits(pos->second->to_string());
-    valbuf.emplace(
-      sig_bv_ptr->hash,
-      val
-    );
-    fout << val << " " << sig_bv_ptr->hash << std::endl;
-  } // for all bv signals
-
-  for (auto && sig_array_ptr : allsig_array_) {
-    auto pos = valmap.find(sig_array_ptr->ast);
-    if (pos == valmap.end()) {
-      logger.log(1, "missing value in provided trace @{}: {}" ,
-        t,
-        sig_array_ptr->full_name);
-      continue;
-    }
-    smt::Term memvalue = pos->second;
-    smt::TermVec store_children(3);
-    while (memvalue->get_op() == smt::Store) {
-      int num = 0;
-      for (auto c : memvalue) {
-        store_children[num] = c;
-        num++;
-      }
+void VCDStreamWriter::dump_array_elem(const VCDArray * arr,
+                                      const std::string & index,
+                                      const std::string & data)
+{
+  auto addr_pos = arr->indices2hash.find(index);
+  if (addr_pos == arr->indices2hash.end()) {
+    // the element was first assigned after the header was written
+    logger.log(1, "missing addr index for array: {}: , addr : {}" ,
+      arr->full_name, index);
+    return;
+  }
+  auto prev_pos = array_prev_.find(addr_pos->second);
+  if (prev_pos == array_prev_.end()) {
+    // this happens if some elements are not assigned by
+    // the solver in the beginning, GtkWave shows them as X
+    // before they are first assigned
+    array_prev_.emplace(addr_pos->second, data);
+  } else if (prev_pos->second != data) {
+    prev_pos->second = data; // update the value
+  } else {
+    return;
+  }
+  emit(data + " " + addr_pos->second + "\n");
+}
 
-      auto addr = as_decimal(store_children[1]->to_string());
-      auto data = as_bits(store_children[2]->to_string());
-      auto addr_pos = sig_array_ptr->indices2hash.find(addr);
-      if (addr_pos != sig_array_ptr->indices2hash.end()) {
-        valbuf.emplace(addr_pos->second, data);
-        fout << data << " " << addr_pos->second << std::endl;
-      } else {
-        logger.log(1, "missing addr index for array: {}: , addr : {}" ,
-          sig_array_ptr->full_name, addr);
+void VCDStreamWriter::write_frame(const WitnessTrace & trace, size_t frame)
+{
+  if (closed_)
+    throw PonoException("VCD: writing to closed file " + file_name_);
+
+  if (!header_written_) {
+    if (!signals_collected_) {
+      // declare the array indices of this frame
+      size_t idx;
+      for (auto && state : ts_.statevars()) {
+        if (state->get_sort()->get_sort_kind() == smt::ARRAY
+            && trace.find(state, idx) && trace.has_value(idx, frame))
+          declare_array_value(state, trace.term_value(idx, frame));
       }
-
-      memvalue = store_children[0];
     }
+    collect_signals();
+    GenHeader();
+    header_written_ = true;
+  }
 
-    if (memvalue->get_op().is_null() && memvalue->is_value()) {
-      smt::Term const_val = *(memvalue->begin());
-      auto data_default = as_bits(const_val->to_string());
-      auto addr_pos = sig_array_ptr->indices2hash.find("default");
-      if (addr_pos != sig_array_ptr->indices2hash.end()) {
-        valbuf.emplace(addr_pos->second, data_default);
-        fout << data_default << " " << addr_pos->second << std::endl;
-      } else {
-        logger.log(1, "missing addr index for array: {}: , addr : {}" ,
-          sig_array_ptr->full_name, "-default-");
-      }
-    } // handling the inner constant default
-  } // for all array signals
-  // TODO : mems
-} // end of VCDWitnessPrinter::dump_all
-
-void VCDWitnessPrinter::dump_diff(const smt::UnorderedTermMap & valmap,
-  std::unordered_map<std::string, std::string> & valprev,
-  uint64_t t, std::ostream & fout) const {
+  emit("#" + std::to_string(tick_) + "\n");
 
   for (auto && sig_bv_ptr : allsig_bv_) {
-    auto pos = valmap.find(sig_bv_ptr->ast);
-    if (pos == valmap.end()) {
+    size_t idx;
+    if (!trace.find(sig_bv_ptr->ast, idx) || !trace.has_value(idx, frame)) {
       logger.log(1, "missing value in provided trace @{}: {}" ,
-        t,
+        tick_,
         sig_bv_ptr->full_name);
       continue;
     }
-    auto val = as_bits(pos->second->to_string());
-    auto prev_pos = valprev.find(sig_bv_ptr->hash);
-    if (prev_pos == valprev.end()) {
-      valprev.emplace(sig_bv_ptr->hash, val );
-      fout << val << " " << sig_bv_ptr->hash << std::endl;
-      logger.log(1, "Bug, {} was not cached before time : {}.",
-        sig_bv_ptr->full_name, std::to_string(t));
-      continue;
-    }
-    if ( prev_pos->second == val )
+    assert(trace.width(idx) == sig_bv_ptr->data_width);
+    const uint64_t * words = trace.words(idx, frame);
+    if (sig_bv_ptr->has_prev
+        && std::equal(sig_bv_ptr->prev.begin(), sig_bv_ptr->prev.end(), words))
       continue;
     // update old value and print
-    prev_pos->second = val;
-    fout << val << " " << sig_bv_ptr->hash << std::endl;
+    sig_bv_ptr->prev.assign(words, words + sig_bv_ptr->prev.size());
+    sig_bv_ptr->has_prev = true;
+    emit("b" + trace.bits(idx, frame) + " " + sig_bv_ptr->hash + "\n");
   } // for all bv signals
 
-
+  smt::TermVec store_children(3);
   for (auto && sig_array_ptr : allsig_array_) {
-    auto pos = valmap.find(sig_array_ptr->ast);
-    if (pos == valmap.end()) {
+    size_t idx;
+    if (!trace.find(sig_array_ptr->ast, idx) || !trace.has_value(idx, frame)) {
       logger.log(1, "missing value in provided trace @{}: {}" ,
-        t,
+        tick_,
         sig_array_ptr->full_name);
       continue;
     }
-    smt::Term memvalue = pos->second;
-    smt::TermVec store_children(3);
+    smt::Term memvalue = trace.term_value(idx, frame);
     while (memvalue->get_op() == smt::Store) { // peel the (store (store ...))
       int num = 0;
       for (auto c : memvalue) {
         store_children[num] = c;
         num++;
       }
-
-      auto addr = as_decimal(store_children[1]->to_string());
-      auto data = as_bits(store_children[2]->to_string());
-      auto addr_pos = sig_array_ptr->indices2hash.find(addr);
-      if (addr_pos != sig_array_ptr->indices2hash.end()) {
-        auto prev_pos = valprev.find(addr_pos->second);
-        if (prev_pos == valprev.end()) {
-          valprev.emplace(addr_pos->second, data );
-          fout << data << " " << addr_pos->second << std::endl;
-          // this happens if some elements are not assigned by
-          // the solver in the beginning, I think this is also
-          // common and GtkWave is able to handle it (by having X, don't care)
-          // before it is first assigned
-          // so you can consider even remove the logger below
-          logger.log(3, "{} was not cached before time : {}.",
-            sig_array_ptr->full_name+"["+addr+"]", std::to_string(t));
-        } else {
-          if (prev_pos->second != data) {
-            prev_pos->second = data; // update the value
-            fout << data << " " << addr_pos->second << std::endl;
-          }
-        } // exists in prev pos or not
-      } else {
-        // we should have already recorded all the indices by
-        // going through all the frames earlier on
-        // so if the case happens, it should be a bug actually
-        logger.log(1, "missing addr index for array: {}: , addr : {}" ,
-          sig_array_ptr->full_name, addr);
-      }
+      dump_array_elem(sig_array_ptr,
+                      WitnessTrace::value_decimal(store_children[1]),
+                      "b" + WitnessTrace::value_bits(store_children[2]));
       memvalue = store_children[0];
     }
 
     if (memvalue->get_op().is_null() && memvalue->is_value()) {
       smt::Term const_val = *(memvalue->begin());
-      auto data_default = as_bits(const_val->to_string());
-      auto addr_pos = sig_array_ptr->indices2hash.find("default");
-      if (addr_pos != sig_array_ptr->indices2hash.end()) {
-        auto prev_pos = valprev.find(addr_pos->second);
-        if (prev_pos == valprev.end()) {
-          valprev.emplace(addr_pos->second, data_default );
-          fout << data_default << " " << addr_pos->second << std::endl;
-          // this happens if some elements are not assigned by
-          // the solver in the beginning, I think this is also
-          // common and GtkWave is able to handle it (by having X, don't care)
-          // before it is first assigned
-          // so you can consider even remove the logger below
-          logger.log(3, "{} was not cached before time : {}.",
-            sig_array_ptr->full_name+"[default]", std::to_string(t));
-        } else {
-          if (prev_pos->second != data_default) {
-            prev_pos->second = data_default; // update the value
-            fout << data_default << " " << addr_pos->second << std::endl;
-          }
-        } // exists in prev pos or not
-      } else {
-        // we should have already recorded all the indices by
-        // going through all the frames earlier on
-        // so if the case happens, it should be a bug actually
-        logger.log(1, "missing addr index for array: {}: , addr : {}" ,
-          sig_array_ptr->full_name, "-default-");
-      }
+      dump_array_elem(
+          sig_array_ptr, "default", "b" + WitnessTrace::value_bits(const_val));
     } // handling the inner constant default
   } // for all array signals
-} // end of VCDWitnessPrinter::dump_diff
-
-void VCDWitnessPrinter::DumpValues(std::ostream & fout) const {
-  // at time 0 we dump all the values
-  // and then at each later time, we compare and
-  // see if there is any difference, if not
-  // we just skip it
-  // finally add an empty time-tick
-  if (cex_.empty()) throw PonoException("No trace to dump");
 
-  std::unordered_map<std::string, std::string> hash_to_value_map;
-  // used to store the previous value for comparison
-  fout << "#0" << std::endl;
-  dump_all(cex_.at(0), hash_to_value_map, 0, fout);
-  for (uint64_t t = 1; t < cex_.size(); ++t ) {
-    fout << "#" << t << std::endl;
-    dump_diff(cex_.at(t), hash_to_value_map, t, fout);
+  ++tick_;
+} // end of VCDStreamWriter::write_frame
+
+void VCDStreamWriter::write_frame(const smt::UnorderedTermMap & valmap)
+{
+  if (!signals_collected_)
+    declare_array_indices(valmap);
+  // pack the values of the selected signals only
+  write_frame(WitnessTrace::from_maps(signals(), { valmap }), 0);
+}
+
+void VCDStreamWriter::close()
+{
+  if (closed_)
+    return;
+  closed_ = true;
+  if (header_written_) {
+    // finally add an empty time-tick
+    emit("#" + std::to_string(tick_) + "\n");
   }
-  fout << "#" << cex_.size() << std::endl;
+  flush();
+#ifdef WITH_ZLIB
+  if (gz_) {
+    gzclose((gzFile)gz_);
+    gz_ = nullptr;
+  }
+#endif
+  if (fout_.is_open())
+    fout_.close();
+} // end of VCDStreamWriter::close
+
+VCDWitnessPrinter::VCDWitnessPrinter(
+    const TransitionSystem & ts, const std::vector<smt::UnorderedTermMap> & cex)
+    : ts_(ts), cex_(cex)
+{
 }
 
+void VCDWitnessPrinter::debug_dump() const
+{
+  for (uint64_t fidx = 0; fidx < cex_.size(); ++ fidx) {
+    logger.log(3, "------------- CEX : F{} -----------------", fidx);
+    for (auto && t : cex_.at(fidx)) {
+      logger.log(3, "{} -> {}", t.first->to_string(), t.second->to_string() );
+    }
+  }
+}  // debug_dump
+
 void VCDWitnessPrinter::dump_trace_to_file(
-    const std::string & vcd_file_name) const
+    const std::string & vcd_file_name, const VCDSignalFilter & filter) const
 {
-  std::ofstream fout(vcd_file_name);
-  if (!fout.is_open())
-    throw PonoException("Unable to write to : " + vcd_file_name);
+  if (cex_.empty()) throw PonoException("No trace to dump");
 
-  GenHeader(fout);
-  DumpValues(fout);
+  VCDStreamWriter writer(ts_, vcd_file_name, filter);
+  // all frames are available, so declare every array index up front
+  for (auto && valmap : cex_) {
+    writer.declare_array_indices(valmap);
+  }
+  // pack the values of the selected signals once
+  WitnessTrace trace = WitnessTrace::from_maps(writer.signals(), cex_);
+  for (size_t f = 0; f < trace.num_frames(); ++f) {
+    writer.write_frame(trace, f);
+  }
+  writer.close();
   logger.log(0, "Trace written to " + vcd_file_name);
 }  // dump_trace_to_file
 
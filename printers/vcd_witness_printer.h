@@ -9,19 +9,26 @@
  ** All rights reserved.  See the file LICENSE in the top-level source
  ** directory for licensing information.\endverbatim
  **
- ** \brief
- **
+ ** \brief VCD output of witnesses. VCDStreamWriter emits the header and
+ **        then every frame as soon as it is given, keeping only the last
+ **        printed value of each selected signal. Values are printed from
+ **        the packed columns of a WitnessTrace.
  **
  **/
 
+#pragma once
+
+#include <fstream>
+#include <functional>
 #include <iterator>
 #include <map>
+#include <regex>
+#include <set>
 #include <sstream>
 #include <vector>
-#include <set>
-#include <functional>
 
-#include "gmpxx.h"
+#include "core/ts.h"
+#include "core/witness_trace.h"
 #include "smt-switch/smt.h"
 
 #include "utils/logger.h"
@@ -34,6 +41,8 @@ struct VCDSignal {
   std::string hash;
   smt::Term   ast;
   uint64_t    data_width;
+  std::vector<uint64_t> prev; // last printed value (packed)
+  bool        has_prev;
   VCDSignal(const std::string & _vcd_name,
             const std::string & _full_name,
             const std::string & _hash,
@@ -43,7 +52,9 @@ struct VCDSignal {
         full_name(_full_name),
         hash(_hash),
         ast(_ast),
-        data_width(w)
+        data_width(w),
+        prev((w + 63) / 64, 0),
+        has_prev(false)
   {
   }
 };
@@ -66,20 +77,102 @@ struct VCDScope {
   std::map<std::string, VCDArray> arrays;
 }; // struct VCDScope
 
-class VCDWitnessPrinter {
+/** Selects the signals that are written to a VCD file
+ *  An empty filter selects everything. Otherwise a signal is written if
+ *  its name matches one of the globs or the regex (when given), and it
+ *  only depends on variables in the cone-of-influence of coi_of (when given)
+ */
+struct VCDSignalFilter {
+  std::vector<std::string> globs; // '*' and '?' wildcards
+  std::string regex;              // ECMAScript syntax
+  smt::TermVec coi_of;
+
+  bool empty() const { return globs.empty() && regex.empty() && coi_of.empty(); }
+};
+
+class VCDStreamWriter {
 public:
-  // types
-  typedef std::map<std::string, std::vector<std::string>> per_mem_indices;
+  /** Opens the output file, the header is written with the first frame
+   *  @param ts the transition system the frames are over
+   *  @param vcd_file_name the file to write, a name ending in .gz
+   *         is written gzip compressed (requires building with zlib)
+   *  @param filter selects the signals to write
+   */
+  VCDStreamWriter(const TransitionSystem & ts,
+                  const std::string & vcd_file_name,
+                  const VCDSignalFilter & filter = VCDSignalFilter());
+  ~VCDStreamWriter();
+
+  /** Declares the array indices assigned in valmap
+   *  VCD needs every variable in the header, so array elements first
+   *  assigned after the signals are selected are skipped. Call this on the
+   *  frames ahead of time when they are all available.
+   */
+  void declare_array_indices(const smt::UnorderedTermMap & valmap);
+
+  /** @return the terms written to the file, they are selected by the
+   *          first call to this or to write_frame
+   *  Build the WitnessTrace given to write_frame over these terms
+   */
+  const smt::TermVec & signals();
+
+  /** Writes the values of frame of trace as the next frame, only changes
+   *  are written after the first frame
+   *  @param trace a trace over (a superset of) signals()
+   *  @param frame the frame of trace to write
+   */
+  void write_frame(const WitnessTrace & trace, size_t frame);
+
+  /** Writes the values of the next frame, only changes are written
+   *  after the first frame
+   */
+  void write_frame(const smt::UnorderedTermMap & valmap);
+
+  /** Writes the final time tick and closes the file */
+  void close();
+
+  size_t num_frames() const { return tick_; }
+  size_t num_signals() const { return allsig_bv_.size(); }
+
 protected:
- const smt::UnorderedTermSet & inputs_;
- const smt::UnorderedTermSet & states_;
- const std::unordered_map<std::string, smt::Term> & named_terms_;
- const std::vector<smt::UnorderedTermMap> & cex_;
+ const TransitionSystem & ts_;
+ std::string file_name_;
+ VCDSignalFilter filter_;
+ std::regex regex_;
+ smt::UnorderedTermSet coi_vars_;
 
  VCDScope root_scope_;
  // hash id --> signal object
  std::vector<VCDSignal *> allsig_bv_;
  std::vector<VCDArray *> allsig_array_;
+ // array element hash id --> last printed value
+ std::unordered_map<std::string, std::string> array_prev_;
+ // array --> indices seen before the header is written
+ std::unordered_map<smt::Term, std::set<std::string>> array_indices_;
+ smt::UnorderedTermSet array_has_default_;
+
+ bool signals_collected_;
+ smt::TermVec signals_;
+ bool header_written_;
+ bool closed_;
+ uint64_t tick_;
+
+ // output is buffered and written in large chunks
+ std::string buf_;
+ std::ofstream fout_;
+ void * gz_; // gzFile if compressed
+
+ void emit(const std::string & s);
+ void flush();
+
+ // does filter_ keep this signal
+ bool selected(const std::string & name, const smt::Term & ast) const;
+ void compute_coi();
+
+ // registers the signals, called once before the header is written
+ void collect_signals();
+ // records the indices assigned in the value of an array state variable
+ void declare_array_value(const smt::Term & state, const smt::Term & value);
 
  // given a name like a.b.c, find the right scope and
  // create if it does not exists
@@ -88,7 +181,7 @@ protected:
                          const smt::Term & ast);
  // another function for array maybe?
  void check_insert_scope_array(std::string full_name,
-                               const std::unordered_set<std::string> & indices,
+                               const std::set<std::string> & indices,
                                bool has_default,
                                const smt::Term & ast);
 
@@ -99,28 +192,29 @@ protected:
  std::string new_property_id();
 
  void dump_current_scope(std::ostream & fout, const VCDScope *) const;
+ void GenHeader();
 
- void dump_all(const smt::UnorderedTermMap & valmap,
-               std::unordered_map<std::string, std::string> & valbuf,
-               uint64_t tick,
-               std::ostream & fout) const;
- void dump_diff(const smt::UnorderedTermMap & valmap,
-                std::unordered_map<std::string, std::string> & valprev,
-                uint64_t tick,
-                std::ostream & fout) const;
+ // writes the value of an array element if it changed
+ void dump_array_elem(const VCDArray * arr,
+                      const std::string & index,
+                      const std::string & data);
 
+}; // class VCDStreamWriter
 
+class VCDWitnessPrinter {
+public:
+  // types
+  typedef std::map<std::string, std::vector<std::string>> per_mem_indices;
 protected:
-
-  void DumpScopes(std::ostream & fout) const;
-  void GenHeader(std::ostream & fout) const;
-  void DumpValues(std::ostream & fout) const;
+ const TransitionSystem & ts_;
+ const std::vector<smt::UnorderedTermMap> & cex_;
 
 public:
  VCDWitnessPrinter(const TransitionSystem & ts,
                    const std::vector<smt::UnorderedTermMap> & cex);
 
- void dump_trace_to_file(const std::string & vcd_file_name) const;
+ void dump_trace_to_file(const std::string & vcd_file_name,
+                         const VCDSignalFilter & filter = VCDSignalFilter()) const;
  void debug_dump() const;
 
 }; // class VCDWitnessPrinter
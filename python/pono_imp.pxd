@@ -39,6 +39,8 @@ cdef extern from "core/ts.h" namespace "pono":
         const c_UnorderedTermSet & inputvars() except +
         c_Term init() except +
         c_Term trans() except +
+        const c_TermVec & init_conjuncts() except +
+        const c_TermVec & trans_conjuncts() except +
         const c_UnorderedTermMap & state_updates() except +
         unordered_map[string, c_Term] & named_terms() except +
         const vector[pair[c_Term, bool]] & constraints() except +
@@ -91,6 +93,24 @@ cdef extern from "core/unroller.h" namespace "pono":
         size_t get_var_time(const c_Term & v) except +
 
 
+cdef extern from "core/simulator.h" namespace "pono":
+    cdef cppclass Simulator:
+        Simulator(const TransitionSystem & ts) except +
+        void add_signal(const c_Term & t) except +
+        bint reset(bint random) except +
+        void eval() except +
+        bint constraints_hold() except +
+        void advance() except +
+        bint step() except +
+        void seed(uint64_t s) except +
+        void randomize_inputs() except +
+        void set_bits(const c_Term & var, const string & bits) except +
+        void set_value(const c_Term & var, const c_Term & val) except +
+        string get_bits(const c_Term & t) except +
+        c_Term get_value(const c_Term & t) except +
+        void get_frame(c_UnorderedTermMap & m) except +
+
+
 cdef extern from "core/proverresult.h" namespace "pono":
     cdef cppclass ProverResult:
         pass
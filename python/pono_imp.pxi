@@ -1,5 +1,5 @@
 from cython.operator cimport dereference as dref, preincrement as inc
-from libc.stdint cimport uintptr_t
+from libc.stdint cimport uintptr_t, uint64_t
 from libcpp cimport bool as cbool
 from libcpp.pair cimport pair
 from libcpp.string cimport string
@@ -12,6 +12,7 @@ from pono_imp cimport RelationalTransitionSystem as c_RelationalTransitionSystem
 from pono_imp cimport FunctionalTransitionSystem as c_FunctionalTransitionSystem
 from pono_imp cimport Property as c_Property
 from pono_imp cimport Unroller as c_Unroller
+from pono_imp cimport Simulator as c_Simulator
 from pono_imp cimport ProverResult as c_ProverResult
 from pono_imp cimport UNKNOWN as c_UNKNOWN
 from pono_imp cimport FALSE as c_FALSE
@@ -231,6 +232,26 @@ cdef class __AbstractTransitionSystem:
         term.ct = dref(self.cts).trans()
         return term
 
+    @property
+    def init_conjuncts(self):
+        conjuncts = []
+        cdef c_TermVec c_conjuncts = dref(self.cts).init_conjuncts()
+        for c in c_conjuncts:
+            python_term = Term(self._solver)
+            python_term.ct = c
+            conjuncts.append(python_term)
+        return conjuncts
+
+    @property
+    def trans_conjuncts(self):
+        conjuncts = []
+        cdef c_TermVec c_conjuncts = dref(self.cts).trans_conjuncts()
+        for c in c_conjuncts:
+            python_term = Term(self._solver)
+            python_term.ct = c
+            conjuncts.append(python_term)
+        return conjuncts
+
     def is_functional(self):
         return dref(self.cts).is_functional()
 
@@ -448,6 +469,78 @@ cdef class Unroller:
         return dref(self.cu).get_var_time(v.ct)
 
 
+cdef class Simulator:
+    cdef c_Simulator* csim
+    # keeps the system alive, the simulator holds a reference to it
+    cdef __AbstractTransitionSystem _ts
+    cdef SmtSolver _solver
+    def __cinit__(self, __AbstractTransitionSystem ts):
+        self.csim = new c_Simulator(ts.cts[0])
+        self._ts = ts
+        self._solver = ts._solver
+
+    def __dealloc__(self):
+        del self.csim
+
+    def add_signal(self, Term t):
+        dref(self.csim).add_signal(t.ct)
+
+    def reset(self, bint random=False):
+        return dref(self.csim).reset(random)
+
+    def eval(self):
+        dref(self.csim).eval()
+
+    def constraints_hold(self):
+        return dref(self.csim).constraints_hold()
+
+    def advance(self):
+        dref(self.csim).advance()
+
+    def step(self):
+        return dref(self.csim).step()
+
+    def seed(self, uint64_t s):
+        dref(self.csim).seed(s)
+
+    def randomize_inputs(self):
+        dref(self.csim).randomize_inputs()
+
+    def set(self, Term var, val):
+        '''
+        Sets a bit-vector or boolean variable to an int or a solver value
+        '''
+        if isinstance(val, Term):
+            dref(self.csim).set_value(var.ct, (<Term> val).ct)
+        else:
+            width = len(dref(self.csim).get_bits(var.ct))
+            bits = format(int(val) % (1 << width), '0{}b'.format(width))
+            dref(self.csim).set_bits(var.ct, bits.encode())
+
+    def get(self, Term t):
+        return int(dref(self.csim).get_bits(t.ct).decode(), 2)
+
+    def get_value(self, Term t):
+        cdef Term term = Term(self._solver)
+        term.ct = dref(self.csim).get_value(t.ct)
+        return term
+
+    def get_frame(self):
+        cdef c_UnorderedTermMap m
+        dref(self.csim).get_frame(m)
+
+        cdef Term kt
+        cdef Term vt
+        d = dict()
+        for elem in m:
+            kt = Term(self._solver)
+            kt.ct = (<c_Term?> elem.first)
+            vt = Term(self._solver)
+            vt.ct = (<c_Term?> elem.second)
+            d[kt] = vt
+        return d
+
+
 cdef class __AbstractProver:
     # this pointer is allocated and deallocated by derived classes
     cdef c_Prover* cp
@@ -0,0 +1,620 @@
+/*********************                                                        */
+/*! \file sat_solver.cpp
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Incremental CDCL SAT solver for the bit-level engines.
+**        Two watched literals with blockers, first-UIP learning with
+**        local minimization, VSIDS with phase saving, Luby restarts and
+**        activity-based deletion of learnt clauses.
+**
+**/
+
+#include "smt/sat_solver.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+
+#include "utils/exceptions.h"
+
+using namespace std;
+
+namespace pono {
+
+namespace {
+
+/** Luby sequence scaled by y, as in MiniSat */
+double luby(double y, int x)
+{
+  int size, seq;
+  for (size = 1, seq = 0; size < x + 1; seq++, size = 2 * size + 1)
+    ;
+  while (size - 1 != x) {
+    size = (size - 1) >> 1;
+    seq--;
+    x = x % size;
+  }
+  double res = 1;
+  for (int i = 0; i < seq; ++i) {
+    res *= y;
+  }
+  return res;
+}
+
+const double var_decay = 0.95;
+const double clause_decay = 0.999;
+const int64_t restart_first = 100;
+
+}  // namespace
+
+SatSolver::SatSolver()
+    : ok_(true),
+      qhead_(0),
+      var_inc_(1),
+      clause_inc_(1),
+      max_learnts_(2000),
+      simp_assigns_(0),
+      conflicts_(0)
+{
+  // variable 0 is unused, literals are numbered from 2
+  assigns_.push_back(0);
+  level_.push_back(0);
+  reason_.push_back(nullptr);
+  phase_.push_back(true);
+  seen_.push_back(false);
+  activity_.push_back(0);
+  heap_idx_.push_back(-1);
+  watches_.resize(2);
+  conflict_.resize(2, false);
+}
+
+SatSolver::~SatSolver()
+{
+  for (auto c : clauses_) {
+    delete c;
+  }
+  for (auto c : learnts_) {
+    delete c;
+  }
+}
+
+int SatSolver::new_var()
+{
+  uint32_t v = assigns_.size();
+  assigns_.push_back(0);
+  level_.push_back(0);
+  reason_.push_back(nullptr);
+  phase_.push_back(true);
+  seen_.push_back(false);
+  activity_.push_back(0);
+  heap_idx_.push_back(-1);
+  watches_.resize(2 * v + 2);
+  conflict_.resize(2 * v + 2, false);
+  heap_insert(v);
+  return v;
+}
+
+void SatSolver::add_clause(const vector<int> & lits)
+{
+  assert(!decision_level());
+  if (!ok_) {
+    return;
+  }
+
+  vector<Lit> c;
+  c.reserve(lits.size());
+  for (int l : lits) {
+    if (!l || abs(l) > (int)num_vars()) {
+      throw PonoException("SatSolver: literal " + std::to_string(l)
+                          + " of an unknown variable");
+    }
+    c.push_back(to_lit(l));
+  }
+  sort(c.begin(), c.end());
+
+  // drop duplicates and false literals, skip satisfied clauses
+  size_t j = 0;
+  for (size_t i = 0; i < c.size(); ++i) {
+    if (lit_value(c[i]) == 1 || (i && c[i] == (c[i - 1] ^ 1))) {
+      return;
+    } else if (lit_value(c[i]) == 0 && (!j || c[i] != c[j - 1])) {
+      c[j++] = c[i];
+    }
+  }
+  c.resize(j);
+
+  if (c.empty()) {
+    ok_ = false;
+  } else if (c.size() == 1) {
+    enqueue(c[0], nullptr);
+    ok_ = (propagate() == nullptr);
+  } else {
+    Clause * cl = new Clause{ c, false, false, 0 };
+    clauses_.push_back(cl);
+    attach(cl);
+  }
+}
+
+SatResult SatSolver::solve(const vector<int> & assumptions)
+{
+  model_.clear();
+  fill(conflict_.begin(), conflict_.end(), false);
+  if (!ok_) {
+    return SatResult::UNSAT;
+  }
+
+  assumptions_.clear();
+  for (int l : assumptions) {
+    assumptions_.push_back(to_lit(l));
+  }
+
+  if (trail_.size() > simp_assigns_ + 100) {
+    remove_satisfied();
+  }
+  max_learnts_ = max(max_learnts_, clauses_.size() / 3);
+
+  SatResult res = SatResult::UNKNOWN;
+  for (int restarts = 0; res == SatResult::UNKNOWN; ++restarts) {
+    res = search(luby(2, restarts) * restart_first);
+    if (res == SatResult::UNKNOWN && terminate_ && terminate_()) {
+      break;
+    }
+  }
+
+  if (res == SatResult::SAT) {
+    model_ = assigns_;
+  }
+  cancel_until(0);
+  return res;
+}
+
+bool SatSolver::value(int lit) const
+{
+  assert(!model_.empty());
+  int8_t v = model_[abs(lit)];
+  return (lit > 0) ? (v == 1) : (v == -1);
+}
+
+bool SatSolver::failed(int lit) const { return conflict_[to_lit(lit)]; }
+
+void SatSolver::enqueue(Lit l, Clause * reason)
+{
+  assert(!lit_value(l));
+  uint32_t v = var(l);
+  assigns_[v] = (l & 1) ? -1 : 1;
+  level_[v] = decision_level();
+  reason_[v] = reason;
+  trail_.push_back(l);
+}
+
+void SatSolver::attach(Clause * c)
+{
+  assert(c->lits.size() > 1);
+  watches_[c->lits[0] ^ 1].push_back({ c, c->lits[1] });
+  watches_[c->lits[1] ^ 1].push_back({ c, c->lits[0] });
+}
+
+SatSolver::Clause * SatSolver::propagate()
+{
+  Clause * confl = nullptr;
+  while (qhead_ < trail_.size()) {
+    Lit p = trail_[qhead_++];
+    Lit false_lit = p ^ 1;
+    vector<Watcher> & ws = watches_[p];
+    size_t i = 0, j = 0;
+    while (i < ws.size()) {
+      Watcher w = ws[i];
+      if (w.c->deleted) {
+        ++i;
+        continue;
+      }
+      if (lit_value(w.blocker) == 1) {
+        ws[j++] = ws[i++];
+        continue;
+      }
+
+      vector<Lit> & c = w.c->lits;
+      if (c[0] == false_lit) {
+        swap(c[0], c[1]);
+      }
+      assert(c[1] == false_lit);
+      ++i;
+
+      Lit first = c[0];
+      Watcher nw{ w.c, first };
+      if (first != w.blocker && lit_value(first) == 1) {
+        ws[j++] = nw;
+        continue;
+      }
+
+      // look for a new literal to watch
+      bool found = false;
+      for (size_t k = 2; k < c.size(); ++k) {
+        if (lit_value(c[k]) != -1) {
+          swap(c[1], c[k]);
+          watches_[c[1] ^ 1].push_back(nw);
+          found = true;
+          break;
+        }
+      }
+      if (found) {
+        continue;
+      }
+
+      // unit or conflicting
+      ws[j++] = nw;
+      if (lit_value(first) == -1) {
+        confl = w.c;
+        qhead_ = trail_.size();
+        while (i < ws.size()) {
+          ws[j++] = ws[i++];
+        }
+      } else {
+        enqueue(first, w.c);
+      }
+    }
+    ws.resize(j);
+    if (confl) {
+      break;
+    }
+  }
+  return confl;
+}
+
+void SatSolver::analyze(Clause * confl, vector<Lit> & learnt, size_t & bt_level)
+{
+  int path = 0;
+  Lit p = lit_undef;
+  learnt.clear();
+  learnt.push_back(lit_undef);
+  size_t idx = trail_.size();
+
+  do {
+    assert(confl);
+    if (confl->learnt) {
+      bump_clause(confl);
+    }
+    const vector<Lit> & c = confl->lits;
+    for (size_t j = (p == lit_undef) ? 0 : 1; j < c.size(); ++j) {
+      uint32_t v = var(c[j]);
+      if (!seen_[v] && level_[v] > 0) {
+        bump_var(v);
+        seen_[v] = true;
+        if (level_[v] >= decision_level()) {
+          path++;
+        } else {
+          learnt.push_back(c[j]);
+        }
+      }
+    }
+    // next literal of the current level on the trail
+    while (!seen_[var(trail_[--idx])])
+      ;
+    p = trail_[idx];
+    confl = reason_[var(p)];
+    seen_[var(p)] = false;
+    path--;
+  } while (path > 0);
+  learnt[0] = p ^ 1;
+
+  // drop literals implied by the other literals of the clause
+  vector<Lit> to_clear(learnt.begin() + 1, learnt.end());
+  size_t j = 1;
+  for (size_t i = 1; i < learnt.size(); ++i) {
+    Clause * r = reason_[var(learnt[i])];
+    bool keep = !r;
+    for (size_t k = 1; r && !keep && k < r->lits.size(); ++k) {
+      uint32_t v = var(r->lits[k]);
+      keep = !seen_[v] && level_[v] > 0;
+    }
+    if (keep) {
+      learnt[j++] = learnt[i];
+    }
+  }
+  learnt.resize(j);
+  for (Lit l : to_clear) {
+    seen_[var(l)] = false;
+  }
+
+  // the literal of the highest remaining level is watched with learnt[0]
+  bt_level = 0;
+  if (learnt.size() > 1) {
+    size_t max_i = 1;
+    for (size_t i = 2; i < learnt.size(); ++i) {
+      if (level_[var(learnt[i])] > level_[var(learnt[max_i])]) {
+        max_i = i;
+      }
+    }
+    swap(learnt[1], learnt[max_i]);
+    bt_level = level_[var(learnt[1])];
+  }
+}
+
+void SatSolver::analyze_final(Lit p)
+{
+  conflict_[p] = true;
+  if (!decision_level()) {
+    return;
+  }
+
+  seen_[var(p)] = true;
+  for (size_t i = trail_.size(); i-- > trail_lim_[0];) {
+    uint32_t v = var(trail_[i]);
+    if (!seen_[v]) {
+      continue;
+    }
+    Clause * r = reason_[v];
+    if (!r) {
+      // decisions below the assumption levels are assumptions
+      conflict_[trail_[i]] = true;
+    } else {
+      for (size_t k = 1; k < r->lits.size(); ++k) {
+        if (level_[var(r->lits[k])] > 0) {
+          seen_[var(r->lits[k])] = true;
+        }
+      }
+    }
+    seen_[v] = false;
+  }
+  seen_[var(p)] = false;
+}
+
+void SatSolver::cancel_until(size_t level)
+{
+  if (decision_level() <= level) {
+    return;
+  }
+  for (size_t i = trail_.size(); i-- > trail_lim_[level];) {
+    uint32_t v = var(trail_[i]);
+    assigns_[v] = 0;
+    reason_[v] = nullptr;
+    phase_[v] = trail_[i] & 1;
+    heap_insert(v);
+  }
+  qhead_ = trail_lim_[level];
+  trail_.resize(trail_lim_[level]);
+  trail_lim_.resize(level);
+}
+
+SatSolver::Lit SatSolver::pick_branch()
+{
+  while (!heap_.empty()) {
+    uint32_t v = heap_pop();
+    if (!assigns_[v]) {
+      return 2 * v + (phase_[v] ? 1 : 0);
+    }
+  }
+  return lit_undef;
+}
+
+SatResult SatSolver::search(int64_t max_conflicts)
+{
+  int64_t num_conflicts = 0;
+  vector<Lit> learnt;
+  for (;;) {
+    Clause * confl = propagate();
+    if (confl) {
+      conflicts_++;
+      num_conflicts++;
+      if (!decision_level()) {
+        ok_ = false;
+        return SatResult::UNSAT;
+      }
+
+      size_t bt_level;
+      analyze(confl, learnt, bt_level);
+      cancel_until(bt_level);
+      if (learnt.size() == 1) {
+        enqueue(learnt[0], nullptr);
+      } else {
+        Clause * c = new Clause{ learnt, true, false, 0 };
+        learnts_.push_back(c);
+        attach(c);
+        bump_clause(c);
+        enqueue(learnt[0], c);
+      }
+      var_inc_ /= var_decay;
+      clause_inc_ /= clause_decay;
+      continue;
+    }
+
+    if (num_conflicts >= max_conflicts
+        || ((conflicts_ & 255) == 255 && terminate_ && terminate_())) {
+      // restart
+      cancel_until(0);
+      return SatResult::UNKNOWN;
+    }
+
+    if (learnts_.size() >= max_learnts_ + trail_.size()) {
+      reduce_db();
+    }
+
+    Lit next = lit_undef;
+    while (decision_level() < assumptions_.size()) {
+      Lit p = assumptions_[decision_level()];
+      if (lit_value(p) == 1) {
+        // dummy decision level
+        trail_lim_.push_back(trail_.size());
+      } else if (lit_value(p) == -1) {
+        analyze_final(p);
+        return SatResult::UNSAT;
+      } else {
+        next = p;
+        break;
+      }
+    }
+
+    if (next == lit_undef) {
+      next = pick_branch();
+      if (next == lit_undef) {
+        return SatResult::SAT;
+      }
+    }
+    trail_lim_.push_back(trail_.size());
+    enqueue(next, nullptr);
+  }
+}
+
+void SatSolver::bump_var(uint32_t v)
+{
+  activity_[v] += var_inc_;
+  if (activity_[v] > 1e100) {
+    for (auto & a : activity_) {
+      a *= 1e-100;
+    }
+    var_inc_ *= 1e-100;
+  }
+  if (heap_idx_[v] >= 0) {
+    heap_up(heap_idx_[v]);
+  }
+}
+
+void SatSolver::bump_clause(Clause * c)
+{
+  c->activity += clause_inc_;
+  if (c->activity > 1e20) {
+    for (auto l : learnts_) {
+      l->activity *= 1e-20;
+    }
+    clause_inc_ *= 1e-20;
+  }
+}
+
+bool SatSolver::locked(const Clause * c) const
+{
+  return reason_[var(c->lits[0])] == c && lit_value(c->lits[0]) == 1;
+}
+
+void SatSolver::reduce_db()
+{
+  sort(learnts_.begin(),
+       learnts_.end(),
+       [](const Clause * a, const Clause * b) {
+         return a->activity < b->activity;
+       });
+  size_t half = learnts_.size() / 2;
+  for (size_t i = 0; i < half; ++i) {
+    Clause * c = learnts_[i];
+    if (c->lits.size() > 2 && !locked(c)) {
+      c->deleted = true;
+    }
+  }
+  purge_deleted();
+  max_learnts_ += max_learnts_ / 10;
+}
+
+void SatSolver::remove_satisfied()
+{
+  assert(!decision_level());
+  if (propagate()) {
+    ok_ = false;
+    return;
+  }
+  for (auto l : trail_) {
+    // reasons at level 0 are never analyzed
+    reason_[var(l)] = nullptr;
+  }
+  for (auto cs : { &clauses_, &learnts_ }) {
+    for (auto c : *cs) {
+      for (Lit l : c->lits) {
+        if (lit_value(l) == 1) {
+          c->deleted = true;
+          break;
+        }
+      }
+    }
+  }
+  purge_deleted();
+  simp_assigns_ = trail_.size();
+}
+
+void SatSolver::purge_deleted()
+{
+  for (auto & ws : watches_) {
+    ws.erase(remove_if(ws.begin(),
+                       ws.end(),
+                       [](const Watcher & w) { return w.c->deleted; }),
+             ws.end());
+  }
+  for (auto cs : { &clauses_, &learnts_ }) {
+    size_t j = 0;
+    for (auto c : *cs) {
+      if (c->deleted) {
+        delete c;
+      } else {
+        (*cs)[j++] = c;
+      }
+    }
+    cs->resize(j);
+  }
+}
+
+void SatSolver::heap_insert(uint32_t v)
+{
+  if (heap_idx_[v] >= 0) {
+    return;
+  }
+  heap_idx_[v] = heap_.size();
+  heap_.push_back(v);
+  heap_up(heap_.size() - 1);
+}
+
+uint32_t SatSolver::heap_pop()
+{
+  uint32_t v = heap_[0];
+  heap_[0] = heap_.back();
+  heap_idx_[heap_[0]] = 0;
+  heap_.pop_back();
+  heap_idx_[v] = -1;
+  if (heap_.size() > 1) {
+    heap_down(0);
+  }
+  return v;
+}
+
+void SatSolver::heap_up(size_t i)
+{
+  uint32_t v = heap_[i];
+  while (i > 0) {
+    size_t parent = (i - 1) / 2;
+    if (!heap_less(v, heap_[parent])) {
+      break;
+    }
+    heap_[i] = heap_[parent];
+    heap_idx_[heap_[i]] = i;
+    i = parent;
+  }
+  heap_[i] = v;
+  heap_idx_[v] = i;
+}
+
+void SatSolver::heap_down(size_t i)
+{
+  uint32_t v = heap_[i];
+  for (;;) {
+    size_t child = 2 * i + 1;
+    if (child >= heap_.size()) {
+      break;
+    }
+    if (child + 1 < heap_.size() && heap_less(heap_[child + 1], heap_[child])) {
+      child++;
+    }
+    if (!heap_less(heap_[child], v)) {
+      break;
+    }
+    heap_[i] = heap_[child];
+    heap_idx_[heap_[i]] = i;
+    i = child;
+  }
+  heap_[i] = v;
+  heap_idx_[v] = i;
+}
+
+}  // namespace pono
@@ -0,0 +1,166 @@
+/*********************                                                        */
+/*! \file sat_solver.h
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Incremental CDCL SAT solver for the bit-level engines.
+**        The interface follows IPASIR: literals are non-zero integers
+**        (negative for negated variables), clauses are added
+**        permanently and each solve call takes a set of assumptions.
+**
+**/
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace pono {
+
+enum class SatResult
+{
+  SAT,
+  UNSAT,
+  UNKNOWN  ///< interrupted by the terminate callback
+};
+
+class SatSolver
+{
+ public:
+  SatSolver();
+  ~SatSolver();
+
+  SatSolver(const SatSolver &) = delete;
+  SatSolver & operator=(const SatSolver &) = delete;
+
+  /** @return a new variable, numbered from 1 */
+  int new_var();
+
+  size_t num_vars() const { return assigns_.size() - 1; }
+
+  /** Adds a clause over existing variables */
+  void add_clause(const std::vector<int> & lits);
+
+  /** Checks satisfiability under assumptions
+   *  @param assumptions literals that must hold in this call only
+   */
+  SatResult solve(const std::vector<int> & assumptions = {});
+
+  /** @return the value of lit in the model, after solve returned SAT */
+  bool value(int lit) const;
+
+  /** @return true iff assumption lit was needed to prove unsatisfiability,
+   *          after solve returned UNSAT
+   */
+  bool failed(int lit) const;
+
+  /** Sets a callback that is polled during search, solve returns UNKNOWN
+   *  once it returns true
+   */
+  void set_terminate(std::function<bool()> terminate)
+  {
+    terminate_ = terminate;
+  }
+
+  uint64_t num_conflicts() const { return conflicts_; }
+
+ protected:
+  // internal literals are var * 2 + sign
+  typedef uint32_t Lit;
+  static constexpr Lit lit_undef = UINT32_MAX;
+
+  struct Clause
+  {
+    std::vector<Lit> lits;
+    bool learnt;
+    bool deleted;
+    double activity;
+  };
+
+  struct Watcher
+  {
+    Clause * c;
+    Lit blocker;
+  };
+
+  static Lit to_lit(int l) { return (l > 0) ? (2 * l) : (-2 * l + 1); }
+  static uint32_t var(Lit l) { return l >> 1; }
+
+  /** @return 1 if l is true, -1 if false, 0 if unassigned */
+  int8_t lit_value(Lit l) const
+  {
+    int8_t v = assigns_[var(l)];
+    return (l & 1) ? -v : v;
+  }
+
+  size_t decision_level() const { return trail_lim_.size(); }
+
+  void enqueue(Lit l, Clause * reason);
+  void attach(Clause * c);
+  Clause * propagate();
+  void analyze(Clause * confl, std::vector<Lit> & learnt, size_t & bt_level);
+  /** Computes the assumptions responsible for falsifying assumption p */
+  void analyze_final(Lit p);
+  void cancel_until(size_t level);
+  Lit pick_branch();
+  SatResult search(int64_t max_conflicts);
+
+  void bump_var(uint32_t v);
+  void bump_clause(Clause * c);
+  bool locked(const Clause * c) const;
+  /** Deletes half of the learnt clauses, the least active first */
+  void reduce_db();
+  /** Deletes clauses satisfied at decision level 0 */
+  void remove_satisfied();
+  /** Removes deleted clauses from the watch lists and frees them */
+  void purge_deleted();
+
+  // order heap, the most active variable on top
+  bool heap_less(uint32_t a, uint32_t b) const
+  {
+    return activity_[a] > activity_[b];
+  }
+  void heap_insert(uint32_t v);
+  uint32_t heap_pop();
+  void heap_up(size_t i);
+  void heap_down(size_t i);
+
+  bool ok_;  ///< false once the clauses are unsatisfiable
+  std::vector<Clause *> clauses_;
+  std::vector<Clause *> learnts_;
+  std::vector<std::vector<Watcher>> watches_;  ///< per literal that is true
+
+  std::vector<int8_t> assigns_;
+  std::vector<size_t> level_;
+  std::vector<Clause *> reason_;
+  std::vector<bool> phase_;  ///< saved phase, true for negative
+  std::vector<bool> seen_;
+  std::vector<Lit> trail_;
+  std::vector<size_t> trail_lim_;
+  size_t qhead_;
+
+  std::vector<double> activity_;
+  double var_inc_;
+  double clause_inc_;
+  std::vector<uint32_t> heap_;
+  std::vector<int64_t> heap_idx_;  ///< -1 if not in heap_
+
+  std::vector<Lit> assumptions_;
+  std::vector<int8_t> model_;
+  std::vector<bool> conflict_;  ///< failed assumptions, per literal
+
+  size_t max_learnts_;
+  size_t simp_assigns_;  ///< level 0 assignments at the last simplification
+  uint64_t conflicts_;
+
+  std::function<bool()> terminate_;
+};
+
+}  // namespace pono
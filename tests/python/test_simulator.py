@@ -0,0 +1,27 @@
+import pytest
+import smt_switch as ss
+import pono
+
+
+@pytest.mark.parametrize("create_solver", ss.solvers.values())
+def test_simulator_counter(create_solver):
+    solver = create_solver(False)
+    bvsort8 = solver.make_sort(ss.sortkinds.BV, 8)
+
+    ts = pono.FunctionalTransitionSystem(solver)
+    x = ts.make_statevar('x', bvsort8)
+    inc = ts.make_inputvar('inc', bvsort8)
+    ts.constrain_init(solver.make_term(ss.primops.Equal,
+                                       x,
+                                       solver.make_term(0, bvsort8)))
+    ts.assign_next(x, solver.make_term(ss.primops.BVAdd, x, inc))
+
+    sim = pono.Simulator(ts)
+    assert sim.reset()
+    sim.set(inc, 3)
+    for i in range(100):
+        assert sim.get(x) == (3*i) % 256
+        assert sim.step()
+
+    frame = sim.get_frame()
+    assert frame[x] == solver.make_term(44, bvsort8)
@@ -0,0 +1,295 @@
+#include <sstream>
+#include <vector>
+
+#include "core/aig.h"
+#include "core/aig_sweeper.h"
+#include "core/fts.h"
+#include "core/rts.h"
+#include "engines/aig_bmc.h"
+#include "engines/aig_ic3.h"
+#include "frontends/aiger_encoder.h"
+#include "gtest/gtest.h"
+#include "modifiers/aig_reducer.h"
+#include "smt/available_solvers.h"
+#include "smt/sat_solver.h"
+#include "tests/common_ts.h"
+#include "utils/exceptions.h"
+#include "utils/ts_analysis.h"
+
+using namespace pono;
+using namespace smt;
+using namespace std;
+
+namespace pono_tests {
+
+TEST(SatSolverTests, Incremental)
+{
+  SatSolver sat;
+  int a = sat.new_var();
+  int b = sat.new_var();
+  int c = sat.new_var();
+  sat.add_clause({ a, b });
+  sat.add_clause({ -a, c });
+  ASSERT_EQ(sat.solve({ -b }), SatResult::SAT);
+  EXPECT_TRUE(sat.value(a));
+  EXPECT_TRUE(sat.value(c));
+
+  ASSERT_EQ(sat.solve({ -b, -c, a }), SatResult::UNSAT);
+  EXPECT_TRUE(sat.failed(-b) || sat.failed(a));
+  EXPECT_TRUE(sat.failed(-c));
+
+  // assumptions don't persist
+  ASSERT_EQ(sat.solve(), SatResult::SAT);
+  sat.add_clause({ -c });
+  ASSERT_EQ(sat.solve(), SatResult::SAT);
+  EXPECT_TRUE(sat.value(b));
+  sat.add_clause({ -b });
+  EXPECT_EQ(sat.solve(), SatResult::UNSAT);
+}
+
+TEST(SatSolverTests, Pigeonhole)
+{
+  // 5 pigeons in 4 holes
+  SatSolver sat;
+  const int pigeons = 5, holes = 4;
+  vector<vector<int>> p(pigeons, vector<int>(holes));
+  for (auto & row : p) {
+    for (auto & x : row) {
+      x = sat.new_var();
+    }
+    sat.add_clause(row);
+  }
+  for (int h = 0; h < holes; ++h) {
+    for (int i = 0; i < pigeons; ++i) {
+      for (int j = i + 1; j < pigeons; ++j) {
+        sat.add_clause({ -p[i][h], -p[j][h] });
+      }
+    }
+  }
+  EXPECT_EQ(sat.solve(), SatResult::UNSAT);
+}
+
+TEST(AigTests, StructuralHashing)
+{
+  Aig aig;
+  AigLit a = aig.make_input();
+  AigLit b = aig.make_input();
+  AigLit g = aig.make_and(a, b);
+  EXPECT_EQ(aig.make_and(b, a), g);
+  EXPECT_EQ(aig.make_and(a, Aig::negate(a)), Aig::aig_false);
+  EXPECT_EQ(aig.make_and(a, Aig::aig_true), a);
+  EXPECT_EQ(aig.make_and(a, a), a);
+  EXPECT_EQ(aig.num_ands(), 1u);
+}
+
+TEST(AigTests, Sweeping)
+{
+  Aig aig;
+  AigLit a = aig.make_input();
+  AigLit b = aig.make_input();
+  // two structurally different xors of a and b
+  AigLit x1 = aig.make_xor(a, b);
+  AigLit x2 = aig.make_and(aig.make_or(a, b),
+                           Aig::negate(aig.make_and(a, b)));
+  // two latches with the same next state and initial value
+  AigLit l1 = aig.make_latch();
+  AigLit l2 = aig.make_latch();
+  aig.set_next(l1, x1);
+  aig.set_next(l2, x2);
+  aig.set_init(l1, Aig::aig_false);
+  aig.set_init(l2, Aig::aig_false);
+  aig.add_bad(aig.make_xor(l1, l2));
+
+  AigSweeper sweeper(aig);
+  sweeper.reduce();
+  EXPECT_GE(sweeper.num_merged_ands(), 1u);
+  EXPECT_EQ(sweeper.num_merged_latches(), 1u);
+  EXPECT_EQ(sweeper.result().bad().at(0), Aig::aig_false);
+  EXPECT_EQ(sweeper.result().latches().size(), 0u);
+}
+
+class AigUnitTests : public ::testing::Test,
+                     public ::testing::WithParamInterface<SolverEnum>
+{
+ protected:
+  void SetUp() override
+  {
+    s = create_solver(GetParam());
+    s->set_opt("produce-models", "true");
+    boolsort = s->make_sort(BOOL);
+    bvsort8 = s->make_sort(BV, 8);
+  }
+  SmtSolver s;
+  Sort boolsort, bvsort8;
+};
+
+TEST_P(AigUnitTests, ParseAiger)
+{
+  // a two bit counter with an enable input, bad when both bits are set
+  // b0' = b0 xor en, b1' = b1 xor (b0 /\ en)
+  string aag =
+      "aag 11 1 2 0 8 1\n"
+      "2\n"
+      "4 13\n"
+      "6 21\n"
+      "22\n"
+      "8 4 3\n"
+      "10 5 2\n"
+      "12 9 11\n"
+      "14 4 2\n"
+      "16 6 15\n"
+      "18 7 14\n"
+      "20 17 19\n"
+      "22 4 6\n"
+      "i0 en\n"
+      "l0 b0\n"
+      "l1 b1\n";
+  istringstream in(aag);
+  FunctionalTransitionSystem fts(s);
+  AigerEncoder enc(in, fts);
+  ASSERT_EQ(enc.propvec().size(), 1);
+  ASSERT_EQ(enc.inputsvec().size(), 1);
+  ASSERT_EQ(enc.statesvec().size(), 2);
+  EXPECT_EQ(fts.lookup("en"), enc.inputsvec()[0]);
+  EXPECT_EQ(fts.lookup("b1"), enc.statesvec()[1]);
+
+  Property p(s, enc.propvec()[0]);
+  AigBmc bmc(p, fts, s);
+  ASSERT_EQ(bmc.check_until(10), FALSE);
+  vector<UnorderedTermMap> witness;
+  ASSERT_TRUE(bmc.witness(witness));
+  ASSERT_EQ(witness.size(), 4);
+  // the counter is enabled in every transition
+  for (size_t i = 0; i + 1 < witness.size(); ++i) {
+    EXPECT_EQ(witness[i].at(enc.inputsvec()[0]), s->make_term(true));
+  }
+
+  istringstream bad_header("aag 1 0 1\n");
+  FunctionalTransitionSystem fts2(s);
+  EXPECT_THROW(AigerEncoder(bad_header, fts2), PonoException);
+}
+
+TEST_P(AigUnitTests, BmcCounter)
+{
+  FunctionalTransitionSystem fts(s);
+  Term max_val = fts.make_term(10, bvsort8);
+  counter_system(fts, max_val);
+  Term x = fts.named_terms().at("x");
+
+  // off-by-one in property -- unsafe
+  Term prop_term = s->make_term(BVUlt, x, max_val);
+  Property p(s, prop_term);
+
+  AigBmc bmc(p, fts, s);
+  ASSERT_EQ(bmc.check_until(9), pono::UNKNOWN);
+  ASSERT_EQ(bmc.check_until(12), FALSE);
+  vector<UnorderedTermMap> witness;
+  ASSERT_TRUE(bmc.witness(witness));
+  ASSERT_EQ(witness.size(), 11);
+  for (size_t i = 0; i < witness.size(); ++i) {
+    EXPECT_EQ(witness[i].at(x), fts.make_term(i, bvsort8));
+  }
+}
+
+TEST_P(AigUnitTests, BmcOpsMatchSolver)
+{
+  FunctionalTransitionSystem fts(s);
+  Term a = fts.make_inputvar("a", bvsort8);
+  Term b = fts.make_inputvar("b", bvsort8);
+  Term c = fts.make_inputvar("c", bvsort8);
+  for (auto po : { BVAdd, BVSub, BVMul, BVUdiv, BVUrem, BVSdiv, BVSrem,
+                   BVSmod, BVShl, BVLshr, BVAshr }) {
+    Term t = fts.make_term(po, a, b);
+    // any witness has c equal to t
+    Property p(s, fts.make_term(Distinct, t, c));
+    AigBmc bmc(p, fts, s);
+    ASSERT_EQ(bmc.check_until(0), FALSE);
+    vector<UnorderedTermMap> witness;
+    ASSERT_TRUE(bmc.witness(witness));
+
+    s->push();
+    for (const auto & v : { a, b, c }) {
+      s->assert_formula(fts.make_term(Equal, v, witness[0].at(v)));
+    }
+    s->assert_formula(fts.make_term(Equal, t, c));
+    EXPECT_TRUE(s->check_sat().is_sat()) << t;
+    s->pop();
+  }
+}
+
+TEST_P(AigUnitTests, IC3Counter)
+{
+  FunctionalTransitionSystem fts(s);
+  Term max_val = fts.make_term(10, bvsort8);
+  counter_system(fts, max_val);
+  Term x = fts.named_terms().at("x");
+
+  Term safe_prop = s->make_term(BVUle, x, max_val);
+  AigIC3 ic3(Property(s, safe_prop), fts, s);
+  ASSERT_EQ(ic3.prove(), TRUE);
+  ASSERT_TRUE(check_invar(fts, safe_prop, ic3.invar()));
+
+  Term unsafe_prop = s->make_term(BVUlt, x, max_val);
+  AigIC3 ic3_unsafe(Property(s, unsafe_prop), fts, s);
+  ASSERT_EQ(ic3_unsafe.check_until(12), FALSE);
+  vector<UnorderedTermMap> witness;
+  ASSERT_TRUE(ic3_unsafe.witness(witness));
+  ASSERT_EQ(witness.size(), 11);
+  EXPECT_EQ(witness.back().at(x), max_val);
+}
+
+TEST_P(AigUnitTests, ReducerWitness)
+{
+  FunctionalTransitionSystem fts(s);
+  Term max_val = fts.make_term(10, bvsort8);
+  counter_system(fts, max_val);
+  Term x = fts.named_terms().at("x");
+  // a copy of the counter, merged by latch correspondence
+  Term y = fts.make_statevar("y", bvsort8);
+  fts.constrain_init(fts.make_term(Equal, y, fts.make_term(0, bvsort8)));
+  fts.assign_next(y, fts.state_updates().at(x));
+  Term both = fts.make_term(
+      Concat, fts.make_term(BVAdd, x, fts.make_term(1, bvsort8)), y);
+  fts.name_term("both", both);
+
+  TransitionSystem ts = fts;
+  Term prop = s->make_term(BVUlt, y, max_val);
+  AigReducer reducer(ts, prop);
+  EXPECT_EQ(ts.statevars().size(), 8);
+
+  AigBmc bmc(Property(s, prop), ts, s);
+  ASSERT_EQ(bmc.check_until(12), FALSE);
+  vector<UnorderedTermMap> witness;
+  ASSERT_TRUE(bmc.witness(witness));
+  ASSERT_TRUE(reducer.complete_witness(witness));
+  ASSERT_EQ(witness.size(), 11);
+  for (size_t i = 0; i < witness.size(); ++i) {
+    EXPECT_EQ(witness[i].at(x), fts.make_term(i, bvsort8));
+    EXPECT_EQ(witness[i].at(y), fts.make_term(i, bvsort8));
+    EXPECT_EQ(witness[i].at(both),
+              fts.make_term((i + 1) * 256 + i, s->make_sort(BV, 16)));
+  }
+
+  TransitionSystem safe_ts = fts;
+  Term safe_prop = s->make_term(BVUle, y, max_val);
+  AigReducer safe_reducer(safe_ts, safe_prop);
+  AigIC3 ic3(Property(s, safe_prop), safe_ts, s);
+  ASSERT_EQ(ic3.prove(), TRUE);
+  ASSERT_TRUE(check_invar(safe_ts, safe_prop, ic3.invar()));
+}
+
+TEST_P(AigUnitTests, RelationalUnsupported)
+{
+  RelationalTransitionSystem rts(s);
+  Term x = rts.make_statevar("x", bvsort8);
+  rts.constrain_init(rts.make_term(Equal, x, rts.make_term(0, bvsort8)));
+  rts.constrain_trans(rts.make_term(Equal, rts.next(x), x));
+  AigBmc bmc(Property(s, rts.make_term(Equal, x, x)), rts, s);
+  EXPECT_THROW(bmc.check_until(1), PonoException);
+}
+
+INSTANTIATE_TEST_SUITE_P(ParameterizedSolverAigUnitTests,
+                         AigUnitTests,
+                         testing::ValuesIn(available_solver_enums()));
+
+}  // namespace pono_tests
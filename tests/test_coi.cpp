@@ -1,4 +1,5 @@
 #include "core/fts.h"
+#include "engines/bmc.h"
 #include "gtest/gtest.h"
 #include "modifiers/static_coi.h"
 #include "smt/available_solvers.h"
@@ -60,6 +61,48 @@ TEST_P(CoiUnitTests, SimpleCoiTest)
   EXPECT_TRUE(named_terms.find("c") == named_terms.end());
 }
 
+TEST_P(CoiUnitTests, CompleteWitness)
+{
+  FunctionalTransitionSystem fts(s);
+  Term zero = fts.make_term(0, bvsort8);
+  Term one = fts.make_term(1, bvsort8);
+
+  Term x = fts.make_statevar("x", bvsort8);
+  fts.constrain_init(fts.make_term(Equal, x, zero));
+  fts.assign_next(x, fts.make_term(BVAdd, x, one));
+
+  // outside of the cone-of-influence of the property
+  Term y = fts.make_statevar("y", bvsort8);
+  Term c = fts.make_inputvar("c", bvsort8);
+  fts.constrain_init(fts.make_term(Equal, y, fts.make_term(10, bvsort8)));
+  fts.assign_next(y, fts.make_term(BVAdd, y, fts.make_term(2, bvsort8)));
+  Term yc = fts.make_term(BVAdd, y, c);
+  fts.name_term("yc", yc);
+
+  Term prop_term = fts.make_term(BVUlt, x, fts.make_term(3, bvsort8));
+  StaticConeOfInfluence coi(fts, { prop_term });
+  EXPECT_TRUE(fts.inputvars().find(c) == fts.inputvars().end());
+  EXPECT_EQ(coi.orig_ts().inputvars().size(), 1);
+
+  Bmc bmc(Property(s, prop_term), fts, s);
+  ASSERT_EQ(bmc.check_until(5), FALSE);
+  vector<UnorderedTermMap> witness;
+  ASSERT_TRUE(bmc.witness(witness));
+  ASSERT_EQ(witness.size(), 4);
+
+  ASSERT_TRUE(coi.complete_witness(witness));
+  for (size_t k = 0; k < witness.size(); ++k) {
+    EXPECT_EQ(witness[k].at(x), fts.make_term(k, bvsort8));
+    EXPECT_EQ(witness[k].at(y), fts.make_term(10 + 2 * k, bvsort8));
+    ASSERT_TRUE(witness[k].find(c) != witness[k].end());
+    Term expected_yc = s->make_term(BVAdd, witness[k].at(y), witness[k].at(c));
+    s->push();
+    s->assert_formula(s->make_term(Distinct, witness[k].at(yc), expected_yc));
+    EXPECT_TRUE(s->check_sat().is_unsat());
+    s->pop();
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(ParameterizedCoiUnitTests,
                          CoiUnitTests,
                          testing::ValuesIn(available_solver_enums()));
@@ -8,6 +8,7 @@
 #include "engines/bmc_simplepath.h"
 #include "engines/interpolantmc.h"
 #include "engines/kinduction.h"
+#include "engines/multi_prop_bmc.h"
 #include "gtest/gtest.h"
 #include "smt/available_solvers.h"
 #include "tests/common_ts.h"
@@ -112,6 +113,66 @@ TEST_P(EngineUnitTests, KInductionFalse)
   ASSERT_EQ(r, ProverResult::FALSE);
 }
 
+TEST_P(EngineUnitTests, MultiPropBmc)
+{
+  SmtSolver s = create_solver(se);
+  Term x = ts->named_terms().at("x");
+  // fails at bound 6 -- before the false_p property
+  Term early_prop = ts->make_term(BVUle, x, ts->make_term(5, bvsort8));
+  PonoOptions opts;
+  opts.witness_ = true;
+  MultiPropBmc bmc(
+      { true_p->prop(), false_p->prop(), early_prop }, *ts, s, opts);
+  ProverResult r = bmc.check_until(20);
+  ASSERT_EQ(r, ProverResult::FALSE);
+  ASSERT_EQ(bmc.num_props(), 3);
+  ASSERT_EQ(bmc.prop_result(0), ProverResult::UNKNOWN);
+  ASSERT_EQ(bmc.prop_result(1), ProverResult::FALSE);
+  ASSERT_EQ(bmc.prop_result(2), ProverResult::FALSE);
+
+  // properties are retired in the order they fail
+  ASSERT_EQ(bmc.failed_props(), vector<size_t>({ 2, 1 }));
+  ASSERT_EQ(bmc.prop_witness_length(2), 6);
+  ASSERT_EQ(bmc.prop_witness_length(1), 7);
+
+  vector<UnorderedTermMap> cex;
+  ASSERT_TRUE(bmc.prop_witness(1, cex));
+  ASSERT_EQ(cex.size(), 8);
+  ASSERT_EQ(cex.back().at(x), ts->make_term(7, bvsort8));
+}
+
+TEST_P(EngineUnitTests, CancelAndResume)
+{
+  SmtSolver s = create_solver(se);
+  Bmc b(*false_p, *ts, s);
+  b.interrupt();
+  ASSERT_EQ(b.check_until(20), ProverResult::UNKNOWN);
+  ASSERT_EQ(b.cancel_token()->reason(), "cancellation requested");
+
+  b.cancel_token()->reset();
+  ASSERT_FALSE(b.interrupted());
+  ASSERT_EQ(b.check_until(20), ProverResult::FALSE);
+
+  // a process always uses more than a megabyte
+  SmtSolver s2 = create_solver(se);
+  KInduction kind(*true_p, *ts, s2);
+  kind.cancel_token()->set_memory_limit(1);
+  ASSERT_EQ(kind.check_until(20), ProverResult::UNKNOWN);
+  ASSERT_EQ(kind.cancel_token()->reason(), "memory limit reached");
+
+  // budgets are inherited from a parent token
+  SmtSolver s3 = create_solver(se);
+  Bmc b2(*false_p, *ts, s3);
+  shared_ptr<CancelToken> parent = make_shared<CancelToken>();
+  b2.set_cancel_token(make_shared<CancelToken>(parent));
+  bool called = false;
+  parent->on_cancel([&called]() { called = true; });
+  parent->cancel();
+  ASSERT_TRUE(called);
+  ASSERT_EQ(b2.check_until(20), ProverResult::UNKNOWN);
+  ASSERT_EQ(b2.cancel_token()->reason(), "parent cancelled");
+}
+
 INSTANTIATE_TEST_SUITE_P(
     ParameterizedEngineUnitTests,
     EngineUnitTests,
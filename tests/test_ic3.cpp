@@ -1,3 +1,5 @@
+#include <cstdio>
+#include <fstream>
 #include <utility>
 #include <vector>
 
@@ -76,6 +78,218 @@ TEST_P(IC3UnitTests, SimpleSystemUnsafe)
   ASSERT_EQ(r, FALSE);
 }
 
+TEST_P(IC3UnitTests, Checkpoint)
+{
+  RelationalTransitionSystem rts(s);
+  Term s1 = rts.make_statevar("s1", boolsort);
+  Term s2 = rts.make_statevar("s2", boolsort);
+  Term s3 = rts.make_statevar("s3", boolsort);
+  rts.constrain_init(s->make_term(Not, s1));
+  rts.constrain_init(s->make_term(Not, s2));
+  rts.constrain_init(s->make_term(Not, s3));
+  // shift register
+  rts.assign_next(s1, s1);
+  rts.assign_next(s2, s1);
+  rts.assign_next(s3, s2);
+  Property p(s, s->make_term(Not, s3));
+
+  string filename = ::testing::TempDir() + "ic3_checkpoint.ptl";
+  remove(filename.c_str());
+
+  PonoOptions opts;
+  opts.ic3_checkpoint_ = filename;
+  IC3 ic3(p, rts, s, opts);
+  ASSERT_EQ(ic3.prove(), TRUE);
+  ic3.save_checkpoint(filename);
+
+  // warm-start from the saved frames
+  // the prover copies the system to its own solver
+  SmtSolver warm_solver = create_solver_for(GetParam(), IC3_BOOL, false);
+  IC3 warm(p, rts, warm_solver, opts);
+  ASSERT_EQ(warm.prove(), TRUE);
+  ASSERT_TRUE(check_invar(rts, p.prop(), warm.invar()));
+
+  // a broken checkpoint is ignored
+  {
+    ofstream f(filename);
+    f << "garbage";
+  }
+  SmtSolver cold_solver = create_solver_for(GetParam(), IC3_BOOL, false);
+  IC3 cold(p, rts, cold_solver, opts);
+  ASSERT_EQ(cold.prove(), TRUE);
+
+  remove(filename.c_str());
+}
+
+TEST_P(IC3UnitTests, CtgGeneralization)
+{
+  // a token moves through a ring once it is injected by an input, at most
+  // one position holds it
+  FunctionalTransitionSystem fts(s);
+  Term in = fts.make_inputvar("in", boolsort);
+  TermVec ring;
+  for (size_t i = 0; i < 4; ++i) {
+    ring.push_back(fts.make_statevar("r" + std::to_string(i), boolsort));
+    fts.constrain_init(s->make_term(Not, ring.back()));
+  }
+  Term empty = s->make_term(Not, s->make_term(Or, ring));
+  fts.assign_next(ring[0],
+                  s->make_term(Or, ring[3], s->make_term(And, empty, in)));
+  for (size_t i = 1; i < ring.size(); ++i) {
+    fts.assign_next(ring[i], ring[i - 1]);
+  }
+  Property p(s, s->make_term(Not, s->make_term(And, ring[0], ring[2])));
+
+  PonoOptions opts;
+  opts.ic3_ctg_ = true;
+  opts.ic3_ctg_depth_ = 2;
+  IC3 ic3(p, fts, s, opts);
+  ASSERT_EQ(ic3.prove(), TRUE);
+  Term invar = ic3.invar();
+  ASSERT_TRUE(check_invar(fts, p.prop(), invar));
+
+  // also finds counterexamples
+  SmtSolver s2 = create_solver_for(GetParam(), IC3_BOOL, false);
+  TermTranslator tt(s2);
+  FunctionalTransitionSystem unsafe(fts, tt);
+  Term bad = tt.transfer_term(ring[3], BOOL);
+  Property p2(s2, s2->make_term(Not, bad));
+  IC3 ic3_unsafe(p2, unsafe, s2, opts);
+  ASSERT_EQ(ic3_unsafe.prove(), FALSE);
+}
+
+TEST_P(IC3UnitTests, FrameSolvers)
+{
+  RelationalTransitionSystem rts(s);
+  TermVec regs;
+  for (size_t i = 0; i < 4; ++i) {
+    regs.push_back(rts.make_statevar("s" + std::to_string(i), boolsort));
+    rts.constrain_init(s->make_term(Not, regs.back()));
+  }
+  // shift register
+  rts.assign_next(regs[0], regs[0]);
+  for (size_t i = 1; i < regs.size(); ++i) {
+    rts.assign_next(regs[i], regs[i - 1]);
+  }
+  Property p(s, s->make_term(Not, regs.back()));
+
+  PonoOptions opts;
+  opts.ic3_frame_solvers_ = true;
+  IC3 ic3(p, rts, s, opts);
+  ASSERT_EQ(ic3.prove(), TRUE);
+  ASSERT_TRUE(check_invar(rts, p.prop(), ic3.invar()));
+}
+
+TEST_P(IC3UnitTests, FrameSolverLemmas)
+{
+  Term x = s->make_symbol("x", boolsort);
+  Term xn = s->make_symbol("x.next", boolsort);
+  SmtSolver fs_solver = create_reducer_for(GetParam(), IC3IA_ENGINE, false);
+  FrameSolver fs(fs_solver, s->make_term(Equal, xn, x));
+  fs.add_lemma(x, 2);
+  Term not_x = fs.transfer(s->make_term(Not, x));
+
+  // only queries on frames up to 2 use the lemma
+  fs.set_frame(3);
+  ASSERT_TRUE(fs.intersects(not_x));
+  fs.set_frame(2);
+  ASSERT_FALSE(fs.intersects(not_x));
+  fs.set_frame(1);
+  ASSERT_FALSE(fs.intersects(not_x));
+}
+
+TEST_P(IC3UnitTests, ParallelPropagation)
+{
+  // a long shift register gives frames with enough lemmas for several
+  // workers
+  RelationalTransitionSystem rts(s);
+  TermVec regs;
+  for (size_t i = 0; i < 24; ++i) {
+    regs.push_back(rts.make_statevar("s" + std::to_string(i), boolsort));
+    rts.constrain_init(s->make_term(Not, regs.back()));
+  }
+  rts.assign_next(regs[0], regs[0]);
+  for (size_t i = 1; i < regs.size(); ++i) {
+    rts.assign_next(regs[i], regs[i - 1]);
+  }
+  Property p(s, s->make_term(Not, regs.back()));
+
+  PonoOptions opts;
+  opts.ic3_prop_threads_ = 4;
+  IC3 ic3(p, rts, s, opts);
+  ASSERT_EQ(ic3.prove(), TRUE);
+  ASSERT_TRUE(check_invar(rts, p.prop(), ic3.invar()));
+}
+
+TEST_P(IC3UnitTests, TernaryPredecessorGeneralization)
+{
+  // a shift register fed by an input, the property only fails if the input
+  // is ever set
+  FunctionalTransitionSystem fts(s);
+  Term in = fts.make_inputvar("in", boolsort);
+  Term en = fts.make_statevar("en", boolsort);
+  fts.constrain_init(s->make_term(Not, en));
+  fts.assign_next(en, en);
+  TermVec regs;
+  for (size_t i = 0; i < 6; ++i) {
+    regs.push_back(fts.make_statevar("s" + std::to_string(i), boolsort));
+    fts.constrain_init(s->make_term(Not, regs.back()));
+    fts.assign_next(regs.back(),
+                    i ? regs[i - 1] : s->make_term(And, en, in));
+  }
+  Property p(s, s->make_term(Not, regs.back()));
+
+  PonoOptions opts;
+  opts.ic3_ternary_pregen_ = true;
+  IC3 ic3(p, fts, s, opts);
+  ASSERT_EQ(ic3.prove(), TRUE);
+  ASSERT_TRUE(check_invar(fts, p.prop(), ic3.invar()));
+}
+
+TEST_P(IC3UnitTests, LemmaIndex)
+{
+  Term a = s->make_symbol("a", boolsort);
+  Term b = s->make_symbol("b", boolsort);
+  Term c = s->make_symbol("c", boolsort);
+  auto clause = [this](const TermVec & lits) {
+    Term t = lits[0];
+    for (size_t i = 1; i < lits.size(); ++i) {
+      t = s->make_term(Or, t, lits[i]);
+    }
+    return IC3Formula(t, lits, true);
+  };
+
+  IC3Formula ab = clause({ a, b });
+  IC3Formula abc = clause({ a, b, c });
+  IC3Formula nac = clause({ s->make_term(Not, a), c });
+
+  LemmaIndex index;
+  index.add(abc, 1);
+  index.add(nac, 2);
+  ASSERT_EQ(index.size(), 2);
+
+  // only lemmas in frames >= the given frame are considered
+  EXPECT_TRUE(index.subsumes(abc, 1));
+  EXPECT_FALSE(index.subsumes(abc, 2));
+  EXPECT_FALSE(index.subsumes(ab, 1));
+  EXPECT_TRUE(index.subsumes(nac, 2));
+
+  // a stronger lemma removes the lemmas it subsumes up to its frame
+  vector<pair<size_t, Term>> removed;
+  index.remove_subsumed(ab, 2, removed);
+  ASSERT_EQ(removed.size(), 1);
+  EXPECT_EQ(removed[0].first, 1);
+  EXPECT_EQ(removed[0].second, abc.term);
+  EXPECT_FALSE(index.subsumes(abc, 1));
+  index.add(ab, 2);
+  EXPECT_TRUE(index.subsumes(abc, 1));
+
+  index.remove(ab, 2);
+  index.remove(nac, 2);
+  EXPECT_EQ(index.size(), 0);
+  EXPECT_FALSE(index.subsumes(abc, 0));
+}
+
 INSTANTIATE_TEST_SUITE_P(
     ParameterizedSolverIC3UnitTests,
     IC3UnitTests,
@@ -3,10 +3,13 @@
 
 #include "core/fts.h"
 #include "core/rts.h"
+#include "engines/bmc.h"
 #include "gtest/gtest.h"
 #include "modifiers/history_modifier.h"
 #include "modifiers/implicit_predicate_abstractor.h"
+#include "modifiers/init_phase_unroller.h"
 #include "modifiers/prophecy_modifier.h"
+#include "modifiers/ts_simplifier.h"
 #include "smt-switch/utils.h"
 #include "smt/available_solvers.h"
 #include "tests/common_ts.h"
@@ -138,6 +141,112 @@ TEST_P(ModifierUnitTests, ImplicitPredicateAbstractor)
   EXPECT_TRUE(r.is_unsat());  // expecting it to be inductive now
 }
 
+TEST_P(ModifierUnitTests, TransitionSystemSimplifier)
+{
+  FunctionalTransitionSystem fts(s);
+  Term max_val = fts.make_term(10, bvsort);
+  counter_system(fts, max_val);
+  Term x = fts.named_terms().at("x");
+  Term zero = fts.make_term(0, bvsort);
+  Term one = fts.make_term(1, bvsort);
+  Term five = fts.make_term(5, bvsort);
+
+  // a copy of the counter
+  Term y = fts.make_statevar("y", bvsort);
+  fts.constrain_init(fts.make_term(Equal, y, zero));
+  fts.assign_next(y,
+                  fts.make_term(Ite,
+                                fts.make_term(BVUlt, y, max_val),
+                                fts.make_term(BVAdd, y, one),
+                                zero));
+  // a constant register
+  Term c = fts.make_statevar("c", bvsort);
+  fts.constrain_init(fts.make_term(Equal, c, five));
+  fts.assign_next(c, c);
+  // an input fixed by a constraint
+  Term i = fts.make_inputvar("i", bvsort);
+  fts.add_constraint(fts.make_term(Equal, i, fts.make_term(BVAdd, x, c)));
+  Term z = fts.make_statevar("z", bvsort);
+  fts.constrain_init(fts.make_term(Equal, z, zero));
+  Term hi = fts.make_term(Op(Extract, 15, 8), fts.make_term(Concat, i, z));
+  fts.assign_next(z, hi);
+
+  TermVec props({ fts.make_term(BVUlt, y, fts.make_term(3, bvsort)) });
+  TransitionSystemSimplifier simplifier(fts, props);
+  EXPECT_EQ(fts.statevars().size(), 2);
+  EXPECT_TRUE(fts.statevars().find(x) != fts.statevars().end());
+  EXPECT_TRUE(fts.statevars().find(z) != fts.statevars().end());
+  EXPECT_EQ(fts.inputvars().size(), 0);
+  EXPECT_EQ(fts.state_updates().at(z), fts.make_term(BVAdd, x, five));
+  EXPECT_EQ(props[0], fts.make_term(BVUlt, x, fts.make_term(3, bvsort)));
+
+  Bmc bmc(Property(s, props[0]), fts, s);
+  ASSERT_EQ(bmc.check_until(5), FALSE);
+  vector<UnorderedTermMap> witness;
+  ASSERT_TRUE(bmc.witness(witness));
+  ASSERT_TRUE(simplifier.complete_witness(witness));
+  ASSERT_EQ(witness.size(), 4);
+  for (size_t k = 0; k < witness.size(); ++k) {
+    EXPECT_EQ(witness[k].at(y), fts.make_term(k, bvsort));
+    EXPECT_EQ(witness[k].at(c), five);
+    EXPECT_EQ(witness[k].at(i), fts.make_term(k + 5, bvsort));
+  }
+}
+
+TEST_P(ModifierUnitTests, SimplifierKeepsRelationalSystems)
+{
+  RelationalTransitionSystem rts(s);
+  counter_system(rts, rts.make_term(10, bvsort));
+  TermVec props({ rts.make_term(true) });
+  EXPECT_THROW(TransitionSystemSimplifier simplifier(rts, props),
+               PonoException);
+}
+
+TEST_P(ModifierUnitTests, InitPhaseUnroller)
+{
+  FunctionalTransitionSystem fts(s);
+  counter_system(fts, fts.make_term(10, bvsort));
+  Term x = fts.named_terms().at("x");
+  Term zero = fts.make_term(0, bvsort);
+  Term seven = fts.make_term(7, bvsort);
+  // y samples the input at step 2
+  Term i = fts.make_inputvar("i", bvsort);
+  Term y = fts.make_statevar("y", bvsort);
+  fts.constrain_init(fts.make_term(Equal, y, zero));
+  fts.assign_next(
+      y,
+      fts.make_term(
+          Ite, fts.make_term(Equal, x, fts.make_term(2, bvsort)), i, y));
+
+  // fails during the phase
+  TransitionSystem ts = fts;
+  Term early_prop = fts.make_term(BVUlt, x, fts.make_term(3, bvsort));
+  EXPECT_THROW(InitPhaseUnroller unroller(ts, { early_prop }, 4),
+               PonoException);
+  EXPECT_EQ(ts.statevars().size(), 2);
+
+  Term prop = fts.make_term(Or,
+                            fts.make_term(BVUlt, x, fts.make_term(6, bvsort)),
+                            fts.make_term(Distinct, y, seven));
+  InitPhaseUnroller unroller(ts, { prop }, 4);
+  // x is constant after the phase, y is the input at step 2
+  EXPECT_EQ(unroller.frozen_vars().size(), 1);
+  EXPECT_EQ(ts.statevars().size(), 3);
+
+  Bmc bmc(Property(s, prop), ts, s);
+  ASSERT_EQ(bmc.check_until(5), FALSE);
+  vector<UnorderedTermMap> witness;
+  ASSERT_TRUE(bmc.witness(witness));
+  EXPECT_EQ(witness.size(), 3);
+  ASSERT_TRUE(unroller.complete_witness(witness));
+  ASSERT_EQ(witness.size(), 7);
+  for (size_t k = 0; k < witness.size(); ++k) {
+    EXPECT_EQ(witness[k].at(x), fts.make_term(k, bvsort));
+  }
+  EXPECT_EQ(witness[2].at(i), seven);
+  EXPECT_EQ(witness[6].at(y), seven);
+}
+
 INSTANTIATE_TEST_SUITE_P(ParameterizedModifierUnitTests,
                          ModifierUnitTests,
                          testing::ValuesIn(available_solver_enums()));
@@ -0,0 +1,99 @@
+#include <mutex>
+#include <vector>
+
+#include "core/fts.h"
+#include "core/rts.h"
+#include "engines/multi_prop_scheduler.h"
+#include "gtest/gtest.h"
+#include "smt/available_solvers.h"
+#include "tests/common_ts.h"
+
+using namespace pono;
+using namespace smt;
+using namespace std;
+
+namespace pono_tests {
+
+class MultiPropSchedulerUnitTests
+    : public ::testing::Test,
+      public ::testing::WithParamInterface<SolverEnum>
+{
+ protected:
+  void SetUp() override
+  {
+    s = create_solver(GetParam());
+    bvsort8 = s->make_sort(BV, 8);
+  }
+  SmtSolver s;
+  Sort bvsort8;
+};
+
+TEST_P(MultiPropSchedulerUnitTests, IndependentCounters)
+{
+  FunctionalTransitionSystem fts(s);
+  counter_system(fts, fts.make_term(7, bvsort8));
+  Term x = fts.named_terms().at("x");
+  // second counter that does not depend on x
+  Term y = fts.make_statevar("y", bvsort8);
+  fts.constrain_init(fts.make_term(Equal, y, fts.make_term(0, bvsort8)));
+  fts.assign_next(y, fts.make_term(BVAdd, y, fts.make_term(1, bvsort8)));
+
+  TermVec props = { fts.make_term(BVUle, x, fts.make_term(7, bvsort8)),
+                    fts.make_term(BVUle, y, fts.make_term(3, bvsort8)),
+                    fts.make_term(BVUle, x, fts.make_term(6, bvsort8)) };
+
+  PonoOptions opts;
+  opts.engine_ = MBIC3;
+  opts.bound_ = 20;
+  MultiPropScheduler scheduler(fts, props, opts);
+
+  // x and y have disjoint cones of influence
+  const auto & clusters = scheduler.clusters();
+  ASSERT_EQ(clusters.size(), 2);
+  ASSERT_EQ(clusters[0], vector<size_t>({ 0, 2 }));
+  ASSERT_EQ(clusters[1], vector<size_t>({ 1 }));
+  ASSERT_EQ(scheduler.cluster_ts(0).statevars().size(), 1);
+  ASSERT_EQ(scheduler.cluster_ts(1).statevars().size(), 1);
+
+  vector<size_t> reported;
+  mutex m;
+  scheduler.set_result_callback(
+      [&](size_t idx, ProverResult r, const vector<UnorderedTermMap> & cex) {
+        lock_guard<mutex> lock(m);
+        reported.push_back(idx);
+      });
+
+  vector<ProverResult> results = scheduler.run(2);
+  ASSERT_EQ(results.size(), 3);
+  ASSERT_EQ(results[0], ProverResult::TRUE);
+  ASSERT_EQ(results[1], ProverResult::FALSE);
+  ASSERT_EQ(results[2], ProverResult::FALSE);
+  ASSERT_EQ(reported.size(), 3);
+}
+
+TEST_P(MultiPropSchedulerUnitTests, RelationalSingleCluster)
+{
+  RelationalTransitionSystem rts(s);
+  counter_system(rts, rts.make_term(7, bvsort8));
+  Term x = rts.named_terms().at("x");
+  TermVec props = { rts.make_term(BVUle, x, rts.make_term(7, bvsort8)),
+                    rts.make_term(BVUle, x, rts.make_term(6, bvsort8)) };
+
+  PonoOptions opts;
+  opts.engine_ = KIND;
+  opts.bound_ = 20;
+  MultiPropScheduler scheduler(rts, props, opts);
+  ASSERT_EQ(scheduler.clusters().size(), 1);
+
+  vector<ProverResult> results = scheduler.run();
+  ASSERT_EQ(results[0], ProverResult::TRUE);
+  ASSERT_EQ(results[1], ProverResult::FALSE);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    ParameterizedSolverMultiPropSchedulerUnitTests,
+    MultiPropSchedulerUnitTests,
+    // CVC4 does not support multiple solver instances
+    testing::ValuesIn(available_solver_enums_except({ smt::CVC4 })));
+
+}  // namespace pono_tests
@@ -0,0 +1,161 @@
+#include <utility>
+#include <vector>
+
+#include "core/fts.h"
+#include "core/rts.h"
+#include "engines/lemma_exchange.h"
+#include "engines/portfolio.h"
+#include "gtest/gtest.h"
+#include "smt/available_solvers.h"
+#include "tests/common_ts.h"
+#include "utils/exceptions.h"
+#include "utils/ts_analysis.h"
+
+using namespace pono;
+using namespace smt;
+using namespace std;
+
+namespace pono_tests {
+
+class PortfolioUnitTests : public ::testing::Test,
+                           public ::testing::WithParamInterface<SolverEnum>
+{
+ protected:
+  void SetUp() override
+  {
+    s = create_solver_for(GetParam(), PORTFOLIO, false);
+    bvsort8 = s->make_sort(BV, 8);
+    opts.portfolio_engines_ = { BMC, KIND, MBIC3 };
+  }
+  SmtSolver s;
+  Sort bvsort8;
+  PonoOptions opts;
+};
+
+TEST_P(PortfolioUnitTests, CounterTrue)
+{
+  FunctionalTransitionSystem fts(s);
+  counter_system(fts, fts.make_term(7, bvsort8));
+  Term x = fts.named_terms().at("x");
+  Property p(s, fts.make_term(BVUle, x, fts.make_term(7, bvsort8)));
+
+  Portfolio portfolio(p, fts, s, opts);
+  ProverResult r = portfolio.check_until(20);
+  ASSERT_EQ(r, TRUE);
+  ASSERT_TRUE(portfolio.winner() == KIND || portfolio.winner() == MBIC3);
+  ASSERT_EQ(portfolio.results().size(), 3);
+  // bmc can't prove the property and should have been interrupted
+  // or run out of bound
+  ASSERT_EQ(portfolio.results().at(0).engine, BMC);
+  ASSERT_EQ(portfolio.results().at(0).result, ProverResult::UNKNOWN);
+
+  if (portfolio.winner() == MBIC3) {
+    Term invar = portfolio.invar();
+    ASSERT_TRUE(check_invar(fts, p.prop(), invar));
+  }
+}
+
+TEST_P(PortfolioUnitTests, CounterFalse)
+{
+  RelationalTransitionSystem rts(s);
+  counter_system(rts, rts.make_term(7, bvsort8));
+  Term x = rts.named_terms().at("x");
+  Property p(s, rts.make_term(BVUle, x, rts.make_term(6, bvsort8)));
+
+  opts.portfolio_engines_ = { BMC, KIND };
+  Portfolio portfolio(p, rts, s, opts);
+  ProverResult r = portfolio.check_until(20);
+  ASSERT_EQ(r, FALSE);
+  ASSERT_NE(portfolio.winner(), NONE);
+
+  vector<UnorderedTermMap> cex;
+  ASSERT_TRUE(portfolio.witness(cex));
+  ASSERT_GT(cex.size(), 0);
+}
+
+TEST_P(PortfolioUnitTests, Interrupted)
+{
+  FunctionalTransitionSystem fts(s);
+  counter_system(fts, fts.make_term(7, bvsort8));
+  Term x = fts.named_terms().at("x");
+  Property p(s, fts.make_term(BVUle, x, fts.make_term(7, bvsort8)));
+
+  opts.portfolio_engines_ = { BMC };
+  Portfolio portfolio(p, fts, s, opts);
+  portfolio.interrupt();
+  ProverResult r = portfolio.check_until(20);
+  ASSERT_EQ(r, ProverResult::UNKNOWN);
+  ASSERT_EQ(portfolio.winner(), NONE);
+}
+
+TEST_P(PortfolioUnitTests, SharedLemmas)
+{
+  FunctionalTransitionSystem fts(s);
+  counter_system(fts, fts.make_term(7, bvsort8));
+  Term x = fts.named_terms().at("x");
+  Property p(s, fts.make_term(BVUle, x, fts.make_term(7, bvsort8)));
+
+  vector<PonoOptions> configs(2, opts);
+  configs[0].engine_ = MBIC3;
+  configs[1].engine_ = MBIC3;
+  configs[1].ic3_indgen_ = false;
+  opts.portfolio_share_lemmas_ = true;
+
+  Portfolio portfolio(p, fts, s, configs, opts);
+  ProverResult r = portfolio.check_until(20);
+  ASSERT_EQ(r, TRUE);
+  ASSERT_EQ(portfolio.winner(), MBIC3);
+  Term invar = portfolio.invar();
+  ASSERT_TRUE(check_invar(fts, p.prop(), invar));
+}
+
+TEST_P(PortfolioUnitTests, LemmaExchange)
+{
+  FunctionalTransitionSystem fts0(s);
+  Term x0 = fts0.make_statevar("x", bvsort8);
+  Term y0 = fts0.make_statevar("y", bvsort8);
+
+  SmtSolver s1 = create_solver(GetParam());
+  FunctionalTransitionSystem fts1(s1);
+  Sort bvsort8_1 = s1->make_sort(BV, 8);
+  Term x1 = fts1.make_statevar("x", bvsort8_1);
+  Term y1 = fts1.make_statevar("y", bvsort8_1);
+
+  LemmaExchange lx(GetParam());
+  size_t id0 = lx.add_participant(fts0);
+  size_t id1 = lx.add_participant(fts1);
+  ASSERT_NE(id0, id1);
+
+  lx.publish(id0,
+             { s->make_term(Equal, x0, y0),
+               s->make_term(BVUlt, x0, s->make_term(3, bvsort8)) });
+  ASSERT_EQ(lx.num_lemmas(), 1);
+
+  // a participant doesn't get its own lemmas back
+  ASSERT_EQ(lx.collect(id0).size(), 0);
+
+  vector<TermVec> lemmas = lx.collect(id1);
+  ASSERT_EQ(lemmas.size(), 1);
+  ASSERT_EQ(lemmas[0].size(), 2);
+  for (const auto & l : lemmas[0]) {
+    ASSERT_TRUE(fts1.only_curr(l));
+  }
+
+  // already collected
+  ASSERT_EQ(lx.collect(id1).size(), 0);
+
+  // participants need matching state variables
+  SmtSolver s2 = create_solver(GetParam());
+  FunctionalTransitionSystem fts2(s2);
+  fts2.make_statevar("z", s2->make_sort(BV, 8));
+  fts2.make_statevar("y", s2->make_sort(BV, 8));
+  ASSERT_THROW(lx.add_participant(fts2), PonoException);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    ParameterizedSolverPortfolioUnitTests,
+    PortfolioUnitTests,
+    // CVC4 does not support multiple solver instances
+    testing::ValuesIn(available_solver_enums_except({ smt::CVC4 })));
+
+}  // namespace pono_tests
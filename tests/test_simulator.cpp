@@ -0,0 +1,382 @@
+#include <random>
+#include <vector>
+
+#include "core/fts.h"
+#include "core/rts.h"
+#include "core/simulator.h"
+#include "core/ternary_simulator.h"
+#include "core/witness_trace.h"
+#include "engines/bmc.h"
+#include "engines/kinduction.h"
+#include "engines/random_sim.h"
+#include "gtest/gtest.h"
+#include "smt/available_solvers.h"
+#include "tests/common_ts.h"
+#include "utils/exceptions.h"
+#include "utils/invariant_miner.h"
+
+using namespace pono;
+using namespace smt;
+using namespace std;
+
+namespace pono_tests {
+
+class SimulatorUnitTests : public ::testing::Test,
+                           public ::testing::WithParamInterface<SolverEnum>
+{
+ protected:
+  void SetUp() override
+  {
+    s = create_solver(GetParam());
+    s->set_opt("produce-models", "true");
+    boolsort = s->make_sort(BOOL);
+    bvsort8 = s->make_sort(BV, 8);
+    bvsort100 = s->make_sort(BV, 100);
+  }
+  SmtSolver s;
+  Sort boolsort, bvsort8, bvsort100;
+};
+
+TEST_P(SimulatorUnitTests, Counter)
+{
+  FunctionalTransitionSystem fts(s);
+  counter_system(fts, fts.make_term(5, bvsort8));
+  Term x = fts.named_terms().at("x");
+
+  Simulator sim(fts);
+  ASSERT_TRUE(sim.reset());
+  for (size_t i = 0; i < 20; ++i) {
+    EXPECT_EQ(sim.get(x), i % 6);
+    ASSERT_TRUE(sim.step());
+  }
+}
+
+TEST_P(SimulatorUnitTests, OpsMatchSolver)
+{
+  FunctionalTransitionSystem fts(s);
+  TermVec terms;
+  for (const auto & sort : { bvsort8, bvsort100 }) {
+    Term a = fts.make_inputvar("a" + std::to_string(sort->get_width()), sort);
+    Term b = fts.make_inputvar("b" + std::to_string(sort->get_width()), sort);
+    for (auto po : { BVAnd,  BVOr,   BVXor,  BVNand, BVNor,  BVXnor, BVAdd,
+                     BVSub,  BVMul,  BVUdiv, BVUrem, BVSdiv, BVSrem, BVSmod,
+                     BVShl,  BVLshr, BVAshr, BVComp, Concat, BVUlt,  BVUle,
+                     BVUgt,  BVUge,  BVSlt,  BVSle,  BVSgt,  BVSge,  Equal,
+                     Distinct }) {
+      terms.push_back(fts.make_term(po, a, b));
+    }
+    terms.push_back(fts.make_term(BVNot, a));
+    terms.push_back(fts.make_term(BVNeg, a));
+    terms.push_back(fts.make_term(Op(Extract, 6, 2), a));
+    terms.push_back(fts.make_term(Op(Zero_Extend, 3), a));
+    terms.push_back(fts.make_term(Op(Sign_Extend, 3), a));
+    terms.push_back(fts.make_term(Op(Rotate_Left, 3), a));
+    terms.push_back(fts.make_term(Op(Rotate_Right, 3), a));
+    terms.push_back(fts.make_term(Op(Repeat, 2), a));
+    terms.push_back(fts.make_term(
+        Ite, fts.make_term(BVUlt, a, b), a, fts.make_term(BVAdd, a, b)));
+  }
+
+  Simulator sim(fts);
+  for (const auto & t : terms) {
+    sim.add_signal(t);
+  }
+
+  sim.seed(1);
+  for (size_t i = 0; i < 10; ++i) {
+    sim.randomize_inputs();
+    if (i == 0) {
+      // exercise division by zero
+      for (const auto & v : fts.inputvars()) {
+        if (v->to_string()[0] == 'b') {
+          sim.set(v, 0);
+        }
+      }
+    }
+    sim.eval();
+
+    s->push();
+    for (const auto & v : fts.inputvars()) {
+      s->assert_formula(fts.make_term(Equal, v, sim.get_value(v)));
+    }
+    ASSERT_TRUE(s->check_sat().is_sat());
+    for (const auto & t : terms) {
+      EXPECT_EQ(sim.get_bits(t), WitnessTrace::value_bits(s->get_value(t)))
+          << t;
+    }
+    s->pop();
+  }
+}
+
+TEST_P(SimulatorUnitTests, Memory)
+{
+  FunctionalTransitionSystem fts(s);
+  Sort bvsort4 = fts.make_sort(BV, 4);
+  Sort arrsort = fts.make_sort(ARRAY, bvsort4, bvsort8);
+  Term addr = fts.make_inputvar("addr", bvsort4);
+  Term data = fts.make_inputvar("data", bvsort8);
+  Term we = fts.make_inputvar("we", boolsort);
+  Term mem = fts.make_statevar("mem", arrsort);
+  Term rd = fts.make_statevar("rd", bvsort8);
+
+  fts.constrain_init(fts.make_term(
+      Equal, mem, fts.make_term(fts.make_term(7, bvsort8), arrsort)));
+  fts.assign_next(
+      mem,
+      fts.make_term(Ite, we, fts.make_term(Store, mem, addr, data), mem));
+  fts.assign_next(rd, fts.make_term(Select, mem, addr));
+
+  Simulator sim(fts);
+  ASSERT_TRUE(sim.reset());
+  sim.set(addr, 3);
+  sim.set(data, 42);
+  sim.set(we, 1);
+  sim.step();
+  sim.set(we, 0);
+  sim.step();
+  EXPECT_EQ(sim.get(rd), 42);
+  sim.set(addr, 4);
+  sim.step();
+  EXPECT_EQ(sim.get(rd), 7);
+}
+
+TEST_P(SimulatorUnitTests, InitAndConstraints)
+{
+  FunctionalTransitionSystem fts(s);
+  Term x = fts.make_statevar("x", bvsort8);
+  Term y = fts.make_statevar("y", bvsort8);
+  Term z = fts.make_statevar("z", bvsort8);
+  Term in = fts.make_inputvar("in", bvsort8);
+  // y is initialized from x, which is initialized later
+  Term one = fts.make_term(1, bvsort8);
+  fts.constrain_init(fts.make_term(Equal, y, fts.make_term(BVAdd, x, one)));
+  fts.constrain_init(fts.make_term(Equal, fts.make_term(3, bvsort8), x));
+  fts.constrain_init(fts.make_term(BVUlt, z, fts.make_term(4, bvsort8)));
+  fts.assign_next(x, in);
+  fts.add_constraint(fts.make_term(BVUlt, in, fts.make_term(10, bvsort8)));
+
+  Simulator sim(fts);
+  ASSERT_TRUE(sim.reset());
+  EXPECT_EQ(sim.get(x), 3);
+  EXPECT_EQ(sim.get(y), 4);
+  EXPECT_EQ(sim.get(z), 0);
+
+  sim.set(in, 5);
+  EXPECT_TRUE(sim.step());
+  EXPECT_EQ(sim.get(x), 5);
+  sim.set(in, 12);
+  EXPECT_FALSE(sim.step());
+
+  RelationalTransitionSystem rts(s);
+  EXPECT_THROW(Simulator rsim(rts), PonoException);
+}
+
+TEST_P(SimulatorUnitTests, ReplayWitness)
+{
+  FunctionalTransitionSystem fts(s);
+  Term x = fts.make_statevar("x", bvsort8);
+  Term in = fts.make_inputvar("in", bvsort8);
+  fts.constrain_init(fts.make_term(Equal, x, fts.make_term(0, bvsort8)));
+  fts.assign_next(x, fts.make_term(BVAdd, x, in));
+  Term prop_term = fts.make_term(BVUlt, x, fts.make_term(200, bvsort8));
+  Property prop(fts.solver(), prop_term);
+
+  Bmc bmc(prop, fts, s);
+  ASSERT_EQ(bmc.check_until(5), FALSE);
+  vector<UnorderedTermMap> witness;
+  ASSERT_TRUE(bmc.witness(witness));
+
+  // only replay the inputs, the states must follow
+  Simulator sim(fts);
+  sim.add_signal(prop_term);
+  ASSERT_TRUE(sim.reset());
+  for (size_t i = 0; i < witness.size(); ++i) {
+    EXPECT_EQ(sim.get_bits(x), WitnessTrace::value_bits(witness[i].at(x)));
+    sim.set_value(in, witness[i].at(in));
+    sim.eval();
+    EXPECT_EQ(sim.get(prop_term), i + 1 < witness.size());
+    sim.advance();
+  }
+}
+
+TEST_P(SimulatorUnitTests, RandomSimulation)
+{
+  FunctionalTransitionSystem fts(s);
+  counter_system(fts, fts.make_term(20, bvsort8));
+  Term x = fts.named_terms().at("x");
+  Term en = fts.make_inputvar("en", boolsort);
+  Term y = fts.make_statevar("y", bvsort8);
+  fts.constrain_init(fts.make_term(Equal, y, fts.make_term(0, bvsort8)));
+  fts.assign_next(y, fts.make_term(Ite, en, fts.make_term(BVAdd, y, x), y));
+
+  PonoOptions opts;
+  opts.sim_seeds_ = 4;
+  Term thirty = fts.make_term(30, bvsort8);
+  Property prop(fts.solver(), fts.make_term(BVUlt, y, thirty));
+  RandomSimulation rsim(prop, fts, s, opts);
+  ASSERT_EQ(rsim.check_until(100), FALSE);
+  vector<UnorderedTermMap> witness;
+  ASSERT_TRUE(rsim.witness(witness));
+
+  // the witness is a trace of the system that ends in a bad state
+  Simulator sim(fts);
+  ASSERT_TRUE(sim.reset());
+  for (size_t i = 0; i < witness.size(); ++i) {
+    EXPECT_EQ(sim.get_bits(y), WitnessTrace::value_bits(witness[i].at(y)));
+    sim.set_value(en, witness[i].at(en));
+    sim.step();
+  }
+  EXPECT_GE(WitnessTrace::value_bits(witness.back().at(y)), "00011110");
+
+  // x never exceeds 20
+  Term twenty = fts.make_term(20, bvsort8);
+  Property safe(fts.solver(), fts.make_term(BVUle, x, twenty));
+  RandomSimulation rsim_safe(safe, fts, s, opts);
+  EXPECT_EQ(rsim_safe.check_until(100), pono::UNKNOWN);
+}
+
+TEST_P(SimulatorUnitTests, MineInvariants)
+{
+  FunctionalTransitionSystem fts(s);
+  // redundant registers
+  Term a = fts.make_statevar("a", boolsort);
+  Term b = fts.make_statevar("b", boolsort);
+  Term nb = fts.make_statevar("nb", boolsort);
+  Term x = fts.make_statevar("x", bvsort8);
+  Term y = fts.make_statevar("y", bvsort8);
+  Term zero = fts.make_term(0, bvsort8);
+  Term one = fts.make_term(1, bvsort8);
+  fts.constrain_init(fts.make_term(Not, a));
+  fts.constrain_init(fts.make_term(Not, b));
+  fts.constrain_init(nb);
+  fts.constrain_init(fts.make_term(Equal, x, zero));
+  fts.constrain_init(fts.make_term(Equal, y, zero));
+  fts.assign_next(a, fts.make_term(Not, a));
+  fts.assign_next(b, fts.make_term(Not, b));
+  fts.assign_next(nb, fts.make_term(Not, nb));
+  fts.assign_next(x, fts.make_term(BVAdd, x, one));
+  fts.assign_next(y, fts.make_term(BVAdd, y, one));
+
+  PonoOptions opts;
+  opts.sim_seeds_ = 2;
+  opts.sim_cycles_ = 20;
+  InvariantMiner miner(fts, s, opts);
+  vector<TermVec> candidates = miner.propose();
+  // a == b and a != nb as two clauses each, x == y
+  EXPECT_EQ(candidates.size(), 5);
+  // holds initially but is not inductive
+  candidates.push_back({ fts.make_term(Not, a) });
+  EXPECT_EQ(miner.filter(candidates).size(), 5);
+
+  // not 1-inductive without a == b
+  Term bad = fts.make_term(And, a, fts.make_term(Not, b));
+  Property prop(fts.solver(), fts.make_term(Not, bad));
+  SmtSolver s1 = create_solver(GetParam());
+  s1->set_opt("produce-models", "true");
+  KInduction kind(prop, fts, s1, opts);
+  EXPECT_EQ(kind.check_until(0), pono::UNKNOWN);
+
+  opts.mine_invariants_ = true;
+  SmtSolver s2 = create_solver(GetParam());
+  s2->set_opt("produce-models", "true");
+  KInduction kind_mined(prop, fts, s2, opts);
+  EXPECT_EQ(kind_mined.check_until(0), pono::TRUE);
+}
+
+TEST_P(SimulatorUnitTests, TernaryGeneralize)
+{
+  FunctionalTransitionSystem fts(s);
+  Term a = fts.make_statevar("a", boolsort);
+  Term b = fts.make_statevar("b", boolsort);
+  Term c = fts.make_statevar("c", boolsort);
+  Term d = fts.make_statevar("d", boolsort);
+  Term in = fts.make_inputvar("in", boolsort);
+  fts.assign_next(a, fts.make_term(And, b, c));
+  fts.assign_next(b, fts.make_term(Not, d));
+  fts.assign_next(c, fts.make_term(Or, in, a));
+  fts.assign_next(d, d);
+
+  Term true_ = s->make_term(true);
+  Term false_ = s->make_term(false);
+  TermVec cube = { a, b, c, fts.make_term(Not, d) };
+  TernarySimulator sim(fts);
+
+  // a' only depends on b and c
+  TermVec gen = sim.generalize(cube, { { in, false_ } }, a);
+  EXPECT_EQ(gen, TermVec({ b, c }));
+
+  // with the input set, c' holds for any predecessor
+  gen = sim.generalize(cube, { { in, true_ } }, fts.make_term(And, b, c));
+  EXPECT_EQ(gen, TermVec({ fts.make_term(Not, d) }));
+
+  // the input is X when it is not given, so a is needed
+  gen = sim.generalize(cube, {}, c);
+  EXPECT_EQ(gen, TermVec({ a }));
+
+  // the whole cube is kept if the successor does not satisfy the target
+  gen = sim.generalize(cube, { { in, true_ } }, d);
+  EXPECT_EQ(gen, cube);
+
+  // systems with constraints are not deterministic
+  fts.add_constraint(fts.make_term(Or, a, b));
+  EXPECT_THROW(TernarySimulator bad(fts), PonoException);
+}
+
+TEST_P(SimulatorUnitTests, TernaryKnownBits)
+{
+  FunctionalTransitionSystem fts(s);
+  Term x = fts.make_statevar("x", bvsort8);
+  Term y = fts.make_statevar("y", bvsort8);
+  Term z = fts.make_statevar("z", bvsort8);
+  Term w = fts.make_statevar("w", bvsort100);
+  Term sum = fts.make_statevar("sum", bvsort8);
+  Term shl = fts.make_statevar("shl", bvsort8);
+  Term conj = fts.make_statevar("conj", bvsort8);
+  Term lt = fts.make_statevar("lt", boolsort);
+  fts.assign_next(x, x);
+  fts.assign_next(y, y);
+  fts.assign_next(z, z);
+  fts.assign_next(w, w);
+  fts.assign_next(sum, fts.make_term(BVAdd, x, y));
+  fts.assign_next(shl, fts.make_term(BVShl, x, fts.make_term(4, bvsort8)));
+  fts.assign_next(conj, fts.make_term(BVAnd, x, z));
+  // the high bits of z are known zeros after the extension
+  fts.assign_next(lt,
+                  fts.make_term(BVUlt,
+                                fts.make_term(Op(Zero_Extend, 4),
+                                              fts.make_term(Op(Extract, 3, 0),
+                                                            z)),
+                                fts.make_term(16, bvsort8)));
+
+  auto eq = [&fts](const Term & v, int64_t val) {
+    return fts.make_term(Equal, v, fts.make_term(val, v->get_sort()));
+  };
+  TermVec cube = { eq(x, 2), eq(y, 3), eq(z, 0), eq(w, 1) };
+  TernarySimulator sim(fts);
+
+  // literals over values wider than 64 bits are always kept
+  TermVec gen = sim.generalize(cube, {}, eq(sum, 5));
+  EXPECT_EQ(gen, TermVec({ eq(x, 2), eq(y, 3), eq(w, 1) }));
+
+  // the low bits of a left shift are known zeros
+  gen = sim.generalize(
+      cube, {}, eq(fts.make_term(Op(Extract, 3, 0), shl), 0));
+  EXPECT_EQ(gen, TermVec({ eq(w, 1) }));
+
+  // a known zero operand is enough for a conjunction
+  gen = sim.generalize(cube, {}, eq(conj, 0));
+  EXPECT_EQ(gen, TermVec({ eq(z, 0), eq(w, 1) }));
+
+  gen = sim.generalize(cube, {}, lt);
+  EXPECT_EQ(gen, TermVec({ eq(w, 1) }));
+
+  // and their values are X
+  gen = sim.generalize(cube, {}, eq(w, 1));
+  EXPECT_EQ(gen, cube);
+}
+
+INSTANTIATE_TEST_SUITE_P(ParameterizedSimulatorUnitTests,
+                         SimulatorUnitTests,
+                         testing::ValuesIn(available_solver_enums()));
+
+}  // namespace pono_tests
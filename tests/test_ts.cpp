@@ -1,9 +1,13 @@
+#include <algorithm>
+#include <cstdio>
+#include <functional>
 #include <utility>
 #include <vector>
 
 #include "core/fts.h"
 #include "core/prop.h"
 #include "core/rts.h"
+#include "core/ts_snapshot.h"
 #include "core/unroller.h"
 #include "gtest/gtest.h"
 #include "smt/available_solvers.h"
@@ -128,6 +132,102 @@ TEST_P(TSUnitTests, Prop_Copy)
   Property p2 = p;
 }
 
+TEST_P(TSUnitTests, BalancedConjunctions)
+{
+  FunctionalTransitionSystem fts(s);
+  EXPECT_EQ(fts.trans(), s->make_term(true));
+  EXPECT_EQ(fts.trans_conjuncts().size(), 0);
+
+  const size_t num_vars = 1000;
+  Term one = s->make_term(1, bvsort);
+  for (size_t i = 0; i < num_vars; ++i) {
+    Term x = fts.make_statevar("x" + std::to_string(i), bvsort);
+    fts.constrain_init(fts.make_term(Equal, x, s->make_term(0, bvsort)));
+    fts.assign_next(x, fts.make_term(BVAdd, x, one));
+  }
+  EXPECT_EQ(fts.init_conjuncts().size(), num_vars);
+  EXPECT_EQ(fts.trans_conjuncts().size(), num_vars);
+
+  // the And tree should be balanced, not a chain of length num_vars
+  std::function<size_t(const Term &)> and_depth = [&](const Term & t) {
+    if (t->get_op() != And) {
+      return (size_t)0;
+    }
+    size_t d = 0;
+    for (const auto & c : t) {
+      d = std::max(d, and_depth(c));
+    }
+    return d + 1;
+  };
+  // ceil(log2(1000)) == 10
+  EXPECT_LE(and_depth(fts.trans()), 10);
+  EXPECT_LE(and_depth(fts.init()), 10);
+
+  // cached until a new conjunct is added
+  Term trans = fts.trans();
+  EXPECT_EQ(trans, fts.trans());
+  fts.add_constraint(fts.make_term(BVUlt,
+                                   fts.named_terms().at("x0"),
+                                   s->make_term(10, bvsort)));
+  EXPECT_NE(trans, fts.trans());
+  // the constraint and its next-state version
+  EXPECT_EQ(fts.trans_conjuncts().size(), num_vars + 2);
+  EXPECT_EQ(fts.init_conjuncts().size(), num_vars + 1);
+
+  // copies share the conjuncts
+  TransitionSystem ts_copy = fts;
+  EXPECT_EQ(ts_copy.trans_conjuncts(), fts.trans_conjuncts());
+  EXPECT_EQ(ts_copy, fts);
+}
+
+TEST_P(TSUnitTests, Snapshot_RoundTrip)
+{
+  FunctionalTransitionSystem fts(s);
+  Term x = fts.make_statevar("x", bvsort);
+  Term in = fts.make_inputvar("in", bvsort);
+  fts.constrain_init(fts.make_term(Equal, x, fts.make_term(0, bvsort)));
+  Term sum = fts.make_term(BVAdd, x, in);
+  fts.assign_next(x, sum);
+  fts.add_constraint(fts.make_term(BVUlt, in, fts.make_term(3, bvsort)));
+  fts.name_term("sum", sum);
+  Term prop = fts.make_term(BVUle, x, fts.make_term(200, bvsort));
+
+  string filename = ::testing::TempDir() + "pono_test_snapshot.ptss";
+  write_ts_snapshot(filename, fts, { prop });
+
+  // CVC4 does not support multiple solver instances
+  for (const auto & se : available_solver_enums_except({ smt::CVC4 })) {
+    SmtSolver s2 = create_solver(se);
+    TransitionSystem ts(s2);
+    TermVec props = read_ts_snapshot(filename, ts);
+    ASSERT_EQ(props.size(), 1);
+    EXPECT_TRUE(ts.is_functional());
+    EXPECT_EQ(ts.is_deterministic(), fts.is_deterministic());
+    EXPECT_EQ(ts.statevars().size(), 1);
+    EXPECT_EQ(ts.inputvars().size(), 1);
+    EXPECT_EQ(ts.constraints().size(), 1);
+
+    Term x2 = ts.named_terms().at("x");
+    EXPECT_TRUE(ts.is_curr_var(x2));
+    EXPECT_TRUE(ts.is_next_var(ts.next(x2)));
+    EXPECT_EQ(ts.state_updates().at(x2), ts.named_terms().at("sum"));
+    EXPECT_TRUE(ts.only_curr(props[0]));
+
+    // can't read into a system that already has variables
+    EXPECT_THROW(read_ts_snapshot(filename, ts), PonoException);
+  }
+
+  // relational snapshots can't be read into a functional system
+  RelationalTransitionSystem rts(s);
+  rts.make_statevar("y", bvsort);
+  write_ts_snapshot(filename, rts);
+  SmtSolver s3 = create_solver(BTOR);
+  FunctionalTransitionSystem fts3(s3);
+  EXPECT_THROW(read_ts_snapshot(filename, fts3), PonoException);
+
+  remove(filename.c_str());
+}
+
 INSTANTIATE_TEST_SUITE_P(ParameterizedSolverTSUnitTests,
                          TSUnitTests,
                          testing::ValuesIn(available_solver_enums()));
@@ -124,6 +124,52 @@ TEST_P(UnrollerUnitTests, StagedUnrolling)
   EXPECT_EQ(x4py4_2, x4py4);
 }
 
+TEST_P(UnrollerUnitTests, SharedSubterms)
+{
+  RelationalTransitionSystem rts(s);
+  counter_system(rts, rts.make_term(10, bvsort));
+  Term x = rts.named_terms().at("x");
+  Term xp1 = rts.make_term(BVAdd, x, rts.make_term(1, bvsort));
+  Term bad = rts.make_term(Equal, xp1, rts.make_term(3, bvsort));
+
+  Unroller u(rts);
+  Term xp1_2 = u.at_time(xp1, 2);
+  Term bad_2 = u.at_time(bad, 2);
+  // the memoized subterm is reused
+  ASSERT_EQ(*(bad_2->begin()), xp1_2);
+  ASSERT_EQ(bad_2, u.at_time(bad, 2));
+  ASSERT_EQ(u.at_time(x, 2), *(xp1_2->begin()));
+  ASSERT_NE(u.at_time(bad, 3), bad_2);
+
+  Term trans_2 = u.at_time(rts.trans(), 2);
+  UnorderedTermSet free_vars;
+  get_free_symbolic_consts(trans_2, free_vars);
+  for (const auto & v : free_vars) {
+    size_t t = u.get_var_time(v);
+    EXPECT_TRUE(t == 2 || t == 3);
+  }
+}
+
+TEST_P(UnrollerUnitTests, TimeShift)
+{
+  RelationalTransitionSystem rts(s);
+  counter_system(rts, rts.make_term(10, bvsort));
+
+  Unroller u(rts);
+  Term trans_1 = u.at_time(rts.trans(), 1);
+  EXPECT_EQ(u.time_shift(trans_1, 1, 5), u.at_time(rts.trans(), 5));
+  EXPECT_EQ(u.time_shift(trans_1, 1, 0), u.at_time(rts.trans(), 0));
+  EXPECT_EQ(u.time_shift(trans_1, 1, 1), trans_1);
+  // would move the current state variables before 0
+  EXPECT_THROW(u.time_shift(trans_1, 2, 0), PonoException);
+
+  FunctionalTransitionSystem fts(s);
+  counter_system(fts, fts.make_term(10, bvsort));
+  FunctionalUnroller fu(fts);
+  Term x = fts.named_terms().at("x");
+  EXPECT_THROW(fu.time_shift(fu.at_time(x, 1), 1, 2), PonoException);
+}
+
 TEST_P(UnrollerUnitTests, Unroller)
 {
   RelationalTransitionSystem rts(s);
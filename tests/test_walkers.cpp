@@ -105,6 +105,25 @@ TEST_P(WalkersUnitTests, SubTermCollectorBasic)
   }
 }
 
+TEST_P(WalkersUnitTests, WordLevelRewriter)
+{
+  Term b = s->make_symbol("b", boolsort);
+  Term xy = s->make_term(Concat, x, y);
+  Term low = s->make_term(Op(Extract, 3, 0), y);
+
+  WordLevelRewriter rw(s, { { b, s->make_term(true) } });
+  EXPECT_EQ(rw.rewrite(s->make_term(Op(Extract, 3, 0), xy)), low);
+  EXPECT_EQ(rw.rewrite(s->make_term(Op(Extract, 15, 8), xy)), x);
+  EXPECT_EQ(rw.rewrite(s->make_term(Ite, b, x, y)), x);
+  EXPECT_EQ(rw.rewrite(s->make_term(Ite, s->make_term(Not, b), x, y)), y);
+  Term high = s->make_term(Op(Extract, 7, 4), y);
+  EXPECT_EQ(rw.rewrite(s->make_term(Concat, high, low)), y);
+  EXPECT_EQ(rw.rewrite(s->make_term(Op(Extract, 2, 1), low)),
+            s->make_term(Op(Extract, 2, 1), y));
+  EXPECT_EQ(rw.rewrite(s->make_term(And, b, s->make_term(Equal, x, x))),
+            s->make_term(true));
+}
+
 INSTANTIATE_TEST_SUITE_P(ParameterizedWalkersUnitTests,
                          WalkersUnitTests,
                          testing::ValuesIn(available_solver_enums()));
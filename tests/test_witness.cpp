@@ -1,14 +1,18 @@
+#include <fstream>
+#include <sstream>
 #include <utility>
 #include <vector>
 
 #include "core/fts.h"
 #include "core/rts.h"
 #include "core/unroller.h"
+#include "core/witness_trace.h"
 #include "engines/bmc.h"
 #include "engines/bmc_simplepath.h"
 #include "engines/interpolantmc.h"
 #include "engines/kinduction.h"
 #include "gtest/gtest.h"
+#include "printers/vcd_witness_printer.h"
 #include "smt/available_solvers.h"
 #include "tests/common_ts.h"
 #include "utils/exceptions.h"
@@ -89,6 +93,121 @@ TEST_P(WitnessUnitTests, ArraysDefaultSolver)
   ASSERT_EQ(witness[6][x], fts.make_term(10, bvsort4));
 }
 
+TEST_P(WitnessUnitTests, PackedTrace)
+{
+  FunctionalTransitionSystem fts;
+  Sort bvsort8 = fts.make_sort(BV, 8);
+  Sort bvsort100 = fts.make_sort(BV, 100);
+  counter_system(fts, fts.make_term(20, bvsort8));
+  Term x = fts.named_terms().at("x");
+  Term wide = fts.make_statevar("wide", bvsort100);
+  fts.constrain_init(fts.make_term(Equal, wide, fts.make_term(0, bvsort100)));
+  // shift in ones so the value crosses the word boundary
+  fts.assign_next(
+      wide,
+      fts.make_term(BVOr,
+                    fts.make_term(BVShl, wide, fts.make_term(40, bvsort100)),
+                    fts.make_term(1, bvsort100)));
+
+  Term prop_term = fts.make_term(BVUlt, x, fts.make_term(3, bvsort8));
+  Property prop(fts.solver(), prop_term);
+
+  SmtSolver s = create_solver(GetParam());
+  Bmc bmc(prop, fts, s);
+  ASSERT_EQ(bmc.check_until(5), FALSE);
+
+  vector<UnorderedTermMap> witness;
+  ASSERT_TRUE(bmc.witness(witness));
+  ASSERT_EQ(witness.size(), 4);
+
+  // duplicates are ignored
+  WitnessTrace trace = WitnessTrace::from_maps({ x, wide, x }, witness);
+  ASSERT_EQ(trace.num_signals(), 2);
+  ASSERT_EQ(trace.num_frames(), 4);
+
+  size_t xi, wi;
+  ASSERT_TRUE(trace.find(x, xi));
+  ASSERT_TRUE(trace.find(wide, wi));
+  ASSERT_TRUE(trace.is_packed(wi));
+  ASSERT_EQ(trace.width(wi), 100);
+
+  for (size_t k = 0; k < trace.num_frames(); ++k) {
+    ASSERT_TRUE(trace.has_value(xi, k));
+    ASSERT_EQ(trace.words(xi, k)[0], k);
+    ASSERT_EQ(trace.bits(xi, k), WitnessTrace::value_bits(witness[k][x]));
+  }
+
+  ASSERT_EQ(trace.bits(wi, 0), string(100, '0'));
+  // frame 2: (1 << 40) | 1
+  ASSERT_EQ(trace.words(wi, 2)[0], (uint64_t(1) << 40) | 1);
+  ASSERT_EQ(trace.words(wi, 2)[1], 0);
+  // frame 3: (1 << 80) | (1 << 40) | 1
+  ASSERT_EQ(trace.words(wi, 3)[1], uint64_t(1) << 16);
+  ASSERT_EQ(WitnessTrace::value_decimal(witness[3][wide]),
+            "1208925819615728686333953");
+  ASSERT_FALSE(trace.same_value(wi, 2, 3));
+  ASSERT_TRUE(trace.same_value(wi, 3, 3));
+}
+
+TEST_P(WitnessUnitTests, VCDFilter)
+{
+  FunctionalTransitionSystem fts;
+  Sort bvsort8 = fts.make_sort(BV, 8);
+  counter_system(fts, fts.make_term(20, bvsort8));
+  Term x = fts.named_terms().at("x");
+  // does not influence the property
+  Term y = fts.make_statevar("y", bvsort8);
+  fts.constrain_init(fts.make_term(Equal, y, fts.make_term(5, bvsort8)));
+  fts.assign_next(y, y);
+
+  Term prop_term = fts.make_term(BVUlt, x, fts.make_term(4, bvsort8));
+  Property prop(fts.solver(), prop_term);
+
+  SmtSolver s = create_solver(GetParam());
+  Bmc bmc(prop, fts, s);
+  ASSERT_EQ(bmc.check_until(5), FALSE);
+  vector<UnorderedTermMap> witness;
+  ASSERT_TRUE(bmc.witness(witness));
+
+  auto read_file = [](const string & filename) {
+    ifstream in(filename);
+    stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+  };
+
+  string filename = ::testing::TempDir() + "pono_test_witness.vcd";
+  VCDSignalFilter filter;
+  filter.coi_of.push_back(prop_term);
+  {
+    VCDStreamWriter writer(fts, filename, filter);
+    for (const auto & m : witness) {
+      writer.write_frame(m);
+    }
+    ASSERT_EQ(writer.num_signals(), 1);
+    ASSERT_EQ(writer.num_frames(), witness.size());
+  }
+  string vcd = read_file(filename);
+  ASSERT_NE(vcd.find(" x[7:0] $end"), string::npos);
+  ASSERT_EQ(vcd.find(" y[7:0] $end"), string::npos);
+  // x changes every frame
+  ASSERT_NE(vcd.find("b00000100 v0"), string::npos);
+  ASSERT_NE(vcd.find("#" + std::to_string(witness.size())), string::npos);
+
+  filter = VCDSignalFilter();
+  filter.globs.push_back("y*");
+  VCDWitnessPrinter printer(fts, witness);
+  printer.dump_trace_to_file(filename, filter);
+  vcd = read_file(filename);
+  ASSERT_EQ(vcd.find(" x[7:0] $end"), string::npos);
+  ASSERT_NE(vcd.find(" y[7:0] $end"), string::npos);
+  // y never changes, so its value is written once
+  size_t first = vcd.find("b00000101");
+  ASSERT_NE(first, string::npos);
+  ASSERT_EQ(vcd.find("b00000101", first + 1), string::npos);
+  remove(filename.c_str());
+}
+
 INSTANTIATE_TEST_SUITE_P(
     ParameterizedWitnessUnitTests,
     WitnessUnitTests,
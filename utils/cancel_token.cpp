@@ -0,0 +1,183 @@
+/*********************                                                        */
+/*! \file cancel_token.cpp
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Cooperative cancellation with an optional wall-clock and memory
+**        budget.
+**
+**/
+
+#include "utils/cancel_token.h"
+
+#include <sys/resource.h>
+#include <algorithm>
+
+#include "utils/logger.h"
+
+using namespace std;
+
+namespace pono {
+
+enum CancelReason
+{
+  NOT_CANCELLED = 0,
+  CANCEL_REQUESTED,
+  TIME_LIMIT,
+  MEMORY_LIMIT,
+  PARENT_CANCELLED
+};
+
+const chrono::milliseconds CancelToken::memory_probe_interval(10);
+
+CancelToken::CancelToken(const shared_ptr<CancelToken> & parent)
+    : parent_(parent),
+      cancelled_(false),
+      reason_(NOT_CANCELLED),
+      time_limit_(0),
+      deadline_(0),
+      memory_limit_mb_(0),
+      next_memory_probe_(0)
+{
+}
+
+void CancelToken::cancel()
+{
+  vector<function<void()>> callbacks;
+  {
+    lock_guard<mutex> lock(callbacks_mutex_);
+    if (cancelled_) {
+      return;
+    }
+    reason_ = CANCEL_REQUESTED;
+    cancelled_ = true;
+    callbacks = callbacks_;
+  }
+
+  for (const auto & cb : callbacks) {
+    cb();
+  }
+}
+
+bool CancelToken::cancelled()
+{
+  if (cancelled_) {
+    return true;
+  }
+
+  int reason = NOT_CANCELLED;
+  if (parent_ && parent_->cancelled()) {
+    reason = PARENT_CANCELLED;
+  } else if (time_limit_ || memory_limit_mb_) {
+    ClockTicks now = chrono::steady_clock::now().time_since_epoch().count();
+    ClockTicks time_limit = time_limit_;
+    if (time_limit) {
+      ClockTicks deadline = deadline_;
+      if (!deadline) {
+        // the budget starts at the first poll, unless another thread
+        // started it concurrently
+        ClockTicks unset = 0;
+        deadline = now + time_limit;
+        if (!deadline_.compare_exchange_strong(unset, deadline)) {
+          deadline = unset;
+        }
+      }
+      if (now >= deadline) {
+        reason = TIME_LIMIT;
+      }
+    }
+
+    ClockTicks next_probe = next_memory_probe_;
+    if (reason == NOT_CANCELLED && memory_limit_mb_ && now >= next_probe) {
+      ClockTicks interval =
+          chrono::duration_cast<chrono::steady_clock::duration>(
+              memory_probe_interval)
+              .count();
+      // only one of the threads polling concurrently probes
+      if (next_memory_probe_.compare_exchange_strong(next_probe,
+                                                     now + interval)
+          && peak_memory_mb() >= memory_limit_mb_) {
+        reason = MEMORY_LIMIT;
+      }
+    }
+  }
+
+  if (reason != NOT_CANCELLED) {
+    reason_ = reason;
+    cancelled_ = true;
+    logger.log(1, "Cancelled: {}", this->reason());
+  }
+  return cancelled_;
+}
+
+void CancelToken::set_time_limit(double seconds)
+{
+  time_limit_ = 0;
+  deadline_ = 0;
+  if (seconds > 0) {
+    // at least one tick, 0 means no time limit
+    time_limit_ = max<ClockTicks>(
+        chrono::duration_cast<chrono::steady_clock::duration>(
+            chrono::duration<double>(seconds))
+            .count(),
+        1);
+  }
+}
+
+void CancelToken::set_memory_limit(size_t megabytes)
+{
+  memory_limit_mb_ = megabytes;
+  // probe at the next poll
+  next_memory_probe_ = 0;
+}
+
+void CancelToken::on_cancel(const function<void()> & callback)
+{
+  lock_guard<mutex> lock(callbacks_mutex_);
+  callbacks_.push_back(callback);
+}
+
+void CancelToken::reset()
+{
+  lock_guard<mutex> lock(callbacks_mutex_);
+  time_limit_ = 0;
+  deadline_ = 0;
+  memory_limit_mb_ = 0;
+  next_memory_probe_ = 0;
+  reason_ = NOT_CANCELLED;
+  cancelled_ = false;
+}
+
+string CancelToken::reason() const
+{
+  switch (reason_) {
+    case CANCEL_REQUESTED: return "cancellation requested";
+    case TIME_LIMIT: return "time limit reached";
+    case MEMORY_LIMIT: return "memory limit reached";
+    case PARENT_CANCELLED: return "parent cancelled";
+    default: return "";
+  }
+}
+
+size_t CancelToken::peak_memory_mb()
+{
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage)) {
+    return 0;
+  }
+#ifdef __APPLE__
+  // reported in bytes
+  return usage.ru_maxrss / (1024 * 1024);
+#else
+  // reported in kilobytes
+  return usage.ru_maxrss / 1024;
+#endif
+}
+
+}  // namespace pono
@@ -0,0 +1,106 @@
+/*********************                                                        */
+/*! \file cancel_token.h
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Cooperative cancellation with an optional wall-clock and memory
+**        budget. Engines poll the token between solver calls and return
+**        UNKNOWN once it is cancelled, keeping their state so that checking
+**        can be resumed later.
+**
+**/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace pono {
+
+class CancelToken
+{
+ public:
+  /** @param parent if non-null, this token is also cancelled whenever
+   *         the parent is (e.g. for the sub-provers of a portfolio)
+   */
+  CancelToken(const std::shared_ptr<CancelToken> & parent = nullptr);
+
+  /** Requests cancellation and runs the registered callbacks once
+   *  Safe to call from any thread
+   */
+  void cancel();
+
+  /** @return true if cancel() was called, the time or memory budget is
+   *          exhausted, or the parent token is cancelled
+   */
+  bool cancelled();
+
+  /** Sets a wall-clock budget
+   *  The budget starts at the first poll of cancelled() after this call,
+   *  i.e. when an engine starts checking rather than when it is built
+   *  @param seconds the budget, 0 for no time limit
+   */
+  void set_time_limit(double seconds);
+
+  /** Sets a budget on the peak resident memory of the process
+   *  The memory use is probed at most once per memory_probe_interval
+   *  @param megabytes the budget, 0 for no memory limit
+   */
+  void set_memory_limit(size_t megabytes);
+
+  /** Registers a callback that is run when cancel() is first called
+   *  e.g. to interrupt a solver that supports asynchronous termination
+   *  Note: budgets are only noticed when polled, so exhausting them
+   *  does not run the callbacks
+   */
+  void on_cancel(const std::function<void()> & callback);
+
+  /** Clears the cancellation and the budgets so the token can be reused
+   *  for resuming a check
+   */
+  void reset();
+
+  /** @return a description of why the token was cancelled,
+   *          empty if it was not
+   */
+  std::string reason() const;
+
+ protected:
+  /** the minimum time between two probes of the memory use
+   *  getrusage is a system call, while engines may poll very often
+   */
+  static const std::chrono::milliseconds memory_probe_interval;
+
+  /** @return the peak resident memory of the process in megabytes */
+  static size_t peak_memory_mb();
+
+  std::shared_ptr<CancelToken> parent_;
+
+  std::atomic<bool> cancelled_;
+  std::atomic<int> reason_;  ///< one of the reasons in the source file
+
+  typedef std::chrono::steady_clock::rep ClockTicks;
+
+  // budgets are polled from several threads, e.g. by the workers of a
+  // portfolio, so the times are kept as atomic steady_clock ticks
+  std::atomic<ClockTicks> time_limit_;  ///< 0 for no time limit
+  std::atomic<ClockTicks> deadline_;    ///< 0 until the first poll
+  std::atomic<size_t> memory_limit_mb_;
+  std::atomic<ClockTicks> next_memory_probe_;
+
+  std::mutex callbacks_mutex_;
+  std::vector<std::function<void()>> callbacks_;
+};
+
+}  // namespace pono
@@ -0,0 +1,353 @@
+/*********************                                                        */
+/*! \file invariant_miner.cpp
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Mines candidate invariants from random simulation traces and
+**        keeps the ones that are inductive.
+**
+**/
+
+#include "utils/invariant_miner.h"
+
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+
+#include "core/simulator.h"
+#include "utils/exceptions.h"
+#include "utils/logger.h"
+
+using namespace smt;
+using namespace std;
+
+namespace pono {
+
+namespace {
+
+struct ClassKeyHash
+{
+  size_t operator()(const pair<uint32_t, uint64_t> & k) const
+  {
+    return hash<uint64_t>()(k.second * 0x9e3779b97f4a7c15ULL + k.first);
+  }
+};
+
+}  // namespace
+
+InvariantMiner::InvariantMiner(const TransitionSystem & ts,
+                               const SmtSolver & solver,
+                               const PonoOptions & opts)
+    : ts_(ts),
+      solver_(solver),
+      options_(opts),
+      num_samples_(0),
+      num_buffered_(0),
+      implications_init_(false),
+      num_word_classes_(0)
+{
+}
+
+vector<TermVec> InvariantMiner::propose()
+{
+  unique_ptr<Simulator> sim;
+  try {
+    sim.reset(new Simulator(ts_));
+  }
+  catch (PonoException & e) {
+    logger.log(1, "Skipping invariant mining: {}", e.what());
+    return {};
+  }
+
+  // sorted by name for reproducibility
+  TermVec states(ts_.statevars().begin(), ts_.statevars().end());
+  sort(states.begin(), states.end(), [](const Term & a, const Term & b) {
+    return a->to_string() < b->to_string();
+  });
+  for (const auto & sv : states) {
+    Sort sort = sv->get_sort();
+    SortKind sk = sort->get_sort_kind();
+    if (sk == BOOL || (sk == BV && sort->get_width() == 1)) {
+      bit_vars_.push_back(sv);
+    } else if (sk == BV && sort->get_width() <= 64) {
+      word_vars_.push_back(sv);
+    }
+  }
+
+  bit_first_.assign(bit_vars_.size(), 0);
+  bit_buf_.assign(bit_vars_.size(), 0);
+  bit_const_.assign(bit_vars_.size(), true);
+  bit_class_.assign(bit_vars_.size(), 0);
+  word_first_.assign(word_vars_.size(), 0);
+  word_vals_.assign(word_vars_.size(), 0);
+  word_const_.assign(word_vars_.size(), true);
+  // only variables of the same width can be equal
+  word_class_.clear();
+  for (const auto & wv : word_vars_) {
+    word_class_.push_back(wv->get_sort()->get_width());
+  }
+  num_word_classes_ = refine(word_class_, word_vals_);
+
+  for (size_t t = 0; t < options_.sim_seeds_; ++t) {
+    sim->seed(options_.random_seed_ + t);
+    bool ok = false;
+    for (size_t a = 0; !ok && a <= max_redraws_; ++a) {
+      sim->randomize_inputs();
+      ok = sim->reset(a < max_redraws_);
+    }
+
+    for (size_t i = 0; ok && i <= options_.sim_cycles_; ++i) {
+      sim->eval();
+      for (size_t a = 0; i > 0 && !sim->constraints_hold() && a < max_redraws_;
+           ++a) {
+        sim->randomize_inputs();
+        sim->eval();
+      }
+      if (!sim->constraints_hold()) {
+        break;
+      }
+      sample(*sim);
+      sim->advance();
+      sim->randomize_inputs();
+    }
+  }
+  if (num_buffered_) {
+    flush_bits();
+  }
+
+  vector<TermVec> candidates;
+  if (!num_samples_) {
+    logger.log(1, "Invariant mining: no state satisfied the constraints");
+    return candidates;
+  }
+
+  // constants
+  for (size_t i = 0; i < bit_vars_.size(); ++i) {
+    if (bit_const_[i]) {
+      candidates.push_back({ literal(bit_vars_[i], bit_first_[i]) });
+    }
+  }
+  for (size_t i = 0; i < word_vars_.size(); ++i) {
+    if (word_const_[i]) {
+      const Term & wv = word_vars_[i];
+      Term val =
+          solver_->make_term(std::to_string(word_first_[i]), wv->get_sort());
+      candidates.push_back({ solver_->make_term(Equal, wv, val) });
+    }
+  }
+
+  // equivalences with the first (non-constant) variable of each class
+  unordered_map<uint32_t, size_t> rep;
+  for (size_t i = 0; i < bit_vars_.size(); ++i) {
+    if (bit_const_[i]) {
+      continue;
+    }
+    auto it = rep.find(bit_class_[i]);
+    if (it == rep.end()) {
+      rep[bit_class_[i]] = i;
+      continue;
+    }
+    size_t r = it->second;
+    bool d = bit_first_[r] != bit_first_[i];
+    // i == r xor d
+    candidates.push_back(
+        { literal(bit_vars_[r], false), literal(bit_vars_[i], !d) });
+    candidates.push_back(
+        { literal(bit_vars_[r], true), literal(bit_vars_[i], d) });
+  }
+  rep.clear();
+  for (size_t i = 0; i < word_vars_.size(); ++i) {
+    if (word_const_[i]) {
+      continue;
+    }
+    auto it = rep.find(word_class_[i]);
+    if (it == rep.end()) {
+      rep[word_class_[i]] = i;
+      continue;
+    }
+    candidates.push_back(
+        { solver_->make_term(Equal, word_vars_[it->second], word_vars_[i]) });
+  }
+
+  // implications that do not follow from the above
+  for (const auto & ab : implications_) {
+    if (bit_const_[ab.first] || bit_const_[ab.second]
+        || bit_class_[ab.first] == bit_class_[ab.second]) {
+      continue;
+    }
+    candidates.push_back({ literal(bit_vars_[ab.first], false),
+                           literal(bit_vars_[ab.second], true) });
+  }
+
+  logger.log(1,
+             "Invariant mining: {} candidates from {} sampled states",
+             candidates.size(),
+             num_samples_);
+  return candidates;
+}
+
+vector<TermVec> InvariantMiner::filter(const vector<TermVec> & candidates)
+{
+  vector<TermVec> clauses = candidates;
+  drop_violated(clauses, false);
+  drop_violated(clauses, true);
+  logger.log(1,
+             "Invariant mining: {} of {} candidates are inductive",
+             clauses.size(),
+             candidates.size());
+  return clauses;
+}
+
+vector<TermVec> InvariantMiner::mine() { return filter(propose()); }
+
+void InvariantMiner::sample(const Simulator & sim)
+{
+  for (size_t i = 0; i < bit_vars_.size(); ++i) {
+    uint64_t v = sim.get(bit_vars_[i]);
+    if (!num_samples_) {
+      bit_first_[i] = v;
+    }
+    bit_buf_[i] |= v << num_buffered_;
+  }
+
+  for (size_t i = 0; i < word_vars_.size(); ++i) {
+    uint64_t v = sim.get(word_vars_[i]);
+    if (!num_samples_) {
+      word_first_[i] = v;
+    } else if (v != word_first_[i]) {
+      word_const_[i] = false;
+    }
+    word_vals_[i] = v;
+  }
+  // nothing left to split once all classes are singletons
+  if (num_word_classes_ < word_vars_.size()) {
+    num_word_classes_ = refine(word_class_, word_vals_);
+  }
+
+  ++num_samples_;
+  if (++num_buffered_ == 64) {
+    flush_bits();
+  }
+}
+
+void InvariantMiner::flush_bits()
+{
+  assert(num_buffered_ && num_buffered_ <= 64);
+  uint64_t valid =
+      (num_buffered_ == 64) ? ~0ULL : ((1ULL << num_buffered_) - 1);
+
+  vector<uint64_t> norm(bit_vars_.size());
+  for (size_t i = 0; i < bit_vars_.size(); ++i) {
+    norm[i] = (bit_buf_[i] ^ (bit_first_[i] ? ~0ULL : 0)) & valid;
+    if (norm[i]) {
+      bit_const_[i] = false;
+    }
+  }
+  refine(bit_class_, norm);
+
+  const vector<uint64_t> & w = bit_buf_;
+  if (!implications_init_) {
+    implications_init_ = true;
+    vector<uint32_t> vars;
+    for (size_t i = 0;
+         i < bit_vars_.size() && vars.size() < max_implication_vars_;
+         ++i) {
+      if (!bit_const_[i]) {
+        vars.push_back(i);
+      }
+    }
+    for (auto a : vars) {
+      for (auto b : vars) {
+        if (a != b && !(w[a] & ~w[b] & valid)) {
+          implications_.push_back({ a, b });
+        }
+      }
+    }
+  } else {
+    auto violated = [&w, valid](const pair<uint32_t, uint32_t> & ab) {
+      return (w[ab.first] & ~w[ab.second] & valid) != 0;
+    };
+    implications_.erase(
+        remove_if(implications_.begin(), implications_.end(), violated),
+        implications_.end());
+  }
+
+  fill(bit_buf_.begin(), bit_buf_.end(), 0);
+  num_buffered_ = 0;
+}
+
+void InvariantMiner::drop_violated(vector<TermVec> & clauses, bool next)
+{
+  Term false_ = solver_->make_term(false);
+  while (clauses.size()) {
+    TermVec terms;
+    Term all = solver_->make_term(true);
+    for (const auto & c : clauses) {
+      Term t = c.at(0);
+      for (size_t i = 1; i < c.size(); ++i) {
+        t = solver_->make_term(Or, t, c[i]);
+      }
+      terms.push_back(next ? ts_.next(t) : t);
+      all = solver_->make_term(And, all, t);
+    }
+
+    solver_->push();
+    if (next) {
+      solver_->assert_formula(ts_.trans());
+      solver_->assert_formula(all);
+      all = ts_.next(all);
+    } else {
+      solver_->assert_formula(ts_.init());
+    }
+    solver_->assert_formula(solver_->make_term(Not, all));
+    Result r = solver_->check_sat();
+    if (r.is_unsat()) {
+      solver_->pop();
+      return;
+    } else if (!r.is_sat()) {
+      solver_->pop();
+      logger.log(1, "Invariant mining: solver returned {}", r.to_string());
+      clauses.clear();
+      return;
+    }
+
+    vector<TermVec> kept;
+    for (size_t i = 0; i < clauses.size(); ++i) {
+      if (solver_->get_value(terms[i]) != false_) {
+        kept.push_back(clauses[i]);
+      }
+    }
+    solver_->pop();
+    assert(kept.size() < clauses.size());
+    clauses = kept;
+  }
+}
+
+Term InvariantMiner::literal(const Term & var, bool val) const
+{
+  Sort sort = var->get_sort();
+  if (sort->get_sort_kind() == BOOL) {
+    return val ? var : solver_->make_term(Not, var);
+  }
+  return solver_->make_term(Equal, var, solver_->make_term(val ? 1 : 0, sort));
+}
+
+size_t InvariantMiner::refine(vector<uint32_t> & cls,
+                              const vector<uint64_t> & vals)
+{
+  assert(cls.size() == vals.size());
+  unordered_map<pair<uint32_t, uint64_t>, uint32_t, ClassKeyHash> ids;
+  for (size_t i = 0; i < cls.size(); ++i) {
+    auto res = ids.insert({ { cls[i], vals[i] }, ids.size() });
+    cls[i] = res.first->second;
+  }
+  return ids.size();
+}
+
+}  // namespace pono
@@ -0,0 +1,125 @@
+/*********************                                                        */
+/*! \file invariant_miner.h
+** \verbatim
+** Top contributors (to current version):
+**   agent
+** This file is part of the pono project.
+** Copyright (c) 2019 by the authors listed in the file AUTHORS
+** in the top-level source directory) and their institutional affiliations.
+** All rights reserved.  See the file LICENSE in the top-level source
+** directory for licensing information.\endverbatim
+**
+** \brief Mines candidate invariants from random simulation traces and
+**        keeps the ones that are inductive.
+**
+**        Candidates are constant state variables, equivalent or
+**        complementary pairs of bit-level (boolean or 1-bit) state
+**        variables, equal pairs of wider state variables and implications
+**        between bit-level state variables. Bit-level samples are packed
+**        64 per word so that a pair is checked against 64 states at once.
+**
+**/
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "core/ts.h"
+#include "options/options.h"
+#include "smt-switch/smt.h"
+
+namespace pono {
+
+class Simulator;
+
+class InvariantMiner
+{
+ public:
+  /** @param ts the system to mine, it can only be simulated if it is
+   *         functional (see Simulator)
+   *  @param solver the solver of ts, used (with push and pop) to filter
+   *         the candidates
+   *  @param opts uses sim_seeds_ (number of traces), sim_cycles_ (steps
+   *         per trace) and random_seed_
+   */
+  InvariantMiner(const TransitionSystem & ts,
+                 const smt::SmtSolver & solver,
+                 const PonoOptions & opts);
+
+  /** Simulates random traces and proposes the facts that held in every
+   *  visited state
+   *  @return the candidates as clauses over current state variables,
+   *          empty if ts cannot be simulated
+   */
+  std::vector<smt::TermVec> propose();
+
+  /** Drops candidates until the remaining ones hold initially and are
+   *  inductive together (i.e. relative to each other)
+   *  @param candidates clauses over current state variables
+   *  @return the candidates that were kept
+   */
+  std::vector<smt::TermVec> filter(
+      const std::vector<smt::TermVec> & candidates);
+
+  /** propose followed by filter */
+  std::vector<smt::TermVec> mine();
+
+ protected:
+  /** Records the values of the current state of sim */
+  void sample(const Simulator & sim);
+
+  /** Refines the bit-level candidates with the buffered samples */
+  void flush_bits();
+
+  /** Drops the clauses that can be falsified until none can
+   *  @param clauses the candidates, updated in place
+   *  @param next if set, check the clauses in the next state of a
+   *         transition from a state where they all hold, otherwise
+   *         check them in the initial states
+   */
+  void drop_violated(std::vector<smt::TermVec> & clauses, bool next);
+
+  /** @return a literal for a bit-level variable having value val */
+  smt::Term literal(const smt::Term & var, bool val) const;
+
+  /** Splits the classes of cls by values, variables stay in the same
+   *  class only if they have the same value
+   *  @return the number of classes
+   */
+  static size_t refine(std::vector<uint32_t> & cls,
+                       const std::vector<uint64_t> & vals);
+
+  const TransitionSystem & ts_;
+  smt::SmtSolver solver_;
+  PonoOptions options_;
+
+  size_t num_samples_;
+
+  // bit-level (boolean or 1-bit) state variables
+  smt::TermVec bit_vars_;
+  std::vector<uint64_t> bit_first_;  ///< value in the first sample
+  std::vector<uint64_t> bit_buf_;  ///< samples not flushed yet, packed
+  size_t num_buffered_;
+  std::vector<bool> bit_const_;
+  // class of equivalent variables, relative to the first sample so that
+  // complementary variables are in the same class
+  std::vector<uint32_t> bit_class_;
+  // (a, b) such that a implies b in all samples
+  std::vector<std::pair<uint32_t, uint32_t>> implications_;
+  bool implications_init_;
+
+  // wider state variables (at most 64 bits)
+  smt::TermVec word_vars_;
+  std::vector<uint64_t> word_first_;
+  std::vector<uint64_t> word_vals_;
+  std::vector<bool> word_const_;
+  std::vector<uint32_t> word_class_;
+  size_t num_word_classes_;
+
+  // implications are only mined between this many bit-level variables
+  static const size_t max_implication_vars_ = 256;
+  static const size_t max_redraws_ = 8;
+};
+
+}  // namespace pono
@@ -16,6 +16,8 @@
 
 #include "make_provers.h"
 
+#include "engines/aig_bmc.h"
+#include "engines/aig_ic3.h"
 #include "engines/bmc.h"
 #include "engines/bmc_simplepath.h"
 #include "engines/ceg_prophecy_arrays.h"
@@ -27,6 +29,7 @@
 #include "engines/interpolantmc.h"
 #include "engines/kinduction.h"
 #include "engines/mbic3.h"
+#include "engines/portfolio.h"
 #include "engines/syguspdr.h"
 #ifdef WITH_MSAT_IC3IA
 #include "engines/msat_ic3ia.h"
@@ -88,6 +91,12 @@ shared_ptr<Prover> make_prover(Engine e,
     return make_shared<IC3SA>(p, ts, slv, opts);
   } else if (e == SYGUS_PDR) {
     return make_shared<SygusPdr>(p, ts, slv, opts);
+  } else if (e == AIG_BMC) {
+    return make_shared<AigBmc>(p, ts, slv, opts);
+  } else if (e == AIG_IC3) {
+    return make_shared<AigIC3>(p, ts, slv, opts);
+  } else if (e == PORTFOLIO) {
+    return make_shared<Portfolio>(p, ts, slv, opts);
   } else {
     throw PonoException("Unhandled engine");
   }
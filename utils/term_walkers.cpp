@@ -123,4 +123,146 @@ WalkerStepResult SubTermCollector::visit_term(smt::Term & term)
   return Walker_Continue;
 }
 
+WordLevelRewriter::WordLevelRewriter(const SmtSolver & solver,
+                                     const UnorderedTermMap & subst)
+    : super(solver, false),
+      true_(solver_->make_term(true)),
+      false_(solver_->make_term(false))
+{
+  for (const auto & elem : subst) {
+    save_in_cache(elem.first, elem.second);
+  }
+}
+
+WalkerStepResult WordLevelRewriter::visit_term(Term & term)
+{
+  if (preorder_ || in_cache(term)) {
+    return Walker_Continue;
+  }
+
+  Op op = term->get_op();
+  if (op.is_null()) {
+    save_in_cache(term, term);
+    return Walker_Continue;
+  }
+
+  TermVec cached_children;
+  bool changed = false;
+  Term cc;
+  for (auto c : term) {
+    bool ok = query_cache(c, cc);
+    assert(ok);  // in post-order so should always have a cache hit
+    changed |= (c != cc);
+    cached_children.push_back(cc);
+  }
+
+  Term res = rewrite_node(op, cached_children);
+  if (!res) {
+    res = changed ? solver_->make_term(op, cached_children) : term;
+  }
+  save_in_cache(term, res);
+  return Walker_Continue;
+}
+
+Term WordLevelRewriter::make_term(const Op & op, const TermVec & children)
+{
+  Term res = rewrite_node(op, children);
+  return res ? res : solver_->make_term(op, children);
+}
+
+Term WordLevelRewriter::rewrite_node(const Op & op, const TermVec & children)
+{
+  const PrimOp po = op.prim_op;
+  if (po == Ite) {
+    assert(children.size() == 3);
+    if (children[0] == true_ || children[1] == children[2]) {
+      return children[1];
+    } else if (children[0] == false_) {
+      return children[2];
+    }
+  } else if (po == Extract) {
+    assert(children.size() == 1);
+    const Term & x = children[0];
+    const uint64_t hi = op.idx0;
+    const uint64_t lo = op.idx1;
+    if (!lo && hi + 1 == x->get_sort()->get_width()) {
+      return x;
+    }
+    const Op xop = x->get_op();
+    if (xop == Extract) {
+      Term y = *(x->begin());
+      return make_term(Op(Extract, hi + xop.idx1, lo + xop.idx1), { y });
+    } else if (xop == Concat) {
+      TermVec parts;
+      for (auto c : x) {
+        parts.push_back(c);
+      }
+      assert(parts.size() == 2);
+      // the second argument holds the least significant bits
+      const uint64_t w = parts[1]->get_sort()->get_width();
+      if (hi < w) {
+        return make_term(op, { parts[1] });
+      } else if (lo >= w) {
+        return make_term(Op(Extract, hi - w, lo - w), { parts[0] });
+      }
+    } else if (xop == Zero_Extend) {
+      Term y = *(x->begin());
+      if (hi < y->get_sort()->get_width()) {
+        return make_term(op, { y });
+      }
+    }
+  } else if (po == Concat) {
+    assert(children.size() == 2);
+    const Op op0 = children[0]->get_op();
+    const Op op1 = children[1]->get_op();
+    if (op0 == Extract && op1 == Extract && op0.idx1 == op1.idx0 + 1) {
+      Term x = *(children[0]->begin());
+      if (x == *(children[1]->begin())) {
+        return make_term(Op(Extract, op0.idx0, op1.idx1), { x });
+      }
+    }
+  } else if (po == Equal) {
+    assert(children.size() == 2);
+    if (children[0] == children[1]) {
+      return true_;
+    }
+    // values of these sorts are unique
+    const SortKind sk = children[0]->get_sort()->get_sort_kind();
+    if ((sk == BV || sk == BOOL) && children[0]->is_value()
+        && children[1]->is_value()) {
+      return false_;
+    }
+  } else if (po == Not) {
+    assert(children.size() == 1);
+    const Term & x = children[0];
+    if (x == true_) {
+      return false_;
+    } else if (x == false_) {
+      return true_;
+    } else if (x->get_op() == Not) {
+      return *(x->begin());
+    }
+  } else if (po == Implies) {
+    assert(children.size() == 2);
+    if (children[0] == true_) {
+      return children[1];
+    } else if (children[0] == false_ || children[1] == true_
+               || children[0] == children[1]) {
+      return true_;
+    }
+  } else if ((po == And || po == Or) && children.size() == 2) {
+    // absorbing and neutral constants
+    const Term & absorb = (po == And) ? false_ : true_;
+    const Term & neutral = (po == And) ? true_ : false_;
+    if (children[0] == absorb || children[1] == absorb) {
+      return absorb;
+    } else if (children[0] == neutral || children[0] == children[1]) {
+      return children[1];
+    } else if (children[1] == neutral) {
+      return children[0];
+    }
+  }
+  return nullptr;
+}
+
 }  // namespace pono
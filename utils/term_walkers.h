@@ -92,4 +92,43 @@ class SubTermCollector : public smt::IdentityWalker
   smt::WalkerStepResult visit_term(smt::Term & term) override;
 };
 
+/** Class for cheap word-level rewriting
+ *  Rebuilds terms bottom-up, simplifying ites with a constant condition or
+ *  equal branches, extracts of concats, extracts and zero extensions,
+ *  concats of adjacent extracts, and boolean operators and equalities
+ *  with constant or equal arguments.
+ *  The cache persists between calls, so shared subterms are only
+ *  rewritten once.
+ */
+class WordLevelRewriter : public smt::IdentityWalker
+{
+ public:
+  /** @param solver the solver of the terms to rewrite
+   *  @param subst replacements applied before rewriting, e.g. of variables
+   *         by constants, the replacements themselves are not rewritten
+   */
+  WordLevelRewriter(const smt::SmtSolver & solver,
+                    const smt::UnorderedTermMap & subst = {});
+
+  typedef smt::IdentityWalker super;
+
+  smt::Term rewrite(smt::Term term) { return visit(term); }
+
+ protected:
+  smt::WalkerStepResult visit_term(smt::Term & term) override;
+
+  /** @return a term equivalent to op applied to the (rewritten) children
+   *          or nullptr if no rule applies
+   */
+  smt::Term rewrite_node(const smt::Op & op, const smt::TermVec & children);
+
+  /** @return rewrite_node of op and children, or the plain term if no rule
+   *          applies
+   */
+  smt::Term make_term(const smt::Op & op, const smt::TermVec & children);
+
+  smt::Term true_;
+  smt::Term false_;
+};
+
 }  // namespace pono